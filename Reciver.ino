@@ -7,20 +7,48 @@ void setup() {
   Config cfg;
   cfg.frequency = 915E6; // o 868E6 según tu setup
   cfg.sck=5; cfg.miso=19; cfg.mosi=27; cfg.ss=18; cfg.rst=14; cfg.dio0=26;
-  if (!begin(cfg)) {
+  if (!begin(cfg) || !beginAsync()) {
     Serial.println("LoRa init FAILED");
     while (1) delay(1000);
   }
   Serial.println("LoRa OK (RX esperando)");
 }
 
+// Un operator() por tipo: dispatch<> elige en compilación según el byte de
+// tipo. AlertMsg / PreAlertMsg / CancelMsg son las tramas de pkt_codec, así
+// que este receptor también entiende a los nodos ESP-IDF.
+struct OnMsg {
+  void operator()(const HelloMsg& m, const Packet& p) const {
+    Serial.printf("RX: HELLO %lu | RSSI=%d dBm SNR=%.1f\r\n", (unsigned long)m.seq, p.rssi, p.snr);
+  }
+  void operator()(const AlertMsg& m, const Packet& p) const {
+    Serial.printf("RX: ALERTA t=%lu ms pico=%d cg quieto=%u ms | RSSI=%d dBm\r\n", (unsigned long)m.epochMs,
+                  m.peakCentiG, m.idleMs, p.rssi);
+  }
+  void operator()(const PreAlertMsg& m, const Packet& p) const {
+    Serial.printf("RX: PREALERTA #%u t=%lu ms pico=%d cg | RSSI=%d dBm\r\n", m.seq, (unsigned long)m.epochMs,
+                  m.peakCentiG, p.rssi);
+  }
+  void operator()(const CancelMsg& m, const Packet& p) const {
+    Serial.printf("RX: CANCELA #%u t=%lu ms | RSSI=%d dBm\r\n", m.seq, (unsigned long)m.epochMs, p.rssi);
+  }
+};
+
 void loop() {
-  int rssi; float snr;
-  // timeoutMs=0 → espera indefinidamente
-  String msg = receiveString(/*timeoutMs=*/0, &rssi, &snr);
-  if (msg.length()) {
-    Serial.print("RX: "); Serial.print(msg);
-    Serial.print(" | RSSI="); Serial.print(rssi);
-    Serial.print(" dBm SNR="); Serial.println(snr, 1);
+  // Bloquea en la cola hasta que DIO0 avise un paquete (sin sondear la radio).
+  Packet* p;
+  if (!receivePacket(p, portMAX_DELAY)) return;
+  if (!dispatch<HelloMsg, AlertMsg, PreAlertMsg, CancelMsg>(p, OnMsg())) {
+    Serial.printf("RX: %u B desconocidos o CRC invalido (tipo 0x%02X)\r\n", p->len, p->len ? p->data[0] : 0);
+  }
+  release(p);
+
+  static uint32_t count = 0;
+  if (++count % 10 == 0) {
+    AsyncStats st;
+    asyncStats(&st);
+    Serial.printf("[RX] CPU radio %lu us/paquete, descartados %lu, CRC %lu\r\n",
+                  (unsigned long)(st.rxPackets ? st.rxCpuUs / st.rxPackets : 0),
+                  (unsigned long)st.rxDropped, (unsigned long)st.rxCrcErrors);
   }
-}
\ No newline at end of file
+}
@@ -1,12 +1,20 @@
 #include <Arduino.h>
 #include "SimpleLora.h"                 // tu wrapper
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "freertos/task.h"
 
 using namespace SimpleLora;
 
 static void TxTask(void *pv);           // prototipo
 
+// Resultado de un envío: onTxDone sólo lo encola, TxTask lo imprime.
+struct TxResult {
+  uint32_t seq;
+  bool ok;
+};
+static QueueHandle_t txResults = nullptr;
+
 void setup() {
   Serial.begin(115200);
   delay(500);
@@ -25,6 +33,16 @@ void setup() {
     Serial.println("LoRa init FAILED");
     for(;;) delay(1000);
   }
+  txResults = xQueueCreate(8, sizeof(TxResult));
+  if (!txResults) {
+    Serial.println("cola TX FAILED");
+    for(;;) delay(1000);
+  }
+  // Radio en su propia tarea (prio 3, core 1): TxTask no espera el fin de TX.
+  if (!beginAsync(3, 1)) {
+    Serial.println("LoRa async FAILED");
+    for(;;) delay(1000);
+  }
   Serial.println("LoRa OK - creando task TX");
 
   // Crea la tarea de transmisión (stack 4 KB, prio 2, core 1)
@@ -37,17 +55,51 @@ void loop() {
   // vacío: todo corre en FreeRTOS
 }
 
+// Corre en la tarea de radio al terminar cada envío: sin Serial, sólo encola
+// (cola llena: se pierde el aviso, no el paquete).
+static void onTxDone(bool ok, void *arg) {
+  const TxResult r = { (uint32_t)(uintptr_t)arg, ok };
+  xQueueSend(txResults, &r, 0);
+}
+
+static void printTxResults() {
+  TxResult r;
+  while (xQueueReceive(txResults, &r, 0) == pdTRUE) {
+    Serial.printf("[TX] HELLO %lu | %s\r\n", (unsigned long)r.seq, r.ok ? "OK" : "FAIL");
+  }
+}
+
+// CPU que TxTask ya no pasa girando en endPacket(): aire menos lo que la
+// tarea de radio gasta en cargar la FIFO y cambiar de modo.
+static void printCpuFreed() {
+  AsyncStats st;
+  asyncStats(&st);
+  const uint32_t n = st.txDone + st.txFailed;
+  if (n == 0) return;
+  const uint32_t air = (uint32_t)(st.txAirUs / n);
+  const uint32_t cpu = (uint32_t)(st.txCpuUs / n);
+  Serial.printf("[TX] por paquete: aire %lu us, CPU radio %lu us -> liberado %lu us (fallos %lu, cola llena %lu)\r\n",
+                (unsigned long)air, (unsigned long)cpu, (unsigned long)(air > cpu ? air - cpu : 0),
+                (unsigned long)st.txFailed, (unsigned long)st.txQueueFull);
+}
+
 static void TxTask(void *pv) {
   const TickType_t period = pdMS_TO_TICKS(1000); // cada 1 s
   TickType_t last = xTaskGetTickCount();
   uint32_t seq = 0;
 
   for(;;){
-    char buf[64];
-    int n = snprintf(buf, sizeof(buf), "HELLO %lu", (unsigned long)seq++);
+    // Trama binaria tipada (TYPE, VER, seq, CRC8): 7 B, sin snprintf ni String.
+    HelloMsg msg;
+    msg.seq = seq;
+
+    printTxResults();
 
-    bool ok = send(reinterpret_cast<const uint8_t*>(buf), (size_t)n);
-    Serial.printf("[TX] %s | %s\r\n", buf, ok ? "OK" : "FAIL");
+    // Copia a la cola y vuelve; el resultado llega por onTxDone.
+    if (!sendMsg(msg, onTxDone, (void *)(uintptr_t)seq)) {
+      Serial.printf("[TX] HELLO %lu | cola llena\r\n", (unsigned long)seq);
+    }
+    if (++seq % 10 == 0) printCpuFreed();
 
     vTaskDelayUntil(&last, period); // periodicidad exacta
   }
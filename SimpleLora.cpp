@@ -1,4 +1,5 @@
 #include "SimpleLora.h"
+#include "freertos/queue.h"
 
 namespace SimpleLora {
 
@@ -68,3 +69,205 @@ String receiveString(unsigned long timeoutMs, int* rssiOut, float* snrOut) {
 }
 
 } // namespace SimpleLora
+
+// ---------------------------------------------------------------------------
+// API asíncrona
+// ---------------------------------------------------------------------------
+
+namespace SimpleLora {
+
+namespace {
+
+struct TxReq {
+  uint16_t len;
+  TxDoneFn done;
+  void*    arg;
+  uint8_t  data[SIMPLELORA_MAX_PAYLOAD];
+};
+
+Packet        g_pool[SIMPLELORA_RX_POOL];
+QueueHandle_t g_free  = nullptr;   // Packet* libres
+QueueHandle_t g_ready = nullptr;   // Packet* recibidos
+QueueHandle_t g_tx    = nullptr;   // TxReq por copia
+TaskHandle_t  g_task  = nullptr;
+AsyncStats    g_stats;
+portMUX_TYPE  g_statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Estado de la tarea de radio (sólo ella lo toca).
+volatile bool g_txBusy = false;   // txPending() lo lee desde otras tareas
+uint32_t      g_txStartUs = 0;
+TxDoneFn      g_txDone = nullptr;
+void*         g_txArg = nullptr;
+bool          g_txShort = false;
+
+void IRAM_ATTR onDio0() {
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(g_task, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+// Con callbacks registrados la librería mapea DIO0 a TxDone en
+// endPacket(true) y a RxDone en receive(); nunca se llaman porque
+// attachInterrupt() reemplaza su ISR (que hace SPI) por onDio0.
+void unusedRx(int) {}
+void unusedTx() {}
+
+void startNextTx() {
+  TxReq req;
+  if (xQueueReceive(g_tx, &req, 0) != pdTRUE) return;
+  const uint32_t t0 = micros();
+  LoRa.idle();
+  (void)LoRa.beginPacket();
+  g_txShort = LoRa.write(req.data, req.len) != req.len;
+  (void)LoRa.endPacket(true);   // no espera: DIO0 avisa TxDone
+  g_txStartUs = micros();
+  g_txDone = req.done;
+  g_txArg = req.arg;
+  g_txBusy = true;
+  portENTER_CRITICAL(&g_statsMux);
+  g_stats.txCpuUs += g_txStartUs - t0;
+  portEXIT_CRITICAL(&g_statsMux);
+}
+
+void finishTx(bool done) {
+  const uint32_t t0 = micros();
+  (void)LoRa.parsePacket();   // lee y limpia IRQ (TxDone)
+  LoRa.receive();             // RX continuo, DIO0 → RxDone
+  const bool ok = done && !g_txShort;
+  portENTER_CRITICAL(&g_statsMux);
+  g_stats.txAirUs += t0 - g_txStartUs;
+  g_stats.txCpuUs += micros() - t0;
+  if (ok) g_stats.txDone++; else g_stats.txFailed++;
+  portEXIT_CRITICAL(&g_statsMux);
+  g_txBusy = false;
+  if (g_txDone) g_txDone(ok, g_txArg);
+}
+
+void readPacket() {
+  const uint32_t t0 = micros();
+  const int n = LoRa.parsePacket();   // 0: CRC inválido (IRQ ya limpia)
+  bool got = false, dropped = false;
+  if (n > 0) {
+    Packet* p = nullptr;
+    if (xQueueReceive(g_free, &p, 0) == pdTRUE) {
+      uint16_t i = 0;
+      while (LoRa.available() && i < sizeof(p->data)) p->data[i++] = (uint8_t)LoRa.read();
+      p->len = i;
+      p->rssi = (int16_t)LoRa.packetRssi();
+      p->snr = LoRa.packetSnr();
+      xQueueSend(g_ready, &p, 0);
+      got = true;
+    } else {
+      dropped = true;
+    }
+  }
+  LoRa.receive();
+  portENTER_CRITICAL(&g_statsMux);
+  if (got) g_stats.rxPackets++;
+  else if (dropped) g_stats.rxDropped++;
+  else g_stats.rxCrcErrors++;
+  g_stats.rxCpuUs += micros() - t0;
+  portEXIT_CRITICAL(&g_statsMux);
+}
+
+void radioTask(void*) {
+  for (;;) {
+    // Despiertan DIO0 y sendAsync(); sin nada que hacer duerme sin sondear.
+    // En TX espera lo que queda del plazo desde endPacket: una notificación
+    // espuria (sendAsync durante el envío) no lo reinicia.
+    TickType_t wait = portMAX_DELAY;
+    if (g_txBusy) {
+      const uint32_t elapsedMs = (micros() - g_txStartUs) / 1000U;
+      wait = elapsedMs >= SIMPLELORA_TX_TIMEOUT_MS ? 0 : pdMS_TO_TICKS(SIMPLELORA_TX_TIMEOUT_MS - elapsedMs) + 1;
+    }
+    ulTaskNotifyTake(pdTRUE, wait);
+    const bool dio0 = digitalRead(g_cfg.dio0) == HIGH;
+    if (g_txBusy) {
+      if (dio0) {
+        finishTx(true);
+      } else if ((micros() - g_txStartUs) / 1000U >= SIMPLELORA_TX_TIMEOUT_MS) {
+        finishTx(false);
+      }
+    } else if (dio0) {
+      readPacket();
+    }
+    if (!g_txBusy) startNextTx();
+  }
+}
+
+} // namespace
+
+bool beginAsync(UBaseType_t priority, BaseType_t core) {
+  if (g_task) return true;
+  g_free = xQueueCreate(SIMPLELORA_RX_POOL, sizeof(Packet*));
+  g_ready = xQueueCreate(SIMPLELORA_RX_POOL, sizeof(Packet*));
+  g_tx = xQueueCreate(SIMPLELORA_TX_DEPTH, sizeof(TxReq));
+  if (!g_free || !g_ready || !g_tx) return false;
+  for (size_t i = 0; i < SIMPLELORA_RX_POOL; ++i) {
+    Packet* p = &g_pool[i];
+    xQueueSend(g_free, &p, 0);
+  }
+  memset(&g_stats, 0, sizeof(g_stats));
+  if (xTaskCreatePinnedToCore(radioTask, "lora_radio", SIMPLELORA_TASK_STACK, nullptr,
+                              priority, &g_task, core) != pdPASS) {
+    return false;
+  }
+  LoRa.onTxDone(unusedTx);
+  LoRa.onReceive(unusedRx);
+  attachInterrupt(digitalPinToInterrupt(g_cfg.dio0), onDio0, RISING);
+  LoRa.receive();
+  return true;
+}
+
+bool sendAsync(const uint8_t* data, size_t len, TxDoneFn done, void* arg) {
+  if (!g_task || !data || len == 0 || len > SIMPLELORA_MAX_PAYLOAD) return false;
+  TxReq req;
+  req.len = (uint16_t)len;
+  req.done = done;
+  req.arg = arg;
+  memcpy(req.data, data, len);
+  if (xQueueSend(g_tx, &req, 0) != pdTRUE) {
+    portENTER_CRITICAL(&g_statsMux);
+    g_stats.txQueueFull++;
+    portEXIT_CRITICAL(&g_statsMux);
+    return false;
+  }
+  xTaskNotifyGive(g_task);
+  return true;
+}
+
+bool asyncRunning() {
+  return g_task != nullptr;
+}
+
+size_t txPending() {
+  if (!g_tx) return 0;
+  return uxQueueMessagesWaiting(g_tx) + (g_txBusy ? 1U : 0U);
+}
+
+bool receivePacket(Packet*& out, TickType_t waitTicks) {
+  out = nullptr;
+  return g_ready && xQueueReceive(g_ready, &out, waitTicks) == pdTRUE;
+}
+
+void release(Packet* p) {
+  if (p && g_free) xQueueSend(g_free, &p, 0);
+}
+
+uint8_t crc8(const uint8_t* data, size_t len) {
+  uint8_t crc = 0x00;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; ++b) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+void asyncStats(AsyncStats* out) {
+  if (!out) return;
+  portENTER_CRITICAL(&g_statsMux);
+  *out = g_stats;
+  portEXIT_CRITICAL(&g_statsMux);
+}
+
+} // namespace SimpleLora
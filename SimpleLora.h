@@ -2,6 +2,26 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <LoRa.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <type_traits>
+
+// API asíncrona (beginAsync): tamaños fijos, sin heap por paquete.
+#ifndef SIMPLELORA_MAX_PAYLOAD
+#define SIMPLELORA_MAX_PAYLOAD 255
+#endif
+#ifndef SIMPLELORA_RX_POOL
+#define SIMPLELORA_RX_POOL 4          // paquetes recibidos en vuelo
+#endif
+#ifndef SIMPLELORA_TX_DEPTH
+#define SIMPLELORA_TX_DEPTH 4         // envíos encolados (copia del payload)
+#endif
+#ifndef SIMPLELORA_TX_TIMEOUT_MS
+#define SIMPLELORA_TX_TIMEOUT_MS 10000  // 255 B a SF12/125 kHz ≈ 9.2 s en aire
+#endif
+#ifndef SIMPLELORA_TASK_STACK
+#define SIMPLELORA_TASK_STACK 3072
+#endif
 
 namespace SimpleLora {
 
@@ -23,6 +43,8 @@ struct Config {
 
 bool begin(const Config& cfg);
 
+// --- API bloqueante (no mezclar con la asíncrona una vez llamada beginAsync) ---
+
 bool send(const uint8_t* data, size_t len);
 inline bool sendString(const String& s) {
   return send(reinterpret_cast<const uint8_t*>(s.c_str()), s.length());
@@ -35,4 +57,206 @@ int receive(uint8_t* buf, size_t maxLen,
 String receiveString(unsigned long timeoutMs = 0,
                      int* rssiOut = nullptr, float* snrOut = nullptr);
 
+// --- API asíncrona ---
+// DIO0 (TxDone / RxDone) sólo despierta a una tarea de radio; el SPI corre
+// en la tarea, nunca en la ISR. sendAsync() copia el payload a una cola y
+// vuelve; la tarea lo carga en la FIFO del SX127x y espera TxDone dormida.
+// Lo recibido va a un pool fijo de Packet y se entrega por una cola de
+// FreeRTOS: receivePacket() bloquea sin sondear la radio y release()
+// devuelve el buffer al pool.
+
+struct Packet {
+  uint16_t len;
+  int16_t  rssi;
+  float    snr;
+  uint8_t  data[SIMPLELORA_MAX_PAYLOAD];
+};
+
+// Corre en la tarea de radio: debe ser breve (p. ej. xTaskNotify a quien espera).
+typedef void (*TxDoneFn)(bool ok, void* arg);
+
+struct AsyncStats {
+  uint32_t txDone;
+  uint32_t txFailed;      // timeout de TxDone o escritura corta a la FIFO
+  uint32_t txQueueFull;
+  uint32_t rxPackets;
+  uint32_t rxDropped;     // pool sin buffers libres
+  uint32_t rxCrcErrors;
+  uint64_t txCpuUs;       // tarea de radio: FIFO + cambio de modo por envío
+  uint64_t txAirUs;       // endPacket → TxDone: lo que send() pasaba girando
+  uint64_t rxCpuUs;       // tarea de radio: leer FIFO + rearmar RX
+};
+// Sin cifras medidas todavía: txAirUs − txCpuUs (CPU liberada por envío)
+// depende de SF/BW y del SPI real; Sender.ino la imprime en la placa.
+
+// Después de begin(). Crea la tarea de radio y toma DIO0.
+bool beginAsync(UBaseType_t priority = 3, BaseType_t core = 1);
+
+// false si la cola de envíos está llena o len es inválido. done (opcional)
+// se llama desde la tarea de radio al terminar.
+bool sendAsync(const uint8_t* data, size_t len,
+               TxDoneFn done = nullptr, void* arg = nullptr);
+// Envíos encolados o en el aire.
+size_t txPending();
+
+// Próximo paquete recibido, o false tras waitTicks. Devolver con release().
+bool receivePacket(Packet*& out, TickType_t waitTicks = portMAX_DELAY);
+void release(Packet* p);
+
+void asyncStats(AsyncStats* out);
+
+// true desde que beginAsync() creó la tarea de radio.
+bool asyncRunning();
+
+// --- Mensajes tipados (sobre la API asíncrona) ---
+// Trama = TYPE, VER, cuerpo, CRC8: el mismo formato que pkt_codec del
+// firmware ESP-IDF (firmware_node/src/services/pkt_codec.h), así que un
+// AlertMsg sale y entra como PKT_TYPE_ALERT. Los cuerpos son structs
+// empaquetados y trivialmente copiables con su byte de tipo en kType; en el
+// ESP32 (little endian) su memoria ya es el orden del cable. sendMsg<T>()
+// arma la trama en la pila; view<T>() / receiveMsg<T>() / dispatch<Ts...>()
+// apuntan al cuerpo dentro del Packet del pool, sin copiar ni usar heap.
+// sendMsg/receiveMsg sólo andan con la API asíncrona: sin beginAsync()
+// devuelven false / nullptr de inmediato (no caen en send()/receive()).
+
+#define SIMPLELORA_PKT_VER 0x01   // PKT_VER
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "los cuerpos se copian tal cual al cable (LE)");
+
+// CRC-8 de pkt_codec: polinomio 0x07, inicial 0x00.
+uint8_t crc8(const uint8_t* data, size_t len);
+
+struct __attribute__((packed)) AlertMsg {     // confirmación
+  static constexpr uint8_t kType = 0xFA;      // PKT_TYPE_ALERT
+  uint32_t epochMs;
+  int16_t  peakCentiG;
+  uint16_t idleMs;
+};
+
+struct __attribute__((packed)) PreAlertMsg {
+  static constexpr uint8_t kType = 0xFC;      // PKT_TYPE_PRE
+  uint8_t  seq;
+  uint32_t epochMs;
+  int16_t  peakCentiG;
+};
+
+struct __attribute__((packed)) CancelMsg {
+  static constexpr uint8_t kType = 0xFD;      // PKT_TYPE_CANCEL
+  uint8_t  seq;
+  uint32_t epochMs;                           // de la prealerta
+};
+
+// Propio de los sketches, fuera del rango de tipos de pkt_codec (0xF9..0xFE).
+struct __attribute__((packed)) HelloMsg {
+  static constexpr uint8_t kType = 0x10;
+  uint32_t seq;
+};
+
+template <typename T>
+struct __attribute__((packed)) Frame {
+  uint8_t type;
+  uint8_t ver;
+  T       body;
+  uint8_t crc;
+};
+
+template <typename T>
+constexpr size_t wireSize() {
+  return sizeof(Frame<T>);
+}
+
+namespace detail {
+
+template <typename T>
+struct MsgCheck {
+  static_assert(std::is_trivially_copyable<T>::value, "el mensaje debe ser trivialmente copiable");
+  static_assert(alignof(T) == 1, "el mensaje debe ser __attribute__((packed))");
+  static_assert(wireSize<T>() <= SIMPLELORA_MAX_PAYLOAD, "el mensaje no entra en una trama");
+  static constexpr bool value = true;
+};
+
+template <typename T, typename... Us>
+struct TypeUnique : std::true_type {};
+template <typename T, typename U, typename... Us>
+struct TypeUnique<T, U, Us...>
+    : std::integral_constant<bool, T::kType != U::kType && TypeUnique<T, Us...>::value> {};
+
+template <typename... Ts>
+struct TypesDistinct : std::true_type {};
+template <typename T, typename... Ts>
+struct TypesDistinct<T, Ts...>
+    : std::integral_constant<bool, TypeUnique<T, Ts...>::value && TypesDistinct<Ts...>::value> {};
+
+} // namespace detail
+
+static_assert(wireSize<AlertMsg>() == 11, "AlertMsg != PKT_ALERT_BYTES");
+static_assert(wireSize<PreAlertMsg>() == 10, "PreAlertMsg != PKT_PRE_BYTES");
+static_assert(wireSize<CancelMsg>() == 8, "CancelMsg != PKT_CANCEL_BYTES");
+
+// Encola msg como en sendAsync(). false sin beginAsync() o con la cola llena.
+template <typename T>
+bool sendMsg(const T& msg, TxDoneFn done = nullptr, void* arg = nullptr) {
+  static_assert(detail::MsgCheck<T>::value, "");
+  if (!asyncRunning()) return false;
+  Frame<T> f;
+  f.type = T::kType;
+  f.ver = SIMPLELORA_PKT_VER;
+  f.body = msg;
+  f.crc = crc8(reinterpret_cast<const uint8_t*>(&f), wireSize<T>() - 1);
+  return sendAsync(reinterpret_cast<const uint8_t*>(&f), wireSize<T>(), done, arg);
+}
+
+// Cuerpo de T dentro de p, o nullptr si tipo, versión, largo o CRC no coinciden.
+template <typename T>
+const T* view(const Packet* p) {
+  static_assert(detail::MsgCheck<T>::value, "");
+  if (!p || p->len < wireSize<T>() || p->data[0] != T::kType || p->data[1] != SIMPLELORA_PKT_VER) return nullptr;
+  if (crc8(p->data, wireSize<T>() - 1) != p->data[wireSize<T>() - 1]) return nullptr;
+  return &reinterpret_cast<const Frame<T>*>(p->data)->body;
+}
+
+// Próximo mensaje válido de tipo T (los demás paquetes se liberan). El
+// puntero vive en p hasta release(p); waitTicks rige por paquete. nullptr
+// sin beginAsync().
+template <typename T>
+const T* receiveMsg(Packet*& p, TickType_t waitTicks = portMAX_DELAY) {
+  while (asyncRunning() && receivePacket(p, waitTicks)) {
+    const T* m = view<T>(p);
+    if (m) return m;
+    release(p);
+  }
+  p = nullptr;
+  return nullptr;
+}
+
+namespace detail {
+
+template <typename... Ts>
+struct Dispatch {
+  template <typename H>
+  static bool run(const Packet*, H&) { return false; }
+};
+
+template <typename T, typename... Ts>
+struct Dispatch<T, Ts...> {
+  template <typename H>
+  static bool run(const Packet* p, H& h) {
+    if (p->data[0] != T::kType) return Dispatch<Ts...>::run(p, h);
+    const T* m = view<T>(p);
+    if (!m) return false;
+    h(*m, *p);
+    return true;
+  }
+};
+
+} // namespace detail
+
+// Llama h(const T&, const Packet&) con el T de Ts... cuyo kType coincide con
+// el primer byte. false si ninguno coincide o la trama es inválida. No libera p.
+template <typename... Ts, typename H>
+bool dispatch(const Packet* p, H&& h) {
+  static_assert(detail::TypesDistinct<Ts...>::value, "kType repetido en dispatch");
+  return p && p->len > 0 && detail::Dispatch<Ts...>::run(p, h);
+}
+
 } // namespace SimpleLora
@@ -25,5 +25,11 @@
 // Optional LED indicator (on-board GPIO25)
 #define BOARD_STATUS_LED       GPIO_NUM_25
 
+// MPU9250 INT (wake-on-motion), push-pull activo alto; GPIO34 es sólo entrada
+#define BOARD_IMU_PIN_INT      GPIO_NUM_34
+
 // I2C clock frequency
 #define BOARD_I2C_FREQ_HZ      400000
+
+// OLED SSD1306 128x64 en el bus I2C (dirección de 7 bits)
+#define BOARD_OLED_ADDR        0x3C
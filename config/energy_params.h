@@ -0,0 +1,62 @@
+#pragma once
+
+// Modelo de corriente por estado (µA) para services/energy (orientativo:
+// datasheets, 3.3 V). Ajustar con mediciones en placa; todos se pueden
+// redefinir con -D para comparar escenarios en host.
+
+// ESP32 (sin light sleep automático: la tarea idle sólo ejecuta WAITI)
+#ifndef ENERGY_I_CPU_ACTIVE_UA
+#define ENERGY_I_CPU_ACTIVE_UA    40000   // 160 MHz, RF apagado
+#endif
+#ifndef ENERGY_I_CPU_IDLE_UA
+#define ENERGY_I_CPU_IDLE_UA      15000   // idle + WAITI
+#endif
+
+// SX1276
+#ifndef ENERGY_I_RADIO_SLEEP_UA
+#define ENERGY_I_RADIO_SLEEP_UA       1
+#endif
+#ifndef ENERGY_I_RADIO_STDBY_UA
+#define ENERGY_I_RADIO_STDBY_UA    1600
+#endif
+#ifndef ENERGY_I_RADIO_RX_UA
+#define ENERGY_I_RADIO_RX_UA      11500
+#endif
+#ifndef ENERGY_I_RADIO_TX_UA
+#define ENERGY_I_RADIO_TX_UA      90000   // PA_BOOST +15..17 dBm
+#endif
+
+// MPU9250
+#ifndef ENERGY_I_IMU_SLEEP_UA
+#define ENERGY_I_IMU_SLEEP_UA         8
+#endif
+#ifndef ENERGY_I_IMU_LP_ACCEL_UA
+#define ENERGY_I_IMU_LP_ACCEL_UA     30   // accel low-power (wake-on-motion)
+#endif
+#ifndef ENERGY_I_IMU_ACCEL_UA
+#define ENERGY_I_IMU_ACCEL_UA       450   // sólo acelerómetro
+#endif
+#ifndef ENERGY_I_IMU_ACCEL_GYRO_UA
+#define ENERGY_I_IMU_ACCEL_GYRO_UA 3700   // accel + giroscopio
+#endif
+
+// LED (GPIO25 + resistencia)
+#ifndef ENERGY_I_LED_ON_UA
+#define ENERGY_I_LED_ON_UA         5000
+#endif
+#ifndef ENERGY_I_LED_BLINK_UA
+#define ENERGY_I_LED_BLINK_UA      2500   // LEDC al 50 %
+#endif
+
+// Consumo fijo de placa (LDO, divisores)
+#ifndef ENERGY_I_BOARD_UA
+#define ENERGY_I_BOARD_UA           150
+#endif
+
+// Batería
+#ifndef ENERGY_BATTERY_MAH
+#define ENERGY_BATTERY_MAH         1000
+#endif
+#ifndef ENERGY_BATTERY_USABLE_PCT
+#define ENERGY_BATTERY_USABLE_PCT    80   // corte de tensión + envejecimiento
+#endif
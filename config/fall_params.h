@@ -7,4 +7,27 @@
 #define FALL_I_THR_CENTI_G    20   // ~0.2 g (inmovilidad)
 #define FALL_IDLE_MS         700   // 500..1000 ms
 #define FALL_FS_HZ           100   // Frecuencia de muestreo (Hz)
+#define FALL_FEAT_WIN_MS     500   // ventana de features (services/feat_window), ≤ FEAT_WIN_MAX muestras
 
+// Segunda etapa: MLP int8 (services/fall_clf) sobre los features del pico al
+// confirmar. Pesos en fall_clf_model.h (tools/train_fall_clf.py).
+#ifndef FALL_CLF_ENABLE
+#define FALL_CLF_ENABLE 0
+#endif
+
+// Adquisición adaptativa (wake-on-motion)
+#define FALL_STILL_THR_CENTI_G   8   // ~80 mg por eje: umbral WOM del MPU9250
+#define FALL_STILL_MS         2000   // quieto este tiempo (sin pico en curso) → WOM
+#define FALL_WOM_LP_ODR_SEL      7   // LP_ACCEL_ODR: 7 = 31.25 Hz (≤ 32 ms de latencia)
+
+// Orientación y cambio de postura (services/orientation). Con 1 el nodo
+// enciende el giroscopio, lee accel+gyro en ráfaga y el detector descarta
+// eventos sin cambio de postura (sentarse de golpe). ~+3.2 mA en tasa completa.
+#ifndef FALL_POSTURE_CHECK
+#define FALL_POSTURE_CHECK 0
+#endif
+#define FALL_POSTURE_COS_Q15    23170   // cos(45°): inclinación mínima pre → post
+#define FALL_POSTURE_REF_MS      1000   // referencia: orientación ~1 s antes del pico
+#define ORIENT_ALPHA_Q15        32112   // 0.98: peso del giroscopio en el filtro
+#define ORIENT_GATE_LO_CENTI_G     80   // el accel corrige sólo con |a| en [0.8, 1.2] g
+#define ORIENT_GATE_HI_CENTI_G    120
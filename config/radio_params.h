@@ -8,7 +8,13 @@
 #define LORA_POUT_DBM       15           // Potencia de salida
 #define LORA_CRC_ON         1            // CRC activado
 
+// Identidad del nodo en el sobre de retransmisión (PKT_TYPE_RELAY); única
+// en la instalación.
+#ifndef NODE_ID
+#define NODE_ID             1
+#endif
+
 // Timeouts sugeridos (ms)
 #define LORA_TX_TIMEOUT_MS   100
-#define LORA_RX_TIMEOUT_MS   200
+#define LORA_RX_TIMEOUT_MS   200   // el receptor usa espera indefinida (DIO0)
 
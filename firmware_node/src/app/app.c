@@ -7,25 +7,35 @@
 #include "config/radio_params.h"
 #include "firmware_node/src/drivers/imu_accel.h"
 #include "firmware_node/src/drivers/lora_radio.h"
+#include "firmware_node/src/port/os_port.h"
 #include "firmware_node/src/services/alert_queue.h"
+#include "firmware_node/src/services/alert_store.h"
+#include "firmware_node/src/services/bbox_xfer.h"
+#include "firmware_node/src/services/dlog.h"
+#include "firmware_node/src/services/energy.h"
 #include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/lat_probe.h"
+#include "firmware_node/src/services/mem_report.h"
+#include "firmware_node/src/services/motion_gate.h"
+#include "firmware_node/src/services/orientation.h"
+#include "firmware_node/src/services/prof.h"
+#include "firmware_node/src/services/relay.h"
+#include "firmware_node/src/services/trace_ring.h"
+#include "firmware_node/src/services/imu_ring.h"
 #include "firmware_node/src/services/pkt_codec.h"
 
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
 #if APP_USE_FREERTOS
-#include "FreeRTOS.h"
-#include "task.h"
-#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "esp_attr.h"
+#include "esp_random.h"
 #endif
 #include "esp_log.h"
 
-#if defined(__unix__) || defined(__APPLE__)
-#include <time.h>
-#endif
-
 #ifndef APP_SAMPLE_QUEUE_CAP
 #define APP_SAMPLE_QUEUE_CAP 4U
 #endif
@@ -34,149 +44,523 @@
 #define APP_SAMPLE_PERIOD_MS (1000U / FALL_FS_HZ)
 #endif
 
-#ifndef APP_ALERT_TIMEOUT_MS
-#define APP_ALERT_TIMEOUT_MS 50U
+// Partición por defecto: sensado/detección en APP (1), radio/protocolo en PRO (0).
+// APP_CORE_RADIO=1 restaura el esquema anterior (todo en el núcleo 1).
+#ifndef APP_CORE_SENSE
+#define APP_CORE_SENSE 1
+#endif
+
+#ifndef APP_CORE_RADIO
+#define APP_CORE_RADIO 0
+#endif
+
+#ifndef APP_CORE_AUX
+#define APP_CORE_AUX 0
+#endif
+
+// LED por hardware (LEDC): latido 1 Hz; parpadeo rápido tras una alerta.
+#ifndef APP_LED_HEARTBEAT_HZ
+#define APP_LED_HEARTBEAT_HZ 1U
+#endif
+
+#ifndef APP_LED_ALERT_HZ
+#define APP_LED_ALERT_HZ 5U
+#endif
+
+#ifndef APP_LED_ALERT_MS
+#define APP_LED_ALERT_MS 3000U
+#endif
+
+// > 0: tsk_blink loguea despertares/s, histogramas de latencia, la tabla de
+// prof (si PROF_ENABLE), memoria, energía y el trace cada APP_REPORT_MS (agrega esos
+// despertares).
+#ifndef APP_REPORT_MS
+#define APP_REPORT_MS 0U
+#endif
+
+// Stacks en bytes. Ajustar con las líneas "MEM stack" del reporte (uso
+// medido + margen). tsk_blink formatea el reporte periódico con printf.
+#ifndef APP_STACK_SAMPLE
+#define APP_STACK_SAMPLE 4096U
+#endif
+
+#ifndef APP_STACK_ALERT_TX
+#define APP_STACK_ALERT_TX 4096U
 #endif
 
-#ifndef APP_BLINK_PERIOD_MS
-#define APP_BLINK_PERIOD_MS 500U
+#ifndef APP_STACK_BLINK
+#define APP_STACK_BLINK (APP_REPORT_MS ? 4096U : 2048U)
+#endif
+
+#define APP_EVT_ALERT_SENT   (1U << 0)
+#define APP_EVT_ALERT_FAILED (1U << 1)
+
+// Ventana "caja negra": pre-impacto antes del pico + todo hasta la confirmación.
+#ifndef APP_BBOX_PRE_MS
+#define APP_BBOX_PRE_MS 1500U
+#endif
+
+// Separación entre fragmentos de caja negra (las alertas la interrumpen).
+#ifndef APP_BBOX_FRAG_GAP_MS
+#define APP_BBOX_FRAG_GAP_MS 50U
+#endif
+
+// Quieto FALL_STILL_MS sin pico en curso → IMU en wake-on-motion y
+// tsk_sample_detect dormida hasta la interrupción de movimiento.
+#ifndef APP_WOM_ENABLE
+#define APP_WOM_ENABLE 1
+#endif
+
+// Prealerta al entrar el detector en seguimiento (pico) y cancelación si el
+// candidato se descarta; la confirmación sigue siendo PKT_TYPE_ALERT.
+#ifndef APP_PREALERT_ENABLE
+#define APP_PREALERT_ENABLE 1
+#endif
+
+// Alertas confirmadas cuyo lora_tx() falló quedan en alert_store y se
+// reenvían en lotes: apenas una transmisión vuelve a salir bien o cada
+// APP_STORE_RETRY_MS mientras haya pendientes.
+#ifndef APP_STORE_ENABLE
+#define APP_STORE_ENABLE 1
+#endif
+
+#ifndef APP_STORE_RETRY_MS
+#define APP_STORE_RETRY_MS 5000U
+#endif
+
+// 1: cada trama sale dentro del sobre PKT_TYPE_RELAY (origen NODE_ID) para
+// que los receptores repetidores (APP_RX_RELAY) la propaguen multi-salto.
+#ifndef APP_RELAY_ORIGIN
+#define APP_RELAY_ORIGIN 0
 #endif
 
 #if !APP_USE_FREERTOS
 #include <stdio.h>
-#define APP_DEMO_ITER_SAMPLE 500U
-#define APP_DEMO_ITER_TX     200U
-#define APP_DEMO_ITER_BLINK  20U
 #endif
 
+typedef enum {
+  APP_LED_HEARTBEAT = 0,
+  APP_LED_ALERT,
+  APP_LED_ERROR
+} app_led_mode_t;
+
 typedef struct {
   bool drivers_ready;
-#if !APP_USE_FREERTOS
-  uint32_t sample_iterations;
-  uint32_t tx_iterations;
-  uint32_t blink_iterations;
+  os_evt_t events;
+  uint32_t wakeups[APP_TASK_COUNT];
+  uint64_t wake_since_us;
+  uint64_t wom_us;
+  lat_hist_t sample_jitter;
+  // Pedido de caja negra: lo escribe el núcleo sense, lo consume el de radio.
+  // Ventana primero, bandera al final (release); el consumidor la toma con
+  // atomic_exchange (acquire), así un pedido nuevo nunca se borra sin leer.
+  _Atomic bool bbox_requested;
+  _Atomic uint32_t bbox_first_seq;
+  _Atomic uint32_t bbox_samples;
+  uint64_t store_retry_us;  // próximo reintento del store-and-forward
+  uint8_t confirmed_seq;    // candidato de la última confirmación (tsk_alert_tx)
+  bool confirmed_valid;
+#if APP_RELAY_ORIGIN
+  relay_t relay;            // sólo numeración de sobres y eco propio
 #endif
 } app_ctx_t;
 
 static app_ctx_t s_app_ctx;
+static app_cores_t s_cores = { APP_CORE_SENSE, APP_CORE_RADIO, APP_CORE_AUX };
 static const char* TAG_APP = "app_node";
 
-static void app_delay_ms(uint32_t ms) {
+static void led_init(void) {
 #if APP_USE_FREERTOS
-  vTaskDelay(pdMS_TO_TICKS(ms));
-#elif defined(__unix__) || defined(__APPLE__)
-  struct timespec ts;
-  ts.tv_sec = (time_t)(ms / 1000U);
-  ts.tv_nsec = (long)((ms % 1000U) * 1000000L);
-  nanosleep(&ts, NULL);
+  ledc_timer_config_t timer = {
+    .speed_mode = LEDC_LOW_SPEED_MODE,
+    .duty_resolution = LEDC_TIMER_13_BIT,
+    .timer_num = LEDC_TIMER_0,
+    .freq_hz = APP_LED_HEARTBEAT_HZ,
+    .clk_cfg = LEDC_AUTO_CLK,
+  };
+  ledc_timer_config(&timer);
+  ledc_channel_config_t channel = {
+    .gpio_num = BOARD_STATUS_LED,
+    .speed_mode = LEDC_LOW_SPEED_MODE,
+    .channel = LEDC_CHANNEL_0,
+    .timer_sel = LEDC_TIMER_0,
+    .duty = 0,
+    .hpoint = 0,
+  };
+  ledc_channel_config(&channel);
+#endif
+}
+
+// El LEDC genera el parpadeo solo; la CPU sólo interviene al cambiar de modo.
+static void led_set_mode(app_led_mode_t mode) {
+  TRACE_INSTANT_EV(TRACE_EV_LED, mode);
+  energy_set_state(ENERGY_LED, mode == APP_LED_ERROR ? ENERGY_LED_ON : ENERGY_LED_BLINK);
+#if APP_USE_FREERTOS
+  const uint32_t duty_half = 1U << 12;   // 50 % con 13 bits
+  switch (mode) {
+    case APP_LED_ALERT:
+      ledc_set_freq(LEDC_LOW_SPEED_MODE, LEDC_TIMER_0, APP_LED_ALERT_HZ);
+      ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, duty_half);
+      break;
+    case APP_LED_ERROR:
+      ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, (1U << 13) - 1U);
+      break;
+    default:
+      ledc_set_freq(LEDC_LOW_SPEED_MODE, LEDC_TIMER_0, APP_LED_HEARTBEAT_HZ);
+      ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, duty_half);
+      break;
+  }
+  ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
 #else
-  volatile uint32_t spin = ms * 4000U;
-  while (spin-- > 0U) {
-    (void)spin;
+#ifndef APP_SUPPRESS_LOGS
+  static const char* const names[] = { "latido", "alerta", "error" };
+  printf("[LED] modo=%s\n", names[mode]);
+  fflush(stdout);
+#else
+  (void)mode;
+#endif
+#endif
+}
+
+static void log_wakeups(void) {
+  app_wakeups_t w;
+  app_get_wakeups(&w);
+  const uint64_t elapsed_ms = (os_now_us() - w.since_us) / 1000U;
+  if (elapsed_ms == 0U) return;
+#if APP_USE_FREERTOS
+  ESP_LOGI(TAG_APP, "wakeups/s x100 sample=%u tx=%u blink=%u",
+           (unsigned)(w.wakeups[APP_TASK_SAMPLE] * 100000ULL / elapsed_ms),
+           (unsigned)(w.wakeups[APP_TASK_ALERT_TX] * 100000ULL / elapsed_ms),
+           (unsigned)(w.wakeups[APP_TASK_BLINK] * 100000ULL / elapsed_ms));
+#elif !defined(APP_SUPPRESS_LOGS)
+  printf("[WAKE] /s sample=%.1f tx=%.1f blink=%.1f\n",
+         w.wakeups[APP_TASK_SAMPLE] * 1000.0 / (double)elapsed_ms,
+         w.wakeups[APP_TASK_ALERT_TX] * 1000.0 / (double)elapsed_ms,
+         w.wakeups[APP_TASK_BLINK] * 1000.0 / (double)elapsed_ms);
+#endif
+}
+
+#if APP_RELAY_ORIGIN
+// Numeración de sobres entre reinicios. La caché de duplicados del receptor
+// no se entera de un reset del nodo: si seq volviera a 0 las primeras tramas
+// repetirían claves (origen, seq) recientes y se descartarían como copias.
+// En RTC_NOINIT sobrevive watchdog / brown-out; tras un encendido (o RTC
+// corrupta) arranca en un valor aleatorio.
+#define APP_RELAY_BOOT_MAGIC 0x524C5331U   // "1SLR"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t next_seq;
+  uint32_t check;   // ~next_seq
+} app_relay_boot_t;
+
+#if APP_USE_FREERTOS
+RTC_NOINIT_ATTR static app_relay_boot_t s_relay_boot;
+#else
+static app_relay_boot_t s_relay_boot;   // host: sobrevive a app_init en el mismo proceso
+#endif
+
+static uint8_t relay_boot_seq(void) {
+  if (s_relay_boot.magic == APP_RELAY_BOOT_MAGIC && s_relay_boot.check == ~s_relay_boot.next_seq &&
+      s_relay_boot.next_seq <= UINT8_MAX) {
+    return (uint8_t)s_relay_boot.next_seq;
   }
+#if APP_USE_FREERTOS
+  return (uint8_t)esp_random();
+#else
+  return (uint8_t)(os_now_us() ^ (os_now_us() >> 8));
 #endif
 }
 
+static void relay_boot_save(void) {
+  const uint32_t seq = relay_next_seq(&s_app_ctx.relay);
+  s_relay_boot.next_seq = seq;
+  s_relay_boot.check = ~seq;
+  s_relay_boot.magic = APP_RELAY_BOOT_MAGIC;
+}
+#endif
+
 static uint32_t sample_period_ms(void) {
   uint32_t period = APP_SAMPLE_PERIOD_MS;
   if (period == 0U) period = 10U;
   return period;
 }
 
-static void log_alert(const fall_event_t* evt) {
-#ifndef APP_SUPPRESS_LOGS
-#if !APP_USE_FREERTOS
-  printf("[ALERTA] epoch=%ums peak=%d idle=%ums\n",
-         (unsigned)evt->epoch_ms,
-         (int)evt->ax_peak_centi_g,
-         (unsigned)evt->idle_ms);
-  fflush(stdout);
-#else
-  ESP_LOGI(TAG_APP, "ALERTA epoch=%u peak=%d idle=%u",
-           (unsigned)evt->epoch_ms,
-           (int)evt->ax_peak_centi_g,
-           (unsigned)evt->idle_ms);
-#endif
-#else
-  (void)evt;
-#endif
+// Marca la ventana de caja negra para el evento confirmado en la muestra seq.
+static void bbox_mark_window(const fall_event_t* evt, uint32_t seq) {
+  const uint32_t period = sample_period_ms();
+  const uint32_t since_peak = (fall_detector_now_ms() - evt->epoch_ms) / period;
+  uint32_t span = since_peak + (APP_BBOX_PRE_MS / period) + 1U;
+  if (span > BBOX_MAX_SAMPLES) span = BBOX_MAX_SAMPLES;
+  if (span > seq + 1U) span = seq + 1U;
+  atomic_store_explicit(&s_app_ctx.bbox_first_seq, seq + 1U - span, memory_order_relaxed);
+  atomic_store_explicit(&s_app_ctx.bbox_samples, span, memory_order_relaxed);
+  atomic_store_explicit(&s_app_ctx.bbox_requested, true, memory_order_release);
 }
 
-void app_init(void) {
+void app_node_reset(void) {
   memset(&s_app_ctx, 0, sizeof(s_app_ctx));
+  fall_detector_init(NULL);
+  motion_gate_init(NULL);
+  orientation_init(NULL);
+  imu_ring_init();
+  bbox_xfer_init();
+  const size_t queue_cap = alert_queue_init(APP_SAMPLE_QUEUE_CAP);
+  if (queue_cap != APP_SAMPLE_QUEUE_CAP) {
+    ESP_LOGW(TAG_APP, "alert_queue: pedido %u por nivel, efectivo %u", (unsigned)APP_SAMPLE_QUEUE_CAP,
+             (unsigned)queue_cap);
+  }
+}
+
+void app_init(void) {
+  energy_init();   // antes de los drivers: registra sus cambios de estado
 
   bool imu_ok = imu_init();
   bool lora_ok = lora_init(LORA_FREQ_HZ, LORA_SF, LORA_BW_KHZ, LORA_POUT_DBM, LORA_CRC_ON);
 
-  fall_detector_init(NULL);
-  alert_queue_init(APP_SAMPLE_QUEUE_CAP);
+  dlog_init();
+  lat_probe_init();
+  trace_ring_init();
+  app_node_reset();
+  if (FALL_POSTURE_CHECK && imu_ok && !imu_set_gyro(true)) {
+    ESP_LOGW(TAG_APP, "giroscopio no disponible: sin chequeo de postura");
+  }
+  if (APP_STORE_ENABLE) alert_store_init();   // recupera lo pendiente antes del reset
+#if APP_RELAY_ORIGIN
+  relay_init(&s_app_ctx.relay, NULL);
+  relay_set_next_seq(&s_app_ctx.relay, relay_boot_seq());
+  relay_boot_save();
+#endif
+  prof_reset();
+  mem_report_static("app_ctx", sizeof(s_app_ctx));
 
   s_app_ctx.drivers_ready = imu_ok && lora_ok;
+  s_app_ctx.events = os_evt_create();
+  s_app_ctx.wake_since_us = os_now_us();
+  lat_hist_reset(&s_app_ctx.sample_jitter);
 
-#if !APP_USE_FREERTOS
-  s_app_ctx.sample_iterations = APP_DEMO_ITER_SAMPLE;
-  s_app_ctx.tx_iterations = APP_DEMO_ITER_TX;
-  s_app_ctx.blink_iterations = APP_DEMO_ITER_BLINK;
-#else
-  if (s_app_ctx.drivers_ready) {
-    gpio_config_t led_cfg = {
-      .pin_bit_mask = 1ULL << BOARD_STATUS_LED,
-      .mode = GPIO_MODE_OUTPUT,
-      .pull_up_en = GPIO_PULLUP_DISABLE,
-      .pull_down_en = GPIO_PULLDOWN_DISABLE,
-      .intr_type = GPIO_INTR_DISABLE,
-    };
-    gpio_config(&led_cfg);
-
-    xTaskCreatePinnedToCore(tsk_sample_detect, "sample_detect", 4096, NULL, configMAX_PRIORITIES - 2, NULL, 1);
-    xTaskCreatePinnedToCore(tsk_alert_tx, "alert_tx", 4096, NULL, configMAX_PRIORITIES - 1, NULL, 1);
-    xTaskCreatePinnedToCore(tsk_blink, "blink", 2048, NULL, tskIDLE_PRIORITY + 1, NULL, 1);
-  } else {
+  led_init();
+  if (!s_app_ctx.drivers_ready) {
     ESP_LOGE(TAG_APP, "Drivers init failed (imu=%d lora=%d)", imu_ok, lora_ok);
+    led_set_mode(APP_LED_ERROR);
+    return;
   }
-#endif
+
+  os_task_create(tsk_sample_detect, "sample_detect", APP_STACK_SAMPLE, OS_PRIO_HIGH, s_cores.sense, NULL, NULL);
+  os_task_create(tsk_alert_tx, "alert_tx", APP_STACK_ALERT_TX, OS_PRIO_MAX, s_cores.radio, NULL, NULL);
+  os_task_create(tsk_blink, "blink", APP_STACK_BLINK, OS_PRIO_LOW, s_cores.aux, NULL, NULL);
+  dlog_start(s_cores.aux);
+}
+
+void app_set_cores(const app_cores_t* cores) {
+  if (cores) s_cores = *cores;
+}
+
+void app_get_cores(app_cores_t* out) {
+  if (out) *out = s_cores;
+}
+
+// IMU en wake-on-motion hasta la interrupción; el reloj del detector avanza
+// por las muestras no leídas para que epoch_ms siga siendo tiempo real.
+static void sleep_until_motion(void) {
+  if (!imu_enter_wom(motion_gate_wom_thr_mg(), FALL_WOM_LP_ODR_SEL)) {
+    motion_gate_wake();
+    return;
+  }
+  const uint64_t t0 = os_now_us();
+  while (os_running() && !imu_wait_motion(OS_WAIT_FOREVER)) {
+  }
+  imu_exit_wom();
+  const uint64_t slept_us = os_now_us() - t0;
+  s_app_ctx.wom_us += slept_us;
+  fall_detector_skip_samples((uint32_t)(slept_us / ((uint64_t)sample_period_ms() * 1000U)));
+  orientation_reset();   // el giroscopio estuvo apagado: re-sembrar desde el accel
+  motion_gate_wake();
+}
+
+bool app_node_step_sample(const imu_gyro_t* gyro) {
+  accel_raw_t* sample = imu_ring_slot();
+  const uint32_t seq = imu_ring_commit();
+  fall_event_t evt;
+  TRACE_BEGIN_EV(TRACE_EV_DETECT);
+  const bool fell = gyro ? fall_detector_feed_imu(sample, gyro, &evt) : fall_detector_feed(sample, &evt);
+  TRACE_END_EV(TRACE_EV_DETECT);
+  fall_event_t phase;
+  if (fall_detector_take_phase(&phase) && APP_PREALERT_ENABLE) {
+    // Nivel aparte: una ráfaga de prealertas/cancelaciones con el enlace
+    // caído nunca llena el nivel de las confirmaciones.
+    alert_queue_push_prio(&phase, ALERT_PRIO_NORMAL);
+  }
+  if (fell) {
+    bbox_mark_window(&evt, seq);
+    // Antes del push: alert_tx (prioridad mayor) puede sacarlo al instante.
+    LAT_PROBE_MARK(evt.epoch_ms, LAT_STAGE_PUSH);
+    TRACE_INSTANT_EV(TRACE_EV_ALERT_PUSH, 0U);
+    alert_queue_push(&evt);
+  }
+  return fell;
 }
 
 void tsk_sample_detect(void* arg) {
   (void)arg;
   if (!s_app_ctx.drivers_ready) return;
 
-#if APP_USE_FREERTOS
-  for (;;) {
-#else
-  for (uint32_t i = 0; i < s_app_ctx.sample_iterations; ++i) {
+  const uint64_t period_us = (uint64_t)sample_period_ms() * 1000U;
+  uint64_t prev_us = 0;
+  os_tick_t last_wake = os_ticks_now();
+  while (os_running()) {
+    const uint64_t now_us = os_now_us();
+    if (prev_us != 0U) {
+      const uint64_t dt = now_us - prev_us;
+      const uint64_t jitter = dt > period_us ? dt - period_us : period_us - dt;
+      lat_hist_record(&s_app_ctx.sample_jitter, jitter > UINT32_MAX ? UINT32_MAX : (uint32_t)jitter);
+    }
+    prev_us = now_us;
+    s_app_ctx.wakeups[APP_TASK_SAMPLE]++;
+    TRACE_BEGIN_EV(TRACE_EV_SAMPLE);
+    // imu_read() escribe directo en el ring (sin copia extra). Con
+    // FALL_POSTURE_CHECK la misma transacción trae el giroscopio.
+    accel_raw_t* sample = imu_ring_slot();
+    imu_gyro_t gyro;
+    if (FALL_POSTURE_CHECK ? imu_read_motion(sample, &gyro) : imu_read(sample)) {
+      app_node_step_sample(FALL_POSTURE_CHECK ? &gyro : NULL);
+      if (APP_WOM_ENABLE && motion_gate_feed(sample, fall_detector_busy())) {
+        TRACE_END_EV(TRACE_EV_SAMPLE);
+        sleep_until_motion();
+        // Primera muestra a tasa completa ya mismo (≤ 1 periodo tras el INT).
+        last_wake = os_ticks_now();
+        prev_us = 0U;
+        continue;
+      }
+    }
+    TRACE_END_EV(TRACE_EV_SAMPLE);
+    os_delay_until(&last_wake, sample_period_ms());
+  }
+}
+
+// Toda trama del nodo pasa por aquí (sobre de retransmisión opcional).
+static bool radio_send(const uint8_t* frame, size_t len) {
+#if APP_RELAY_ORIGIN
+  uint8_t env[PKT_RELAY_MAX_FRAME];
+  len = relay_wrap(&s_app_ctx.relay, (uint8_t)NODE_ID, frame, len, env, sizeof(env));
+  relay_boot_save();
+  frame = env;
 #endif
-    accel_raw_t sample;
-    if (imu_read(&sample)) {
-      fall_event_t evt;
-      if (fall_detector_feed(&sample, &evt)) {
-        alert_queue_push(&evt);
+  return len > 0U && lora_tx(frame, len, LORA_TX_TIMEOUT_MS);
+}
+
+// Hasta PKT_BATCH_MAX alertas guardadas (críticas más viejas primero) en
+// una trama; un lote por vuelta para que las alertas nuevas no esperen.
+static size_t store_flush(uint8_t* buf, size_t max) {
+  fall_event_t batch[PKT_BATCH_MAX];
+  uint32_t ids[PKT_BATCH_MAX];
+  const size_t n = alert_store_peek(batch, ids, PKT_BATCH_MAX);
+  const size_t len = pkt_encode_batch(batch, n, buf, max);
+  if (len > 0U && radio_send(buf, len)) {
+    alert_store_drop(ids, n);
+    DLOG(DLOG_STORE_FLUSH, (int32_t)n, (int32_t)alert_store_count());
+    s_app_ctx.store_retry_us = os_now_us();
+    return len;
+  }
+  s_app_ctx.store_retry_us = os_now_us() + (uint64_t)APP_STORE_RETRY_MS * 1000U;
+  return 0U;
+}
+
+static bool store_due(void) {
+  return APP_STORE_ENABLE && alert_store_count() > 0U && os_now_us() >= s_app_ctx.store_retry_us;
+}
+
+// El enlace volvió: reenviar lo guardado en la próxima vuelta libre.
+static void link_ok(void) {
+  s_app_ctx.store_retry_us = 0U;
+}
+
+size_t app_node_step_tx(const fall_event_t* evt, alert_prio_t prio, uint8_t* buf, size_t max) {
+  size_t sent = 0U;
+  if (evt && evt->kind != FALL_EVT_CONFIRMED && s_app_ctx.confirmed_valid && evt->seq == s_app_ctx.confirmed_seq) {
+    // Fase de un candidato ya confirmado (la confirmación, de mayor nivel,
+    // la adelantó en la cola): fuera de tiempo, no se envía.
+  } else if (evt && evt->kind != FALL_EVT_CONFIRMED) {
+    s_app_ctx.confirmed_valid = false;   // FIFO por nivel: ya no quedan fases viejas (y seq da la vuelta)
+    // Prealerta / cancelación: trama corta, sin sondas ni caja negra. No se
+    // guardan si fallan: fuera de tiempo no significan nada.
+    const size_t len = pkt_encode_event(evt, buf, max);
+    if (len > 0U && radio_send(buf, len)) {
+      sent = len;
+      link_ok();
+      if (evt->kind == FALL_EVT_PREALERT) {
+        DLOG(DLOG_PRE_TX, evt->seq, (int32_t)evt->epoch_ms, evt->ax_peak_centi_g);
+      } else {
+        DLOG(DLOG_CANCEL_TX, evt->seq, (int32_t)evt->epoch_ms);
+      }
+    } else {
+      DLOG(DLOG_ALERT_TX_FAIL, (int32_t)evt->epoch_ms);
+    }
+  } else if (evt) {
+    s_app_ctx.confirmed_seq = evt->seq;
+    s_app_ctx.confirmed_valid = true;
+    TRACE_BEGIN_EV(TRACE_EV_ALERT_TX);
+    LAT_PROBE_MARK(evt->epoch_ms, LAT_STAGE_POP);
+    const size_t len = pkt_encode_alert(evt, buf, max);
+    LAT_PROBE_MARK(evt->epoch_ms, LAT_STAGE_ENCODE);
+    LAT_PROBE_MARK(evt->epoch_ms, LAT_STAGE_TX_START);
+    if (len > 0U && radio_send(buf, len)) {
+      sent = len;
+      LAT_PROBE_MARK(evt->epoch_ms, LAT_STAGE_TX_DONE);
+      DLOG(DLOG_ALERT_TX, (int32_t)evt->epoch_ms, evt->ax_peak_centi_g, evt->idle_ms);
+      os_evt_set(s_app_ctx.events, APP_EVT_ALERT_SENT);
+      link_ok();
+    } else {
+      DLOG(DLOG_ALERT_TX_FAIL, (int32_t)evt->epoch_ms);
+      os_evt_set(s_app_ctx.events, APP_EVT_ALERT_FAILED);
+      // Después del intento: guardar nunca demora la primera transmisión.
+      if (APP_STORE_ENABLE && alert_store_put(evt, prio)) {
+        DLOG(DLOG_STORE_PUT, (int32_t)evt->epoch_ms, (int32_t)alert_store_count());
+        if (s_app_ctx.store_retry_us == 0U) {
+          s_app_ctx.store_retry_us = os_now_us() + (uint64_t)APP_STORE_RETRY_MS * 1000U;
+        }
       }
     }
-    app_delay_ms(sample_period_ms());
+    // La alerta sale primero; la ventana se comprime después y se envía
+    // fragmentada sólo cuando la cola de alertas está vacía.
+    if (atomic_exchange_explicit(&s_app_ctx.bbox_requested, false, memory_order_acq_rel)) {
+      bbox_xfer_tx_load(atomic_load_explicit(&s_app_ctx.bbox_first_seq, memory_order_relaxed),
+                        atomic_load_explicit(&s_app_ctx.bbox_samples, memory_order_relaxed));
+    }
+    TRACE_END_EV(TRACE_EV_ALERT_TX);
+  } else if (store_due()) {
+    sent = store_flush(buf, max);
+  } else if (bbox_xfer_tx_pending()) {
+    TRACE_BEGIN_EV(TRACE_EV_BBOX_FRAG);
+    const size_t len = bbox_xfer_tx_next(buf, max);
+    if (len > 0U && radio_send(buf, len)) sent = len;
+    TRACE_END_EV(TRACE_EV_BBOX_FRAG);
   }
+  // Cola vacía: recién ahora el desborde a NVS (ms de flash).
+  if (!evt && APP_STORE_ENABLE) alert_store_service();
+  return sent;
 }
 
 void tsk_alert_tx(void* arg) {
   (void)arg;
   if (!s_app_ctx.drivers_ready) return;
 
-  uint8_t tx_buf[32];
+  uint8_t tx_buf[PKT_BBOX_MAX_FRAME];
 
-#if APP_USE_FREERTOS
-  for (;;) {
-#else
-  for (uint32_t i = 0; i < s_app_ctx.tx_iterations; ++i) {
-#endif
+  while (os_running()) {
     fall_event_t evt;
-    if (alert_queue_pop(&evt, APP_ALERT_TIMEOUT_MS)) {
-      size_t len = pkt_encode_alert(&evt, tx_buf, sizeof(tx_buf));
-      if (len > 0U && lora_tx(tx_buf, len, LORA_TX_TIMEOUT_MS)) {
-        log_alert(&evt);
-      }
-    } else {
-      app_delay_ms(5U);
+    alert_prio_t prio = ALERT_PRIO_CRITICAL;
+    // Sin fragmentos ni reenvíos pendientes bloquea hasta que el detector publique.
+    uint32_t wait_ms = bbox_xfer_tx_pending() ? APP_BBOX_FRAG_GAP_MS : OS_WAIT_FOREVER;
+    if (APP_STORE_ENABLE && alert_store_count() > 0U) {
+      const uint64_t now = os_now_us();
+      const uint64_t due = s_app_ctx.store_retry_us > now ? (s_app_ctx.store_retry_us - now) / 1000U : 0U;
+      if (due < wait_ms) wait_ms = (uint32_t)due;
     }
+    const bool got = alert_queue_pop_prio(&evt, &prio, wait_ms);
+    if (!os_running()) break;
+    s_app_ctx.wakeups[APP_TASK_ALERT_TX]++;
+    app_node_step_tx(got ? &evt : NULL, prio, tx_buf, sizeof(tx_buf));
   }
 }
 
@@ -184,22 +568,52 @@ void tsk_blink(void* arg) {
   (void)arg;
   if (!s_app_ctx.drivers_ready) return;
 
-#if APP_USE_FREERTOS
-  for (;;) {
-#else
-  for (uint32_t i = 0; i < s_app_ctx.blink_iterations; ++i) {
-#endif
-#ifndef APP_SUPPRESS_LOGS
-#if !APP_USE_FREERTOS
-    printf("[LED] toggle\n");
-    fflush(stdout);
-#endif
-#endif
-#if APP_USE_FREERTOS
-    static bool led_state = false;
-    led_state = !led_state;
-    gpio_set_level(BOARD_STATUS_LED, led_state);
-#endif
-    app_delay_ms(APP_BLINK_PERIOD_MS);
+  led_set_mode(APP_LED_HEARTBEAT);
+  bool alert_mode = false;
+  uint64_t alert_until_us = 0;
+
+  while (os_running()) {
+    uint32_t wait_ms = APP_REPORT_MS ? APP_REPORT_MS : OS_WAIT_FOREVER;
+    if (alert_mode) {
+      const uint64_t now = os_now_us();
+      const uint32_t left_ms = alert_until_us > now ? (uint32_t)((alert_until_us - now) / 1000U) : 0U;
+      if (left_ms < wait_ms) wait_ms = left_ms;
+    }
+
+    const uint32_t bits = os_evt_wait(s_app_ctx.events, APP_EVT_ALERT_SENT | APP_EVT_ALERT_FAILED, wait_ms);
+    if (!os_running()) break;
+    s_app_ctx.wakeups[APP_TASK_BLINK]++;
+
+    if (bits & (APP_EVT_ALERT_SENT | APP_EVT_ALERT_FAILED)) {
+      alert_mode = true;
+      alert_until_us = os_now_us() + (uint64_t)APP_LED_ALERT_MS * 1000U;
+      led_set_mode((bits & APP_EVT_ALERT_SENT) ? APP_LED_ALERT : APP_LED_ERROR);
+    } else if (alert_mode && os_now_us() >= alert_until_us) {
+      alert_mode = false;
+      led_set_mode(APP_LED_HEARTBEAT);
+    }
+    if (APP_REPORT_MS && bits == 0U) {
+      log_wakeups();
+      lat_probe_dump();
+      prof_dump();
+      mem_report_dump();
+      energy_dump();
+      trace_ring_dump();
+    }
   }
 }
+
+void app_get_sample_jitter(lat_hist_t* out) {
+  if (out) *out = s_app_ctx.sample_jitter;
+}
+
+void app_get_wakeups(app_wakeups_t* out) {
+  if (!out) return;
+  for (unsigned i = 0; i < APP_TASK_COUNT; ++i) out->wakeups[i] = s_app_ctx.wakeups[i];
+  out->since_us = s_app_ctx.wake_since_us;
+  motion_gate_stats_t g;
+  motion_gate_stats(&g);
+  out->wom_entries = g.entries;
+  out->wom_us = s_app_ctx.wom_us;
+  out->imu_i2c = imu_i2c_count();
+}
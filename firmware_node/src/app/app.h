@@ -1,8 +1,44 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "config/system_config.h"
+#include "firmware_node/src/drivers/imu_accel.h"
+#include "firmware_node/src/services/alert_queue.h"
+#include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/lat_probe.h"
+
+typedef enum {
+  APP_TASK_SAMPLE = 0,
+  APP_TASK_ALERT_TX,
+  APP_TASK_BLINK,
+  APP_TASK_COUNT
+} app_task_id_t;
+
+// Despertares por tarea (una vuelta de su lazo = un despertar).
+typedef struct {
+  uint32_t wakeups[APP_TASK_COUNT];
+  uint64_t since_us;
+  uint32_t wom_entries;   // pasajes del IMU a wake-on-motion
+  uint64_t wom_us;        // tiempo total en wake-on-motion
+  uint32_t imu_i2c;       // transacciones I2C del IMU
+} app_wakeups_t;
+
+// Reparto de tareas entre núcleos (ESP32: 0 = PRO, 1 = APP; -1 = cualquiera).
+// sense: tsk_sample_detect; radio: tsk_alert_tx (+ SPI/protocolo); aux: tsk_blink.
+// Ambos lados se comunican sólo por alert_queue (ring lock-free, apto
+// entre núcleos) y la ventana de caja negra publicada antes del push.
+typedef struct {
+  int sense;
+  int radio;
+  int aux;
+} app_cores_t;
+
+// Opcional, antes de app_init(): reemplaza APP_CORE_SENSE/RADIO/AUX.
+void app_set_cores(const app_cores_t* cores);
+void app_get_cores(app_cores_t* out);
 
 // Inicialización de la aplicación (creación de tareas/colas/timers)
 void app_init(void);
@@ -11,3 +47,21 @@ void app_init(void);
 void tsk_sample_detect(void* arg);
 void tsk_alert_tx(void* arg);
 void tsk_blink(void* arg);
+
+// Cuerpos de las tareas, sin drivers ni esperas: las tareas los llaman en cada
+// vuelta y tools/load_sim los usa para reproducir el nodo en tiempo simulado.
+// Estado de la lógica (detector, orientación, ring, caja negra, cola de
+// alertas); app_init la llama antes de crear las tareas.
+void app_node_reset(void);
+// La muestra recién escrita en imu_ring_slot(): la publica en el ring, la pasa
+// por el detector (con giroscopio si gyro != NULL) y encola fases y
+// confirmación. true si confirmó una caída.
+bool app_node_step_sample(const imu_gyro_t* gyro);
+// Un despertar de tsk_alert_tx con el evento sacado de la cola (NULL: ninguno;
+// entonces reenvío de guardadas o un fragmento de caja negra). Retorna el largo
+// de la trama que salió por radio desde buf (0: ninguna o falló).
+size_t app_node_step_tx(const fall_event_t* evt, alert_prio_t prio, uint8_t* buf, size_t max);
+
+void app_get_wakeups(app_wakeups_t* out);
+// |periodo real - periodo nominal| de tsk_sample_detect, en us.
+void app_get_sample_jitter(lat_hist_t* out);
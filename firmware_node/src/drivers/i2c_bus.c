@@ -0,0 +1,270 @@
+#include "firmware_node/src/drivers/i2c_bus.h"
+
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/mem_report.h"
+#include "firmware_node/src/services/trace_ring.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+static bool s_ready = false;
+static os_sem_t s_lock = NULL;      // binario: dueño del bus
+static os_sem_t s_hi_idle = NULL;   // el IMU soltó el bus y no hay otro pedido alto
+static atomic_uint s_hi_waiting;    // pedidos de alta prioridad esperando o en curso
+static atomic_uint s_lo_parked;     // clientes bajos dormidos en s_hi_idle
+static size_t s_chunk = I2C_BUS_CHUNK_BYTES;
+static os_sem_t s_stats_lock = NULL;   // binario: s_stats, también sin el bus
+static i2c_bus_stats_t s_stats[I2C_CLIENT_COUNT];
+
+#if APP_USE_FREERTOS
+
+#include "config/board_pins.h"
+
+#include "driver/i2c.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+static const char* TAG = "i2c_bus";
+
+static bool wire_init(void) {
+  i2c_config_t cfg = {
+    .mode = I2C_MODE_MASTER,
+    .sda_io_num = BOARD_I2C_SDA,
+    .scl_io_num = BOARD_I2C_SCL,
+    .sda_pullup_en = GPIO_PULLUP_ENABLE,
+    .scl_pullup_en = GPIO_PULLUP_ENABLE,
+    .master.clk_speed = BOARD_I2C_FREQ_HZ,
+  };
+  esp_err_t err = i2c_param_config(BOARD_I2C_PORT, &cfg);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+    ESP_LOGE(TAG, "i2c_param_config failed (%d)", err);
+    return false;
+  }
+  err = i2c_driver_install(BOARD_I2C_PORT, cfg.mode, 0, 0, 0);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+    ESP_LOGE(TAG, "i2c_driver_install failed (%d)", err);
+    return false;
+  }
+  return true;
+}
+
+static bool wire_write_read(uint8_t addr, const uint8_t* w, size_t wlen, uint8_t* r, size_t rlen, uint32_t timeout_ms) {
+  const esp_err_t err = rlen
+      ? i2c_master_write_read_device(BOARD_I2C_PORT, addr, w, wlen, r, rlen, pdMS_TO_TICKS(timeout_ms))
+      : i2c_master_write_to_device(BOARD_I2C_PORT, addr, w, wlen, pdMS_TO_TICKS(timeout_ms));
+  return err == ESP_OK;
+}
+
+// prefix + data en una transacción sin copiar data (link de comandos en stack).
+static bool wire_write_prefixed(uint8_t addr, uint8_t prefix, const uint8_t* data, size_t n, uint32_t timeout_ms) {
+  uint8_t link[I2C_LINK_RECOMMENDED_SIZE(3)];
+  i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(link, sizeof(link));
+  if (!cmd) return false;
+  i2c_master_start(cmd);
+  i2c_master_write_byte(cmd, (uint8_t)((addr << 1) | I2C_MASTER_WRITE), true);
+  i2c_master_write_byte(cmd, prefix, true);
+  i2c_master_write(cmd, data, n, true);
+  i2c_master_stop(cmd);
+  const esp_err_t err = i2c_master_cmd_begin(BOARD_I2C_PORT, cmd, pdMS_TO_TICKS(timeout_ms));
+  i2c_cmd_link_delete_static(cmd);
+  return err == ESP_OK;
+}
+
+#else  // host: el bus sólo cuesta tiempo
+
+static bool wire_init(void) {
+  return true;
+}
+
+// bytes en el cable (dirección incluida), 9 bits cada uno con el ACK. Espera
+// activa: nanosleep de cientos de us se pasa por ms en host y taparía el
+// arbitraje que se quiere medir.
+static void wire_time(size_t bytes) {
+  const uint64_t end = os_now_us() + (uint64_t)bytes * 9U * 1000000ULL / I2C_BUS_HOST_HZ;
+  while (os_now_us() < end) {
+  }
+}
+
+static bool wire_write_read(uint8_t addr, const uint8_t* w, size_t wlen, uint8_t* r, size_t rlen, uint32_t timeout_ms) {
+  (void)addr;
+  (void)w;
+  (void)timeout_ms;
+  if (rlen) memset(r, 0, rlen);
+  wire_time(1U + wlen + (rlen ? 1U + rlen : 0U));
+  return true;
+}
+
+static bool wire_write_prefixed(uint8_t addr, uint8_t prefix, const uint8_t* data, size_t n, uint32_t timeout_ms) {
+  (void)addr;
+  (void)prefix;
+  (void)data;
+  (void)timeout_ms;
+  wire_time(2U + n);
+  return true;
+}
+
+#endif  // APP_USE_FREERTOS
+
+static void hi_done(void) {
+  if (atomic_fetch_sub(&s_hi_waiting, 1U) == 1U) os_sem_give(s_hi_idle);
+}
+
+// Espera a que el IMU suelte el bus. s_hi_idle es binario y hi_done() lo da
+// una vez: el que despierta con el IMU ya fuera se lo pasa al siguiente
+// cliente bajo dormido, así despiertan todos. Con el IMU otra vez anunciado
+// (o una señal vieja) no se pasa: vuelven a dormir.
+static bool hi_idle_wait(uint32_t timeout_ms) {
+  atomic_fetch_add(&s_lo_parked, 1U);
+  const bool ok = os_sem_take(s_hi_idle, timeout_ms);
+  atomic_fetch_sub(&s_lo_parked, 1U);
+  if (ok && atomic_load(&s_hi_waiting) == 0U && atomic_load(&s_lo_parked) > 0U) os_sem_give(s_hi_idle);
+  return ok;
+}
+
+// Lo que queda hasta deadline (us), redondeado hacia arriba; 0: un intento.
+// UINT64_MAX: sin plazo (OS_WAIT_FOREVER).
+static uint32_t remaining_ms(uint64_t deadline) {
+  if (deadline == UINT64_MAX) return OS_WAIT_FOREVER;
+  const uint64_t now = os_now_us();
+  return now >= deadline ? 0U : (uint32_t)((deadline - now + 999U) / 1000U);
+}
+
+// Alta prioridad: se anuncia y espera el lock. Baja: mientras haya un pedido
+// alto anunciado no compite por el lock (el IMU lo toma en el próximo límite
+// de trozo aunque el planificador despierte primero a la tarea baja). Ya con
+// el lock vuelve a mirar: si el IMU se anunció entre el último vistazo y la
+// toma, lo suelta y espera de nuevo. Queda una carrera: un anuncio posterior
+// al re-chequeo espera un trozo en vuelo, la cota del peor caso (i2c_bus.h).
+// timeout_ms acota la espera entera, no cada vuelta. *yielded: si cedió.
+static bool bus_take(i2c_client_t c, uint32_t timeout_ms, bool* yielded) {
+  *yielded = false;
+  if (c == I2C_CLIENT_IMU) {
+    atomic_fetch_add(&s_hi_waiting, 1U);
+    if (os_sem_take(s_lock, timeout_ms)) return true;
+    hi_done();
+    return false;
+  }
+  const uint64_t deadline = timeout_ms == OS_WAIT_FOREVER ? UINT64_MAX : os_now_us() + (uint64_t)timeout_ms * 1000U;
+  for (;;) {
+    while (atomic_load(&s_hi_waiting) > 0U) {
+      *yielded = true;
+      if (!hi_idle_wait(remaining_ms(deadline))) return false;
+    }
+    if (!os_sem_take(s_lock, remaining_ms(deadline))) return false;
+    if (atomic_load(&s_hi_waiting) == 0U) return true;
+    os_sem_give(s_lock);
+    *yielded = true;
+  }
+}
+
+static void bus_give(i2c_client_t c) {
+  os_sem_give(s_lock);
+  if (c == I2C_CLIENT_IMU) hi_done();
+}
+
+// Bus no obtenido: no hay transacción, sólo el fallo.
+static void account_fail(i2c_client_t c) {
+  os_sem_take(s_stats_lock, OS_WAIT_FOREVER);
+  s_stats[c].fails++;
+  os_sem_give(s_stats_lock);
+}
+
+// Contabilidad después de la transacción, con el bus todavía tomado.
+static void account(i2c_client_t c, uint64_t t_req, uint64_t t_grant, size_t bytes, bool ok, bool yielded) {
+  i2c_bus_stats_t* s = &s_stats[c];
+  const uint32_t wait = (uint32_t)(t_grant - t_req);
+  const uint32_t lat = (uint32_t)(os_now_us() - t_req);
+  os_sem_take(s_stats_lock, OS_WAIT_FOREVER);
+  s->xfers++;
+  if (yielded) s->yields++;
+  s->bytes += (uint32_t)bytes;
+  if (!ok) s->fails++;
+  s->wait_us_sum += wait;
+  if (wait > s->wait_us_max) s->wait_us_max = wait;
+  if (lat > s->lat_us_max) s->lat_us_max = lat;
+  os_sem_give(s_stats_lock);
+}
+
+bool i2c_bus_init(void) {
+  if (s_ready) return true;
+  if (!wire_init()) return false;
+  s_lock = os_sem_create();
+  s_hi_idle = os_sem_create();
+  s_stats_lock = os_sem_create();
+  if (!s_lock || !s_hi_idle || !s_stats_lock) return false;
+  os_sem_give(s_lock);
+  os_sem_give(s_stats_lock);
+  atomic_store(&s_hi_waiting, 0U);
+  atomic_store(&s_lo_parked, 0U);
+  mem_report_static("i2c_bus", sizeof(s_stats));
+  s_ready = true;
+  return true;
+}
+
+bool i2c_bus_write_read(i2c_client_t c, uint8_t addr, const uint8_t* w, size_t wlen, uint8_t* r, size_t rlen,
+                        uint32_t timeout_ms) {
+  if (!s_ready || c >= I2C_CLIENT_COUNT || !w || wlen == 0U || (rlen && !r)) return false;
+  const uint64_t t_req = os_now_us();
+  bool yielded;
+  if (!bus_take(c, timeout_ms, &yielded)) {
+    account_fail(c);
+    return false;
+  }
+  const uint64_t t_grant = os_now_us();
+  TRACE_BEGIN_EV(TRACE_EV_I2C);
+  const bool ok = wire_write_read(addr, w, wlen, r, rlen, timeout_ms);
+  TRACE_END_EV(TRACE_EV_I2C);
+  account(c, t_req, t_grant, wlen + rlen, ok, yielded);
+  bus_give(c);
+  return ok;
+}
+
+bool i2c_bus_write(i2c_client_t c, uint8_t addr, const uint8_t* buf, size_t len, uint32_t timeout_ms) {
+  return i2c_bus_write_read(c, addr, buf, len, NULL, 0U, timeout_ms);
+}
+
+bool i2c_bus_write_bulk(i2c_client_t c, uint8_t addr, uint8_t prefix, const uint8_t* data, size_t len,
+                        uint32_t timeout_ms) {
+  if (!s_ready || c >= I2C_CLIENT_COUNT || !data || len == 0U) return false;
+  const size_t chunk = s_chunk ? s_chunk : len;
+  for (size_t off = 0; off < len; off += chunk) {
+    const size_t n = len - off < chunk ? len - off : chunk;
+    const uint64_t t_req = os_now_us();
+    bool yielded;
+    if (!bus_take(c, timeout_ms, &yielded)) {
+      account_fail(c);
+      return false;
+    }
+    const uint64_t t_grant = os_now_us();
+    TRACE_BEGIN_EV(TRACE_EV_I2C);
+    const bool ok = wire_write_prefixed(addr, prefix, &data[off], n, timeout_ms);
+    TRACE_END_EV(TRACE_EV_I2C);
+    account(c, t_req, t_grant, n, ok, yielded);
+    bus_give(c);
+    if (!ok) return false;
+  }
+  return true;
+}
+
+void i2c_bus_set_chunk(size_t bytes) {
+  s_chunk = bytes;
+}
+
+size_t i2c_bus_chunk(void) {
+  return s_chunk;
+}
+
+// Copia con s_stats_lock: wait_us_sum (64 bits) no se lee a medias.
+void i2c_bus_stats(i2c_client_t c, i2c_bus_stats_t* out) {
+  if (!out || c >= I2C_CLIENT_COUNT) return;
+  if (s_ready) os_sem_take(s_stats_lock, OS_WAIT_FOREVER);
+  *out = s_stats[c];
+  if (s_ready) os_sem_give(s_stats_lock);
+}
+
+void i2c_bus_reset_stats(void) {
+  if (s_ready) os_sem_take(s_stats_lock, OS_WAIT_FOREVER);
+  memset(s_stats, 0, sizeof(s_stats));
+  if (s_ready) os_sem_give(s_stats_lock);
+}
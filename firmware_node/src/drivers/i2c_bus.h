@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config/system_config.h"
+
+// Árbitro del bus I2C compartido (BOARD_I2C_*: MPU9250 y OLED del TTGO).
+// Serializa a los clientes con un lock; el IMU es de prioridad alta y el
+// resto de baja. Las escrituras largas de baja prioridad (i2c_bus_write_bulk)
+// se parten en trozos de a lo sumo i2c_bus_chunk() bytes, cada uno una
+// transacción: entre trozos el bus se libera y, si el IMU espera, el trozo
+// siguiente no compite hasta que el IMU termina. Peor caso de espera del IMU:
+// un trozo en vuelo (16 B + prefijo + dirección ≈ 0.4 ms a 400 kHz), no la
+// escritura entera (un cuadro del OLED en una transacción ≈ 23 ms, más que
+// el timeout de lectura del IMU).
+// En host no hay dispositivos: cada transacción ocupa el bus el tiempo que
+// tardaría en el cable (9 bits por byte a I2C_BUS_HOST_HZ) y las lecturas
+// devuelven ceros; así se mide el arbitraje sin hardware (tools/bench_i2c_bus.c).
+
+#ifndef I2C_BUS_CHUNK_BYTES
+#define I2C_BUS_CHUNK_BYTES 16U   // por defecto; i2c_bus_set_chunk() lo cambia
+#endif
+
+#ifndef I2C_BUS_HOST_HZ
+#define I2C_BUS_HOST_HZ 400000U   // BOARD_I2C_FREQ_HZ
+#endif
+
+typedef enum {
+  I2C_CLIENT_IMU = 0,   // prioridad alta
+  I2C_CLIENT_OLED,
+  I2C_CLIENT_OTHER,
+  I2C_CLIENT_COUNT
+} i2c_client_t;
+
+typedef struct {
+  uint32_t xfers;         // transacciones (un trozo cuenta como una)
+  uint32_t bytes;         // de datos, sin dirección ni prefijo
+  uint32_t fails;         // error de bus o timeout esperando el lock
+  uint32_t yields;        // trozos demorados porque esperaba el IMU
+  uint32_t wait_us_max;   // pedido → bus concedido
+  uint64_t wait_us_sum;
+  uint32_t lat_us_max;    // pedido → transacción terminada
+} i2c_bus_stats_t;
+
+// Instala el driver (una vez; lo llaman imu_init y oled_init).
+bool i2c_bus_init(void);
+
+// Una transacción: escritura, o escritura + lectura con repeated start.
+bool i2c_bus_write(i2c_client_t c, uint8_t addr, const uint8_t* buf, size_t len, uint32_t timeout_ms);
+bool i2c_bus_write_read(i2c_client_t c, uint8_t addr, const uint8_t* w, size_t wlen, uint8_t* r, size_t rlen,
+                        uint32_t timeout_ms);
+// len bytes de data en trozos, cada uno precedido por prefix (p. ej. 0x40,
+// "datos" del SSD1306). timeout_ms acota la espera del lock de cada trozo.
+bool i2c_bus_write_bulk(i2c_client_t c, uint8_t addr, uint8_t prefix, const uint8_t* data, size_t len,
+                        uint32_t timeout_ms);
+
+// Tamaño de trozo de i2c_bus_write_bulk; 0: sin trocear (una transacción).
+void i2c_bus_set_chunk(size_t bytes);
+size_t i2c_bus_chunk(void);
+
+void i2c_bus_stats(i2c_client_t c, i2c_bus_stats_t* out);
+void i2c_bus_reset_stats(void);
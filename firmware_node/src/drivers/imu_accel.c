@@ -1,12 +1,18 @@
 #include "firmware_node/src/drivers/imu_accel.h"
 
 #include "config/system_config.h"
+#include "firmware_node/src/services/energy.h"
 
 #if APP_USE_FREERTOS
 
 #include "config/board_pins.h"
+#include "firmware_node/src/drivers/i2c_bus.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/dlog.h"
+#include "firmware_node/src/services/prof.h"
 
-#include "driver/i2c.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
 #include "esp_err.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -16,56 +22,82 @@
 #define MPU9250_ADDR            0x68
 #define MPU9250_WHO_AM_I        0x75
 #define MPU9250_PWR_MGMT_1      0x6B
+#define MPU9250_PWR_MGMT_2      0x6C
+#define MPU9250_LP_ACCEL_ODR    0x1E
+#define MPU9250_WOM_THR         0x1F
+#define MPU9250_INT_PIN_CFG     0x37
+#define MPU9250_INT_ENABLE      0x38
+#define MPU9250_INT_STATUS      0x3A
+#define MPU9250_MOT_DETECT_CTRL 0x69
 #define MPU9250_ACCEL_CONFIG    0x1C
 #define MPU9250_ACCEL_CONFIG2   0x1D
 #define MPU9250_SMPLRT_DIV      0x19
+#define MPU9250_CONFIG          0x1A
+#define MPU9250_GYRO_CONFIG     0x1B
 #define MPU9250_ACCEL_XOUT_H    0x3B
 
 #define MPU9250_ACCEL_FS_SEL_4G 0x08
 #define MPU9250_LSB_PER_G_4G    8192
 
+#define MPU9250_PWR1_CLK_PLL    0x01
+#define MPU9250_PWR1_CYCLE      0x20
+#define MPU9250_PWR2_GYRO_OFF   0x07   // DIS_XG | DIS_YG | DIS_ZG
+#define MPU9250_PWR2_ALL_ON     0x00
+#define MPU9250_GYRO_FS_500DPS  0x08
+#define MPU9250_CONFIG_DLPF_41  0x03   // gyro 41 Hz, mismo orden que el accel
+#define MPU9250_TEMP_LSB_X100   33387  // 333.87 LSB/°C
+#define MPU9250_TEMP_OFFSET_C   21
+#define MPU9250_ACCEL2_DLPF_44  0x03
+#define MPU9250_ACCEL2_WOM      0x09   // ACCEL_FCHOICE_B=1, A_DLPF_CFG=1 (secuencia WOM)
+#define MPU9250_INT_LATCH       0x20   // INT se mantiene hasta leer INT_STATUS
+#define MPU9250_INT_WOM         0x40
+#define MPU9250_MOT_INTEL       0xC0   // ACCEL_INTEL_EN | ACCEL_INTEL_MODE (compara)
+#define MPU9250_WOM_LSB_MG      4U
+
 static const char* TAG = "imu_mpu9250";
 
 static bool s_i2c_ready = false;
+static uint32_t s_i2c_count = 0;
+// Por transacción (espera del bus incluida): el OLED cede en el próximo trozo.
+#define IMU_I2C_TIMEOUT_MS 20U
+static os_sem_t s_int_sem = NULL;
+static bool s_gyro_on = false;
 
 static esp_err_t i2c_write_reg(uint8_t reg, uint8_t value) {
   uint8_t data[2] = { reg, value };
-  return i2c_master_write_to_device(
-      BOARD_I2C_PORT, MPU9250_ADDR, data, sizeof(data), pdMS_TO_TICKS(20));
+  s_i2c_count++;
+  return i2c_bus_write(I2C_CLIENT_IMU, MPU9250_ADDR, data, sizeof(data), IMU_I2C_TIMEOUT_MS) ? ESP_OK : ESP_FAIL;
 }
 
 static esp_err_t i2c_read_reg(uint8_t reg, uint8_t* buf, size_t len) {
-  return i2c_master_write_read_device(
-      BOARD_I2C_PORT, MPU9250_ADDR, &reg, 1, buf, len, pdMS_TO_TICKS(20));
+  s_i2c_count++;
+  return i2c_bus_write_read(I2C_CLIENT_IMU, MPU9250_ADDR, &reg, 1, buf, len, IMU_I2C_TIMEOUT_MS) ? ESP_OK
+                                                                                                  : ESP_FAIL;
 }
 
+// Bus compartido con el OLED: lo instala y arbitra i2c_bus.
 static bool ensure_i2c_bus(void) {
-  if (s_i2c_ready) {
-    return true;
-  }
-
-  i2c_config_t cfg = {
-    .mode = I2C_MODE_MASTER,
-    .sda_io_num = BOARD_I2C_SDA,
-    .scl_io_num = BOARD_I2C_SCL,
-    .sda_pullup_en = GPIO_PULLUP_ENABLE,
-    .scl_pullup_en = GPIO_PULLUP_ENABLE,
-    .master.clk_speed = BOARD_I2C_FREQ_HZ,
-  };
+  if (!s_i2c_ready) s_i2c_ready = i2c_bus_init();
+  return s_i2c_ready;
+}
 
-  esp_err_t err = i2c_param_config(BOARD_I2C_PORT, &cfg);
-  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
-    ESP_LOGE(TAG, "i2c_param_config failed (%d)", err);
-    return false;
-  }
-  err = i2c_driver_install(BOARD_I2C_PORT, cfg.mode, 0, 0, 0);
-  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
-    ESP_LOGE(TAG, "i2c_driver_install failed (%d)", err);
-    return false;
-  }
+static void IRAM_ATTR imu_int_isr(void* arg) {
+  (void)arg;
+  os_sem_give(s_int_sem);
+}
 
-  s_i2c_ready = true;
-  return true;
+static bool install_int_isr(void) {
+  if (!s_int_sem) s_int_sem = os_sem_create();
+  if (!s_int_sem) return false;
+  gpio_config_t int_cfg = {
+    .pin_bit_mask = 1ULL << BOARD_IMU_PIN_INT,
+    .mode = GPIO_MODE_INPUT,
+    .intr_type = GPIO_INTR_POSEDGE,
+  };
+  gpio_config(&int_cfg);
+  esp_err_t err = gpio_install_isr_service(0);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;   // ya instalado: ok
+  return gpio_isr_handler_add(BOARD_IMU_PIN_INT, imu_int_isr, NULL) == ESP_OK;
 }
 
 bool imu_init(void) {
@@ -83,11 +115,15 @@ bool imu_init(void) {
     ESP_LOGW(TAG, "Unexpected WHO_AM_I=0x%02X", who_am_i);
   }
 
-  if (i2c_write_reg(MPU9250_PWR_MGMT_1, 0x01) != ESP_OK) {
+  if (i2c_write_reg(MPU9250_PWR_MGMT_1, MPU9250_PWR1_CLK_PLL) != ESP_OK) {
     ESP_LOGE(TAG, "Failed to exit sleep");
     return false;
   }
   vTaskDelay(pdMS_TO_TICKS(10));
+  // Giroscopio apagado por defecto (~3.7 mA → ~0.45 mA); imu_set_gyro() lo enciende.
+  if (i2c_write_reg(MPU9250_PWR_MGMT_2, MPU9250_PWR2_GYRO_OFF) != ESP_OK) {
+    ESP_LOGW(TAG, "Failed to disable gyro");
+  }
 
   if (i2c_write_reg(MPU9250_SMPLRT_DIV, 0x09) != ESP_OK) {
     ESP_LOGE(TAG, "Failed to set sample rate");
@@ -99,47 +135,147 @@ bool imu_init(void) {
     return false;
   }
 
-  if (i2c_write_reg(MPU9250_ACCEL_CONFIG2, 0x03) != ESP_OK) {
+  if (i2c_write_reg(MPU9250_ACCEL_CONFIG2, MPU9250_ACCEL2_DLPF_44) != ESP_OK) {
     ESP_LOGW(TAG, "Failed to set accel bandwidth");
   }
 
+  // Rango/filtro del giroscopio listos para imu_set_gyro(true).
+  if (i2c_write_reg(MPU9250_GYRO_CONFIG, MPU9250_GYRO_FS_500DPS) != ESP_OK ||
+      i2c_write_reg(MPU9250_CONFIG, MPU9250_CONFIG_DLPF_41) != ESP_OK) {
+    ESP_LOGW(TAG, "Failed to configure gyro");
+  }
+
+  if (!install_int_isr()) {
+    ESP_LOGW(TAG, "INT ISR install failed (sin wake-on-motion)");
+  }
+
+  s_gyro_on = false;
+  energy_set_state(ENERGY_IMU, ENERGY_IMU_ACCEL);
   ESP_LOGI(TAG, "MPU9250 initialized (WHO_AM_I=0x%02X)", who_am_i);
   return true;
 }
 
 static int16_t raw_to_centi_g(int16_t raw) {
+  PROF_SCOPE(PROF_RAW_TO_CENTI_G);
   int32_t scaled = ((int32_t)raw * 100) / MPU9250_LSB_PER_G_4G;
   if (scaled > INT16_MAX) return INT16_MAX;
   if (scaled < INT16_MIN) return INT16_MIN;
   return (int16_t)scaled;
 }
 
+static int16_t be16(const uint8_t* p) {
+  return (int16_t)((p[0] << 8) | p[1]);
+}
+
+static void parse_accel(const uint8_t* buf, accel_raw_t* out) {
+  out->ax = raw_to_centi_g(be16(&buf[0]));
+  out->ay = raw_to_centi_g(be16(&buf[2]));
+  out->az = raw_to_centi_g(be16(&buf[4]));
+}
+
 bool imu_read(accel_raw_t* out) {
   if (!out) return false;
   if (!s_i2c_ready && !ensure_i2c_bus()) return false;
 
   uint8_t buf[6];
   if (i2c_read_reg(MPU9250_ACCEL_XOUT_H, buf, sizeof(buf)) != ESP_OK) {
-    ESP_LOGE(TAG, "Accel read failed");
+    DLOG(DLOG_IMU_READ_FAIL, (int32_t)sizeof(buf));
     return false;
   }
+  parse_accel(buf, out);
+  return true;
+}
+
+// Ráfaga de 14 bytes: ACCEL_XOUT_H..ACCEL_ZOUT_L, TEMP_OUT_H/L,
+// GYRO_XOUT_H..GYRO_ZOUT_L. ~380 us a 400 kHz contra ~200 us de imu_read().
+bool imu_read_motion(accel_raw_t* accel, imu_gyro_t* gyro) {
+  if (!accel || !gyro) return false;
+  if (!s_i2c_ready && !ensure_i2c_bus()) return false;
 
-  int16_t raw_ax = (int16_t)((buf[0] << 8) | buf[1]);
-  int16_t raw_ay = (int16_t)((buf[2] << 8) | buf[3]);
-  int16_t raw_az = (int16_t)((buf[4] << 8) | buf[5]);
+  uint8_t buf[IMU_BURST_BYTES];
+  if (i2c_read_reg(MPU9250_ACCEL_XOUT_H, buf, sizeof(buf)) != ESP_OK) {
+    DLOG(DLOG_IMU_READ_FAIL, (int32_t)sizeof(buf));
+    return false;
+  }
+  parse_accel(buf, accel);
+  gyro->temp_centi_c = (int16_t)((int32_t)be16(&buf[6]) * 10000 / MPU9250_TEMP_LSB_X100 +
+                                 MPU9250_TEMP_OFFSET_C * 100);
+  gyro->gx = be16(&buf[8]);
+  gyro->gy = be16(&buf[10]);
+  gyro->gz = be16(&buf[12]);
+  return true;
+}
 
-  out->ax = raw_to_centi_g(raw_ax);
-  out->ay = raw_to_centi_g(raw_ay);
-  out->az = raw_to_centi_g(raw_az);
+bool imu_set_gyro(bool on) {
+  if (i2c_write_reg(MPU9250_PWR_MGMT_2, on ? MPU9250_PWR2_ALL_ON : MPU9250_PWR2_GYRO_OFF) != ESP_OK) {
+    return false;
+  }
+  s_gyro_on = on;
+  energy_set_state(ENERGY_IMU, on ? ENERGY_IMU_ACCEL_GYRO : ENERGY_IMU_ACCEL);
   return true;
 }
 
+// Secuencia de wake-on-motion del datasheet MPU-9250 (sección 7.7 del
+// register map). IMU_XFERS_WOM_ENTER transacciones (+1 si hay que apagar el
+// giroscopio).
+bool imu_enter_wom(uint16_t thr_mg, uint8_t lp_odr_sel) {
+  if (!s_int_sem) return false;
+  uint8_t status = 0;
+  uint32_t thr = thr_mg / MPU9250_WOM_LSB_MG;
+  if (thr > 0xFFU) thr = 0xFFU;
+  bool ok = true;
+  if (s_gyro_on) ok = i2c_write_reg(MPU9250_PWR_MGMT_2, MPU9250_PWR2_GYRO_OFF) == ESP_OK;
+  ok = ok && i2c_write_reg(MPU9250_ACCEL_CONFIG2, MPU9250_ACCEL2_WOM) == ESP_OK;
+  ok = ok && i2c_write_reg(MPU9250_INT_PIN_CFG, MPU9250_INT_LATCH) == ESP_OK;
+  ok = ok && i2c_write_reg(MPU9250_INT_ENABLE, MPU9250_INT_WOM) == ESP_OK;
+  ok = ok && i2c_write_reg(MPU9250_MOT_DETECT_CTRL, MPU9250_MOT_INTEL) == ESP_OK;
+  ok = ok && i2c_write_reg(MPU9250_WOM_THR, (uint8_t)thr) == ESP_OK;
+  ok = ok && i2c_write_reg(MPU9250_LP_ACCEL_ODR, lp_odr_sel & 0x0F) == ESP_OK;
+  ok = ok && i2c_read_reg(MPU9250_INT_STATUS, &status, 1) == ESP_OK;   // limpia el latch
+  (void)os_sem_take(s_int_sem, 0);   // descarta flancos previos
+  ok = ok && i2c_write_reg(MPU9250_PWR_MGMT_1, MPU9250_PWR1_CLK_PLL | MPU9250_PWR1_CYCLE) == ESP_OK;
+  if (!ok) {
+    imu_exit_wom();
+    return false;
+  }
+  energy_set_state(ENERGY_IMU, ENERGY_IMU_LP_ACCEL);
+  return true;
+}
+
+bool imu_exit_wom(void) {
+  bool ok = i2c_write_reg(MPU9250_PWR_MGMT_1, MPU9250_PWR1_CLK_PLL) == ESP_OK;
+  ok = i2c_write_reg(MPU9250_INT_ENABLE, 0x00) == ESP_OK && ok;
+  ok = i2c_write_reg(MPU9250_MOT_DETECT_CTRL, 0x00) == ESP_OK && ok;
+  ok = i2c_write_reg(MPU9250_ACCEL_CONFIG2, MPU9250_ACCEL2_DLPF_44) == ESP_OK && ok;
+  if (s_gyro_on) ok = i2c_write_reg(MPU9250_PWR_MGMT_2, MPU9250_PWR2_ALL_ON) == ESP_OK && ok;
+  energy_set_state(ENERGY_IMU, s_gyro_on ? ENERGY_IMU_ACCEL_GYRO : ENERGY_IMU_ACCEL);
+  return ok;
+}
+
+bool imu_wait_motion(uint32_t timeout_ms) {
+  if (!s_int_sem || !os_sem_take(s_int_sem, timeout_ms)) return false;
+  uint8_t status = 0;
+  if (i2c_read_reg(MPU9250_INT_STATUS, &status, 1) != ESP_OK) return true;   // ante la duda, despertar
+  return (status & MPU9250_INT_WOM) != 0U;
+}
+
+uint32_t imu_i2c_count(void) {
+  return s_i2c_count;
+}
+
 #else  // APP_USE_FREERTOS == 0 (host stub)
 
+#include "firmware_node/src/port/os_port.h"
+
 #include <stdlib.h>
 
 static bool s_initialized = false;
 static uint32_t s_sample_idx = 0;
+static uint32_t s_i2c_count = 0;
+static bool s_wom = false;
+static bool s_gyro_on = false;
+static uint16_t s_wom_thr_mg = 0;
+static uint8_t s_wom_odr_sel = 0;
 
 static int16_t pseudo_noise(uint32_t seed) {
   const uint32_t hash = (seed * 1103515245u + 12345u) & 0x7FFFu;
@@ -151,7 +287,7 @@ static accel_raw_t build_sample(uint32_t sample_idx) {
   out.az = 100 + pseudo_noise(sample_idx);
   if ((sample_idx % 100) == 10) {
     out.az = 450;
-  } else if ((sample_idx % 100) > 10 && (sample_idx % 100) < 80) {
+  } else if ((sample_idx % 100) > 10 && (sample_idx % 100) < 90) {
     out.az = 10 + pseudo_noise(sample_idx);
   }
   out.ax = pseudo_noise(sample_idx + 1U);
@@ -162,14 +298,92 @@ static accel_raw_t build_sample(uint32_t sample_idx) {
 bool imu_init(void) {
   s_initialized = true;
   s_sample_idx = 0;
+  s_i2c_count = 8U;   // WHO_AM_I + 7 escrituras, como el driver real
+  s_gyro_on = false;
+  energy_set_state(ENERGY_IMU, ENERGY_IMU_ACCEL);
   return true;
 }
 
 bool imu_read(accel_raw_t* out) {
   if (!s_initialized || !out) return false;
+  s_i2c_count += IMU_XFERS_READ;
   *out = build_sample(s_sample_idx++);
   return true;
 }
 
+// Giroscopio sintético: el cuerpo gira ~90° en los 200 ms previos a cada
+// impacto (muestras 90..9 de cada ciclo), así la caída cambia de postura.
+bool imu_read_motion(accel_raw_t* accel, imu_gyro_t* gyro) {
+  if (!s_initialized || !accel || !gyro) return false;
+  const uint32_t idx = s_sample_idx;
+  const uint32_t phase = idx % 100U;
+  s_i2c_count += IMU_XFERS_READ;
+  *accel = build_sample(s_sample_idx++);
+  const int16_t turn = (phase >= 90U || phase < 10U) ? 29475 : 0;   // 450 °/s
+  gyro->gx = s_gyro_on ? (int16_t)(turn + pseudo_noise(idx + 3U)) : 0;
+  gyro->gy = s_gyro_on ? pseudo_noise(idx + 4U) : 0;
+  gyro->gz = s_gyro_on ? pseudo_noise(idx + 5U) : 0;
+  gyro->temp_centi_c = 2500;
+  return true;
+}
+
+bool imu_set_gyro(bool on) {
+  if (!s_initialized) return false;
+  s_i2c_count++;
+  s_gyro_on = on;
+  energy_set_state(ENERGY_IMU, on ? ENERGY_IMU_ACCEL_GYRO : ENERGY_IMU_ACCEL);
+  return true;
+}
+
+bool imu_enter_wom(uint16_t thr_mg, uint8_t lp_odr_sel) {
+  if (!s_initialized) return false;
+  s_i2c_count += IMU_XFERS_WOM_ENTER + (s_gyro_on ? 1U : 0U);
+  s_wom = true;
+  s_wom_thr_mg = thr_mg;
+  s_wom_odr_sel = lp_odr_sel;
+  energy_set_state(ENERGY_IMU, ENERGY_IMU_LP_ACCEL);
+  return true;
+}
+
+bool imu_exit_wom(void) {
+  s_i2c_count += IMU_XFERS_WOM_EXIT + (s_gyro_on ? 1U : 0U);
+  s_wom = false;
+  energy_set_state(ENERGY_IMU, s_gyro_on ? ENERGY_IMU_ACCEL_GYRO : ENERGY_IMU_ACCEL);
+  return true;
+}
+
+// LP_ACCEL_ODR: 0.24 Hz · 2^sel (7 = 31.25 Hz). Periodo en muestras de 10 ms.
+static uint32_t wom_stride_samples(uint8_t sel) {
+  const uint32_t period_ms = 4096U >> (sel > 11U ? 11U : sel);   // ~1/(0.24·2^sel)
+  return period_ms >= 10U ? period_ms / 10U : 1U;
+}
+
+// Emula el chip sobre la señal sintética: recorre las muestras a la tasa
+// low-power (el "reloj" avanza con el tiempo real) y duerme hasta la primera
+// que se aparta de la referencia más de thr en algún eje.
+bool imu_wait_motion(uint32_t timeout_ms) {
+  if (!s_wom) return false;
+  const accel_raw_t ref = build_sample(s_sample_idx);
+  const int32_t thr = (int32_t)s_wom_thr_mg / 10;   // mg → centi-g
+  const uint32_t stride = wom_stride_samples(s_wom_odr_sel);
+  const uint32_t max_samples = timeout_ms == OS_WAIT_FOREVER ? 360000U : timeout_ms / 10U;
+  for (uint32_t n = stride; n <= max_samples; n += stride) {
+    const accel_raw_t s = build_sample(s_sample_idx + n);
+    if (abs(s.ax - ref.ax) > thr || abs(s.ay - ref.ay) > thr || abs(s.az - ref.az) > thr) {
+      os_delay_ms(n * 10U);
+      s_sample_idx += n + 1U;
+      s_i2c_count += IMU_XFERS_WOM_WAKE;
+      return os_running();
+    }
+  }
+  os_delay_ms(max_samples * 10U);
+  s_sample_idx += max_samples;
+  return false;
+}
+
+uint32_t imu_i2c_count(void) {
+  return s_i2c_count;
+}
+
 #endif
 
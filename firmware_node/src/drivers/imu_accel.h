@@ -5,6 +5,16 @@
 
 typedef struct { int16_t ax, ay, az; } accel_raw_t;
 
+// Giroscopio en LSB crudos (±500 °/s: IMU_GYRO_LSB_PER_DPS_X10 / 10 LSB por °/s)
+// y temperatura del die.
+typedef struct {
+  int16_t gx, gy, gz;
+  int16_t temp_centi_c;
+} imu_gyro_t;
+
+#define IMU_GYRO_LSB_PER_DPS_X10 655   // 65.5 LSB/(°/s)
+#define IMU_BURST_BYTES           14U  // ACCEL_XOUT_H..GYRO_ZOUT_L
+
 // Inicializa el IMU (acelerómetro)
 // Retorna true en éxito. Tiempo de ejecución acotado.
 bool imu_init(void);
@@ -13,3 +23,32 @@ bool imu_init(void);
 // Debe ser no bloqueante o con tiempo acotado (O(100 us–1 ms) típico)
 bool imu_read(accel_raw_t* out);
 
+// Acelerómetro + temperatura + giroscopio en una sola transacción de
+// IMU_BURST_BYTES (misma muestra interna del MPU9250, sin desfase entre
+// sensores). Requiere imu_set_gyro(true); con el giroscopio apagado gyro
+// queda en 0.
+bool imu_read_motion(accel_raw_t* accel, imu_gyro_t* gyro);
+
+// Enciende/apaga el giroscopio (PWR_MGMT_2). Arranque ~35 ms: las primeras
+// lecturas tras encenderlo no son válidas (orientation_reset() al volver).
+bool imu_set_gyro(bool on);
+
+// --- Wake-on-motion (adquisición adaptativa) ---
+// imu_enter_wom(): acelerómetro en low-power (LP_ACCEL_ODR lp_odr_sel) con
+// interrupción de movimiento al superar thr_mg en cualquier eje respecto de
+// la muestra de referencia; el pin INT despierta por ISR, sin sondeo I2C.
+// imu_exit_wom(): vuelve a muestreo completo; el giroscopio se apaga durante
+// WOM y se restaura si estaba encendido (+1 transacción en cada sentido).
+bool imu_enter_wom(uint16_t thr_mg, uint8_t lp_odr_sel);
+bool imu_exit_wom(void);
+// Duerme hasta la interrupción WOM o timeout_ms (OS_WAIT_FOREVER admitido).
+// true si hubo movimiento.
+bool imu_wait_motion(uint32_t timeout_ms);
+// Transacciones I2C emitidas desde imu_init() (lecturas + configuración).
+uint32_t imu_i2c_count(void);
+
+// Transacciones I2C de cada secuencia (para tools/wom_replay.c).
+#define IMU_XFERS_READ       1U
+#define IMU_XFERS_WOM_ENTER  8U
+#define IMU_XFERS_WOM_WAKE   1U   // lectura de INT_STATUS (limpia el latch)
+#define IMU_XFERS_WOM_EXIT   4U
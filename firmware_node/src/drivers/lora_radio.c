@@ -1,6 +1,21 @@
 #include "firmware_node/src/drivers/lora_radio.h"
 
 #include "config/system_config.h"
+#include "firmware_node/src/services/energy.h"
+
+// Parámetros PHY de la última lora_init (para lora_time_on_air_us).
+static uint8_t s_phy_sf = 7;
+static uint8_t s_phy_bw_khz = 125;
+static bool s_phy_crc = true;
+static int16_t s_rx_rssi_dbm = 0;
+static int8_t s_rx_snr_db = 0;
+static uint8_t s_rx_len = 0;
+
+static void phy_store(uint8_t sf, uint8_t bw_khz, bool crc_on) {
+  s_phy_sf = sf;
+  s_phy_bw_khz = bw_khz;
+  s_phy_crc = crc_on;
+}
 
 #if APP_USE_FREERTOS
 
@@ -8,12 +23,16 @@
 
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
+#include "esp_attr.h"
 #include "esp_err.h"
 #include "esp_log.h"
-#include "esp_timer.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/dlog.h"
+#include "firmware_node/src/services/mem_report.h"
+#include "firmware_node/src/services/prof.h"
+#include "firmware_node/src/services/trace_ring.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include <stdlib.h>
 #include <string.h>
 
 #define SX1276_REG_FIFO              0x00
@@ -28,8 +47,11 @@
 #define SX1276_REG_FIFO_TX_BASE_ADDR 0x0E
 #define SX1276_REG_FIFO_RX_BASE_ADDR 0x0F
 #define SX1276_REG_FIFO_RX_CURRENT   0x10
+#define SX1276_REG_RX_NB_BYTES       0x13
 #define SX1276_REG_IRQ_FLAGS         0x12
 #define SX1276_REG_IRQ_FLAGS_MASK    0x11
+#define SX1276_REG_PKT_SNR_VALUE     0x19
+#define SX1276_REG_PKT_RSSI_VALUE    0x1A
 #define SX1276_REG_MODEM_CONFIG1     0x1D
 #define SX1276_REG_MODEM_CONFIG2     0x1E
 #define SX1276_REG_MODEM_CONFIG3     0x26
@@ -53,11 +75,30 @@
 #define SX1276_IRQ_RX_TIMEOUT        0x80
 #define SX1276_IRQ_PAYLOAD_CRC_ERROR 0x20
 
+// RegDioMapping1: DIO0 = bits 7-6 (00 RxDone, 01 TxDone), DIO1 = bits 5-4 (00 RxTimeout).
+#define SX1276_DIO_MAP_RX            0x00
+#define SX1276_DIO_MAP_TX            0x40
+
 static const char* TAG = "lora_sx1276";
 
 static spi_device_handle_t s_spi = NULL;
 static bool s_lora_ready = false;
 static bool s_bus_ready = false;
+static bool s_rx_armed = false;
+// DIO0/DIO1 → ISR → semáforo: las tareas duermen hasta el flanco, sin sondeo SPI.
+static os_sem_t s_dio_sem = NULL;
+// Buffers SPI fijos (FIFO de 256 B + byte de dirección) en lugar de malloc por
+// transacción: el radio tiene un solo usuario a la vez (alert_tx o rx_lora).
+#define SX1276_SPI_BUF_LEN 257U
+DMA_ATTR static uint8_t s_spi_tx[SX1276_SPI_BUF_LEN];
+DMA_ATTR static uint8_t s_spi_rx[SX1276_SPI_BUF_LEN];
+
+static esp_err_t spi_xfer(spi_transaction_t* t) {
+  TRACE_BEGIN_EV(TRACE_EV_SPI);
+  const esp_err_t ret = spi_device_transmit(s_spi, t);
+  TRACE_END_EV(TRACE_EV_SPI);
+  return ret;
+}
 
 static esp_err_t spi_write_reg(uint8_t reg, uint8_t value) {
   spi_transaction_t t = {
@@ -66,75 +107,58 @@ static esp_err_t spi_write_reg(uint8_t reg, uint8_t value) {
   };
   t.tx_data[0] = reg | 0x80;
   t.tx_data[1] = value;
-  return spi_device_transmit(s_spi, &t);
+  return spi_xfer(&t);
 }
 
-static esp_err_t spi_read_reg(uint8_t reg, uint8_t* out, size_t len) {
+// RegOpMode siempre en modo LoRa; anuncia el estado al modelo de energía.
+static void set_op_mode(uint8_t mode) {
+  spi_write_reg(SX1276_REG_OP_MODE, mode | SX1276_MODE_LONG_RANGE_MODE);
+  switch (mode) {
+    case SX1276_MODE_SLEEP:        energy_set_state(ENERGY_RADIO, ENERGY_RADIO_SLEEP); break;
+    case SX1276_MODE_TX:           energy_set_state(ENERGY_RADIO, ENERGY_RADIO_TX); break;
+    case SX1276_MODE_RXCONTINUOUS:
+    case SX1276_MODE_RXSINGLE:     energy_set_state(ENERGY_RADIO, ENERGY_RADIO_RX); break;
+    default:                       energy_set_state(ENERGY_RADIO, ENERGY_RADIO_STDBY); break;
+  }
+}
+
+static esp_err_t spi_read_burst(uint8_t reg, uint8_t* out, size_t len) {
   if (!out || len == 0) return ESP_ERR_INVALID_ARG;
-  uint8_t header = reg & 0x7F;
+  if (len + 1 > SX1276_SPI_BUF_LEN) return ESP_ERR_INVALID_SIZE;
   spi_transaction_t t = {
     .length = 8 * (len + 1),
+    .tx_buffer = s_spi_tx,
+    .rx_buffer = s_spi_rx,
   };
-  uint8_t* tx = malloc(len + 1);
-  uint8_t* rx = malloc(len + 1);
-  if (!tx || !rx) {
-    free(tx);
-    free(rx);
-    return ESP_ERR_NO_MEM;
-  }
-  tx[0] = header;
-  memset(tx + 1, 0, len);
-  t.tx_buffer = tx;
-  t.rx_buffer = rx;
-  esp_err_t ret = spi_device_transmit(s_spi, &t);
+  s_spi_tx[0] = reg & 0x7F;
+  memset(s_spi_tx + 1, 0, len);
+  esp_err_t ret = spi_xfer(&t);
   if (ret == ESP_OK) {
-    memcpy(out, rx + 1, len);
+    memcpy(out, s_spi_rx + 1, len);
   }
-  free(tx);
-  free(rx);
   return ret;
 }
 
+static esp_err_t spi_read_reg(uint8_t reg, uint8_t* out, size_t len) {
+  PROF_SCOPE(PROF_SPI_READ_REG);
+  return spi_read_burst(reg, out, len);
+}
+
 static esp_err_t spi_write_fifo(const uint8_t* data, size_t len) {
   if (len == 0) return ESP_OK;
-  uint8_t header = SX1276_REG_FIFO | 0x80;
+  if (len + 1 > SX1276_SPI_BUF_LEN) return ESP_ERR_INVALID_SIZE;
   spi_transaction_t t = {
     .length = 8 * (len + 1),
+    .tx_buffer = s_spi_tx,
   };
-  uint8_t* tx = malloc(len + 1);
-  if (!tx) return ESP_ERR_NO_MEM;
-  tx[0] = header;
-  memcpy(tx + 1, data, len);
-  t.tx_buffer = tx;
-  esp_err_t ret = spi_device_transmit(s_spi, &t);
-  free(tx);
-  return ret;
+  s_spi_tx[0] = SX1276_REG_FIFO | 0x80;
+  memcpy(s_spi_tx + 1, data, len);
+  return spi_xfer(&t);
 }
 
 static esp_err_t spi_read_fifo(uint8_t* data, size_t len) {
   if (len == 0) return ESP_OK;
-  uint8_t header = SX1276_REG_FIFO & 0x7F;
-  spi_transaction_t t = {
-    .length = 8 * (len + 1),
-  };
-  uint8_t* tx = malloc(len + 1);
-  uint8_t* rx = malloc(len + 1);
-  if (!tx || !rx) {
-    free(tx);
-    free(rx);
-    return ESP_ERR_NO_MEM;
-  }
-  tx[0] = header;
-  memset(tx + 1, 0, len);
-  t.tx_buffer = tx;
-  t.rx_buffer = rx;
-  esp_err_t ret = spi_device_transmit(s_spi, &t);
-  if (ret == ESP_OK) {
-    memcpy(data, rx + 1, len);
-  }
-  free(tx);
-  free(rx);
-  return ret;
+  return spi_read_burst(SX1276_REG_FIFO, data, len);
 }
 
 static void sx1276_reset(void) {
@@ -200,28 +224,39 @@ static uint8_t sf_to_reg(uint8_t sf) {
   return (sf << 4);
 }
 
-static bool wait_for_irq(uint8_t mask, uint32_t timeout_ms) {
-  int64_t start_us = esp_timer_get_time();
-  while (true) {
+static void IRAM_ATTR dio_isr(void* arg) {
+  (void)arg;
+  TRACE_INSTANT_EV(TRACE_EV_DIO_IRQ, 0U);
+  os_sem_give(s_dio_sem);
+}
+
+// Espera un flanco en DIO0/DIO1 y retorna RegIrqFlags (ya limpiados); 0 si vence.
+// timeout_ms == 0 espera indefinidamente (compatibilidad con la versión por sondeo).
+static uint8_t wait_for_irq(uint8_t mask, uint32_t timeout_ms) {
+  PROF_SCOPE(PROF_WAIT_FOR_IRQ);
+  const uint32_t wait_ms = timeout_ms ? timeout_ms : OS_WAIT_FOREVER;
+  for (;;) {
+    if (!os_sem_take(s_dio_sem, wait_ms)) return 0;
     uint8_t irq = 0;
-    if (spi_read_reg(SX1276_REG_IRQ_FLAGS, &irq, 1) != ESP_OK) {
-      return false;
-    }
-    if (irq & mask) {
-      spi_write_reg(SX1276_REG_IRQ_FLAGS, irq);
-      return true;
-    }
-    if (timeout_ms > 0) {
-      int64_t elapsed_ms = (esp_timer_get_time() - start_us) / 1000;
-      if (elapsed_ms >= timeout_ms) {
-        return false;
-      }
-    }
-    vTaskDelay(pdMS_TO_TICKS(5));
+    if (spi_read_reg(SX1276_REG_IRQ_FLAGS, &irq, 1) != ESP_OK) return 0;
+    spi_write_reg(SX1276_REG_IRQ_FLAGS, irq);
+    if (irq & mask) return irq;
   }
 }
 
+static bool install_dio_isr(void) {
+  if (!s_dio_sem) s_dio_sem = os_sem_create();
+  if (!s_dio_sem) return false;
+  esp_err_t err = gpio_install_isr_service(0);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;   // ya instalado: ok
+  gpio_isr_handler_add(BOARD_LORA_PIN_DIO0, dio_isr, NULL);
+  gpio_isr_handler_add(BOARD_LORA_PIN_DIO1, dio_isr, NULL);
+  return true;
+}
+
 bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, bool crc_on) {
+  mem_report_static("lora_spi_buf", sizeof(s_spi_tx) + sizeof(s_spi_rx));
+  phy_store(sf, bw_khz, crc_on);
   if (!ensure_spi_bus()) return false;
 
   gpio_config_t rst_cfg = {
@@ -234,8 +269,13 @@ bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, boo
   gpio_config_t dio_cfg = {
     .pin_bit_mask = (1ULL << BOARD_LORA_PIN_DIO0) | (1ULL << BOARD_LORA_PIN_DIO1),
     .mode = GPIO_MODE_INPUT,
+    .intr_type = GPIO_INTR_POSEDGE,
   };
   gpio_config(&dio_cfg);
+  if (!install_dio_isr()) {
+    ESP_LOGE(TAG, "DIO ISR install failed");
+    return false;
+  }
 
   if (!attach_device()) return false;
 
@@ -251,9 +291,9 @@ bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, boo
     return false;
   }
 
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_SLEEP | SX1276_MODE_LONG_RANGE_MODE);
+  set_op_mode(SX1276_MODE_SLEEP);
   vTaskDelay(pdMS_TO_TICKS(10));
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_STDBY | SX1276_MODE_LONG_RANGE_MODE);
+  set_op_mode(SX1276_MODE_STDBY);
 
   uint64_t frf = ((uint64_t)freq_hz << 19) / 32000000ULL;
   spi_write_reg(SX1276_REG_FRF_MSB, (frf >> 16) & 0xFF);
@@ -276,7 +316,7 @@ bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, boo
   spi_write_reg(SX1276_REG_OCP, 0x2B);
   spi_write_reg(SX1276_REG_LNA, 0x23);
 
-  spi_write_reg(SX1276_REG_DIO_MAPPING1, 0x00);
+  spi_write_reg(SX1276_REG_DIO_MAPPING1, SX1276_DIO_MAP_RX);
   spi_write_reg(SX1276_REG_IRQ_FLAGS_MASK, ~(SX1276_IRQ_TX_DONE | SX1276_IRQ_RX_DONE | SX1276_IRQ_RX_TIMEOUT | SX1276_IRQ_PAYLOAD_CRC_ERROR));
   spi_write_reg(SX1276_REG_HOP_PERIOD, 0x00);
   spi_write_reg(SX1276_REG_DETECTION_OPTIMIZE, 0x03);
@@ -287,114 +327,190 @@ bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, boo
   return true;
 }
 
-bool lora_tx(const uint8_t* buf, size_t len, uint32_t timeout_ms) {
+static bool radio_tx(const uint8_t* buf, size_t len, uint32_t timeout_ms) {
   if (!s_lora_ready || !buf || len == 0 || len > 255) return false;
 
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_STDBY | SX1276_MODE_LONG_RANGE_MODE);
+  set_op_mode(SX1276_MODE_STDBY);
+  s_rx_armed = false;
+  spi_write_reg(SX1276_REG_DIO_MAPPING1, SX1276_DIO_MAP_TX);
   spi_write_reg(SX1276_REG_IRQ_FLAGS, 0xFF);
+  (void)os_sem_take(s_dio_sem, 0);   // descarta flancos previos
   spi_write_reg(SX1276_REG_FIFO_ADDR_PTR, 0x80);
   spi_write_reg(SX1276_REG_PAYLOAD_LENGTH, (uint8_t)len);
 
   if (spi_write_fifo(buf, len) != ESP_OK) {
-    ESP_LOGE(TAG, "FIFO write failed");
+    DLOG(DLOG_LORA_FIFO_FAIL);
     return false;
   }
 
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_TX | SX1276_MODE_LONG_RANGE_MODE);
+  set_op_mode(SX1276_MODE_TX);
 
   if (!wait_for_irq(SX1276_IRQ_TX_DONE, timeout_ms)) {
-    ESP_LOGE(TAG, "TX timeout");
-    spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_STDBY | SX1276_MODE_LONG_RANGE_MODE);
+    DLOG(DLOG_LORA_TX_TIMEOUT);
+    set_op_mode(SX1276_MODE_STDBY);
     return false;
   }
 
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_STDBY | SX1276_MODE_LONG_RANGE_MODE);
+  set_op_mode(SX1276_MODE_STDBY);
   return true;
 }
 
-bool lora_rx(uint8_t* buf, size_t maxlen, uint32_t timeout_ms) {
+// RX continuo: el receptor queda escuchando entre llamadas y la tarea sólo
+// despierta con RxDone (DIO0) o al vencer timeout_ms.
+static bool radio_rx(uint8_t* buf, size_t maxlen, uint32_t timeout_ms) {
   if (!s_lora_ready || !buf || maxlen == 0) return false;
 
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_STDBY | SX1276_MODE_LONG_RANGE_MODE);
-  spi_write_reg(SX1276_REG_IRQ_FLAGS, 0xFF);
-  spi_write_reg(SX1276_REG_FIFO_ADDR_PTR, 0x00);
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_RXSINGLE | SX1276_MODE_LONG_RANGE_MODE);
-
-  if (!wait_for_irq(SX1276_IRQ_RX_DONE | SX1276_IRQ_RX_TIMEOUT | SX1276_IRQ_PAYLOAD_CRC_ERROR, timeout_ms)) {
-    ESP_LOGE(TAG, "RX wait error");
-    return false;
+  if (!s_rx_armed) {
+    set_op_mode(SX1276_MODE_STDBY);
+    spi_write_reg(SX1276_REG_DIO_MAPPING1, SX1276_DIO_MAP_RX);
+    spi_write_reg(SX1276_REG_IRQ_FLAGS, 0xFF);
+    (void)os_sem_take(s_dio_sem, 0);
+    spi_write_reg(SX1276_REG_FIFO_ADDR_PTR, 0x00);
+    set_op_mode(SX1276_MODE_RXCONTINUOUS);
+    s_rx_armed = true;
   }
 
-  uint8_t irq = 0;
-  spi_read_reg(SX1276_REG_IRQ_FLAGS, &irq, 1);
-  spi_write_reg(SX1276_REG_IRQ_FLAGS, irq);
+  const uint8_t irq = wait_for_irq(SX1276_IRQ_RX_DONE | SX1276_IRQ_RX_TIMEOUT, timeout_ms);
+  if (irq == 0) return false;
 
   if (irq & SX1276_IRQ_RX_TIMEOUT) {
-    ESP_LOGW(TAG, "RX timeout");
+    DLOG(DLOG_LORA_RX_TIMEOUT);
     return false;
   }
   if (irq & SX1276_IRQ_PAYLOAD_CRC_ERROR) {
-    ESP_LOGW(TAG, "RX CRC error");
+    DLOG(DLOG_LORA_RX_CRC);
     return false;
   }
 
   uint8_t current = 0;
   uint8_t bytes = 0;
   spi_read_reg(SX1276_REG_FIFO_RX_CURRENT, &current, 1);
-  spi_read_reg(SX1276_REG_PAYLOAD_LENGTH, &bytes, 1);
+  spi_read_reg(SX1276_REG_RX_NB_BYTES, &bytes, 1);
   if (bytes > maxlen) bytes = (uint8_t)maxlen;
-
-  spi_write_reg(SX1276_REG_FIFO_ADDR_PTR, current);
-  if (spi_read_fifo(buf, bytes) != ESP_OK) {
-    return false;
+  s_rx_len = bytes;
+
+  // Calidad del paquete (SX1276 5.5.5, puerto HF): SNR en cuartos de dB;
+  // con SNR negativa el RSSI del paquete se corrige con ella.
+  uint8_t q[2] = { 0, 0 };
+  if (spi_read_reg(SX1276_REG_PKT_SNR_VALUE, q, sizeof(q)) == ESP_OK) {
+    const int8_t snr_q4 = (int8_t)q[0];
+    s_rx_snr_db = (int8_t)(snr_q4 / 4);
+    s_rx_rssi_dbm = (int16_t)(-157 + q[1] + (snr_q4 < 0 ? snr_q4 / 4 : 0));
   }
 
-  spi_write_reg(SX1276_REG_OP_MODE, SX1276_MODE_STDBY | SX1276_MODE_LONG_RANGE_MODE);
-  return true;
+  spi_write_reg(SX1276_REG_FIFO_ADDR_PTR, current);
+  return spi_read_fifo(buf, bytes) == ESP_OK;
 }
 
 #else  // APP_USE_FREERTOS == 0 (host stub)
 
+// Canal simulado: cola de tramas compartida por todos los usuarios del proceso
+// (nodo y receptor pueden correr juntos). lora_rx bloquea hasta trama o timeout.
+
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/trace_ring.h"
+
 #include <string.h>
 
 #define LORA_STUB_MAX_FRAME 64U
+#define LORA_STUB_DEPTH     8U
+
+// CPU ocupada por trama (us) emulando carga de FIFO/SPI por sondeo; 0 = nada.
+#ifndef LORA_STUB_TX_BUSY_US
+#define LORA_STUB_TX_BUSY_US 0U
+#endif
+
+typedef struct {
+  uint8_t len;
+  uint8_t data[LORA_STUB_MAX_FRAME];
+} lora_stub_frame_t;
 
-static bool s_initialized = false;
-static uint8_t s_last_frame[LORA_STUB_MAX_FRAME];
-static size_t s_last_len = 0;
-static bool s_rx_pending = false;
+static os_queue_t s_air = NULL;
+static volatile bool s_link_down = false;
+
+void lora_stub_set_link(bool up) {
+  s_link_down = !up;
+}
 
 bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, bool crc_on) {
   (void)freq_hz;
-  (void)sf;
-  (void)bw_khz;
   (void)pwr_dbm;
-  (void)crc_on;
-  s_initialized = true;
-  s_last_len = 0;
-  s_rx_pending = false;
-  return true;
+  phy_store(sf, bw_khz, crc_on);
+  energy_set_state(ENERGY_RADIO, ENERGY_RADIO_STDBY);
+  if (!s_air) s_air = os_queue_create(LORA_STUB_DEPTH, sizeof(lora_stub_frame_t));
+  return s_air != NULL;
 }
 
-bool lora_tx(const uint8_t* buf, size_t len, uint32_t timeout_ms) {
+static bool radio_tx(const uint8_t* buf, size_t len, uint32_t timeout_ms) {
   (void)timeout_ms;
-  if (!s_initialized || !buf || len == 0) return false;
+  if (!s_air || !buf || len == 0 || s_link_down) return false;
+  if (LORA_STUB_TX_BUSY_US) {
+    const uint64_t until = os_now_us() + LORA_STUB_TX_BUSY_US;
+    while (os_now_us() < until) {
+    }
+  }
+  lora_stub_frame_t f;
   if (len > LORA_STUB_MAX_FRAME) len = LORA_STUB_MAX_FRAME;
-  memcpy(s_last_frame, buf, len);
-  s_last_len = len;
-  s_rx_pending = true;
+  f.len = (uint8_t)len;
+  memcpy(f.data, buf, len);
+  // Sin receptor escuchando la trama se pierde, como en el aire.
+  os_queue_send(s_air, &f, 0U);
+  // La trama "vuela" al instante; el modelo de energía recibe el tiempo en
+  // aire real (sólo TX: el receptor del mismo proceso es otro equipo).
+  energy_account_us(ENERGY_RADIO, ENERGY_RADIO_TX, lora_time_on_air_us(len));
   return true;
 }
 
-bool lora_rx(uint8_t* buf, size_t maxlen, uint32_t timeout_ms) {
-  (void)timeout_ms;
-  if (!s_initialized || !buf || maxlen == 0) return false;
-  if (!s_rx_pending || s_last_len == 0) return false;
-  size_t copy = s_last_len;
+static bool radio_rx(uint8_t* buf, size_t maxlen, uint32_t timeout_ms) {
+  if (!s_air || !buf || maxlen == 0) return false;
+  lora_stub_frame_t f;
+  if (!os_queue_recv(s_air, &f, timeout_ms ? timeout_ms : OS_WAIT_FOREVER)) return false;
+  size_t copy = f.len;
   if (copy > maxlen) copy = maxlen;
-  memcpy(buf, s_last_frame, copy);
-  s_rx_pending = false;
+  memcpy(buf, f.data, copy);
+  s_rx_len = (uint8_t)copy;
+  // Enlace simulado: RSSI entre -75 y -65 dBm según la trama, SNR fija.
+  s_rx_rssi_dbm = (int16_t)(-75 + (int16_t)(f.data[copy - 1U] % 11U));
+  s_rx_snr_db = 9;
   return true;
 }
 
 #endif
+
+// Semtech AN1200.13, header explícito, CR 4/5, preámbulo de 8 símbolos
+// (lo que configura lora_init); LowDataRateOptimize si el símbolo > 16 ms.
+uint32_t lora_time_on_air_us(size_t len) {
+  const int32_t sf = s_phy_sf;
+  const uint32_t tsym_us = (1000U << sf) / (s_phy_bw_khz ? s_phy_bw_khz : 125U);
+  const int32_t de = tsym_us > 16000U ? 1 : 0;
+  const int32_t cr = 1;
+  const int32_t num = 8 * (int32_t)len - 4 * sf + 28 + (s_phy_crc ? 16 : 0);
+  const int32_t den = 4 * (sf - 2 * de);
+  const int32_t blocks = num > 0 ? (num + den - 1) / den : 0;
+  const uint32_t payload_sym = 8U + (uint32_t)(blocks * (cr + 4));
+  const uint32_t preamble_x4 = 8U * 4U + 17U;   // (8 + 4.25) símbolos × 4
+  return (preamble_x4 * tsym_us) / 4U + payload_sym * tsym_us;
+}
+
+// Envolturas comunes (dispositivo y stub): eventos de trace de radio.
+bool lora_tx(const uint8_t* buf, size_t len, uint32_t timeout_ms) {
+  TRACE_BEGIN_EV(TRACE_EV_LORA_TX);
+  const bool ok = radio_tx(buf, len, timeout_ms);
+  TRACE_END_EV(TRACE_EV_LORA_TX);
+  return ok;
+}
+
+bool lora_rx(uint8_t* buf, size_t maxlen, uint32_t timeout_ms) {
+  const bool ok = radio_rx(buf, maxlen, timeout_ms);
+  if (ok) TRACE_INSTANT_EV(TRACE_EV_LORA_RX, buf[0]);
+  return ok;
+}
+
+void lora_rx_quality(int16_t* rssi_dbm, int8_t* snr_db) {
+  if (rssi_dbm) *rssi_dbm = s_rx_rssi_dbm;
+  if (snr_db) *snr_db = s_rx_snr_db;
+}
+
+size_t lora_rx_len(void) {
+  return s_rx_len;
+}
@@ -4,6 +4,8 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "config/system_config.h"
+
 // Inicializa el módulo LoRa con parámetros básicos
 bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, bool crc_on);
 
@@ -11,5 +13,19 @@ bool lora_init(uint32_t freq_hz, uint8_t sf, uint8_t bw_khz, int8_t pwr_dbm, boo
 bool lora_tx(const uint8_t* buf, size_t len, uint32_t timeout_ms);
 
 // Recibe en un buffer con timeout_ms. Retorna true si hay paquete válido.
+// timeout_ms 0 u OS_WAIT_FOREVER: duerme hasta que llegue una trama (DIO0).
 bool lora_rx(uint8_t* buf, size_t maxlen, uint32_t timeout_ms);
 
+// Calidad de la última trama de lora_rx(): RSSI del paquete (dBm) y SNR (dB).
+void lora_rx_quality(int16_t* rssi_dbm, int8_t* snr_db);
+// Bytes de la última trama de lora_rx() (RegRxNbBytes, recortado a maxlen).
+size_t lora_rx_len(void);
+
+// Tiempo en aire (us) de una trama de len bytes con los parámetros de la
+// última lora_init (sin inicializar: SF7 / 125 kHz / CRC).
+uint32_t lora_time_on_air_us(size_t len);
+
+#if !APP_USE_FREERTOS
+// Stub de host: con el enlace caído lora_tx falla (fuera de alcance).
+void lora_stub_set_link(bool up);
+#endif
@@ -0,0 +1,243 @@
+#include "firmware_node/src/drivers/oled_ssd1306.h"
+
+#include "firmware_node/src/drivers/i2c_bus.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <string.h>
+
+// Fuente 5x7 ASCII 0x20..0x7E, una columna por byte (bit 0 arriba), como la GDDRAM.
+static const uint8_t k_font5x7[95][5] = {
+  { 0x00, 0x00, 0x00, 0x00, 0x00 }, { 0x00, 0x00, 0x5F, 0x00, 0x00 }, { 0x00, 0x07, 0x00, 0x07, 0x00 },
+  { 0x14, 0x7F, 0x14, 0x7F, 0x14 }, { 0x24, 0x2A, 0x7F, 0x2A, 0x12 }, { 0x23, 0x13, 0x08, 0x64, 0x62 },
+  { 0x36, 0x49, 0x55, 0x22, 0x50 }, { 0x00, 0x05, 0x03, 0x00, 0x00 }, { 0x00, 0x1C, 0x22, 0x41, 0x00 },
+  { 0x00, 0x41, 0x22, 0x1C, 0x00 }, { 0x14, 0x08, 0x3E, 0x08, 0x14 }, { 0x08, 0x08, 0x3E, 0x08, 0x08 },
+  { 0x00, 0x50, 0x30, 0x00, 0x00 }, { 0x08, 0x08, 0x08, 0x08, 0x08 }, { 0x00, 0x60, 0x60, 0x00, 0x00 },
+  { 0x20, 0x10, 0x08, 0x04, 0x02 }, { 0x3E, 0x51, 0x49, 0x45, 0x3E }, { 0x00, 0x42, 0x7F, 0x40, 0x00 },
+  { 0x42, 0x61, 0x51, 0x49, 0x46 }, { 0x21, 0x41, 0x45, 0x4B, 0x31 }, { 0x18, 0x14, 0x12, 0x7F, 0x10 },
+  { 0x27, 0x45, 0x45, 0x45, 0x39 }, { 0x3C, 0x4A, 0x49, 0x49, 0x30 }, { 0x01, 0x71, 0x09, 0x05, 0x03 },
+  { 0x36, 0x49, 0x49, 0x49, 0x36 }, { 0x06, 0x49, 0x49, 0x29, 0x1E }, { 0x00, 0x36, 0x36, 0x00, 0x00 },
+  { 0x00, 0x56, 0x36, 0x00, 0x00 }, { 0x08, 0x14, 0x22, 0x41, 0x00 }, { 0x14, 0x14, 0x14, 0x14, 0x14 },
+  { 0x00, 0x41, 0x22, 0x14, 0x08 }, { 0x02, 0x01, 0x51, 0x09, 0x06 }, { 0x32, 0x49, 0x79, 0x41, 0x3E },
+  { 0x7E, 0x11, 0x11, 0x11, 0x7E }, { 0x7F, 0x49, 0x49, 0x49, 0x36 }, { 0x3E, 0x41, 0x41, 0x41, 0x22 },
+  { 0x7F, 0x41, 0x41, 0x22, 0x1C }, { 0x7F, 0x49, 0x49, 0x49, 0x41 }, { 0x7F, 0x09, 0x09, 0x09, 0x01 },
+  { 0x3E, 0x41, 0x49, 0x49, 0x7A }, { 0x7F, 0x08, 0x08, 0x08, 0x7F }, { 0x00, 0x41, 0x7F, 0x41, 0x00 },
+  { 0x20, 0x40, 0x41, 0x3F, 0x01 }, { 0x7F, 0x08, 0x14, 0x22, 0x41 }, { 0x7F, 0x40, 0x40, 0x40, 0x40 },
+  { 0x7F, 0x02, 0x0C, 0x02, 0x7F }, { 0x7F, 0x04, 0x08, 0x10, 0x7F }, { 0x3E, 0x41, 0x41, 0x41, 0x3E },
+  { 0x7F, 0x09, 0x09, 0x09, 0x06 }, { 0x3E, 0x41, 0x51, 0x21, 0x5E }, { 0x7F, 0x09, 0x19, 0x29, 0x46 },
+  { 0x46, 0x49, 0x49, 0x49, 0x31 }, { 0x01, 0x01, 0x7F, 0x01, 0x01 }, { 0x3F, 0x40, 0x40, 0x40, 0x3F },
+  { 0x1F, 0x20, 0x40, 0x20, 0x1F }, { 0x3F, 0x40, 0x38, 0x40, 0x3F }, { 0x63, 0x14, 0x08, 0x14, 0x63 },
+  { 0x07, 0x08, 0x70, 0x08, 0x07 }, { 0x61, 0x51, 0x49, 0x45, 0x43 }, { 0x00, 0x7F, 0x41, 0x41, 0x00 },
+  { 0x02, 0x04, 0x08, 0x10, 0x20 }, { 0x00, 0x41, 0x41, 0x7F, 0x00 }, { 0x04, 0x02, 0x01, 0x02, 0x04 },
+  { 0x40, 0x40, 0x40, 0x40, 0x40 }, { 0x00, 0x01, 0x02, 0x04, 0x00 }, { 0x20, 0x54, 0x54, 0x54, 0x78 },
+  { 0x7F, 0x48, 0x44, 0x44, 0x38 }, { 0x38, 0x44, 0x44, 0x44, 0x20 }, { 0x38, 0x44, 0x44, 0x48, 0x7F },
+  { 0x38, 0x54, 0x54, 0x54, 0x18 }, { 0x08, 0x7E, 0x09, 0x01, 0x02 }, { 0x0C, 0x52, 0x52, 0x52, 0x3E },
+  { 0x7F, 0x08, 0x04, 0x04, 0x78 }, { 0x00, 0x44, 0x7D, 0x40, 0x00 }, { 0x20, 0x40, 0x44, 0x3D, 0x00 },
+  { 0x7F, 0x10, 0x28, 0x44, 0x00 }, { 0x00, 0x41, 0x7F, 0x40, 0x00 }, { 0x7C, 0x04, 0x18, 0x04, 0x78 },
+  { 0x7C, 0x08, 0x04, 0x04, 0x78 }, { 0x38, 0x44, 0x44, 0x44, 0x38 }, { 0x7C, 0x14, 0x14, 0x14, 0x08 },
+  { 0x08, 0x14, 0x14, 0x18, 0x7C }, { 0x7C, 0x08, 0x04, 0x04, 0x08 }, { 0x48, 0x54, 0x54, 0x54, 0x20 },
+  { 0x04, 0x3F, 0x44, 0x40, 0x20 }, { 0x3C, 0x40, 0x40, 0x20, 0x7C }, { 0x1C, 0x20, 0x40, 0x20, 0x1C },
+  { 0x3C, 0x40, 0x30, 0x40, 0x3C }, { 0x44, 0x28, 0x10, 0x28, 0x44 }, { 0x0C, 0x50, 0x50, 0x50, 0x3C },
+  { 0x44, 0x64, 0x54, 0x4C, 0x44 }, { 0x00, 0x08, 0x36, 0x41, 0x00 }, { 0x00, 0x00, 0x7F, 0x00, 0x00 },
+  { 0x00, 0x41, 0x36, 0x08, 0x00 }, { 0x08, 0x04, 0x08, 0x10, 0x08 },
+};
+
+#define OLED_I2C_TIMEOUT_MS 50U
+
+typedef struct {
+  uint8_t x0;   // franja sucia [x0, x1); x0 == x1: limpia
+  uint8_t x1;
+} oled_span_t;
+
+static uint8_t s_fb[OLED_FB_BYTES];
+static oled_span_t s_dirty[OLED_PAGES];
+static oled_stats_t s_stats;
+
+// Escritura de un byte del framebuffer: sólo ensucia si cambia.
+static void put(uint8_t x, uint8_t page, uint8_t v) {
+  uint8_t* b = &s_fb[page * OLED_WIDTH + x];
+  if (*b == v) return;
+  *b = v;
+  oled_span_t* d = &s_dirty[page];
+  if (d->x0 == d->x1) {
+    d->x0 = x;
+    d->x1 = (uint8_t)(x + 1U);
+  } else {
+    if (x < d->x0) d->x0 = x;
+    if (x + 1U > d->x1) d->x1 = (uint8_t)(x + 1U);
+  }
+}
+
+#if APP_USE_FREERTOS
+
+#include "config/board_pins.h"
+
+#include "esp_log.h"
+
+#define OLED_ADDR BOARD_OLED_ADDR
+
+static const char* TAG = "oled_ssd1306";
+
+static bool panel_init(void) {
+  static const uint8_t k_init[] = {
+    0x00,         // control: comandos
+    0xAE,         // display off
+    0xD5, 0x80,   // reloj
+    0xA8, 0x3F,   // multiplex 64
+    0xD3, 0x00,   // offset
+    0x40,         // línea de inicio 0
+    0x8D, 0x14,   // charge pump on
+    0x20, 0x00,   // direccionamiento horizontal
+    0xA1, 0xC8,   // espejado: (0,0) arriba a la izquierda
+    0xDA, 0x12,   // pines COM
+    0x81, 0xCF,   // contraste
+    0xD9, 0xF1,   // precarga
+    0xDB, 0x40,   // VCOMH
+    0xA4, 0xA6,   // sigue la RAM, no invertido
+    0xAF,         // display on
+  };
+  if (!i2c_bus_init()) {
+    ESP_LOGE(TAG, "bus I2C no disponible");
+    return false;
+  }
+  if (!i2c_bus_write(I2C_CLIENT_OLED, OLED_ADDR, k_init, sizeof(k_init), OLED_I2C_TIMEOUT_MS)) {
+    ESP_LOGE(TAG, "sin respuesta en 0x%02X", OLED_ADDR);
+    return false;
+  }
+  return true;
+}
+
+static void panel_shadow(uint8_t page, uint8_t x0, uint8_t x1) {
+  (void)page;
+  (void)x0;
+  (void)x1;
+}
+
+#else  // host: GDDRAM emulada (el bus de host sólo simula el tiempo)
+
+#include <stdio.h>
+
+#define OLED_ADDR 0x3CU
+
+static uint8_t s_panel[OLED_FB_BYTES];
+
+static bool panel_init(void) {
+  memset(s_panel, 0xA5, sizeof(s_panel));   // basura de encendido: el primer flush la pisa
+  return i2c_bus_init();
+}
+
+static void panel_shadow(uint8_t page, uint8_t x0, uint8_t x1) {
+  memcpy(&s_panel[page * OLED_WIDTH + x0], &s_fb[page * OLED_WIDTH + x0], (size_t)(x1 - x0));
+}
+
+const uint8_t* oled_host_panel(void) {
+  return s_panel;
+}
+
+bool oled_host_pgm(const char* path, unsigned scale) {
+  if (!path || scale == 0U || scale > 8U) return false;
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  fprintf(f, "P5\n%u %u\n255\n", OLED_WIDTH * scale, OLED_HEIGHT * scale);
+  uint8_t row[OLED_WIDTH * 8U];
+  for (unsigned y = 0; y < OLED_HEIGHT; ++y) {
+    for (unsigned x = 0; x < OLED_WIDTH; ++x) {
+      const bool on = (s_panel[(y / 8U) * OLED_WIDTH + x] >> (y % 8U)) & 1U;
+      memset(&row[x * scale], on ? 0xFF : 0x00, scale);
+    }
+    for (unsigned k = 0; k < scale; ++k) fwrite(row, 1, OLED_WIDTH * scale, f);
+  }
+  const bool ok = ferror(f) == 0;
+  fclose(f);
+  return ok;
+}
+
+#endif  // APP_USE_FREERTOS
+
+// Rango de columnas y página (comandos) y los datos de la franja, en trozos
+// de baja prioridad: el IMU puede intercalarse entre trozos.
+static bool panel_write(uint8_t page, uint8_t x0, uint8_t x1) {
+  const uint8_t cmd[] = { 0x00, 0x21, x0, (uint8_t)(x1 - 1U), 0x22, page, page };
+  if (!i2c_bus_write(I2C_CLIENT_OLED, OLED_ADDR, cmd, sizeof(cmd), OLED_I2C_TIMEOUT_MS)) return false;
+  if (!i2c_bus_write_bulk(I2C_CLIENT_OLED, OLED_ADDR, 0x40U, &s_fb[page * OLED_WIDTH + x0], (size_t)(x1 - x0),
+                          OLED_I2C_TIMEOUT_MS)) {
+    return false;
+  }
+  panel_shadow(page, x0, x1);
+  return true;
+}
+
+bool oled_init(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+  mem_report_static("oled", sizeof(s_fb) + sizeof(s_dirty) + sizeof(s_stats));
+  if (!panel_init()) return false;
+  // La GDDRAM arranca con basura: el primer flush envía el cuadro entero.
+  memset(s_fb, 0, sizeof(s_fb));
+  for (uint8_t p = 0; p < OLED_PAGES; ++p) s_dirty[p] = (oled_span_t){ 0U, (uint8_t)OLED_WIDTH };
+  return oled_flush() > 0U;
+}
+
+void oled_clear(void) {
+  for (uint8_t p = 0; p < OLED_PAGES; ++p) {
+    for (uint8_t x = 0; x < OLED_WIDTH; ++x) put(x, p, 0U);
+  }
+}
+
+void oled_text(uint8_t x, uint8_t page, const char* s, bool inv) {
+  if (!s || page >= OLED_PAGES) return;
+  const uint8_t mask = inv ? 0xFFU : 0x00U;
+  for (; *s && x < OLED_WIDTH; ++s) {
+    const uint8_t c = (uint8_t)*s;
+    const uint8_t* g = k_font5x7[(c >= 0x20U && c <= 0x7EU) ? c - 0x20U : '?' - 0x20U];
+    for (uint8_t k = 0; k < OLED_CHAR_W && x < OLED_WIDTH; ++k, ++x) {
+      put(x, page, (uint8_t)((k < 5U ? g[k] : 0U) ^ mask));
+    }
+  }
+}
+
+void oled_bar(uint8_t x, uint8_t page, uint8_t w, uint8_t fill) {
+  if (page >= OLED_PAGES || w < 2U) return;
+  for (uint8_t k = 0; k < w && x + k < OLED_WIDTH; ++k) {
+    uint8_t v = 0x41U;   // contorno arriba/abajo (filas 0 y 6)
+    if (k == 0U || k == w - 1U || k < fill) v = 0x7FU;
+    put((uint8_t)(x + k), page, v);
+  }
+}
+
+size_t oled_flush(void) {
+  const size_t chunk = i2c_bus_chunk();
+  size_t bus = 0;
+  for (uint8_t p = 0; p < OLED_PAGES; ++p) {
+    oled_span_t* d = &s_dirty[p];
+    if (d->x0 == d->x1) continue;
+    if (!panel_write(p, d->x0, d->x1)) {
+      s_stats.fails++;   // la franja queda sucia: sale en el próximo flush
+      continue;
+    }
+    const uint32_t n = (uint32_t)(d->x1 - d->x0);
+    s_stats.pages++;
+    s_stats.data_bytes += n;
+    bus += OLED_STRIP_OVERHEAD_BYTES + n;
+    if (chunk && n > chunk) bus += 2U * ((n - 1U) / chunk);   // dirección + 0x40 por trozo extra
+    d->x0 = d->x1 = 0U;
+  }
+  if (bus > 0U) {
+    s_stats.flushes++;
+    s_stats.bus_bytes += (uint32_t)bus;
+  }
+  return bus;
+}
+
+bool oled_dirty(void) {
+  for (uint8_t p = 0; p < OLED_PAGES; ++p) {
+    if (s_dirty[p].x0 != s_dirty[p].x1) return true;
+  }
+  return false;
+}
+
+void oled_stats(oled_stats_t* out) {
+  if (out) *out = s_stats;
+}
+
+const uint8_t* oled_framebuffer(void) {
+  return s_fb;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config/system_config.h"
+
+// OLED SSD1306 128x64 del TTGO (I2C compartido, ver config/board_pins.h).
+// Framebuffer en RAM con el mismo formato que la GDDRAM del controlador:
+// 8 páginas de 8 filas, un byte por columna (bit 0 = fila de arriba).
+// Dibujar sólo toca el framebuffer; cada página guarda la franja de columnas
+// [x0, x1) cuyos bytes cambiaron (rectángulo sucio recortado a la página) y
+// oled_flush() envía sólo esas franjas. Redibujar lo mismo no ensucia nada.
+// En host la "pantalla" es una copia de la GDDRAM que reciben las franjas;
+// oled_host_pgm() la vuelca a un PGM para ver la UI sin hardware.
+// Una sola tarea dibuja y envía (tsk_ui en el receptor): sin locks.
+
+#define OLED_WIDTH      128U
+#define OLED_HEIGHT     64U
+#define OLED_PAGES      (OLED_HEIGHT / 8U)
+#define OLED_FB_BYTES   (OLED_WIDTH * OLED_PAGES)
+#define OLED_CHAR_W     6U   // 5x7 + 1 columna de separación
+#define OLED_COLS       (OLED_WIDTH / OLED_CHAR_W)   // 21 caracteres por página
+
+typedef struct {
+  uint32_t flushes;       // llamadas a oled_flush con algo que enviar
+  uint32_t pages;         // franjas enviadas
+  uint32_t data_bytes;    // bytes de GDDRAM enviados
+  uint32_t bus_bytes;     // en el bus: dirección + control + comandos + datos
+  uint32_t fails;
+} oled_stats_t;
+
+// Por franja: una escritura de comandos (dirección, control 0x00, rango de
+// columnas y de página: 8 B) y una de datos (dirección, control 0x40: 2 B).
+// Los datos van en trozos de i2c_bus_chunk(): cada trozo extra suma 2 B.
+#define OLED_STRIP_OVERHEAD_BYTES 10U
+// Bytes de bus de un cuadro completo sin trocear (referencia de oled_flush incremental).
+#define OLED_FULL_FRAME_BUS_BYTES (OLED_PAGES * (OLED_STRIP_OVERHEAD_BYTES + OLED_WIDTH))
+
+// Configura el controlador y limpia la pantalla. false sin respuesta en I2C.
+bool oled_init(void);
+
+void oled_clear(void);
+// Texto ASCII (0x20..0x7E; otros como '?') en la página page desde la
+// columna x; inv dibuja en negativo. Se recorta al borde derecho.
+void oled_text(uint8_t x, uint8_t page, const char* s, bool inv);
+// Barra horizontal de w columnas en page: fill columnas llenas, el resto
+// sólo contorno.
+void oled_bar(uint8_t x, uint8_t page, uint8_t w, uint8_t fill);
+
+// Envía las franjas sucias. Devuelve los bytes de bus usados (0 si no había).
+size_t oled_flush(void);
+bool oled_dirty(void);
+
+void oled_stats(oled_stats_t* out);
+// Framebuffer actual (OLED_FB_BYTES) para verificaciones.
+const uint8_t* oled_framebuffer(void);
+
+#if !APP_USE_FREERTOS
+// GDDRAM emulada: lo que muestra el panel tras los oled_flush().
+const uint8_t* oled_host_panel(void);
+// Vuelca el panel a PGM (P5) escalado por scale (1..8). false si no se pudo escribir.
+bool oled_host_pgm(const char* path, unsigned scale);
+#endif
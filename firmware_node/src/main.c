@@ -2,12 +2,26 @@
 
 #if !APP_USE_FREERTOS
 #include <stddef.h>
+#include <stdio.h>
+
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/alert_queue.h"
+
+#ifndef APP_HOST_RUN_MS
+#define APP_HOST_RUN_MS 5000U
+#endif
 
 int main(void) {
   app_init();
-  tsk_sample_detect(NULL);
-  tsk_alert_tx(NULL);
-  tsk_blink(NULL);
+  os_run_for_ms(APP_HOST_RUN_MS);
+
+  alert_queue_stats_t st;
+  alert_queue_stats(&st);
+  const uint32_t n = st.popped[ALERT_PRIO_CRITICAL];
+  printf("[HOST] alertas=%u descartadas=%u espera_cola media=%lluus max=%uus\n",
+         (unsigned)n, (unsigned)st.dropped[ALERT_PRIO_CRITICAL],
+         (unsigned long long)(n ? st.wait_us_sum[ALERT_PRIO_CRITICAL] / n : 0U),
+         (unsigned)st.wait_us_max[ALERT_PRIO_CRITICAL]);
   return 0;
 }
 #endif
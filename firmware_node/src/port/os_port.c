@@ -0,0 +1,809 @@
+#ifndef ESP_PLATFORM
+#define _GNU_SOURCE   // pthread_setaffinity_np / CPU_SET (host)
+#endif
+#include "firmware_node/src/port/os_port.h"
+
+#include <stdatomic.h>
+
+// Reserva el próximo índice de una tabla estática. Llena: false sin tocar el
+// contador, que nunca pasa de max.
+static bool slot_alloc(atomic_uint* count, unsigned max, unsigned* idx) {
+  unsigned n = atomic_load(count);
+  do {
+    if (n >= max) return false;
+  } while (!atomic_compare_exchange_weak(count, &n, n + 1U));
+  *idx = n;
+  return true;
+}
+
+// Devuelve idx si todavía es el último reservado; si no, queda ocupado.
+static void slot_release(atomic_uint* count, unsigned idx) {
+  unsigned expected = idx + 1U;
+  (void)atomic_compare_exchange_strong(count, &expected, idx);
+}
+
+#if APP_USE_FREERTOS
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static UBaseType_t map_prio(os_prio_t prio) {
+  switch (prio) {
+    case OS_PRIO_MAX:  return configMAX_PRIORITIES - 1;
+    case OS_PRIO_HIGH: return configMAX_PRIORITIES - 2;
+    default:           return tskIDLE_PRIORITY + 1;
+  }
+}
+
+#ifndef OS_PORT_MAX_TASKS
+#define OS_PORT_MAX_TASKS 16U
+#endif
+
+static TaskHandle_t s_task_handles[OS_PORT_MAX_TASKS];
+static const char* s_task_names[OS_PORT_MAX_TASKS];
+static uint32_t s_task_stacks[OS_PORT_MAX_TASKS];
+static atomic_ullong s_task_busy_us[OS_PORT_MAX_TASKS];
+static uint64_t s_task_run_since[OS_PORT_MAX_TASKS];   // sólo lo escribe la propia tarea
+static atomic_uint s_task_count;
+// Los objetos se crean en init (salvo depuración): contadores sin lock.
+static os_heap_use_t s_heap_use[OS_OBJ_COUNT];
+
+static void heap_account(os_obj_kind_t kind, const void* handle, size_t bytes) {
+  os_heap_use_t* u = &s_heap_use[kind];
+  if (!handle) {
+    u->fails++;
+    return;
+  }
+  u->objects++;
+  u->bytes += (uint32_t)bytes;
+}
+
+static TickType_t to_ticks(uint32_t ms) {
+  return ms == OS_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(ms);
+}
+
+bool os_task_create(os_task_fn_t fn, const char* name, uint32_t stack_bytes,
+                    os_prio_t prio, int core, void* arg, os_task_t* out) {
+  if (!fn) return false;
+  const BaseType_t core_id = core == OS_CORE_ANY ? tskNO_AFFINITY : (BaseType_t)core;
+  // Registrada antes de crearla: en el otro núcleo (o con más prioridad) la
+  // tarea corre antes de que xTaskCreatePinnedToCore vuelva, y su primera
+  // espera (busy_stop) ya debe encontrar su índice. FreeRTOS escribe el
+  // handle en la tabla antes de dejar la tarea lista para correr.
+  unsigned idx = 0;
+  const bool registered = slot_alloc(&s_task_count, OS_PORT_MAX_TASKS, &idx);
+  TaskHandle_t local = NULL;
+  TaskHandle_t* handle = registered ? &s_task_handles[idx] : &local;
+  if (registered) {
+    s_task_names[idx] = name;
+    s_task_stacks[idx] = stack_bytes;
+    s_task_run_since[idx] = (uint64_t)esp_timer_get_time();
+  }
+  if (xTaskCreatePinnedToCore(fn, name, stack_bytes, arg, map_prio(prio), handle, core_id) != pdPASS) {
+    if (registered) {
+      *handle = NULL;
+      slot_release(&s_task_count, idx);
+    }
+    heap_account(OS_OBJ_TASK, NULL, 0U);
+    return false;
+  }
+  heap_account(OS_OBJ_TASK, *handle, stack_bytes + sizeof(StaticTask_t));
+  if (out) *out = (os_task_t)*handle;
+  return true;
+}
+
+os_task_t os_task_self(void) {
+  return (os_task_t)xTaskGetCurrentTaskHandle();
+}
+
+int os_task_index(void) {
+  if (xPortInIsrContext()) return -1;
+  const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  for (unsigned i = 0; i < s_task_count; ++i) {
+    if (s_task_handles[i] == self) return (int)i;
+  }
+  return -1;
+}
+
+const char* os_task_name(int index) {
+  return (index >= 0 && (unsigned)index < s_task_count) ? s_task_names[index] : NULL;
+}
+
+bool os_task_stack_info(int index, uint32_t* size_bytes, uint32_t* min_free_bytes) {
+  if (index < 0 || (unsigned)index >= s_task_count) return false;
+  // En ESP-IDF el stack se mide en bytes (StackType_t = uint8_t).
+  if (size_bytes) *size_bytes = s_task_stacks[index];
+  if (min_free_bytes) *min_free_bytes = (uint32_t)uxTaskGetStackHighWaterMark(s_task_handles[index]);
+  return true;
+}
+
+uint64_t os_task_busy_us(int index) {
+  if (index < 0 || (unsigned)index >= s_task_count) return 0U;
+  return atomic_load_explicit(&s_task_busy_us[index], memory_order_relaxed);
+}
+
+// Antes/después de cada espera bloqueante: acumula el tramo "despierta".
+static void busy_stop(void) {
+  const int idx = os_task_index();
+  if (idx < 0) return;
+  const uint64_t now = (uint64_t)esp_timer_get_time();
+  atomic_fetch_add_explicit(&s_task_busy_us[idx], now - s_task_run_since[idx], memory_order_relaxed);
+}
+
+static void busy_start(void) {
+  const int idx = os_task_index();
+  if (idx >= 0) s_task_run_since[idx] = (uint64_t)esp_timer_get_time();
+}
+
+bool os_running(void) {
+  return true;
+}
+
+uint64_t os_now_us(void) {
+  return (uint64_t)esp_timer_get_time();
+}
+
+os_tick_t os_ticks_now(void) {
+  return (os_tick_t)xTaskGetTickCount();
+}
+
+void os_delay_ms(uint32_t ms) {
+  busy_stop();
+  vTaskDelay(pdMS_TO_TICKS(ms));
+  busy_start();
+}
+
+void os_delay_until(os_tick_t* last, uint32_t period_ms) {
+  TickType_t ref = (TickType_t)*last;
+  busy_stop();
+  xTaskDelayUntil(&ref, pdMS_TO_TICKS(period_ms));
+  busy_start();
+  *last = (os_tick_t)ref;
+}
+
+os_queue_t os_queue_create(size_t depth, size_t item_size) {
+  const QueueHandle_t q = xQueueCreate((UBaseType_t)depth, (UBaseType_t)item_size);
+  heap_account(OS_OBJ_QUEUE, q, depth * item_size + sizeof(StaticQueue_t));
+  return (os_queue_t)q;
+}
+
+bool os_queue_send(os_queue_t q, const void* item, uint32_t timeout_ms) {
+  if (!q) return false;
+  busy_stop();
+  const bool ok = xQueueSend((QueueHandle_t)q, item, to_ticks(timeout_ms)) == pdTRUE;
+  busy_start();
+  return ok;
+}
+
+bool os_queue_send_from_isr(os_queue_t q, const void* item) {
+  if (!q) return false;
+  BaseType_t hp_woken = pdFALSE;
+  const bool ok = xQueueSendFromISR((QueueHandle_t)q, item, &hp_woken) == pdTRUE;
+  portYIELD_FROM_ISR(hp_woken);
+  return ok;
+}
+
+bool os_queue_recv(os_queue_t q, void* item, uint32_t timeout_ms) {
+  if (!q) return false;
+  busy_stop();
+  const bool ok = xQueueReceive((QueueHandle_t)q, item, to_ticks(timeout_ms)) == pdTRUE;
+  busy_start();
+  return ok;
+}
+
+os_sem_t os_sem_create(void) {
+  const SemaphoreHandle_t s = xSemaphoreCreateBinary();
+  heap_account(OS_OBJ_SEM, s, sizeof(StaticSemaphore_t));
+  return (os_sem_t)s;
+}
+
+void os_sem_give(os_sem_t s) {
+  if (!s) return;
+  if (xPortInIsrContext()) {
+    BaseType_t hp_woken = pdFALSE;
+    xSemaphoreGiveFromISR((SemaphoreHandle_t)s, &hp_woken);
+    portYIELD_FROM_ISR(hp_woken);
+  } else {
+    xSemaphoreGive((SemaphoreHandle_t)s);
+  }
+}
+
+bool os_sem_take(os_sem_t s, uint32_t timeout_ms) {
+  if (!s) return false;
+  busy_stop();
+  const bool ok = xSemaphoreTake((SemaphoreHandle_t)s, to_ticks(timeout_ms)) == pdTRUE;
+  busy_start();
+  return ok;
+}
+
+void os_notify(os_task_t t) {
+  if (!t) return;
+  if (xPortInIsrContext()) {
+    BaseType_t hp_woken = pdFALSE;
+    vTaskNotifyGiveFromISR((TaskHandle_t)t, &hp_woken);
+    portYIELD_FROM_ISR(hp_woken);
+  } else {
+    xTaskNotifyGive((TaskHandle_t)t);
+  }
+}
+
+uint32_t os_notify_take(uint32_t timeout_ms) {
+  busy_stop();
+  const uint32_t got = (uint32_t)ulTaskNotifyTake(pdTRUE, to_ticks(timeout_ms));
+  busy_start();
+  return got;
+}
+
+os_evt_t os_evt_create(void) {
+  const EventGroupHandle_t e = xEventGroupCreate();
+  heap_account(OS_OBJ_EVT, e, sizeof(StaticEventGroup_t));
+  return (os_evt_t)e;
+}
+
+void os_evt_set(os_evt_t e, uint32_t bits) {
+  if (!e) return;
+  if (xPortInIsrContext()) {
+    BaseType_t hp_woken = pdFALSE;
+    xEventGroupSetBitsFromISR((EventGroupHandle_t)e, (EventBits_t)bits, &hp_woken);
+    portYIELD_FROM_ISR(hp_woken);
+  } else {
+    xEventGroupSetBits((EventGroupHandle_t)e, (EventBits_t)bits);
+  }
+}
+
+uint32_t os_evt_wait(os_evt_t e, uint32_t bits, uint32_t timeout_ms) {
+  if (!e) return 0U;
+  busy_stop();
+  const EventBits_t got = xEventGroupWaitBits((EventGroupHandle_t)e, (EventBits_t)bits,
+                                              pdTRUE, pdFALSE, to_ticks(timeout_ms));
+  busy_start();
+  return (uint32_t)(got & bits);
+}
+
+void os_heap_usage(os_obj_kind_t kind, os_heap_use_t* out) {
+  if (!out) return;
+  *out = (unsigned)kind < OS_OBJ_COUNT ? s_heap_use[kind] : (os_heap_use_t){ 0 };
+}
+
+#else  // APP_USE_FREERTOS == 0 (pthreads)
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef OS_PORT_MAX_TASKS
+#define OS_PORT_MAX_TASKS 16U
+#endif
+#ifndef OS_PORT_MAX_QUEUES
+#define OS_PORT_MAX_QUEUES 16U
+#endif
+#ifndef OS_PORT_MAX_SEMS
+#define OS_PORT_MAX_SEMS 16U
+#endif
+#ifndef OS_PORT_MAX_EVTS
+#define OS_PORT_MAX_EVTS 8U
+#endif
+
+// Stack host = pedido × escala (x86-64/glibc usa bastante más stack que el
+// Xtensa para el mismo código), nunca menos de OS_PORT_HOST_STACK_MIN. Se
+// pinta con OS_PORT_STACK_FILL para medir el high-water mark.
+#ifndef OS_PORT_HOST_STACK_SCALE
+#define OS_PORT_HOST_STACK_SCALE 4U
+#endif
+#ifndef OS_PORT_HOST_STACK_MIN
+#define OS_PORT_HOST_STACK_MIN (64U * 1024U)
+#endif
+#define OS_PORT_STACK_FILL 0xA5U
+
+struct os_task_s {
+  pthread_t thread;
+  os_task_fn_t fn;
+  void* arg;
+  const char* name;
+  int core;
+  uint8_t* stack;
+  size_t stack_size;
+  atomic_ullong busy_us;
+  uint64_t run_since_us;   // sólo lo escribe la propia tarea
+  pthread_mutex_t mtx;
+  pthread_cond_t cv;
+  uint32_t notify;
+  bool started;
+};
+
+struct os_queue_s {
+  pthread_mutex_t mtx;
+  pthread_cond_t not_empty;
+  pthread_cond_t not_full;
+  uint8_t* buf;
+  size_t item_size;
+  size_t depth;
+  size_t head;
+  size_t count;
+};
+
+struct os_sem_s {
+  pthread_mutex_t mtx;
+  pthread_cond_t cv;
+  bool given;
+};
+
+struct os_evt_s {
+  pthread_mutex_t mtx;
+  pthread_cond_t cv;
+  uint32_t bits;
+};
+
+typedef struct {
+  struct timespec deadline;
+  uint32_t timeout_ms;
+} wait_t;
+
+static struct os_task_s s_tasks[OS_PORT_MAX_TASKS];
+static struct os_queue_s s_queues[OS_PORT_MAX_QUEUES];
+static struct os_sem_s s_sems[OS_PORT_MAX_SEMS];
+static atomic_uint s_task_count;
+static atomic_uint s_queue_count;
+static atomic_uint s_sem_count;
+static struct os_evt_s s_evts[OS_PORT_MAX_EVTS];
+static atomic_uint s_evt_count;
+static atomic_uint s_heap_objects[OS_OBJ_COUNT];
+static atomic_uint s_heap_bytes[OS_OBJ_COUNT];
+static atomic_uint s_heap_fails[OS_OBJ_COUNT];
+
+static atomic_bool s_stop;
+static pthread_mutex_t s_stop_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_stop_cv;
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+static struct timespec s_t0;
+static bool s_fifo_warned = false;
+static __thread struct os_task_s* s_self = NULL;
+
+static void cond_init_monotonic(pthread_cond_t* cv) {
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cv, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+static void port_init_once(void) {
+  clock_gettime(CLOCK_MONOTONIC, &s_t0);
+  cond_init_monotonic(&s_stop_cv);
+}
+
+static void port_init(void) {
+  pthread_once(&s_once, port_init_once);
+}
+
+static void timespec_add_ms(struct timespec* ts, uint32_t ms) {
+  ts->tv_sec += (time_t)(ms / 1000U);
+  ts->tv_nsec += (long)((ms % 1000U) * 1000000L);
+  if (ts->tv_nsec >= 1000000000L) {
+    ts->tv_sec += 1;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+static void wait_begin(wait_t* w, uint32_t timeout_ms) {
+  w->timeout_ms = timeout_ms;
+  if (timeout_ms != OS_WAIT_FOREVER) {
+    clock_gettime(CLOCK_MONOTONIC, &w->deadline);
+    timespec_add_ms(&w->deadline, timeout_ms);
+  }
+}
+
+// Antes/después de cada espera bloqueante: acumula el tramo "despierta".
+static void busy_stop(void) {
+  struct os_task_s* t = s_self;
+  if (!t) return;
+  atomic_fetch_add_explicit(&t->busy_us, os_now_us() - t->run_since_us, memory_order_relaxed);
+}
+
+static void busy_start(void) {
+  if (s_self) s_self->run_since_us = os_now_us();
+}
+
+// Un paso de espera sobre cv (mtx tomado). false: timeout o stop; el
+// llamador re-evalúa su condición en cualquier caso.
+static bool wait_step(wait_t* w, pthread_cond_t* cv, pthread_mutex_t* mtx) {
+  if (atomic_load(&s_stop) || w->timeout_ms == 0U) return false;
+  busy_stop();
+  const int rc = w->timeout_ms == OS_WAIT_FOREVER ? pthread_cond_wait(cv, mtx)
+                                                  : pthread_cond_timedwait(cv, mtx, &w->deadline);
+  busy_start();
+  return rc != ETIMEDOUT && !atomic_load(&s_stop);
+}
+
+// Núcleo fijo como en xTaskCreatePinnedToCore; si el host no tiene ese CPU la
+// tarea queda sin afinidad (misma topología lógica, sin aislamiento real).
+static void pin_to_core(int core) {
+  static atomic_bool warned;
+  if (core == OS_CORE_ANY) return;
+  const long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  if (core < 0 || core >= ncpu) {
+    if (!atomic_exchange(&warned, true)) {
+      fprintf(stderr, "[os_port] core %d no existe (%ld CPU), sin afinidad\n", core, ncpu);
+    }
+    return;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+static void* task_trampoline(void* arg) {
+  struct os_task_s* t = (struct os_task_s*)arg;
+  s_self = t;
+  t->run_since_us = os_now_us();
+  pin_to_core(t->core);
+  t->fn(t->arg);
+  return NULL;
+}
+
+static void heap_account(os_obj_kind_t kind, bool ok, size_t bytes) {
+  if (!ok) {
+    atomic_fetch_add_explicit(&s_heap_fails[kind], 1U, memory_order_relaxed);
+    return;
+  }
+  atomic_fetch_add_explicit(&s_heap_objects[kind], 1U, memory_order_relaxed);
+  atomic_fetch_add_explicit(&s_heap_bytes[kind], (unsigned)bytes, memory_order_relaxed);
+}
+
+static size_t host_stack_size(uint32_t stack_bytes) {
+  size_t size = (size_t)stack_bytes * OS_PORT_HOST_STACK_SCALE;
+  if (size < OS_PORT_HOST_STACK_MIN) size = OS_PORT_HOST_STACK_MIN;
+  if (size < (size_t)PTHREAD_STACK_MIN) size = (size_t)PTHREAD_STACK_MIN;
+  return (size + 4095U) & ~(size_t)4095U;
+}
+
+static int map_fifo_prio(os_prio_t prio) {
+  const int lo = sched_get_priority_min(SCHED_FIFO);
+  switch (prio) {
+    case OS_PRIO_MAX:  return lo + 30;
+    case OS_PRIO_HIGH: return lo + 20;
+    default:           return lo + 10;
+  }
+}
+
+bool os_task_create(os_task_fn_t fn, const char* name, uint32_t stack_bytes,
+                    os_prio_t prio, int core, void* arg, os_task_t* out) {
+  port_init();
+  unsigned idx = 0;
+  if (!fn) return false;
+  if (!slot_alloc(&s_task_count, OS_PORT_MAX_TASKS, &idx)) {
+    heap_account(OS_OBJ_TASK, false, 0U);
+    return false;
+  }
+
+  struct os_task_s* t = &s_tasks[idx];
+  t->fn = fn;
+  t->arg = arg;
+  t->name = name;
+  t->core = core;
+  t->notify = 0U;
+  t->stack_size = host_stack_size(stack_bytes);
+  void* stack = NULL;
+  if (posix_memalign(&stack, 4096U, t->stack_size) != 0) {
+    heap_account(OS_OBJ_TASK, false, 0U);
+    slot_release(&s_task_count, idx);
+    return false;
+  }
+  t->stack = stack;
+  memset(t->stack, OS_PORT_STACK_FILL, t->stack_size);
+  pthread_mutex_init(&t->mtx, NULL);
+  cond_init_monotonic(&t->cv);
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, t->stack, t->stack_size);
+  pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+  pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+  struct sched_param sp = { .sched_priority = map_fifo_prio(prio) };
+  pthread_attr_setschedparam(&attr, &sp);
+  int rc = pthread_create(&t->thread, &attr, task_trampoline, t);
+  if (rc == EPERM) {
+    // Sin CAP_SYS_NICE: misma topología, planificador por defecto.
+    if (!s_fifo_warned) {
+      s_fifo_warned = true;
+      fprintf(stderr, "[os_port] SCHED_FIFO no disponible, usando SCHED_OTHER\n");
+    }
+    pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+    rc = pthread_create(&t->thread, &attr, task_trampoline, t);
+  }
+  pthread_attr_destroy(&attr);
+  if (rc != 0) {
+    pthread_cond_destroy(&t->cv);
+    pthread_mutex_destroy(&t->mtx);
+    free(t->stack);
+    t->stack = NULL;
+    heap_account(OS_OBJ_TASK, false, 0U);
+    slot_release(&s_task_count, idx);
+    return false;
+  }
+  heap_account(OS_OBJ_TASK, true, t->stack_size);
+  t->started = true;
+  if (out) *out = t;
+  return true;
+}
+
+os_task_t os_task_self(void) {
+  return s_self;
+}
+
+int os_task_index(void) {
+  return s_self ? (int)(s_self - s_tasks) : -1;
+}
+
+const char* os_task_name(int index) {
+  const unsigned n = atomic_load(&s_task_count);
+  if (index < 0 || (unsigned)index >= n || (unsigned)index >= OS_PORT_MAX_TASKS) return NULL;
+  return s_tasks[index].name;
+}
+
+// El stack crece hacia abajo: los bytes pintados que sobreviven al fondo
+// son el mínimo libre histórico.
+bool os_task_stack_info(int index, uint32_t* size_bytes, uint32_t* min_free_bytes) {
+  if (!os_task_name(index)) return false;
+  const struct os_task_s* t = &s_tasks[index];
+  size_t free_bytes = 0;
+  while (free_bytes < t->stack_size && t->stack[free_bytes] == OS_PORT_STACK_FILL) free_bytes++;
+  if (size_bytes) *size_bytes = (uint32_t)t->stack_size;
+  if (min_free_bytes) *min_free_bytes = (uint32_t)free_bytes;
+  return true;
+}
+
+uint64_t os_task_busy_us(int index) {
+  if (!os_task_name(index)) return 0U;
+  return atomic_load_explicit(&s_tasks[index].busy_us, memory_order_relaxed);
+}
+
+bool os_running(void) {
+  return !atomic_load(&s_stop);
+}
+
+uint64_t os_now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+os_tick_t os_ticks_now(void) {
+  port_init();
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  const int64_t ms = (int64_t)(ts.tv_sec - s_t0.tv_sec) * 1000 + (ts.tv_nsec - s_t0.tv_nsec) / 1000000L;
+  return (os_tick_t)ms;
+}
+
+// Duerme hasta el tick absoluto target; stop lo interrumpe.
+static void sleep_until_tick(os_tick_t target) {
+  port_init();
+  struct timespec deadline = s_t0;
+  timespec_add_ms(&deadline, target);
+  pthread_mutex_lock(&s_stop_mtx);
+  while (!atomic_load(&s_stop)) {
+    if (pthread_cond_timedwait(&s_stop_cv, &s_stop_mtx, &deadline) == ETIMEDOUT) break;
+  }
+  pthread_mutex_unlock(&s_stop_mtx);
+}
+
+void os_delay_ms(uint32_t ms) {
+  busy_stop();
+  sleep_until_tick(os_ticks_now() + ms);
+  busy_start();
+}
+
+void os_delay_until(os_tick_t* last, uint32_t period_ms) {
+  *last += period_ms;
+  if ((int32_t)(*last - os_ticks_now()) > 0) {
+    busy_stop();
+    sleep_until_tick(*last);
+    busy_start();
+  }
+}
+
+os_queue_t os_queue_create(size_t depth, size_t item_size) {
+  unsigned idx = 0;
+  if (depth == 0U || item_size == 0U) return NULL;
+  if (!slot_alloc(&s_queue_count, OS_PORT_MAX_QUEUES, &idx)) {
+    heap_account(OS_OBJ_QUEUE, false, 0U);
+    return NULL;
+  }
+  struct os_queue_s* q = &s_queues[idx];
+  pthread_mutex_init(&q->mtx, NULL);
+  cond_init_monotonic(&q->not_empty);
+  cond_init_monotonic(&q->not_full);
+  q->buf = malloc(depth * item_size);
+  heap_account(OS_OBJ_QUEUE, q->buf != NULL, depth * item_size);
+  if (!q->buf) {
+    slot_release(&s_queue_count, idx);
+    return NULL;
+  }
+  q->depth = depth;
+  q->item_size = item_size;
+  q->head = 0U;
+  q->count = 0U;
+  return q;
+}
+
+bool os_queue_send(os_queue_t q, const void* item, uint32_t timeout_ms) {
+  if (!q || !item) return false;
+  wait_t w;
+  wait_begin(&w, timeout_ms);
+  pthread_mutex_lock(&q->mtx);
+  while (q->count >= q->depth && wait_step(&w, &q->not_full, &q->mtx)) {
+  }
+  const bool ok = q->count < q->depth;
+  if (ok) {
+    const size_t tail = (q->head + q->count) % q->depth;
+    memcpy(q->buf + tail * q->item_size, item, q->item_size);
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+  }
+  pthread_mutex_unlock(&q->mtx);
+  return ok;
+}
+
+bool os_queue_send_from_isr(os_queue_t q, const void* item) {
+  return os_queue_send(q, item, 0U);
+}
+
+bool os_queue_recv(os_queue_t q, void* item, uint32_t timeout_ms) {
+  if (!q || !item) return false;
+  wait_t w;
+  wait_begin(&w, timeout_ms);
+  pthread_mutex_lock(&q->mtx);
+  while (q->count == 0U && wait_step(&w, &q->not_empty, &q->mtx)) {
+  }
+  const bool ok = q->count > 0U;
+  if (ok) {
+    memcpy(item, q->buf + q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1U) % q->depth;
+    q->count--;
+    pthread_cond_signal(&q->not_full);
+  }
+  pthread_mutex_unlock(&q->mtx);
+  return ok;
+}
+
+os_sem_t os_sem_create(void) {
+  unsigned idx = 0;
+  const bool ok = slot_alloc(&s_sem_count, OS_PORT_MAX_SEMS, &idx);
+  heap_account(OS_OBJ_SEM, ok, 0U);   // tabla estática en host
+  if (!ok) return NULL;
+  struct os_sem_s* s = &s_sems[idx];
+  pthread_mutex_init(&s->mtx, NULL);
+  cond_init_monotonic(&s->cv);
+  s->given = false;
+  return s;
+}
+
+void os_sem_give(os_sem_t s) {
+  if (!s) return;
+  pthread_mutex_lock(&s->mtx);
+  s->given = true;
+  pthread_cond_signal(&s->cv);
+  pthread_mutex_unlock(&s->mtx);
+}
+
+bool os_sem_take(os_sem_t s, uint32_t timeout_ms) {
+  if (!s) return false;
+  wait_t w;
+  wait_begin(&w, timeout_ms);
+  pthread_mutex_lock(&s->mtx);
+  while (!s->given && wait_step(&w, &s->cv, &s->mtx)) {
+  }
+  const bool ok = s->given;
+  s->given = false;
+  pthread_mutex_unlock(&s->mtx);
+  return ok;
+}
+
+void os_notify(os_task_t t) {
+  if (!t) return;
+  pthread_mutex_lock(&t->mtx);
+  t->notify++;
+  pthread_cond_signal(&t->cv);
+  pthread_mutex_unlock(&t->mtx);
+}
+
+uint32_t os_notify_take(uint32_t timeout_ms) {
+  struct os_task_s* t = s_self;
+  if (!t) return 0U;
+  wait_t w;
+  wait_begin(&w, timeout_ms);
+  pthread_mutex_lock(&t->mtx);
+  while (t->notify == 0U && wait_step(&w, &t->cv, &t->mtx)) {
+  }
+  const uint32_t got = t->notify;
+  t->notify = 0U;
+  pthread_mutex_unlock(&t->mtx);
+  return got;
+}
+
+os_evt_t os_evt_create(void) {
+  unsigned idx = 0;
+  const bool ok = slot_alloc(&s_evt_count, OS_PORT_MAX_EVTS, &idx);
+  heap_account(OS_OBJ_EVT, ok, 0U);   // tabla estática en host
+  if (!ok) return NULL;
+  struct os_evt_s* e = &s_evts[idx];
+  pthread_mutex_init(&e->mtx, NULL);
+  cond_init_monotonic(&e->cv);
+  e->bits = 0U;
+  return e;
+}
+
+void os_evt_set(os_evt_t e, uint32_t bits) {
+  if (!e) return;
+  pthread_mutex_lock(&e->mtx);
+  e->bits |= bits;
+  pthread_cond_broadcast(&e->cv);
+  pthread_mutex_unlock(&e->mtx);
+}
+
+uint32_t os_evt_wait(os_evt_t e, uint32_t bits, uint32_t timeout_ms) {
+  if (!e) return 0U;
+  wait_t w;
+  wait_begin(&w, timeout_ms);
+  pthread_mutex_lock(&e->mtx);
+  while ((e->bits & bits) == 0U && wait_step(&w, &e->cv, &e->mtx)) {
+  }
+  const uint32_t got = e->bits & bits;
+  e->bits &= ~bits;
+  pthread_mutex_unlock(&e->mtx);
+  return got;
+}
+
+void os_heap_usage(os_obj_kind_t kind, os_heap_use_t* out) {
+  if (!out) return;
+  if ((unsigned)kind >= OS_OBJ_COUNT) {
+    *out = (os_heap_use_t){ 0 };
+    return;
+  }
+  out->objects = atomic_load_explicit(&s_heap_objects[kind], memory_order_relaxed);
+  out->bytes = atomic_load_explicit(&s_heap_bytes[kind], memory_order_relaxed);
+  out->fails = atomic_load_explicit(&s_heap_fails[kind], memory_order_relaxed);
+}
+
+static void broadcast_locked(pthread_mutex_t* mtx, pthread_cond_t* cv) {
+  pthread_mutex_lock(mtx);
+  pthread_cond_broadcast(cv);
+  pthread_mutex_unlock(mtx);
+}
+
+void os_run_for_ms(uint32_t ms) {
+  port_init();
+  os_delay_ms(ms);
+
+  atomic_store(&s_stop, true);
+  broadcast_locked(&s_stop_mtx, &s_stop_cv);
+  const unsigned n_tasks = atomic_load(&s_task_count);
+  const unsigned n_queues = atomic_load(&s_queue_count);
+  const unsigned n_sems = atomic_load(&s_sem_count);
+  const unsigned n_evts = atomic_load(&s_evt_count);
+
+  for (unsigned i = 0; i < n_tasks; ++i) broadcast_locked(&s_tasks[i].mtx, &s_tasks[i].cv);
+  for (unsigned i = 0; i < n_queues; ++i) {
+    broadcast_locked(&s_queues[i].mtx, &s_queues[i].not_empty);
+    broadcast_locked(&s_queues[i].mtx, &s_queues[i].not_full);
+  }
+  for (unsigned i = 0; i < n_sems; ++i) broadcast_locked(&s_sems[i].mtx, &s_sems[i].cv);
+  for (unsigned i = 0; i < n_evts; ++i) broadcast_locked(&s_evts[i].mtx, &s_evts[i].cv);
+  for (unsigned i = 0; i < n_tasks; ++i) {
+    if (s_tasks[i].started) pthread_join(s_tasks[i].thread, NULL);
+  }
+}
+
+#endif
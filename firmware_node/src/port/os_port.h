@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config/system_config.h"
+
+// Capa de portabilidad RTOS usada por app.c / app_rx.c y los servicios.
+// APP_USE_FREERTOS=1 → FreeRTOS (ESP-IDF).
+// APP_USE_FREERTOS=0 → pthreads: SCHED_FIFO si hay permisos, bloqueo con
+//                      variables de condición (sin sleeps de sondeo).
+
+#define OS_WAIT_FOREVER UINT32_MAX
+#define OS_CORE_ANY     (-1)
+
+typedef enum {
+  OS_PRIO_LOW = 0,    // blink, ui
+  OS_PRIO_HIGH,       // sample_detect, lora_rx
+  OS_PRIO_MAX         // alert_tx
+} os_prio_t;
+
+typedef uint32_t os_tick_t;
+typedef struct os_task_s* os_task_t;
+typedef struct os_queue_s* os_queue_t;
+typedef struct os_sem_s* os_sem_t;
+typedef struct os_evt_s* os_evt_t;
+typedef void (*os_task_fn_t)(void* arg);
+
+// --- Tareas ---
+// core: núcleo fijo (ESP32: 0 = PRO, 1 = APP) u OS_CORE_ANY. En host se
+// traduce a afinidad de CPU si ese CPU existe.
+bool os_task_create(os_task_fn_t fn, const char* name, uint32_t stack_bytes,
+                    os_prio_t prio, int core, void* arg, os_task_t* out);
+os_task_t os_task_self(void);
+// Índice (orden de creación) de la tarea actual; -1 en ISR o tarea ajena a os_port.
+int os_task_index(void);
+const char* os_task_name(int index);   // NULL si el índice no existe
+// Stack reservado y mínimo libre histórico (high-water mark) de la tarea
+// index, en bytes. En host el stack es el pintado por os_port (ver
+// OS_PORT_HOST_STACK_SCALE), no el pedido. false si el índice no existe.
+bool os_task_stack_info(int index, uint32_t* size_bytes, uint32_t* min_free_bytes);
+// Tiempo acumulado fuera de las esperas de os_port (colas, semáforos,
+// notificaciones, eventos, delays): ejecución + preempción. 0 si no existe.
+uint64_t os_task_busy_us(int index);
+// false cuando el host pidió detener la simulación (siempre true en FreeRTOS).
+bool os_running(void);
+
+// --- Tiempo ---
+uint64_t os_now_us(void);
+os_tick_t os_ticks_now(void);
+void os_delay_ms(uint32_t ms);
+// Periodo exacto sin deriva; *last se inicializa con os_ticks_now().
+void os_delay_until(os_tick_t* last, uint32_t period_ms);
+
+// --- Colas (copia por valor, FIFO) ---
+os_queue_t os_queue_create(size_t depth, size_t item_size);
+bool os_queue_send(os_queue_t q, const void* item, uint32_t timeout_ms);
+bool os_queue_send_from_isr(os_queue_t q, const void* item);
+bool os_queue_recv(os_queue_t q, void* item, uint32_t timeout_ms);
+
+// --- Semáforo binario (señal "hay trabajo") ---
+os_sem_t os_sem_create(void);
+void os_sem_give(os_sem_t s);           // detecta contexto ISR en FreeRTOS
+bool os_sem_take(os_sem_t s, uint32_t timeout_ms);
+
+// --- Notificaciones directas a tarea (contador) ---
+void os_notify(os_task_t t);            // detecta contexto ISR en FreeRTOS
+uint32_t os_notify_take(uint32_t timeout_ms);
+
+// --- Grupo de eventos (hasta 24 bits) ---
+os_evt_t os_evt_create(void);
+void os_evt_set(os_evt_t e, uint32_t bits);   // detecta contexto ISR en FreeRTOS
+// Espera cualquiera de bits; los limpia al salir. Retorna los bits activos
+// (0 si venció el timeout).
+uint32_t os_evt_wait(os_evt_t e, uint32_t bits, uint32_t timeout_ms);
+
+// --- Contabilidad de heap de los objetos creados por os_port ---
+typedef enum {
+  OS_OBJ_TASK = 0,   // stack + TCB
+  OS_OBJ_QUEUE,      // almacenamiento + control
+  OS_OBJ_SEM,
+  OS_OBJ_EVT,
+  OS_OBJ_COUNT
+} os_obj_kind_t;
+
+typedef struct {
+  uint32_t objects;
+  uint32_t bytes;    // sin el overhead del allocator
+  uint32_t fails;
+} os_heap_use_t;
+
+void os_heap_usage(os_obj_kind_t kind, os_heap_use_t* out);
+
+#if !APP_USE_FREERTOS
+// Solo host: detiene todas las tareas tras ms, despierta bloqueos y hace join.
+void os_run_for_ms(uint32_t ms);
+#endif
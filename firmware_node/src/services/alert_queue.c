@@ -1,101 +1,207 @@
-#include "config/system_config.h"
 #include "firmware_node/src/services/alert_queue.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/mem_report.h"
 
-#if APP_USE_FREERTOS
+#include <stdatomic.h>
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
+#if (ALERT_QUEUE_LANE_CAP & (ALERT_QUEUE_LANE_CAP - 1U)) != 0U
+#error "ALERT_QUEUE_LANE_CAP debe ser potencia de 2"
+#endif
 
-static QueueHandle_t s_queue = NULL;
+typedef struct {
+  atomic_uint seq;
+  fall_event_t evt;
+  uint64_t push_us;
+} aq_cell_t;
+
+typedef struct {
+  aq_cell_t cells[ALERT_QUEUE_LANE_CAP];
+  atomic_uint enq_pos;
+  atomic_uint deq_pos;
+  atomic_uint pushed;
+  atomic_uint popped;
+  atomic_uint dropped;
+  atomic_uint high_water;
+  // Sólo el consumidor los escribe; atómicos de 32 bits para que
+  // alert_queue_stats no lea una suma a medias (uint64 no es atómico en el ESP32).
+  atomic_uint wait_us_sum;
+  atomic_uint wait_us_max;
+} aq_lane_t;
+
+static aq_lane_t s_lanes[ALERT_PRIO_COUNT];
+static unsigned s_mask = 0;
+static bool s_ready = false;
+// El consumidor lo marca antes de bloquearse: push sólo señaliza si hace falta.
+static atomic_uint s_consumer_waiting;
+static os_sem_t s_wake = NULL;
+
+static unsigned round_capacity(size_t capacity) {
+  unsigned cap = 1U;
+  while (cap < capacity && cap < ALERT_QUEUE_LANE_CAP) cap <<= 1;
+  return cap;
+}
 
-void alert_queue_init(size_t capacity) {
-  if (capacity == 0) capacity = 1;
-  if (capacity > 16) capacity = 16;
-  if (s_queue) {
-    vQueueDelete(s_queue);
+size_t alert_queue_init(size_t capacity) {
+  const unsigned cap = round_capacity(capacity);
+  mem_report_static("alert_queue", sizeof(s_lanes));
+  s_ready = false;
+  for (unsigned p = 0; p < ALERT_PRIO_COUNT; ++p) {
+    aq_lane_t* lane = &s_lanes[p];
+    for (unsigned i = 0; i < cap; ++i) {
+      atomic_store_explicit(&lane->cells[i].seq, i, memory_order_relaxed);
+    }
+    atomic_store_explicit(&lane->enq_pos, 0U, memory_order_relaxed);
+    atomic_store_explicit(&lane->deq_pos, 0U, memory_order_relaxed);
+    atomic_store_explicit(&lane->pushed, 0U, memory_order_relaxed);
+    atomic_store_explicit(&lane->popped, 0U, memory_order_relaxed);
+    atomic_store_explicit(&lane->dropped, 0U, memory_order_relaxed);
+    atomic_store_explicit(&lane->high_water, 0U, memory_order_relaxed);
+    atomic_store_explicit(&lane->wait_us_sum, 0U, memory_order_relaxed);
+    atomic_store_explicit(&lane->wait_us_max, 0U, memory_order_relaxed);
   }
-  s_queue = xQueueCreate((UBaseType_t)capacity, sizeof(fall_event_t));
+  s_mask = cap - 1U;
+  atomic_store_explicit(&s_consumer_waiting, 0U, memory_order_relaxed);
+  if (!s_wake) s_wake = os_sem_create();
+  atomic_thread_fence(memory_order_release);
+  s_ready = true;
+  return cap;
 }
 
-bool alert_queue_push(const fall_event_t* e) {
-  if (!s_queue || !e) return false;
-  if (xQueueSend(s_queue, e, 0) == pdTRUE) {
-    return true;
+static void note_depth(aq_lane_t* lane, unsigned pos) {
+  const unsigned depth = pos + 1U - atomic_load_explicit(&lane->deq_pos, memory_order_relaxed);
+  unsigned hw = atomic_load_explicit(&lane->high_water, memory_order_relaxed);
+  while (depth > hw &&
+         !atomic_compare_exchange_weak_explicit(&lane->high_water, &hw, depth,
+                                                memory_order_relaxed, memory_order_relaxed)) {
   }
-  fall_event_t dropped;
-  xQueueReceive(s_queue, &dropped, 0);
-  return xQueueSend(s_queue, e, 0) == pdTRUE;
 }
 
-bool alert_queue_pop(fall_event_t* e, uint32_t timeout_ms) {
-  if (!s_queue || !e) return false;
-  TickType_t ticks = timeout_ms ? pdMS_TO_TICKS(timeout_ms) : 0;
-  return xQueueReceive(s_queue, e, ticks) == pdTRUE;
+static bool lane_push(aq_lane_t* lane, const fall_event_t* e) {
+  unsigned pos = atomic_load_explicit(&lane->enq_pos, memory_order_relaxed);
+  aq_cell_t* cell;
+  for (;;) {
+    cell = &lane->cells[pos & s_mask];
+    const unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    const int dif = (int)(seq - pos);
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&lane->enq_pos, &pos, pos + 1U,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (dif < 0) {
+      atomic_fetch_add_explicit(&lane->dropped, 1U, memory_order_relaxed);
+      return false;
+    } else {
+      pos = atomic_load_explicit(&lane->enq_pos, memory_order_relaxed);
+    }
+  }
+  cell->evt = *e;
+  cell->push_us = os_now_us();
+  atomic_store_explicit(&cell->seq, pos + 1U, memory_order_release);
+  atomic_fetch_add_explicit(&lane->pushed, 1U, memory_order_relaxed);
+  note_depth(lane, pos);
+  return true;
 }
 
-#else
-
-#if defined(__unix__) || defined(__APPLE__)
-#include <time.h>
-#endif
-
-#define AQ_MAX_CAP 8
-
-static fall_event_t s_buf[AQ_MAX_CAP];
-static unsigned s_cap = 0;
-static unsigned s_head = 0;
-static unsigned s_tail = 0;
-static unsigned s_count = 0;
-
-void alert_queue_init(size_t capacity) {
-  if (capacity == 0) capacity = 1;
-  if (capacity > AQ_MAX_CAP) capacity = AQ_MAX_CAP;
-  s_cap = (unsigned)capacity;
-  s_head = s_tail = s_count = 0;
+static bool lane_pop(aq_lane_t* lane, fall_event_t* e) {
+  unsigned pos = atomic_load_explicit(&lane->deq_pos, memory_order_relaxed);
+  aq_cell_t* cell;
+  for (;;) {
+    cell = &lane->cells[pos & s_mask];
+    const unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    const int dif = (int)(seq - (pos + 1U));
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&lane->deq_pos, &pos, pos + 1U,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (dif < 0) {
+      return false;
+    } else {
+      pos = atomic_load_explicit(&lane->deq_pos, memory_order_relaxed);
+    }
+  }
+  *e = cell->evt;
+  const uint64_t push_us = cell->push_us;
+  atomic_store_explicit(&cell->seq, pos + s_mask + 1U, memory_order_release);
+  atomic_fetch_add_explicit(&lane->popped, 1U, memory_order_relaxed);
+
+  const uint64_t dt = os_now_us() - push_us;
+  const unsigned wait_us = dt > UINT32_MAX ? UINT32_MAX : (unsigned)dt;
+  atomic_fetch_add_explicit(&lane->wait_us_sum, wait_us, memory_order_relaxed);
+  if (wait_us > atomic_load_explicit(&lane->wait_us_max, memory_order_relaxed)) {
+    atomic_store_explicit(&lane->wait_us_max, wait_us, memory_order_relaxed);
+  }
+  return true;
 }
 
 bool alert_queue_push(const fall_event_t* e) {
-  if (!e || s_cap == 0) return false;
-  if (s_count >= s_cap) {
-    s_tail = (s_tail + 1) % s_cap;
-    s_count--;
+  return alert_queue_push_prio(e, ALERT_PRIO_CRITICAL);
+}
+
+bool alert_queue_push_prio(const fall_event_t* e, alert_prio_t prio) {
+  if (!e || !s_ready || (unsigned)prio >= ALERT_PRIO_COUNT) return false;
+  if (!lane_push(&s_lanes[prio], e)) return false;
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_exchange_explicit(&s_consumer_waiting, 0U, memory_order_acq_rel)) {
+    os_sem_give(s_wake);
   }
-  s_buf[s_head] = *e;
-  s_head = (s_head + 1) % s_cap;
-  s_count++;
   return true;
 }
 
-static void sleep_ms(uint32_t ms) {
-#if defined(__unix__) || defined(__APPLE__)
-  struct timespec ts;
-  ts.tv_sec = (time_t)(ms / 1000U);
-  ts.tv_nsec = (long)((ms % 1000U) * 1000000L);
-  nanosleep(&ts, NULL);
-#else
-  volatile uint32_t spin = ms * 4000U;
-  while (spin-- > 0U) {
-    (void)spin;
+static bool try_pop(fall_event_t* e, alert_prio_t* prio_out) {
+  for (unsigned p = 0; p < ALERT_PRIO_COUNT; ++p) {
+    if (lane_pop(&s_lanes[p], e)) {
+      if (prio_out) *prio_out = (alert_prio_t)p;
+      return true;
+    }
   }
-#endif
+  return false;
 }
 
 bool alert_queue_pop(fall_event_t* e, uint32_t timeout_ms) {
-  if (!e || s_cap == 0) return false;
-
-  uint32_t waited = 0;
-  const uint32_t step_ms = 5;
-  while (s_count == 0) {
-    if (timeout_ms == 0) return false;
-    if (waited >= timeout_ms) return false;
-    sleep_ms(step_ms);
-    waited += step_ms;
-  }
+  return alert_queue_pop_prio(e, NULL, timeout_ms);
+}
 
-  *e = s_buf[s_tail];
-  s_tail = (s_tail + 1) % s_cap;
-  s_count--;
-  return true;
+// Lo que queda hasta deadline (us), redondeado hacia arriba; 0: vencido.
+// UINT64_MAX: sin plazo (OS_WAIT_FOREVER).
+static uint32_t remaining_ms(uint64_t deadline) {
+  if (deadline == UINT64_MAX) return OS_WAIT_FOREVER;
+  const uint64_t now = os_now_us();
+  return now >= deadline ? 0U : (uint32_t)((deadline - now + 999U) / 1000U);
 }
 
-#endif
+bool alert_queue_pop_prio(fall_event_t* e, alert_prio_t* prio_out, uint32_t timeout_ms) {
+  if (!e || !s_ready) return false;
+  const uint64_t deadline = timeout_ms == OS_WAIT_FOREVER ? UINT64_MAX : os_now_us() + (uint64_t)timeout_ms * 1000U;
+  for (;;) {
+    if (try_pop(e, prio_out)) return true;
+    if (timeout_ms == 0U) return false;
+    atomic_store_explicit(&s_consumer_waiting, 1U, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    // Re-chequear tras publicar la espera: cubre un push concurrente.
+    if (try_pop(e, prio_out)) {
+      atomic_store_explicit(&s_consumer_waiting, 0U, memory_order_relaxed);
+      return true;
+    }
+    // Un wake sin dato (push ya consumido) sólo provoca un reintento, con lo
+    // que queda del plazo: timeout_ms acota la espera entera, no cada vuelta.
+    timeout_ms = remaining_ms(deadline);
+    if (timeout_ms == 0U || !os_sem_take(s_wake, timeout_ms)) {
+      atomic_store_explicit(&s_consumer_waiting, 0U, memory_order_relaxed);
+      return try_pop(e, prio_out);
+    }
+  }
+}
+
+void alert_queue_stats(alert_queue_stats_t* out) {
+  if (!out) return;
+  for (unsigned p = 0; p < ALERT_PRIO_COUNT; ++p) {
+    out->pushed[p] = atomic_load_explicit(&s_lanes[p].pushed, memory_order_relaxed);
+    out->popped[p] = atomic_load_explicit(&s_lanes[p].popped, memory_order_relaxed);
+    out->dropped[p] = atomic_load_explicit(&s_lanes[p].dropped, memory_order_relaxed);
+    out->high_water[p] = atomic_load_explicit(&s_lanes[p].high_water, memory_order_relaxed);
+    out->wait_us_sum[p] = atomic_load_explicit(&s_lanes[p].wait_us_sum, memory_order_relaxed);
+    out->wait_us_max[p] = atomic_load_explicit(&s_lanes[p].wait_us_max, memory_order_relaxed);
+  }
+}
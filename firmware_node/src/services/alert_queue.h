@@ -5,8 +5,40 @@
 #include <stddef.h>
 #include "firmware_node/src/services/fall_detector.h"
 
-// Cola de eventos de caída (envoltura sobre FreeRTOS Queue)
-void alert_queue_init(size_t capacity);
+// Cola de eventos de caída: un ring lock-free (MPSC, secuencia por celda) por
+// nivel de prioridad. push es no bloqueante y apto para ISR y tareas; pop
+// entrega siempre el evento de mayor prioridad disponible.
+// El bloqueo de pop usa os_port (semáforo binario).
+// Si un nivel está lleno se rechaza el evento NUEVO y se cuenta el descarte:
+// nunca se expulsa una caída ya encolada.
+
+#ifndef ALERT_QUEUE_LANE_CAP
+#define ALERT_QUEUE_LANE_CAP 16U   // potencia de 2, por nivel
+#endif
+
+typedef enum {
+  ALERT_PRIO_CRITICAL = 0,   // caída confirmada
+  ALERT_PRIO_NORMAL,
+  ALERT_PRIO_LOW,            // telemetría
+  ALERT_PRIO_COUNT
+} alert_prio_t;
+
+typedef struct {
+  uint32_t pushed[ALERT_PRIO_COUNT];
+  uint32_t popped[ALERT_PRIO_COUNT];
+  uint32_t dropped[ALERT_PRIO_COUNT];
+  uint32_t high_water[ALERT_PRIO_COUNT];
+  uint32_t wait_us_sum[ALERT_PRIO_COUNT];   // push → pop (latencia de cola); da la vuelta a las ~4295 s
+  uint32_t wait_us_max[ALERT_PRIO_COUNT];
+} alert_queue_stats_t;
+
+// capacity por nivel; se redondea a potencia de 2 y se limita a ALERT_QUEUE_LANE_CAP.
+// Retorna la capacidad efectiva por nivel (el llamador decide si avisar).
+size_t alert_queue_init(size_t capacity);
+// Equivale a alert_queue_push_prio(e, ALERT_PRIO_CRITICAL).
 bool alert_queue_push(const fall_event_t* e);
+bool alert_queue_push_prio(const fall_event_t* e, alert_prio_t prio);
 bool alert_queue_pop (fall_event_t* e, uint32_t timeout_ms);
-
+// Igual que alert_queue_pop; prio_out (opcional) recibe el nivel del evento.
+bool alert_queue_pop_prio(fall_event_t* e, alert_prio_t* prio_out, uint32_t timeout_ms);
+void alert_queue_stats(alert_queue_stats_t* out);
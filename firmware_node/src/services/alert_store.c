@@ -0,0 +1,291 @@
+#include "firmware_node/src/services/alert_store.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if ALERT_STORE_RTC_SPILL >= ALERT_STORE_RTC_LEN
+#error "ALERT_STORE_RTC_SPILL debe ser menor que ALERT_STORE_RTC_LEN"
+#endif
+
+#define STORE_RTC_MAGIC 0x52545331U   // "1STR"
+#define STORE_NVS_MAGIC 0x4E565331U
+
+typedef struct {
+  uint32_t id;          // orden de llegada, creciente entre reinicios
+  uint32_t epoch_ms;
+  int16_t ax_peak_centi_g;
+  uint16_t idle_ms;
+  uint8_t prio;
+  uint8_t rsvd[3];
+} store_entry_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t next_id;
+  uint32_t count;
+  store_entry_t e[ALERT_STORE_RTC_LEN];
+  uint32_t crc;
+} store_rtc_t;
+
+// Blob del desborde (NVS o archivo); en RAM se mantiene un espejo.
+typedef struct {
+  uint32_t magic;
+  uint32_t count;
+  store_entry_t e[ALERT_STORE_NVS_LEN];
+  uint32_t crc;
+} store_nvs_t;
+
+static store_nvs_t s_nvs;
+static alert_store_stats_t s_stats;
+
+static uint32_t crc32(const void* data, size_t n) {
+  const uint8_t* p = (const uint8_t*)data;
+  uint32_t crc = 0xFFFFFFFFU;
+  for (size_t i = 0; i < n; ++i) {
+    crc ^= p[i];
+    for (int b = 0; b < 8; ++b) crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+  }
+  return ~crc;
+}
+
+#if APP_USE_FREERTOS
+
+#include "esp_attr.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+
+RTC_NOINIT_ATTR static store_rtc_t s_rtc;
+
+static bool nvs_load(store_nvs_t* out) {
+  esp_err_t err = nvs_flash_init();
+  if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+    nvs_flash_erase();
+    err = nvs_flash_init();
+  }
+  if (err != ESP_OK) return false;
+  nvs_handle_t h;
+  if (nvs_open("alert_store", NVS_READONLY, &h) != ESP_OK) return false;
+  size_t len = sizeof(*out);
+  err = nvs_get_blob(h, "spill", out, &len);
+  nvs_close(h);
+  return err == ESP_OK && len == sizeof(*out);
+}
+
+static bool nvs_save(const store_nvs_t* in) {
+  nvs_handle_t h;
+  if (nvs_open("alert_store", NVS_READWRITE, &h) != ESP_OK) return false;
+  esp_err_t err = nvs_set_blob(h, "spill", in, sizeof(*in));
+  if (err == ESP_OK) err = nvs_commit(h);
+  nvs_close(h);
+  return err == ESP_OK;
+}
+
+#else  // host: la "RTC" es una estática que alert_store_host_reset no toca
+
+#include <stdio.h>
+
+static store_rtc_t s_rtc;
+static const char* s_path = ALERT_STORE_HOST_PATH;
+
+void alert_store_host_path(const char* path) {
+  s_path = path ? path : ALERT_STORE_HOST_PATH;
+}
+
+void alert_store_host_reset(void) {
+  memset(&s_nvs, 0, sizeof(s_nvs));
+  alert_store_init();
+}
+
+static bool nvs_load(store_nvs_t* out) {
+  FILE* f = fopen(s_path, "rb");
+  if (!f) return false;
+  const bool ok = fread(out, 1, sizeof(*out), f) == sizeof(*out);
+  fclose(f);
+  return ok;
+}
+
+static bool nvs_save(const store_nvs_t* in) {
+  FILE* f = fopen(s_path, "wb");
+  if (!f) return false;
+  const bool ok = fwrite(in, 1, sizeof(*in), f) == sizeof(*in);
+  fclose(f);
+  return ok;
+}
+
+#endif  // APP_USE_FREERTOS
+
+static void rtc_seal(void) {
+  s_rtc.crc = crc32(&s_rtc, offsetof(store_rtc_t, crc));
+}
+
+static bool rtc_valid(void) {
+  return s_rtc.magic == STORE_RTC_MAGIC && s_rtc.count <= ALERT_STORE_RTC_LEN &&
+         s_rtc.crc == crc32(&s_rtc, offsetof(store_rtc_t, crc));
+}
+
+static bool nvs_write(void) {
+  s_nvs.magic = STORE_NVS_MAGIC;
+  s_nvs.crc = crc32(&s_nvs, offsetof(store_nvs_t, crc));
+  s_stats.nvs_writes++;
+  return nvs_save(&s_nvs);
+}
+
+static void remove_at(store_entry_t* e, uint32_t* count, uint32_t i) {
+  memmove(&e[i], &e[i + 1U], (*count - i - 1U) * sizeof(e[0]));
+  (*count)--;
+}
+
+static int find_id(const store_entry_t* e, uint32_t count, uint32_t id) {
+  for (uint32_t i = 0; i < count; ++i) {
+    if (e[i].id == id) return (int)i;
+  }
+  return -1;
+}
+
+void alert_store_init(void) {
+  memset(&s_stats, 0, sizeof(s_stats));
+  mem_report_static("alert_store", sizeof(s_nvs) + sizeof(s_stats));   // la RTC no es DRAM
+  if (!rtc_valid()) {
+    memset(&s_rtc, 0, sizeof(s_rtc));
+    s_rtc.magic = STORE_RTC_MAGIC;
+    s_rtc.next_id = 1U;
+  }
+  if (!nvs_load(&s_nvs) || s_nvs.magic != STORE_NVS_MAGIC || s_nvs.count > ALERT_STORE_NVS_LEN ||
+      s_nvs.crc != crc32(&s_nvs, offsetof(store_nvs_t, crc))) {
+    memset(&s_nvs, 0, sizeof(s_nvs));
+  }
+  // Corte entre guardar el desborde y sacarlo de la RTC: queda en los dos.
+  for (uint32_t i = 0; i < s_rtc.count;) {
+    if (find_id(s_nvs.e, s_nvs.count, s_rtc.e[i].id) >= 0) {
+      remove_at(s_rtc.e, &s_rtc.count, i);
+    } else {
+      ++i;
+    }
+  }
+  for (uint32_t i = 0; i < s_nvs.count; ++i) {
+    if (s_nvs.e[i].id >= s_rtc.next_id) s_rtc.next_id = s_nvs.e[i].id + 1U;
+  }
+  rtc_seal();
+  s_stats.recovered = s_rtc.count + s_nvs.count;
+}
+
+bool alert_store_put(const fall_event_t* e, alert_prio_t prio) {
+  if (!e) return false;
+  // Como alert_queue: lleno se rechaza la nueva, nunca se pisa una guardada.
+  if (s_rtc.count >= ALERT_STORE_RTC_LEN) {
+    s_stats.dropped++;
+    return false;
+  }
+  store_entry_t* d = &s_rtc.e[s_rtc.count++];
+  d->id = s_rtc.next_id++;
+  d->epoch_ms = e->epoch_ms;
+  d->ax_peak_centi_g = e->ax_peak_centi_g;
+  d->idle_ms = e->idle_ms;
+  d->prio = (uint8_t)prio;
+  memset(d->rsvd, 0, sizeof(d->rsvd));
+  rtc_seal();
+  s_stats.stored++;
+  return true;
+}
+
+size_t alert_store_count(void) {
+  return s_rtc.count + s_nvs.count;
+}
+
+static bool before(const store_entry_t* a, const store_entry_t* b) {
+  return a->prio != b->prio ? a->prio < b->prio : a->id < b->id;
+}
+
+size_t alert_store_peek(fall_event_t* out, uint32_t* ids, size_t max) {
+  if (!out || !ids) return 0;
+  size_t n = 0;
+  uint32_t last_id = 0;
+  uint8_t last_prio = 0;
+  // Selección repetida del siguiente en orden (prioridad, id): pocas entradas.
+  for (; n < max; ++n) {
+    const store_entry_t* best = NULL;
+    for (uint32_t t = 0; t < 2U; ++t) {
+      const store_entry_t* e = t ? s_nvs.e : s_rtc.e;
+      const uint32_t count = t ? s_nvs.count : s_rtc.count;
+      for (uint32_t i = 0; i < count; ++i) {
+        const bool after_last = n == 0U || e[i].prio > last_prio || (e[i].prio == last_prio && e[i].id > last_id);
+        if (after_last && (!best || before(&e[i], best))) best = &e[i];
+      }
+    }
+    if (!best) break;
+    out[n] = (fall_event_t){ best->epoch_ms, best->ax_peak_centi_g, best->idle_ms, FALL_EVT_CONFIRMED, 0U };
+    ids[n] = best->id;
+    last_id = best->id;
+    last_prio = best->prio;
+  }
+  return n;
+}
+
+void alert_store_drop(const uint32_t* ids, size_t n) {
+  if (!ids) return;
+  bool nvs_dirty = false;
+  for (size_t k = 0; k < n; ++k) {
+    int i = find_id(s_rtc.e, s_rtc.count, ids[k]);
+    if (i >= 0) {
+      remove_at(s_rtc.e, &s_rtc.count, (uint32_t)i);
+      s_stats.flushed++;
+      continue;
+    }
+    i = find_id(s_nvs.e, s_nvs.count, ids[k]);
+    if (i >= 0) {
+      remove_at(s_nvs.e, &s_nvs.count, (uint32_t)i);
+      s_stats.flushed++;
+      nvs_dirty = true;
+    }
+  }
+  rtc_seal();
+  if (nvs_dirty) nvs_write();
+}
+
+void alert_store_service(void) {
+  if (s_rtc.count <= ALERT_STORE_RTC_SPILL) return;
+  // Las más viejas de la RTC pasan al desborde; la RTC se libera (y los
+  // descartes cuentan) sólo después de que el desborde quedó escrito.
+  const uint32_t move = s_rtc.count - ALERT_STORE_RTC_SPILL;
+  store_entry_t evicted[ALERT_STORE_RTC_LEN];   // sacadas del espejo, para deshacer
+  uint32_t n_evicted = 0;
+  uint32_t dropped = 0;
+  for (uint32_t k = 0; k < move; ++k) {
+    const store_entry_t* in = &s_rtc.e[k];   // la RTC está en orden de llegada
+    if (s_nvs.count >= ALERT_STORE_NVS_LEN) {
+      uint32_t worst = 0;
+      for (uint32_t i = 1; i < s_nvs.count; ++i) {
+        if (before(&s_nvs.e[worst], &s_nvs.e[i])) worst = i;
+      }
+      // La más nueva de menor prioridad pierde, sea la guardada o la que entra.
+      dropped++;
+      if (before(&s_nvs.e[worst], in)) continue;
+      evicted[n_evicted++] = s_nvs.e[worst];
+      remove_at(s_nvs.e, &s_nvs.count, worst);
+    }
+    s_nvs.e[s_nvs.count++] = *in;
+  }
+  if (!nvs_write()) {
+    // Espejo como antes: las nuevas siguen en la RTC y vuelven las
+    // desalojadas; se reintenta en la próxima llamada.
+    for (uint32_t k = 0; k < move; ++k) {
+      const int i = find_id(s_nvs.e, s_nvs.count, s_rtc.e[k].id);
+      if (i >= 0) remove_at(s_nvs.e, &s_nvs.count, (uint32_t)i);
+    }
+    for (uint32_t k = 0; k < n_evicted; ++k) s_nvs.e[s_nvs.count++] = evicted[k];
+    return;
+  }
+  memmove(&s_rtc.e[0], &s_rtc.e[move], (s_rtc.count - move) * sizeof(s_rtc.e[0]));
+  s_rtc.count -= move;
+  rtc_seal();
+  s_stats.spilled += move - dropped + n_evicted;
+  s_stats.dropped += dropped;
+}
+
+void alert_store_stats(alert_store_stats_t* out) {
+  if (!out) return;
+  *out = s_stats;
+  out->rtc_len = s_rtc.count;
+  out->nvs_len = s_nvs.count;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config/system_config.h"
+#include "firmware_node/src/services/alert_queue.h"
+#include "firmware_node/src/services/fall_detector.h"
+
+// Store-and-forward del nodo: alertas confirmadas cuyo lora_tx() falló.
+// Dos niveles acotados:
+// - Cola caliente en memoria RTC (RTC_NOINIT: sobrevive reset por software,
+//   watchdog y brown-out mientras el dominio RTC conserve tensión), validada
+//   con magic + CRC al arrancar. alert_store_put() sólo escribe aquí: un
+//   memcpy y un CRC, nunca flash.
+// - Desborde en NVS (en host, un archivo): alert_store_service() pasa las
+//   más viejas cuando la RTC supera ALERT_STORE_RTC_SPILL. Se llama fuera del
+//   camino de transmisión (tsk_alert_tx sin alertas en cola).
+// Lleno el desborde, se descarta la más vieja de menor prioridad (contada).
+// El reenvío elige primero las críticas más viejas (alert_store_peek).
+// Una sola tarea usa el módulo (tsk_alert_tx): sin locks.
+
+#ifndef ALERT_STORE_RTC_LEN
+#define ALERT_STORE_RTC_LEN 8U
+#endif
+
+#ifndef ALERT_STORE_RTC_SPILL
+#define ALERT_STORE_RTC_SPILL 4U   // por encima se desborda a NVS
+#endif
+
+#ifndef ALERT_STORE_NVS_LEN
+#define ALERT_STORE_NVS_LEN 32U
+#endif
+
+#ifndef ALERT_STORE_HOST_PATH
+#define ALERT_STORE_HOST_PATH "alert_store.bin"
+#endif
+
+typedef struct {
+  uint32_t stored;       // put aceptados
+  uint32_t spilled;      // pasadas de RTC a NVS
+  uint32_t flushed;      // reenviadas (alert_store_drop)
+  uint32_t dropped;      // descartadas por desborde
+  uint32_t recovered;    // encontradas al arrancar (RTC + NVS)
+  uint32_t nvs_writes;
+  uint32_t rtc_len;      // ocupación actual
+  uint32_t nvs_len;
+} alert_store_stats_t;
+
+#if !APP_USE_FREERTOS
+// Archivo del desborde en host (antes de alert_store_init).
+void alert_store_host_path(const char* path);
+// Simula un reinicio: la RTC conserva su contenido, la RAM no.
+void alert_store_host_reset(void);
+#endif
+
+// Valida la RTC (o la limpia) y carga el desborde. Registra su RAM en mem_report.
+void alert_store_init(void);
+
+// Guarda una alerta no entregada (sólo RTC, O(1)). false si no entra.
+bool alert_store_put(const fall_event_t* e, alert_prio_t prio);
+
+size_t alert_store_count(void);
+
+// Hasta max alertas en orden de reenvío (prioridad, antigüedad) sin
+// sacarlas; ids identifica cada una para alert_store_drop.
+size_t alert_store_peek(fall_event_t* out, uint32_t* ids, size_t max);
+// Saca las alertas ya reenviadas.
+void alert_store_drop(const uint32_t* ids, size_t n);
+
+// Desborde RTC → NVS (puede tardar ms); fuera del camino de TX.
+void alert_store_service(void);
+
+void alert_store_stats(alert_store_stats_t* out);
@@ -0,0 +1,182 @@
+#include "firmware_node/src/services/bbox_codec.h"
+
+#include <string.h>
+
+typedef struct {
+  uint8_t* out;
+  size_t max;
+  size_t pos;
+  uint32_t acc;
+  uint8_t nbits;
+} bit_writer_t;
+
+typedef struct {
+  const uint8_t* in;
+  size_t len;
+  size_t pos;
+  uint32_t acc;
+  uint8_t nbits;
+} bit_reader_t;
+
+static inline uint32_t zigzag(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1U);
+}
+
+static inline uint8_t bit_width(uint32_t v) {
+  uint8_t w = 0;
+  while (v) {
+    ++w;
+    v >>= 1;
+  }
+  return w;
+}
+
+static inline int16_t axis_of(const accel_raw_t* s, unsigned axis) {
+  return axis == 0U ? s->ax : (axis == 1U ? s->ay : s->az);
+}
+
+static inline const accel_raw_t* sample_at(const accel_raw_t* seg0, size_t n0,
+                                           const accel_raw_t* seg1, size_t idx) {
+  return idx < n0 ? &seg0[idx] : &seg1[idx - n0];
+}
+
+static bool bw_put(bit_writer_t* w, uint32_t v, uint8_t bits) {
+  if (bits == 0U) return true;
+  w->acc |= v << w->nbits;
+  w->nbits = (uint8_t)(w->nbits + bits);
+  while (w->nbits >= 8U) {
+    if (w->pos >= w->max) return false;
+    w->out[w->pos++] = (uint8_t)w->acc;
+    w->acc >>= 8;
+    w->nbits = (uint8_t)(w->nbits - 8U);
+  }
+  return true;
+}
+
+static bool bw_align(bit_writer_t* w) {
+  if (w->nbits == 0U) return true;
+  if (w->pos >= w->max) return false;
+  w->out[w->pos++] = (uint8_t)w->acc;
+  w->acc = 0;
+  w->nbits = 0;
+  return true;
+}
+
+static bool br_get(bit_reader_t* r, uint8_t bits, uint32_t* v) {
+  if (bits == 0U) {
+    *v = 0;
+    return true;
+  }
+  while (r->nbits < bits) {
+    if (r->pos >= r->len) return false;
+    r->acc |= (uint32_t)r->in[r->pos++] << r->nbits;
+    r->nbits = (uint8_t)(r->nbits + 8U);
+  }
+  *v = r->acc & ((1UL << bits) - 1UL);
+  r->acc >>= bits;
+  r->nbits = (uint8_t)(r->nbits - bits);
+  return true;
+}
+
+static void br_align(bit_reader_t* r) {
+  r->acc = 0;
+  r->nbits = 0;
+}
+
+static void put_i16(uint8_t* p, int16_t v) {
+  p[0] = (uint8_t)((uint16_t)v & 0xFF);
+  p[1] = (uint8_t)(((uint16_t)v >> 8) & 0xFF);
+}
+
+static int16_t get_i16(const uint8_t* p) {
+  return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+size_t bbox_encode(const accel_raw_t* seg0, size_t n0,
+                   const accel_raw_t* seg1, size_t n1,
+                   uint8_t* out, size_t max) {
+  const size_t n = n0 + n1;
+  if (!out || n == 0U || n > 0xFFFFu) return 0;
+  if (n0 && !seg0) return 0;
+  if (n1 && !seg1) return 0;
+  if (max < BBOX_HDR_BYTES) return 0;
+
+  const accel_raw_t* first = sample_at(seg0, n0, seg1, 0);
+  out[0] = (uint8_t)(n & 0xFF);
+  out[1] = (uint8_t)((n >> 8) & 0xFF);
+  put_i16(&out[2], first->ax);
+  put_i16(&out[4], first->ay);
+  put_i16(&out[6], first->az);
+
+  bit_writer_t w = { out, max, BBOX_HDR_BYTES, 0, 0 };
+  uint32_t zz[3][BBOX_BLOCK];
+
+  for (size_t base = 1; base < n; base += BBOX_BLOCK) {
+    const size_t cnt = (n - base) < BBOX_BLOCK ? (n - base) : BBOX_BLOCK;
+    uint32_t any[3] = { 0, 0, 0 };
+
+    const accel_raw_t* prev = sample_at(seg0, n0, seg1, base - 1U);
+    for (size_t k = 0; k < cnt; ++k) {
+      const accel_raw_t* cur = sample_at(seg0, n0, seg1, base + k);
+      for (unsigned a = 0; a < 3U; ++a) {
+        const int32_t d = (int32_t)axis_of(cur, a) - (int32_t)axis_of(prev, a);
+        zz[a][k] = zigzag(d);
+        any[a] |= zz[a][k];
+      }
+      prev = cur;
+    }
+
+    uint8_t width[3];
+    for (unsigned a = 0; a < 3U; ++a) {
+      width[a] = bit_width(any[a]);
+      if (w.pos >= w.max) return 0;
+      w.out[w.pos++] = width[a];
+    }
+    for (unsigned a = 0; a < 3U; ++a) {
+      for (size_t k = 0; k < cnt; ++k) {
+        if (!bw_put(&w, zz[a][k], width[a])) return 0;
+      }
+    }
+    if (!bw_align(&w)) return 0;
+  }
+  return w.pos;
+}
+
+size_t bbox_decode(const uint8_t* in, size_t len, accel_raw_t* out, size_t max_samples) {
+  if (!in || !out || len < BBOX_HDR_BYTES) return 0;
+  const size_t n = (size_t)in[0] | ((size_t)in[1] << 8);
+  if (n == 0U || n > max_samples) return 0;
+
+  out[0].ax = get_i16(&in[2]);
+  out[0].ay = get_i16(&in[4]);
+  out[0].az = get_i16(&in[6]);
+
+  bit_reader_t r = { in, len, BBOX_HDR_BYTES, 0, 0 };
+  for (size_t base = 1; base < n; base += BBOX_BLOCK) {
+    const size_t cnt = (n - base) < BBOX_BLOCK ? (n - base) : BBOX_BLOCK;
+    if (r.pos + 3U > r.len) return 0;
+    const uint8_t width[3] = { r.in[r.pos], r.in[r.pos + 1U], r.in[r.pos + 2U] };
+    r.pos += 3U;
+    for (unsigned a = 0; a < 3U; ++a) {
+      if (width[a] > 17U) return 0;
+    }
+    for (unsigned a = 0; a < 3U; ++a) {
+      for (size_t k = 0; k < cnt; ++k) {
+        uint32_t v;
+        if (!br_get(&r, width[a], &v)) return 0;
+        const accel_raw_t* prev = &out[base + k - 1U];
+        const int32_t p = a == 0U ? prev->ax : (a == 1U ? prev->ay : prev->az);
+        const int16_t cur = (int16_t)(p + unzigzag(v));
+        if (a == 0U) out[base + k].ax = cur;
+        else if (a == 1U) out[base + k].ay = cur;
+        else out[base + k].az = cur;
+      }
+    }
+    br_align(&r);
+  }
+  return n;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "firmware_node/src/drivers/imu_accel.h"
+
+// Codec entero de la ventana "caja negra": delta + zigzag + bit packing.
+//
+// Formato (LE):
+//   n_samples (2B) | ax0, ay0, az0 (3 x 2B)
+//   por bloque de hasta BBOX_BLOCK deltas:
+//     ancho_x, ancho_y, ancho_z (1B c/u, 0..17 bits)
+//     deltas zigzag empaquetados LSB-first (x, luego y, luego z),
+//     alineado a byte al final del bloque.
+// Sin asignación dinámica; O(n) por ventana.
+
+#define BBOX_BLOCK        16U
+#define BBOX_HDR_BYTES    8U
+
+// Peor caso: 17 bits por delta y eje.
+#define BBOX_MAX_ENCODED(n) \
+  (BBOX_HDR_BYTES + (((n) + BBOX_BLOCK - 1U) / BBOX_BLOCK) * (3U + 3U * ((BBOX_BLOCK * 17U + 7U) / 8U)))
+
+// Codifica seg0[0..n0) seguido de seg1[0..n1) (dos mitades de un ring).
+// Retorna bytes escritos o 0 si no entra en max.
+size_t bbox_encode(const accel_raw_t* seg0, size_t n0,
+                   const accel_raw_t* seg1, size_t n1,
+                   uint8_t* out, size_t max);
+
+// Decodifica hasta max_samples muestras. Retorna la cantidad o 0 si es inválido.
+size_t bbox_decode(const uint8_t* in, size_t len, accel_raw_t* out, size_t max_samples);
@@ -0,0 +1,134 @@
+#include "firmware_node/src/services/bbox_xfer.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <string.h>
+
+#define BBOX_TX_BUF_BYTES BBOX_MAX_ENCODED(BBOX_MAX_SAMPLES)
+#define BBOX_RX_BUF_BYTES (BBOX_MAX_FRAGS * PKT_BBOX_MAX_PAYLOAD)
+
+#if ((BBOX_TX_BUF_BYTES + PKT_BBOX_MAX_PAYLOAD - 1U) / PKT_BBOX_MAX_PAYLOAD) > BBOX_MAX_FRAGS
+#error "BBOX_MAX_SAMPLES no entra en BBOX_MAX_FRAGS fragmentos"
+#endif
+
+typedef struct {
+  uint8_t buf[BBOX_TX_BUF_BYTES];
+  size_t len;
+  size_t samples;
+  uint8_t xfer_id;
+  uint8_t next_frag;
+  uint8_t frag_cnt;
+} bbox_tx_ctx_t;
+
+typedef struct {
+  uint8_t buf[BBOX_RX_BUF_BYTES];
+  uint64_t have;
+  size_t len;
+  uint8_t xfer_id;
+  uint8_t frag_cnt;
+  bool active;
+  bool complete;
+} bbox_rx_ctx_t;
+
+static bbox_tx_ctx_t s_tx;
+static bbox_rx_ctx_t s_rx;
+
+bool bbox_xfer_tx_load(uint32_t first_seq, size_t n) {
+  if (n > BBOX_MAX_SAMPLES) {
+    first_seq += (uint32_t)(n - BBOX_MAX_SAMPLES);
+    n = BBOX_MAX_SAMPLES;
+  }
+  imu_ring_span_t span;
+  if (!imu_ring_window(first_seq, n, &span)) return false;
+
+  const size_t len = bbox_encode(span.seg0, span.n0, span.seg1, span.n1,
+                                 s_tx.buf, sizeof(s_tx.buf));
+  // El muestreo sigue escribiendo el ring: descartar si se pisó la ventana.
+  if (len == 0U || !imu_ring_still_valid(first_seq)) {
+    s_tx.frag_cnt = 0;
+    s_tx.next_frag = 0;
+    return false;
+  }
+
+  s_tx.len = len;
+  s_tx.samples = n;
+  s_tx.xfer_id++;
+  s_tx.next_frag = 0;
+  s_tx.frag_cnt = (uint8_t)((len + PKT_BBOX_MAX_PAYLOAD - 1U) / PKT_BBOX_MAX_PAYLOAD);
+  return true;
+}
+
+bool bbox_xfer_tx_pending(void) {
+  return s_tx.next_frag < s_tx.frag_cnt;
+}
+
+size_t bbox_xfer_tx_next(uint8_t* out, size_t max) {
+  if (!bbox_xfer_tx_pending()) return 0;
+  const size_t off = (size_t)s_tx.next_frag * PKT_BBOX_MAX_PAYLOAD;
+  const size_t rem = s_tx.len - off;
+  pkt_bbox_frag_t f = {
+    .xfer_id = s_tx.xfer_id,
+    .frag_idx = s_tx.next_frag,
+    .frag_cnt = s_tx.frag_cnt,
+    .len = (uint8_t)(rem < PKT_BBOX_MAX_PAYLOAD ? rem : PKT_BBOX_MAX_PAYLOAD),
+    .payload = &s_tx.buf[off],
+  };
+  const size_t n = pkt_encode_bbox_frag(&f, out, max);
+  if (n > 0U) s_tx.next_frag++;
+  return n;
+}
+
+size_t bbox_xfer_tx_encoded_bytes(void) {
+  return s_tx.len;
+}
+
+size_t bbox_xfer_tx_samples(void) {
+  return s_tx.samples;
+}
+
+void bbox_xfer_init(void) {
+  mem_report_static("bbox_xfer", sizeof(s_tx) + sizeof(s_rx));
+  memset(&s_tx, 0, sizeof(s_tx));
+  bbox_xfer_rx_reset();
+}
+
+void bbox_xfer_rx_reset(void) {
+  memset(&s_rx, 0, sizeof(s_rx));
+}
+
+bbox_rx_status_t bbox_xfer_rx_feed(const pkt_bbox_frag_t* f) {
+  if (!f || f->frag_cnt == 0U || f->frag_cnt > BBOX_MAX_FRAGS) return BBOX_RX_IGNORED;
+  if (f->frag_idx >= f->frag_cnt) return BBOX_RX_IGNORED;
+  // Todos los fragmentos salvo el último van llenos.
+  if (f->frag_idx + 1U < f->frag_cnt && f->len != PKT_BBOX_MAX_PAYLOAD) return BBOX_RX_IGNORED;
+
+  if (!s_rx.active || s_rx.xfer_id != f->xfer_id || s_rx.frag_cnt != f->frag_cnt) {
+    s_rx.active = true;
+    s_rx.complete = false;
+    s_rx.have = 0;
+    s_rx.len = 0;
+    s_rx.xfer_id = f->xfer_id;
+    s_rx.frag_cnt = f->frag_cnt;
+  }
+  if (s_rx.complete) return BBOX_RX_IGNORED;
+
+  const uint64_t bit = 1ULL << f->frag_idx;
+  if (s_rx.have & bit) return BBOX_RX_PARTIAL;
+
+  memcpy(&s_rx.buf[(size_t)f->frag_idx * PKT_BBOX_MAX_PAYLOAD], f->payload, f->len);
+  s_rx.have |= bit;
+  if (f->frag_idx + 1U == f->frag_cnt) {
+    s_rx.len = (size_t)f->frag_idx * PKT_BBOX_MAX_PAYLOAD + f->len;
+  }
+
+  const uint64_t all = (f->frag_cnt == 64U) ? ~0ULL : ((1ULL << f->frag_cnt) - 1ULL);
+  if (s_rx.have == all) {
+    s_rx.complete = true;
+    return BBOX_RX_COMPLETE;
+  }
+  return BBOX_RX_PARTIAL;
+}
+
+size_t bbox_xfer_rx_samples(accel_raw_t* out, size_t max) {
+  if (!s_rx.complete) return 0;
+  return bbox_decode(s_rx.buf, s_rx.len, out, max);
+}
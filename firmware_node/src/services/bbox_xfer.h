@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "firmware_node/src/services/bbox_codec.h"
+#include "firmware_node/src/services/imu_ring.h"
+#include "firmware_node/src/services/pkt_codec.h"
+
+// Transferencia fragmentada de la ventana "caja negra" (sin ACK, baja prioridad).
+// Nodo: comprime la ventana del ring y entrega un fragmento por llamada.
+// Receptor: reensambla por xfer_id y decodifica al completar.
+
+#ifndef BBOX_MAX_SAMPLES
+#define BBOX_MAX_SAMPLES 384U   // 3.84 s a 100 Hz
+#endif
+
+#define BBOX_MAX_FRAGS 64U
+
+typedef enum {
+  BBOX_RX_IGNORED = 0,
+  BBOX_RX_PARTIAL,
+  BBOX_RX_COMPLETE
+} bbox_rx_status_t;
+
+// Registra sus buffers en mem_report y limpia ambos lados.
+void bbox_xfer_init(void);
+
+// --- Nodo (TX) ---
+// Comprime la ventana [first_seq, first_seq + n) del ring. Reemplaza cualquier
+// transferencia en curso. Retorna false si la ventana ya no es válida.
+bool   bbox_xfer_tx_load(uint32_t first_seq, size_t n);
+bool   bbox_xfer_tx_pending(void);
+// Escribe el próximo fragmento en out. Retorna el largo o 0 si no hay más.
+size_t bbox_xfer_tx_next(uint8_t* out, size_t max);
+// Bytes comprimidos y muestras de la última carga (para métricas).
+size_t bbox_xfer_tx_encoded_bytes(void);
+size_t bbox_xfer_tx_samples(void);
+
+// --- Receptor (RX) ---
+void             bbox_xfer_rx_reset(void);
+bbox_rx_status_t bbox_xfer_rx_feed(const pkt_bbox_frag_t* f);
+// Decodifica la última transferencia completa. Retorna cantidad de muestras.
+size_t           bbox_xfer_rx_samples(accel_raw_t* out, size_t max);
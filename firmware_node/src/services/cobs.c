@@ -0,0 +1,42 @@
+#include "firmware_node/src/services/cobs.h"
+
+size_t cobs_encode(const uint8_t* in, size_t len, uint8_t* out, size_t max) {
+  if (!in || !out || max < COBS_MAX_ENCODED(len)) return 0;
+  size_t code_at = 0;   // byte de código del bloque abierto
+  size_t o = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; ++i) {
+    if (in[i] != 0U) {
+      out[o++] = in[i];
+      code++;
+    }
+    if (in[i] == 0U || code == 0xFFU) {
+      out[code_at] = code;
+      code_at = o++;
+      code = 1;
+    }
+  }
+  out[code_at] = code;
+  return o;
+}
+
+size_t cobs_decode(const uint8_t* in, size_t len, uint8_t* out, size_t max) {
+  if (!in || !out) return 0;
+  size_t o = 0;
+  size_t i = 0;
+  while (i < len) {
+    const uint8_t code = in[i++];
+    if (code == 0U || i + code - 1U > len) return 0;
+    if (o + code - 1U > max) return 0;
+    for (uint8_t k = 1; k < code; ++k) {
+      if (in[i] == 0U) return 0;
+      out[o++] = in[i++];
+    }
+    // Un bloque corto implica un cero, salvo al final de la trama.
+    if (code != 0xFFU && i < len) {
+      if (o >= max) return 0;
+      out[o++] = 0U;
+    }
+  }
+  return o;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// COBS (Consistent Overhead Byte Stuffing): la salida no contiene 0x00, así
+// que 0x00 delimita tramas en un flujo serie y el lector se resincroniza en
+// el próximo cero tras un byte perdido. Costo: 1 B cada 254 (+1 al inicio).
+
+// Peor tamaño codificado de n bytes (sin el delimitador).
+#define COBS_MAX_ENCODED(n) ((n) + (n) / 254U + 1U)
+
+// Codifica len bytes en out; bytes escritos, 0 si no entra en max.
+size_t cobs_encode(const uint8_t* in, size_t len, uint8_t* out, size_t max);
+
+// Decodifica len bytes (sin el 0x00 final) en out; bytes escritos, 0 si la
+// entrada es inválida (un cero o un bloque que se pasa del final) o no entra.
+size_t cobs_decode(const uint8_t* in, size_t len, uint8_t* out, size_t max);
@@ -0,0 +1,170 @@
+#include "firmware_node/src/services/dlog.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (DLOG_RING_LEN & (DLOG_RING_LEN - 1U)) != 0U
+#error "DLOG_RING_LEN debe ser potencia de 2"
+#endif
+
+typedef struct {
+  atomic_uint seq;
+  uint16_t id;
+  uint8_t nargs;
+  uint32_t ts_ms;
+  int32_t args[DLOG_MAX_ARGS];
+} dlog_cell_t;
+
+#define DLOG_MSG_(id, lvl, tag, fmt) { lvl, tag, fmt },
+static const dlog_msg_t s_msgs[DLOG_MSG_COUNT] = {
+  DLOG_MESSAGES(DLOG_MSG_)
+};
+#undef DLOG_MSG_
+
+static dlog_cell_t s_cells[DLOG_RING_LEN];
+static atomic_uint s_enq;
+static atomic_uint s_deq;
+static atomic_uint s_pushed;
+static atomic_uint s_dropped;
+static atomic_uint s_high_water;
+static uint32_t s_printed = 0;
+static atomic_uint s_consumer_waiting;
+static os_sem_t s_wake = NULL;
+static atomic_bool s_init_claimed;
+static atomic_bool s_ready;
+static atomic_bool s_started;
+
+void dlog_init(void) {
+  if (atomic_exchange(&s_init_claimed, true)) return;
+  mem_report_static("dlog", sizeof(s_cells));
+  for (unsigned i = 0; i < DLOG_RING_LEN; ++i) {
+    atomic_store_explicit(&s_cells[i].seq, i, memory_order_relaxed);
+  }
+  s_wake = os_sem_create();
+  atomic_store_explicit(&s_ready, true, memory_order_release);
+}
+
+void dlog_start(int core) {
+  dlog_init();
+  if (atomic_exchange(&s_started, true)) return;
+  os_task_create(tsk_dlog, "dlog", DLOG_STACK, OS_PRIO_LOW, core, NULL, NULL);
+}
+
+bool dlog_write(dlog_id_t id, const int32_t* args, size_t nargs) {
+  if (!atomic_load_explicit(&s_ready, memory_order_acquire) || (unsigned)id >= DLOG_MSG_COUNT) {
+    return false;
+  }
+  unsigned pos = atomic_load_explicit(&s_enq, memory_order_relaxed);
+  dlog_cell_t* cell;
+  for (;;) {
+    cell = &s_cells[pos & (DLOG_RING_LEN - 1U)];
+    const unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    const int dif = (int)(seq - pos);
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&s_enq, &pos, pos + 1U,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (dif < 0) {
+      atomic_fetch_add_explicit(&s_dropped, 1U, memory_order_relaxed);
+      return false;
+    } else {
+      pos = atomic_load_explicit(&s_enq, memory_order_relaxed);
+    }
+  }
+  if (nargs > DLOG_MAX_ARGS) nargs = DLOG_MAX_ARGS;
+  cell->id = (uint16_t)id;
+  cell->nargs = (uint8_t)nargs;
+  cell->ts_ms = (uint32_t)(os_now_us() / 1000U);
+  for (size_t i = 0; i < nargs; ++i) cell->args[i] = args[i];
+  atomic_store_explicit(&cell->seq, pos + 1U, memory_order_release);
+  atomic_fetch_add_explicit(&s_pushed, 1U, memory_order_relaxed);
+
+  const unsigned depth = pos + 1U - atomic_load_explicit(&s_deq, memory_order_relaxed);
+  unsigned hw = atomic_load_explicit(&s_high_water, memory_order_relaxed);
+  while (depth > hw &&
+         !atomic_compare_exchange_weak_explicit(&s_high_water, &hw, depth,
+                                                memory_order_relaxed, memory_order_relaxed)) {
+  }
+
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_exchange_explicit(&s_consumer_waiting, 0U, memory_order_acq_rel)) {
+    os_sem_give(s_wake);
+  }
+  return true;
+}
+
+// Un solo consumidor (tsk_dlog): no necesita CAS sobre s_deq.
+static bool pop_one(dlog_cell_t* out) {
+  const unsigned pos = atomic_load_explicit(&s_deq, memory_order_relaxed);
+  dlog_cell_t* cell = &s_cells[pos & (DLOG_RING_LEN - 1U)];
+  const unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+  if (seq != pos + 1U) return false;
+  out->id = cell->id;
+  out->nargs = cell->nargs;
+  out->ts_ms = cell->ts_ms;
+  memcpy(out->args, cell->args, sizeof(out->args));
+  atomic_store_explicit(&cell->seq, pos + DLOG_RING_LEN, memory_order_release);
+  atomic_store_explicit(&s_deq, pos + 1U, memory_order_relaxed);
+  return true;
+}
+
+static void print_cell(const dlog_cell_t* c) {
+  int32_t a[DLOG_MAX_ARGS] = { 0 };
+  memcpy(a, c->args, c->nargs * sizeof(int32_t));
+#if DLOG_RAW
+  printf("DLG %u %u %d %d %d %d\n", (unsigned)c->id, (unsigned)c->ts_ms,
+         (int)a[0], (int)a[1], (int)a[2], (int)a[3]);
+#else
+  const dlog_msg_t* m = &s_msgs[c->id];
+  printf("%c (%u) %s: ", m->level, (unsigned)c->ts_ms, m->tag);
+  // Argumentos sobrantes se ignoran (C11 7.21.6.1).
+  printf(m->fmt, (int)a[0], (int)a[1], (int)a[2], (int)a[3]);
+  printf("\n");
+#endif
+}
+
+size_t dlog_flush(void) {
+  if (!atomic_load_explicit(&s_ready, memory_order_acquire)) return 0U;
+  size_t n = 0;
+  dlog_cell_t c;
+  while (pop_one(&c)) {
+    print_cell(&c);
+    n++;
+  }
+  if (n) {
+    s_printed += (uint32_t)n;
+    fflush(stdout);
+  }
+  return n;
+}
+
+const dlog_msg_t* dlog_msg(dlog_id_t id) {
+  return (unsigned)id < DLOG_MSG_COUNT ? &s_msgs[id] : NULL;
+}
+
+void dlog_stats(dlog_stats_t* out) {
+  if (!out) return;
+  out->pushed = atomic_load_explicit(&s_pushed, memory_order_relaxed);
+  out->dropped = atomic_load_explicit(&s_dropped, memory_order_relaxed);
+  out->printed = s_printed;
+  out->high_water = atomic_load_explicit(&s_high_water, memory_order_relaxed);
+}
+
+void tsk_dlog(void* arg) {
+  (void)arg;
+  while (os_running()) {
+    dlog_flush();
+    atomic_store_explicit(&s_consumer_waiting, 1U, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if (dlog_flush()) {
+      atomic_store_explicit(&s_consumer_waiting, 0U, memory_order_relaxed);
+      continue;
+    }
+    os_sem_take(s_wake, OS_WAIT_FOREVER);
+  }
+  dlog_flush();   // host: lo pendiente al detener la simulación
+}
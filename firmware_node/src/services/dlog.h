@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Log diferido binario: el sitio de llamada sólo copia un id de formato y
+// hasta DLOG_MAX_ARGS enteros a un ring lock-free (MPSC, secuencia por celda,
+// apto para ISR). tsk_dlog (prioridad baja) formatea y escribe por serial;
+// con DLOG_RAW=1 emite "DLG <id> <ms> <args>" y tools/dlog_decode.c formatea
+// en la PC. Sin printf en el camino de TX/RX.
+// Ring lleno: se descarta el mensaje nuevo y se cuenta (nunca bloquea).
+
+#ifndef DLOG_ENABLE
+#ifdef APP_SUPPRESS_LOGS
+#define DLOG_ENABLE 0
+#else
+#define DLOG_ENABLE 1
+#endif
+#endif
+
+#ifndef DLOG_RING_LEN
+#define DLOG_RING_LEN 64U   // potencia de 2
+#endif
+
+#ifndef DLOG_STACK
+#define DLOG_STACK 3072U   // bytes; ver "MEM stack dlog" en el reporte
+#endif
+
+#ifndef DLOG_RAW
+#define DLOG_RAW 0
+#endif
+
+#define DLOG_MAX_ARGS 4U
+
+// X(id, nivel, tag, formato). Argumentos int32; %u/%d/%x sin modificadores.
+#define DLOG_MESSAGES(X)                                                                  \
+  X(DLOG_ALERT_TX,        'I', "app_node",    "ALERTA epoch=%ums peak=%d idle=%ums")      \
+  X(DLOG_ALERT_TX_FAIL,   'E', "app_node",    "TX alerta fallida epoch=%ums")             \
+  X(DLOG_LORA_FIFO_FAIL,  'E', "lora_sx1276", "FIFO write failed")                        \
+  X(DLOG_LORA_TX_TIMEOUT, 'E', "lora_sx1276", "TX timeout")                               \
+  X(DLOG_LORA_RX_TIMEOUT, 'W', "lora_sx1276", "RX timeout")                               \
+  X(DLOG_LORA_RX_CRC,     'W', "lora_sx1276", "RX CRC error")                             \
+  X(DLOG_RX_ALERT,        'I', "app_rx",      "ALERTA HOMBRE CAIDO - epoch=%ums peak=%d idle=%ums") \
+  X(DLOG_RX_BBOX_DONE,    'I', "app_rx",      "caja negra xfer=%u frags=%u muestras=%u")     \
+  X(DLOG_PRE_TX,          'I', "app_node",    "PREALERTA seq=%u epoch=%ums peak=%d")      \
+  X(DLOG_CANCEL_TX,       'I', "app_node",    "CANCELA seq=%u epoch=%ums")                \
+  X(DLOG_RX_PREALERT,     'W', "app_rx",      "POSIBLE CAIDA seq=%u epoch=%ums peak=%d")  \
+  X(DLOG_RX_PRE_END,      'I', "app_rx",      "prealerta seq=%u fin=%u (0 cancelada, 1 confirmada, 2 vencida) nodo=%u") \
+  X(DLOG_STORE_PUT,       'W', "app_node",    "sin enlace: alerta epoch=%ums guardada (%u pendientes)") \
+  X(DLOG_STORE_FLUSH,     'I', "app_node",    "reenviadas %u alertas guardadas (%u pendientes)") \
+  X(DLOG_RX_BATCH,        'I', "app_rx",      "lote diferido n=%u")                       \
+  X(DLOG_IMU_READ_FAIL,   'E', "imu_mpu9250", "read failed (%u B)")
+
+#define DLOG_ENUM_(id, lvl, tag, fmt) id,
+typedef enum {
+  DLOG_MESSAGES(DLOG_ENUM_)
+  DLOG_MSG_COUNT
+} dlog_id_t;
+#undef DLOG_ENUM_
+
+typedef struct {
+  char level;
+  const char* tag;
+  const char* fmt;
+} dlog_msg_t;
+
+typedef struct {
+  uint32_t pushed;
+  uint32_t dropped;
+  uint32_t printed;
+  uint32_t high_water;
+} dlog_stats_t;
+
+// Idempotentes: nodo y receptor pueden compartir proceso en host.
+void dlog_init(void);
+void dlog_start(int core);   // crea tsk_dlog (OS_PRIO_LOW)
+bool dlog_write(dlog_id_t id, const int32_t* args, size_t nargs);
+// Formatea todo lo pendiente en el contexto actual (lo usa tsk_dlog).
+size_t dlog_flush(void);
+const dlog_msg_t* dlog_msg(dlog_id_t id);
+void dlog_stats(dlog_stats_t* out);
+void tsk_dlog(void* arg);
+
+#if DLOG_ENABLE
+#define DLOG(id, ...)                                                     \
+  dlog_write((id), (const int32_t[]){ 0, ##__VA_ARGS__ } + 1,             \
+             sizeof((int32_t[]){ 0, ##__VA_ARGS__ }) / sizeof(int32_t) - 1U)
+#else
+#define DLOG(id, ...) ((void)0)
+#endif
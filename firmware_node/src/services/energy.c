@@ -0,0 +1,131 @@
+#include "firmware_node/src/services/energy.h"
+#include "config/energy_params.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+  uint8_t state;
+  uint64_t since_us;
+  uint64_t residency_us[ENERGY_MAX_STATES];
+} energy_dom_t;
+
+static const uint32_t s_current_ua[ENERGY_DOM_COUNT][ENERGY_MAX_STATES] = {
+  [ENERGY_CPU] = { ENERGY_I_CPU_IDLE_UA, ENERGY_I_CPU_ACTIVE_UA, 0, 0 },
+  [ENERGY_RADIO] = { ENERGY_I_RADIO_SLEEP_UA, ENERGY_I_RADIO_STDBY_UA, ENERGY_I_RADIO_RX_UA,
+                     ENERGY_I_RADIO_TX_UA },
+  [ENERGY_IMU] = { ENERGY_I_IMU_SLEEP_UA, ENERGY_I_IMU_LP_ACCEL_UA, ENERGY_I_IMU_ACCEL_UA,
+                   ENERGY_I_IMU_ACCEL_GYRO_UA },
+  [ENERGY_LED] = { 0, ENERGY_I_LED_BLINK_UA, ENERGY_I_LED_ON_UA, 0 },
+};
+
+static const char* const s_dom_names[ENERGY_DOM_COUNT] = { "cpu", "radio", "imu", "led" };
+static const char* const s_state_names[ENERGY_DOM_COUNT][ENERGY_MAX_STATES] = {
+  [ENERGY_CPU] = { "idle", "activa", NULL, NULL },
+  [ENERGY_RADIO] = { "sleep", "stdby", "rx", "tx" },
+  [ENERGY_IMU] = { "sleep", "lp_accel", "accel", "accel_gyro" },
+  [ENERGY_LED] = { "off", "blink", "on", NULL },
+};
+
+static energy_dom_t s_dom[ENERGY_DOM_COUNT];
+static uint64_t s_start_us = 0;
+static int s_first_task = 0;
+static bool s_ready = false;
+
+void energy_init(void) {
+  mem_report_static("energy", sizeof(s_dom));
+  memset(s_dom, 0, sizeof(s_dom));
+  s_start_us = os_now_us();
+  for (unsigned d = 0; d < ENERGY_DOM_COUNT; ++d) s_dom[d].since_us = s_start_us;
+  // Antes de sus init: SX1276 en standby tras power-on, MPU9250 en sleep.
+  s_dom[ENERGY_RADIO].state = ENERGY_RADIO_STDBY;
+  s_dom[ENERGY_IMU].state = ENERGY_IMU_SLEEP;
+  s_first_task = 0;
+  while (os_task_name(s_first_task)) s_first_task++;
+  s_ready = true;
+}
+
+void energy_set_state(energy_domain_t dom, uint8_t state) {
+  if (!s_ready || (unsigned)dom >= ENERGY_DOM_COUNT || state >= ENERGY_MAX_STATES) return;
+  energy_dom_t* d = &s_dom[dom];
+  const uint64_t now = os_now_us();
+  if (now > d->since_us) d->residency_us[d->state] += now - d->since_us;
+  d->state = state;
+  d->since_us = now;
+}
+
+void energy_account_us(energy_domain_t dom, uint8_t state, uint32_t us) {
+  if (!s_ready || (unsigned)dom >= ENERGY_DOM_COUNT || state >= ENERGY_MAX_STATES) return;
+  energy_dom_t* d = &s_dom[dom];
+  d->residency_us[state] += us;
+  d->since_us += us;   // el intervalo abierto del estado actual se acorta
+}
+
+// I [µA] · t [µs] → nAh: / 3.6e6.
+static uint64_t charge_nah(uint32_t current_ua, uint64_t us) {
+  return (uint64_t)current_ua * us / 3600000ULL;
+}
+
+void energy_snapshot(energy_report_t* out) {
+  if (!out) return;
+  memset(out, 0, sizeof(*out));
+  if (!s_ready) return;
+  const uint64_t now = os_now_us();
+  out->elapsed_us = now - s_start_us;
+
+  for (unsigned d = ENERGY_RADIO; d < ENERGY_DOM_COUNT; ++d) {
+    const energy_dom_t* dom = &s_dom[d];
+    memcpy(out->residency_us[d], dom->residency_us, sizeof(dom->residency_us));
+    if (now > dom->since_us) out->residency_us[d][dom->state] += now - dom->since_us;
+  }
+
+  // CPU: tiempo fuera de esperas de os_port de las tareas del nodo. Con dos
+  // núcleos puede superar el tiempo real; el modelo lo acota (una sola CPU
+  // "despierta" domina el consumo del ESP32).
+  uint64_t busy = 0;
+  for (int t = s_first_task; os_task_name(t); ++t) busy += os_task_busy_us(t);
+  if (busy > out->elapsed_us) busy = out->elapsed_us;
+  out->residency_us[ENERGY_CPU][ENERGY_CPU_ACTIVE] = busy;
+  out->residency_us[ENERGY_CPU][ENERGY_CPU_IDLE] = out->elapsed_us - busy;
+
+  for (unsigned d = 0; d < ENERGY_DOM_COUNT; ++d) {
+    for (unsigned s = 0; s < ENERGY_MAX_STATES; ++s) {
+      out->charge_nah[d] += charge_nah(s_current_ua[d][s], out->residency_us[d][s]);
+    }
+    out->charge_total_nah += out->charge_nah[d];
+  }
+  out->charge_board_nah = charge_nah(ENERGY_I_BOARD_UA, out->elapsed_us);
+  out->charge_total_nah += out->charge_board_nah;
+
+  if (out->elapsed_us > 0U) {
+    out->avg_current_ua = (uint32_t)(out->charge_total_nah * 3600000ULL / out->elapsed_us);
+  }
+  if (out->avg_current_ua > 0U) {
+    const uint64_t usable_uah = (uint64_t)ENERGY_BATTERY_MAH * 1000U * ENERGY_BATTERY_USABLE_PCT / 100U;
+    out->life_hours = (uint32_t)(usable_uah / out->avg_current_ua);
+  }
+}
+
+void energy_dump(void) {
+  energy_report_t r;
+  energy_snapshot(&r);
+  for (unsigned d = 0; d < ENERGY_DOM_COUNT; ++d) {
+    printf("NRG %-5s", s_dom_names[d]);
+    for (unsigned s = 0; s < ENERGY_MAX_STATES; ++s) {
+      if (!s_state_names[d][s]) continue;
+      printf(" %s=%llums", s_state_names[d][s], (unsigned long long)(r.residency_us[d][s] / 1000U));
+    }
+    printf(" carga=%llu.%03llu uAh\n", (unsigned long long)(r.charge_nah[d] / 1000U),
+           (unsigned long long)(r.charge_nah[d] % 1000U));
+  }
+  printf("NRG placa carga=%llu.%03llu uAh\n", (unsigned long long)(r.charge_board_nah / 1000U),
+         (unsigned long long)(r.charge_board_nah % 1000U));
+  printf("NRG total %llums carga=%llu.%03llu uAh media=%u uA autonomia=%u h (%u d, %u mAh al %u%%)\n",
+         (unsigned long long)(r.elapsed_us / 1000U), (unsigned long long)(r.charge_total_nah / 1000U),
+         (unsigned long long)(r.charge_total_nah % 1000U), (unsigned)r.avg_current_ua,
+         (unsigned)r.life_hours, (unsigned)(r.life_hours / 24U), (unsigned)ENERGY_BATTERY_MAH,
+         (unsigned)ENERGY_BATTERY_USABLE_PCT);
+  fflush(stdout);
+}
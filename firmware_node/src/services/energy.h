@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Modelo de energía por residencia de estados. Cada dominio (CPU, radio, IMU,
+// LED) acumula microsegundos en su estado actual; el consumo sale de
+// multiplicar por la corriente de config/energy_params.h. Los drivers y la
+// app anuncian cambios con energy_set_state(); la CPU se deriva del tiempo
+// que las tareas pasan fuera de las esperas de os_port (os_task_busy_us).
+// Sólo cuenta las tareas creadas después de energy_init() (en host el
+// receptor comparte proceso y se crea antes que el nodo).
+// Un escritor por dominio; energy_snapshot() desde otra tarea es aproximado.
+
+typedef enum {
+  ENERGY_CPU = 0,
+  ENERGY_RADIO,
+  ENERGY_IMU,
+  ENERGY_LED,
+  ENERGY_DOM_COUNT
+} energy_domain_t;
+
+typedef enum { ENERGY_CPU_IDLE = 0, ENERGY_CPU_ACTIVE } energy_cpu_state_t;
+typedef enum {
+  ENERGY_RADIO_SLEEP = 0,
+  ENERGY_RADIO_STDBY,
+  ENERGY_RADIO_RX,
+  ENERGY_RADIO_TX
+} energy_radio_state_t;
+typedef enum {
+  ENERGY_IMU_SLEEP = 0,
+  ENERGY_IMU_LP_ACCEL,
+  ENERGY_IMU_ACCEL,
+  ENERGY_IMU_ACCEL_GYRO
+} energy_imu_state_t;
+typedef enum { ENERGY_LED_OFF = 0, ENERGY_LED_BLINK, ENERGY_LED_ON } energy_led_state_t;
+
+#define ENERGY_MAX_STATES 4U
+
+typedef struct {
+  uint64_t elapsed_us;
+  uint64_t residency_us[ENERGY_DOM_COUNT][ENERGY_MAX_STATES];
+  uint64_t charge_nah[ENERGY_DOM_COUNT];
+  uint64_t charge_board_nah;
+  uint64_t charge_total_nah;
+  uint32_t avg_current_ua;
+  uint32_t life_hours;   // batería útil / corriente media
+} energy_report_t;
+
+void energy_init(void);
+// Cambia el estado del dominio desde ahora. Se ignora antes de energy_init().
+void energy_set_state(energy_domain_t dom, uint8_t state);
+// Suma us de residencia en state restándolos del estado actual (tiempos
+// modelados, p. ej. el tiempo en aire del stub de radio en host).
+void energy_account_us(energy_domain_t dom, uint8_t state, uint32_t us);
+void energy_snapshot(energy_report_t* out);
+// "NRG ..." por stdout: residencia y carga por dominio, corriente media,
+// autonomía proyectada.
+void energy_dump(void);
@@ -0,0 +1,59 @@
+#include "firmware_node/src/services/fall_clf.h"
+#include "firmware_node/src/services/fall_clf_model.h"
+#include "firmware_node/src/services/fixmath.h"
+#include "firmware_node/src/services/prof.h"
+
+_Static_assert(FALL_CLF_MODEL_N_IN == FALL_CLF_N_IN, "fall_clf_model.h no coincide con las entradas");
+
+static fall_clf_stats_t s_stats;
+
+void fall_clf_features(const feat_values_t* at_peak, const feat_values_t* now, int16_t peak_centi_g,
+                       int32_t out[FALL_CLF_N_IN]) {
+  out[0] = at_peak->min_centi_g;
+  out[1] = at_peak->max_centi_g;
+  out[2] = at_peak->mean_centi_g;
+  out[3] = (int32_t)isqrt32(at_peak->var_centi_g2);
+  out[4] = at_peak->sma_centi_g;
+  out[5] = (int32_t)(at_peak->jerk_centi_g_s / 100U);
+  out[6] = now->mean_centi_g;
+  out[7] = peak_centi_g;
+}
+
+static int32_t clamp_i8(int64_t v, int32_t lo) {
+  if (v > 127) return 127;
+  if (v < lo) return lo;
+  return (int32_t)v;
+}
+
+int32_t fall_clf_score(const int32_t in[FALL_CLF_N_IN]) {
+  int32_t xq[FALL_CLF_N_IN];
+  for (unsigned i = 0; i < FALL_CLF_N_IN; ++i) {
+    // (x - off) · mul / 256 → int8 (≈ ±4 desvíos del entrenamiento)
+    xq[i] = clamp_i8(((int64_t)in[i] - k_fall_clf_in_off[i]) * k_fall_clf_in_mul[i] >> 8, -127);
+  }
+  int32_t out = k_fall_clf_b2;
+  for (unsigned j = 0; j < FALL_CLF_N_HID; ++j) {
+    int32_t acc = k_fall_clf_b1[j];
+    for (unsigned i = 0; i < FALL_CLF_N_IN; ++i) acc += (int32_t)k_fall_clf_w1[j][i] * xq[i];
+    const int32_t h = clamp_i8((int64_t)acc >> FALL_CLF_SHIFT1, 0);   // ReLU + requantización
+    out += (int32_t)k_fall_clf_w2[j] * h;
+  }
+  return out;
+}
+
+bool fall_clf_accept(const feat_values_t* at_peak, const feat_values_t* now, int16_t peak_centi_g) {
+  if (!at_peak || !now) return true;   // sin datos: no bloquear la alerta
+  const uint32_t t0 = prof_cycles();
+  int32_t in[FALL_CLF_N_IN];
+  fall_clf_features(at_peak, now, peak_centi_g, in);
+  const bool fall = fall_clf_score(in) > 0;
+  const uint32_t dt = prof_cycles() - t0;
+  s_stats.runs++;
+  if (!fall) s_stats.rejected++;
+  if (dt > s_stats.cycles_max) s_stats.cycles_max = dt;
+  return fall;
+}
+
+void fall_clf_stats(fall_clf_stats_t* out) {
+  if (out) *out = s_stats;
+}
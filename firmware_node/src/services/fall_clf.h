@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "firmware_node/src/services/feat_window.h"
+
+// Segunda etapa opcional del detector: MLP int8 (FALL_CLF_N_IN → 8 ReLU → 1)
+// que se evalúa sólo cuando las reglas de umbral confirman un evento. Pesos
+// entrenados fuera de línea (tools/train_fall_clf.py) y generados como
+// tablas const en fall_clf_model.h. Inferencia entera, lazos de longitud
+// fija: cota de peor caso = FALL_CLF_MACS multiplicaciones-acumulaciones +
+// cuantización de entradas + una raíz de 16 pasos (sin ramas dependientes de
+// datos salvo saturaciones).
+
+#define FALL_CLF_N_IN 8U
+
+// Entradas (enteros, antes de cuantizar), en orden:
+//   0 min |a| pre-pico   1 max |a| pre-pico   2 media |a| pre-pico
+//   3 desvío |a| pre-pico  4 SMA pre-pico  5 jerk medio pre-pico (g/s)
+//   6 media |a| al confirmar  7 pico por eje del detector
+// Todo en centi-g salvo el jerk.
+void fall_clf_features(const feat_values_t* at_peak, const feat_values_t* now, int16_t peak_centi_g,
+                       int32_t out[FALL_CLF_N_IN]);
+
+// Puntaje entero; > 0 = caída.
+int32_t fall_clf_score(const int32_t in[FALL_CLF_N_IN]);
+
+// features + puntaje + estadísticas. true = aceptar la alerta.
+bool fall_clf_accept(const feat_values_t* at_peak, const feat_values_t* now, int16_t peak_centi_g);
+
+typedef struct {
+  uint32_t runs;
+  uint32_t rejected;
+  uint32_t cycles_max;   // prof_cycles() de fall_clf_accept, peor visto
+} fall_clf_stats_t;
+void fall_clf_stats(fall_clf_stats_t* out);
@@ -0,0 +1,28 @@
+#pragma once
+
+// GENERADO por tools/train_fall_clf.py — no editar a mano.
+// entrenado con 1198 eventos: TP=588 FN=12 FP=0 TN=598 (inferencia entera)
+
+#include <stdint.h>
+
+#define FALL_CLF_MODEL_N_IN 8
+#define FALL_CLF_N_HID 8
+#define FALL_CLF_SHIFT1 7
+#define FALL_CLF_MACS (FALL_CLF_MODEL_N_IN * FALL_CLF_N_HID + FALL_CLF_N_HID)
+#define FALL_CLF_TABLE_BYTES 156
+
+static const int32_t k_fall_clf_in_off[FALL_CLF_MODEL_N_IN] = { 39, 329, 68, 48, 74, 8, 8, 324 };
+static const int16_t k_fall_clf_in_mul[FALL_CLF_MODEL_N_IN] = { 304, 130, 277, 625, 267, 3693, 3365, 133 };
+static const int8_t k_fall_clf_w1[FALL_CLF_N_HID][FALL_CLF_MODEL_N_IN] = {
+  { 6, 6, -2, -3, -5, 0, 0, -6 },
+  { 29, 3, -14, -10, 44, -14, -2, 30 },
+  { -6, -32, 91, 25, 87, -2, -1, -10 },
+  { 127, 16, -32, -42, 61, 5, 6, 127 },
+  { -4, -24, 66, 20, 63, -4, -1, -7 },
+  { 6, -7, 24, 11, 19, -6, 5, -2 },
+  { -2, -27, 55, 21, 57, -4, -1, -3 },
+  { 7, -43, -45, 39, 32, 7, -2, -91 },
+};
+static const int32_t k_fall_clf_b1[FALL_CLF_N_HID] = { -85, 2063, -2771, 2759, -2024, -557, -1758, 2757 };
+static const int8_t k_fall_clf_w2[FALL_CLF_N_HID] = { 4, 19, -127, 17, -93, -36, -81, 61 };
+static const int32_t k_fall_clf_b2 = -100;
@@ -1,7 +1,15 @@
 #include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/fall_clf.h"
+#include "firmware_node/src/services/lat_probe.h"
+#include "firmware_node/src/services/mem_report.h"
+#include "firmware_node/src/services/orientation.h"
+#include "firmware_node/src/services/prof.h"
 #include "config/fall_params.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+#define FALL_POSTURE_SLOTS 8U   // instantáneas de orientación en FALL_POSTURE_REF_MS
 
 typedef enum {
   FALL_STATE_WAIT_PEAK = 0,
@@ -13,17 +21,33 @@ typedef struct {
   fall_state_t state;
   int16_t peak_centi_g;
   uint32_t peak_epoch_ms;
+  uint64_t peak_us;         // reloj real del pico (sondas de latencia)
   uint32_t idle_acc_ms;
   uint32_t elapsed_ms;
   uint32_t sample_period_ms;
   uint32_t sample_period_rem;
   uint32_t sample_period_rem_acc;
+  // Postura: ring de orientaciones recientes; peak_ref = la más vieja al pico.
+  orient_vec_t posture_ring[FALL_POSTURE_SLOTS];
+  uint8_t posture_head;
+  uint8_t posture_fill;
+  uint16_t posture_step;      // muestras entre instantáneas
+  uint16_t posture_countdown;
+  orient_vec_t peak_ref;
+  bool peak_ref_valid;
+  fall_posture_stats_t posture;
+  feat_window_t feat;
+  feat_values_t peak_feat;
+  uint8_t cand_seq;           // seq del candidato en seguimiento
+  uint32_t cand_epoch_ms;     // primer pico del candidato (clave de la prealerta)
+  fall_event_t phase;         // PREALERT/CANCEL de la última muestra
+  bool phase_pending;
   bool initialized;
 } fall_detector_ctx_t;
 
 static fall_detector_ctx_t s_ctx;
 
-static uint32_t compute_sample_period_ms(uint8_t fs_hz, uint32_t* rem_out) {
+static uint32_t compute_sample_period_ms(uint16_t fs_hz, uint32_t* rem_out) {
   if (fs_hz == 0) {
     if (rem_out) *rem_out = 0;
     return 10U;
@@ -39,10 +63,30 @@ static void ctx_reset_state(void) {
   s_ctx.state = FALL_STATE_WAIT_PEAK;
   s_ctx.peak_centi_g = 0;
   s_ctx.peak_epoch_ms = 0;
+  s_ctx.peak_us = 0;
   s_ctx.idle_acc_ms = 0;
+  s_ctx.peak_ref_valid = false;
+}
+
+// Descarta el candidato en seguimiento y anuncia la cancelación de su prealerta.
+static void cancel_candidate(void) {
+  s_ctx.phase.epoch_ms = s_ctx.cand_epoch_ms;
+  s_ctx.phase.ax_peak_centi_g = s_ctx.peak_centi_g;
+  s_ctx.phase.idle_ms = (uint16_t)(s_ctx.idle_acc_ms > 0xFFFFu ? 0xFFFFu : s_ctx.idle_acc_ms);
+  s_ctx.phase.kind = FALL_EVT_CANCEL;
+  s_ctx.phase.seq = s_ctx.cand_seq;
+  s_ctx.phase_pending = true;
+  ctx_reset_state();
+}
+
+static void posture_ring_clear(void) {
+  s_ctx.posture_head = 0U;
+  s_ctx.posture_fill = 0U;
+  s_ctx.posture_countdown = 0U;
 }
 
 void fall_detector_init(const fall_cfg_t* cfg) {
+  mem_report_static("fall_detector", sizeof(s_ctx));
   if (cfg) {
     s_ctx.cfg = *cfg;
   } else {
@@ -50,16 +94,27 @@ void fall_detector_init(const fall_cfg_t* cfg) {
     s_ctx.cfg.Ithr_centi_g = FALL_I_THR_CENTI_G;
     s_ctx.cfg.Tidle_ms     = FALL_IDLE_MS;
     s_ctx.cfg.fs_hz        = FALL_FS_HZ;
+    s_ctx.cfg.use_clf      = FALL_CLF_ENABLE;
   }
 
   s_ctx.elapsed_ms = 0;
   s_ctx.sample_period_ms = compute_sample_period_ms(s_ctx.cfg.fs_hz, &s_ctx.sample_period_rem);
   s_ctx.sample_period_rem_acc = 0U;
+  uint32_t step = (uint32_t)FALL_POSTURE_REF_MS * s_ctx.cfg.fs_hz / (1000U * FALL_POSTURE_SLOTS);
+  s_ctx.posture_step = (uint16_t)(step == 0U ? 1U : (step > 0xFFFFU ? 0xFFFFU : step));
+  posture_ring_clear();
+  memset(&s_ctx.posture, 0, sizeof(s_ctx.posture));
+  const uint32_t win = (uint32_t)FALL_FEAT_WIN_MS * s_ctx.cfg.fs_hz / 1000U;
+  feat_window_init(&s_ctx.feat, (uint16_t)(win > 0xFFFFU ? 0xFFFFU : win), s_ctx.cfg.fs_hz);
+  memset(&s_ctx.peak_feat, 0, sizeof(s_ctx.peak_feat));
+  s_ctx.cand_seq = 0U;
+  s_ctx.phase_pending = false;
   s_ctx.initialized = true;
   ctx_reset_state();
 }
 
 static int16_t vector_peak_centi_g(const accel_raw_t* s) {
+  PROF_SCOPE(PROF_VECTOR_PEAK);
   int16_t ax = (int16_t)abs(s->ax);
   int16_t ay = (int16_t)abs(s->ay);
   int16_t az = (int16_t)abs(s->az);
@@ -81,12 +136,44 @@ static uint32_t advance_time_ms(void) {
   return s_ctx.elapsed_ms;
 }
 
-bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event) {
+// Instantánea cada posture_step muestras (sólo con estimación válida).
+static void posture_sample(void) {
+  if (!orientation_valid()) return;
+  if (s_ctx.posture_countdown > 0U) {
+    s_ctx.posture_countdown--;
+    return;
+  }
+  s_ctx.posture_countdown = (uint16_t)(s_ctx.posture_step - 1U);
+  orientation_get(&s_ctx.posture_ring[s_ctx.posture_head]);
+  s_ctx.posture_head = (uint8_t)((s_ctx.posture_head + 1U) % FALL_POSTURE_SLOTS);
+  if (s_ctx.posture_fill < FALL_POSTURE_SLOTS) s_ctx.posture_fill++;
+}
+
+static void posture_capture_ref(void) {
+  if (s_ctx.posture_fill == 0U) return;
+  const uint8_t oldest = s_ctx.posture_fill < FALL_POSTURE_SLOTS ? 0U : s_ctx.posture_head;
+  s_ctx.peak_ref = s_ctx.posture_ring[oldest];
+  s_ctx.peak_ref_valid = true;
+}
+
+// true si la postura cambió (o no hay con qué comparar: ante la duda, alertar).
+static bool posture_changed(void) {
+  if (!s_ctx.peak_ref_valid) return true;
+  orient_vec_t now;
+  orientation_get(&now);
+  s_ctx.posture.last_cos_q15 = orientation_cos_q15(&s_ctx.peak_ref, &now);
+  return s_ctx.posture.last_cos_q15 < FALL_POSTURE_COS_Q15;
+}
+
+static bool feed_sample(const accel_raw_t* s, fall_event_t* out_event, bool posture) {
+  PROF_SCOPE(PROF_FALL_FEED);
   if (!s || !out_event) return false;
   if (!s_ctx.initialized) fall_detector_init(NULL);
 
   const uint32_t sample_epoch_ms = advance_time_ms();
   const int16_t sample_peak = vector_peak_centi_g(s);
+  feat_window_push(&s_ctx.feat, s);
+  s_ctx.phase_pending = false;
 
   switch (s_ctx.state) {
     case FALL_STATE_WAIT_PEAK:
@@ -94,7 +181,19 @@ bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event) {
         s_ctx.state = FALL_STATE_TRACK_IDLE;
         s_ctx.peak_centi_g = sample_peak;
         s_ctx.peak_epoch_ms = sample_epoch_ms;
+        s_ctx.peak_us = LAT_PROBE_NOW();
         s_ctx.idle_acc_ms = 0;
+        feat_window_get(&s_ctx.feat, &s_ctx.peak_feat);
+        if (posture) posture_capture_ref();
+        s_ctx.cand_seq++;
+        s_ctx.cand_epoch_ms = sample_epoch_ms;
+        s_ctx.phase.epoch_ms = sample_epoch_ms;
+        s_ctx.phase.ax_peak_centi_g = sample_peak;
+        s_ctx.phase.idle_ms = 0U;
+        s_ctx.phase.kind = FALL_EVT_PREALERT;
+        s_ctx.phase.seq = s_ctx.cand_seq;
+        s_ctx.phase_pending = true;
+        LAT_PROBE_MARK_AT(sample_epoch_ms, LAT_STAGE_PEAK, s_ctx.peak_us);
       }
       break;
 
@@ -102,6 +201,8 @@ bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event) {
       if (sample_peak > s_ctx.peak_centi_g) {
         s_ctx.peak_centi_g = sample_peak;
         s_ctx.peak_epoch_ms = sample_epoch_ms;
+        s_ctx.peak_us = LAT_PROBE_NOW();
+        feat_window_get(&s_ctx.feat, &s_ctx.peak_feat);
       }
 
       if (sample_peak <= s_ctx.cfg.Ithr_centi_g) {
@@ -113,9 +214,29 @@ bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event) {
       }
 
       if (s_ctx.idle_acc_ms >= s_ctx.cfg.Tidle_ms) {
+        if (posture) {
+          if (!posture_changed()) {
+            s_ctx.posture.rejected++;
+            cancel_candidate();
+            return false;
+          }
+          s_ctx.posture.confirmed++;
+        }
+        if (s_ctx.cfg.use_clf) {
+          feat_values_t now;
+          feat_window_get(&s_ctx.feat, &now);
+          if (!fall_clf_accept(&s_ctx.peak_feat, &now, s_ctx.peak_centi_g)) {
+            cancel_candidate();
+            return false;
+          }
+        }
         out_event->epoch_ms = s_ctx.peak_epoch_ms;
         out_event->ax_peak_centi_g = s_ctx.peak_centi_g;
         out_event->idle_ms = (uint16_t)(s_ctx.idle_acc_ms > 0xFFFFu ? 0xFFFFu : s_ctx.idle_acc_ms);
+        out_event->kind = FALL_EVT_CONFIRMED;
+        out_event->seq = s_ctx.cand_seq;
+        LAT_PROBE_MARK_AT(out_event->epoch_ms, LAT_STAGE_PEAK, s_ctx.peak_us);
+        LAT_PROBE_MARK(out_event->epoch_ms, LAT_STAGE_CONFIRM);
         ctx_reset_state();
         return true;
       }
@@ -123,7 +244,7 @@ bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event) {
       if (sample_peak < s_ctx.cfg.Athr_centi_g && s_ctx.idle_acc_ms == 0) {
         const uint32_t window_ms = s_ctx.cfg.Tidle_ms + 100U;
         if ((sample_epoch_ms - s_ctx.peak_epoch_ms) > window_ms) {
-          ctx_reset_state();
+          cancel_candidate();
         }
       }
       break;
@@ -131,3 +252,49 @@ bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event) {
 
   return false;
 }
+
+bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event) {
+  return feed_sample(s, out_event, false);
+}
+
+bool fall_detector_feed_imu(const accel_raw_t* s, const imu_gyro_t* g, fall_event_t* out_event) {
+  if (!s || !g || !out_event) return false;
+  orientation_update(s, g);
+  posture_sample();
+  return feed_sample(s, out_event, true);
+}
+
+bool fall_detector_take_phase(fall_event_t* out) {
+  if (!out || !s_ctx.phase_pending) return false;
+  *out = s_ctx.phase;
+  s_ctx.phase_pending = false;
+  return true;
+}
+
+void fall_detector_features(feat_values_t* now, feat_values_t* at_peak) {
+  if (now) feat_window_get(&s_ctx.feat, now);
+  if (at_peak) *at_peak = s_ctx.peak_feat;
+}
+
+void fall_detector_posture_stats(fall_posture_stats_t* out) {
+  if (out) *out = s_ctx.posture;
+}
+
+uint32_t fall_detector_now_ms(void) {
+  return s_ctx.elapsed_ms;
+}
+
+bool fall_detector_busy(void) {
+  return s_ctx.state != FALL_STATE_WAIT_PEAK;
+}
+
+void fall_detector_skip_samples(uint32_t n) {
+  if (!s_ctx.initialized) fall_detector_init(NULL);
+  // Igual que n llamadas a advance_time_ms(), en O(1).
+  const uint32_t fs = s_ctx.cfg.fs_hz;
+  const uint64_t rem = (uint64_t)s_ctx.sample_period_rem * n + s_ctx.sample_period_rem_acc;
+  s_ctx.elapsed_ms += n * s_ctx.sample_period_ms + (fs ? (uint32_t)(rem / fs) : 0U);
+  s_ctx.sample_period_rem_acc = fs ? (uint32_t)(rem % fs) : 0U;
+  posture_ring_clear();   // orientaciones previas al hueco ya no sirven de referencia
+  feat_window_reset(&s_ctx.feat);
+}
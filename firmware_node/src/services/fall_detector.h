@@ -3,18 +3,33 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "firmware_node/src/drivers/imu_accel.h"
+#include "firmware_node/src/services/feat_window.h"
+
+// Alerta en dos fases: PREALERT al entrar en seguimiento (pico ≥ Athr) y,
+// para el mismo candidato (mismo seq), CONFIRMED tras Tidle_ms de
+// inmovilidad o CANCEL si se descarta (sin inmovilidad a tiempo, postura,
+// segunda etapa). CONFIRMED = 0 para que un evento sin inicializar siga
+// siendo una alerta común.
+typedef enum {
+  FALL_EVT_CONFIRMED = 0,
+  FALL_EVT_PREALERT,
+  FALL_EVT_CANCEL
+} fall_evt_kind_t;
 
 typedef struct {
-  uint32_t epoch_ms;
+  uint32_t epoch_ms;         // PREALERT/CANCEL: primer pico del candidato
   int16_t  ax_peak_centi_g;
   uint16_t idle_ms;
+  uint8_t  kind;             // fall_evt_kind_t
+  uint8_t  seq;              // candidato (módulo 256)
 } fall_event_t;
 
 typedef struct {
   int16_t Athr_centi_g;   // ~220 (≈2.2 g)
   int16_t Ithr_centi_g;   // ~20  (≈0.2 g)
   uint16_t Tidle_ms;      // 500..1000 ms
-  uint8_t fs_hz;          // 100 Hz
+  uint16_t fs_hz;         // 100 Hz (hasta 1000)
+  bool use_clf;           // segunda etapa (services/fall_clf) al confirmar
 } fall_cfg_t;
 
 void fall_detector_init(const fall_cfg_t* cfg);
@@ -23,3 +38,36 @@ void fall_detector_init(const fall_cfg_t* cfg);
 // escribe en out_event.
 bool fall_detector_feed(const accel_raw_t* s, fall_event_t* out_event);
 
+// PREALERT o CANCEL generado por la última muestra (a lo sumo uno por
+// muestra); true si había uno y lo copia en out. Llamar tras cada feed: el
+// siguiente feed lo descarta.
+bool fall_detector_take_phase(fall_event_t* out);
+
+// Igual que fall_detector_feed() con la muestra de giroscopio: actualiza
+// services/orientation y, al confirmar, exige un cambio de postura respecto
+// de la orientación ~FALL_POSTURE_REF_MS antes del pico (cos <
+// FALL_POSTURE_COS_Q15); si no lo hay el evento se descarta (sentarse de
+// golpe). Requiere orientation_init().
+bool fall_detector_feed_imu(const accel_raw_t* s, const imu_gyro_t* g, fall_event_t* out_event);
+
+typedef struct {
+  uint32_t confirmed;        // eventos con cambio de postura
+  uint32_t rejected;         // pico + inmovilidad sin cambio de postura
+  int16_t  last_cos_q15;     // coseno pre → post del último candidato
+} fall_posture_stats_t;
+void fall_detector_posture_stats(fall_posture_stats_t* out);
+
+// Features de la ventana deslizante (FALL_FEAT_WIN_MS) que mantiene el
+// detector: al cerrar la última muestra y en el pico del último candidato
+// (caída libre previa = min, impacto = max, jerk, varianza, SMA).
+void fall_detector_features(feat_values_t* now, feat_values_t* at_peak);
+
+// Tiempo del detector (ms) de la última muestra procesada; misma base que
+// fall_event_t.epoch_ms.
+uint32_t fall_detector_now_ms(void);
+
+// true mientras hay un pico en seguimiento (no conviene dejar de muestrear).
+bool fall_detector_busy(void);
+// Avanza el reloj del detector n muestras sin datos (IMU en wake-on-motion):
+// epoch_ms sigue siendo tiempo real. Sólo válido con el detector libre.
+void fall_detector_skip_samples(uint32_t n);
@@ -0,0 +1,105 @@
+#include "firmware_node/src/services/feat_window.h"
+#include "firmware_node/src/services/fixmath.h"
+#include "firmware_node/src/services/prof.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if (FEAT_WIN_MAX & (FEAT_WIN_MAX - 1U)) != 0U || FEAT_WIN_MAX > 4096U
+#error "FEAT_WIN_MAX debe ser potencia de 2 y <= 4096"
+#endif
+
+#define FEAT_MASK (FEAT_WIN_MAX - 1U)
+
+void feat_window_init(feat_window_t* w, uint16_t len, uint16_t fs_hz) {
+  if (!w) return;
+  if (len == 0U) len = 1U;
+  if (len > FEAT_WIN_MAX) len = FEAT_WIN_MAX;
+  w->len = len;
+  w->fs_hz = fs_hz;
+  feat_window_reset(w);
+}
+
+void feat_window_reset(feat_window_t* w) {
+  if (!w) return;
+  w->seq = 0U;
+  w->n = 0U;
+  w->sum_mag = 0;
+  w->sum_svm = 0;
+  w->sum_djerk = 0;
+  w->sum_sq = 0;
+  w->prev_mag = 0;
+  w->have_prev = false;
+  w->dq_min_head = w->dq_min_cnt = 0U;
+  w->dq_max_head = w->dq_max_cnt = 0U;
+}
+
+static inline uint16_t dq_back(const uint16_t* dq, uint16_t head, uint16_t cnt) {
+  return dq[(head + cnt - 1U) & FEAT_MASK];
+}
+
+// Saca del frente lo que sale de la ventana con esta muestra y del fondo lo
+// dominado por v (is_max: valores ≤ v; si no, ≥ v). Queda ≤ len entradas.
+static void dq_push(feat_window_t* w, uint16_t* dq, uint16_t* head, uint16_t* cnt, int16_t v, bool is_max) {
+  while (*cnt > 0U && (uint16_t)(w->seq - dq[*head]) >= w->len) {
+    *head = (uint16_t)((*head + 1U) & FEAT_MASK);
+    (*cnt)--;
+  }
+  while (*cnt > 0U) {
+    const int16_t back = w->mag[dq_back(dq, *head, *cnt) & FEAT_MASK];
+    if (is_max ? back > v : back < v) break;
+    (*cnt)--;
+  }
+  dq[(*head + *cnt) & FEAT_MASK] = w->seq;
+  (*cnt)++;
+}
+
+void feat_window_push(feat_window_t* w, const accel_raw_t* s) {
+  PROF_SCOPE(PROF_FEAT_PUSH);
+  if (!w || !s) return;
+  const uint32_t a2 = (uint32_t)(s->ax * s->ax) + (uint32_t)(s->ay * s->ay) + (uint32_t)(s->az * s->az);
+  const uint16_t m16 = (uint16_t)isqrt32(a2);
+  const int16_t m = (int16_t)(m16 > INT16_MAX ? INT16_MAX : m16);
+  const int32_t svm_full = abs(s->ax) + abs(s->ay) + abs(s->az);
+  const int16_t svm = (int16_t)(svm_full > INT16_MAX ? INT16_MAX : svm_full);
+  const int16_t dj = w->have_prev ? (int16_t)abs(m - w->prev_mag) : 0;
+
+  if (w->n == w->len) {
+    const unsigned old = (uint16_t)(w->seq - w->len) & FEAT_MASK;
+    w->sum_mag -= w->mag[old];
+    w->sum_svm -= w->svm[old];
+    w->sum_djerk -= w->djerk[old];
+    w->sum_sq -= (int32_t)w->mag[old] * w->mag[old];
+  } else {
+    w->n++;
+  }
+  const unsigned slot = w->seq & FEAT_MASK;
+  w->mag[slot] = m;
+  w->svm[slot] = svm;
+  w->djerk[slot] = dj;
+  w->sum_mag += m;
+  w->sum_svm += svm;
+  w->sum_djerk += dj;
+  w->sum_sq += (int32_t)m * m;
+  w->prev_mag = m;
+  w->have_prev = true;
+
+  dq_push(w, w->dq_max, &w->dq_max_head, &w->dq_max_cnt, m, true);
+  dq_push(w, w->dq_min, &w->dq_min_head, &w->dq_min_cnt, m, false);
+  w->seq++;
+}
+
+void feat_window_get(const feat_window_t* w, feat_values_t* out) {
+  if (!out) return;
+  memset(out, 0, sizeof(*out));
+  if (!w || w->n == 0U) return;
+  const int64_t n = w->n;
+  out->n = w->n;
+  out->mean_centi_g = (int16_t)(w->sum_mag / n);
+  const int64_t var_n2 = n * w->sum_sq - (int64_t)w->sum_mag * w->sum_mag;
+  out->var_centi_g2 = var_n2 > 0 ? (uint32_t)(var_n2 / (n * n)) : 0U;
+  out->min_centi_g = w->mag[w->dq_min[w->dq_min_head] & FEAT_MASK];
+  out->max_centi_g = w->mag[w->dq_max[w->dq_max_head] & FEAT_MASK];
+  out->sma_centi_g = (uint16_t)(w->sum_svm / n);
+  out->jerk_centi_g_s = (uint32_t)((int64_t)w->sum_djerk * w->fs_hz / n);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "firmware_node/src/drivers/imu_accel.h"
+
+// Features de ventana deslizante sobre las últimas len muestras, en O(1) por
+// muestra y con memoria fija: sumas y suma de cuadrados corridas (media,
+// varianza, SMA, jerk medio) y deques monótonos para mín/máx de |a|
+// (amortizado O(1): cada muestra entra y sale una vez de cada deque).
+// Aritmética entera; |a| con raíz entera de 16 pasos. Instancia propiedad del
+// llamador, un solo escritor.
+
+#ifndef FEAT_WIN_MAX
+#define FEAT_WIN_MAX 64U   // potencia de 2, ≤ 4096; 10 B por muestra de capacidad
+#endif
+
+typedef struct {
+  uint16_t n;                // muestras en la ventana (≤ len)
+  int16_t  mean_centi_g;     // media de |a|
+  uint32_t var_centi_g2;     // varianza de |a|
+  int16_t  min_centi_g;      // mínimo de |a| (caída libre)
+  int16_t  max_centi_g;      // máximo de |a| (impacto)
+  uint16_t sma_centi_g;      // signal magnitude area: media de |ax|+|ay|+|az|
+  uint32_t jerk_centi_g_s;   // media de |d|a|/dt|
+} feat_values_t;
+
+typedef struct {
+  uint16_t len;
+  uint16_t fs_hz;
+  uint16_t seq;              // próxima muestra (mod 2^16)
+  uint16_t n;
+  int16_t mag[FEAT_WIN_MAX];
+  int16_t svm[FEAT_WIN_MAX];
+  int16_t djerk[FEAT_WIN_MAX];   // ||a|[k] - |a|[k-1]|
+  int32_t sum_mag;
+  int32_t sum_svm;
+  int32_t sum_djerk;
+  int64_t sum_sq;
+  int16_t prev_mag;
+  bool have_prev;
+  // Deques monótonos: secuencias de muestras; mag[seq % FEAT_WIN_MAX] es el valor.
+  uint16_t dq_min[FEAT_WIN_MAX];
+  uint16_t dq_max[FEAT_WIN_MAX];
+  uint16_t dq_min_head, dq_min_cnt;
+  uint16_t dq_max_head, dq_max_cnt;
+} feat_window_t;
+
+// len en muestras (se acota a [1, FEAT_WIN_MAX]); fs_hz para el jerk.
+void feat_window_init(feat_window_t* w, uint16_t len, uint16_t fs_hz);
+// Vacía la ventana (tras un hueco de muestreo) conservando len/fs.
+void feat_window_reset(feat_window_t* w);
+void feat_window_push(feat_window_t* w, const accel_raw_t* s);
+void feat_window_get(const feat_window_t* w, feat_values_t* out);
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+// Aritmética entera compartida por los servicios del detector (sin FPU en el
+// camino de 100 Hz).
+
+// Raíz entera por bits (piso de sqrt(v)): siempre 16 iteraciones, sin
+// divisiones; el resultado entra en 16 bits.
+static inline uint32_t isqrt32(uint32_t v) {
+  uint32_t res = 0;
+  uint32_t bit = 1UL << 30;
+  for (unsigned i = 0; i < 16U; ++i) {
+    if (v >= res + bit) {
+      v -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+    bit >>= 2;
+  }
+  return res;
+}
@@ -0,0 +1,60 @@
+#include "firmware_node/src/services/imu_ring.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#if (IMU_RING_LEN & (IMU_RING_LEN - 1U)) != 0U
+#error "IMU_RING_LEN debe ser potencia de 2"
+#endif
+
+#define IMU_RING_MASK (IMU_RING_LEN - 1U)
+
+// El slot en escritura nunca se considera válido para lectores.
+#define IMU_RING_GUARD 1U
+
+static accel_raw_t s_ring[IMU_RING_LEN];
+static volatile uint32_t s_seq = 0;
+
+void imu_ring_init(void) {
+  mem_report_static("imu_ring", sizeof(s_ring));
+  s_seq = 0;
+}
+
+accel_raw_t* imu_ring_slot(void) {
+  return &s_ring[s_seq & IMU_RING_MASK];
+}
+
+uint32_t imu_ring_commit(void) {
+  const uint32_t seq = s_seq;
+  __sync_synchronize();
+  s_seq = seq + 1U;
+  return seq;
+}
+
+uint32_t imu_ring_seq(void) {
+  return s_seq;
+}
+
+bool imu_ring_still_valid(uint32_t first_seq) {
+  const uint32_t head = s_seq;
+  return (uint32_t)(head - first_seq) <= (IMU_RING_LEN - IMU_RING_GUARD);
+}
+
+bool imu_ring_window(uint32_t first_seq, size_t n, imu_ring_span_t* out) {
+  if (!out || n == 0U || n > (IMU_RING_LEN - IMU_RING_GUARD)) return false;
+  const uint32_t head = s_seq;
+  if ((uint32_t)(head - first_seq) < n) return false;
+  if (!imu_ring_still_valid(first_seq)) return false;
+
+  const size_t start = first_seq & IMU_RING_MASK;
+  const size_t first_len = IMU_RING_LEN - start;
+  out->seg0 = &s_ring[start];
+  if (n <= first_len) {
+    out->n0 = n;
+    out->seg1 = NULL;
+    out->n1 = 0U;
+  } else {
+    out->n0 = first_len;
+    out->seg1 = &s_ring[0];
+    out->n1 = n - first_len;
+  }
+  return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "firmware_node/src/drivers/imu_accel.h"
+
+// Buffer circular de muestras crudas ("caja negra" pre-disparo).
+// Un único escritor (tsk_sample_detect) escribe directo en el slot del ring,
+// sin copias extra; los lectores acceden por número de secuencia.
+
+#ifndef IMU_RING_LEN
+#define IMU_RING_LEN 512U   // potencia de 2; 5.12 s a 100 Hz (3 KB)
+#endif
+
+typedef struct {
+  const accel_raw_t* seg0;
+  size_t n0;
+  const accel_raw_t* seg1;
+  size_t n1;
+} imu_ring_span_t;
+
+void imu_ring_init(void);
+
+// Slot donde escribir la próxima muestra (imu_read() escribe ahí).
+accel_raw_t* imu_ring_slot(void);
+
+// Publica el slot escrito. Retorna la secuencia asignada a la muestra.
+uint32_t imu_ring_commit(void);
+
+// Cantidad total de muestras publicadas (secuencia de la próxima).
+uint32_t imu_ring_seq(void);
+
+// Obtiene la ventana [first_seq, first_seq + n) como hasta dos segmentos
+// contiguos. Falla si parte de la ventana ya fue sobrescrita o no existe.
+bool imu_ring_window(uint32_t first_seq, size_t n, imu_ring_span_t* out);
+
+// true si first_seq sigue intacta (validar después de leer la ventana).
+bool imu_ring_still_valid(uint32_t first_seq);
@@ -0,0 +1,469 @@
+#include "firmware_node/src/services/journal.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <string.h>
+
+#if JOURNAL_SECTORS < 2U
+#error "JOURNAL_SECTORS debe ser >= 2 (uno se recicla mientras el otro está activo)"
+#endif
+
+#if JOURNAL_CAPACITY > 65535U
+#error "JOURNAL_CAPACITY no entra en las posiciones de 16 bits del índice"
+#endif
+
+#define JOURNAL_PART_BYTES ((uint32_t)JOURNAL_SECTORS * JOURNAL_SECTOR_BYTES)
+#define JOURNAL_MAGIC      0x314C4E4AU   // "JNL1"
+#define JOURNAL_REC_MAGIC  0xA5U
+#define JOURNAL_SCAN_RECS  8U            // registros por lectura al recuperar
+
+// Entrada del índice: lo necesario para buscar sin leer flash.
+typedef struct {
+  uint32_t ts;
+  uint16_t loc;     // sector * JOURNAL_RECS_PER_SECTOR + slot
+  uint8_t node;
+  uint8_t kind;
+} jidx_t;
+
+typedef struct {
+  bool mounted;
+  uint32_t sector_seq[JOURNAL_SECTORS];   // 0 = libre
+  uint32_t erase_cnt[JOURNAL_SECTORS];
+  uint16_t head;                          // sector activo
+  uint16_t slot;                          // próximo registro libre del sector activo
+  uint32_t next_rec_no;
+  uint32_t last_ts;
+  jidx_t idx[JOURNAL_CAPACITY];           // anillo en orden de llegada
+  uint16_t first;                         // posición del más viejo en idx
+  uint16_t count;
+  uint16_t by_node[JOURNAL_CAPACITY];     // posiciones en idx, orden (nodo, llegada)
+  journal_stats_t stats;
+} journal_ctx_t;
+
+static journal_ctx_t s_j;
+
+// --- Flash ---
+
+#if APP_USE_FREERTOS
+
+#include "esp_partition.h"
+
+static const esp_partition_t* s_part;
+
+static bool fl_open(void) {
+  s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, JOURNAL_PARTITION_LABEL);
+  return s_part != NULL && s_part->size >= JOURNAL_PART_BYTES;
+}
+
+static void fl_close(void) {
+  s_part = NULL;
+}
+
+static bool fl_read(uint32_t off, void* buf, size_t n) {
+  return esp_partition_read(s_part, off, buf, n) == ESP_OK;
+}
+
+static bool fl_write(uint32_t off, const void* buf, size_t n) {
+  return esp_partition_write(s_part, off, buf, n) == ESP_OK;
+}
+
+static bool fl_erase(uint32_t off) {
+  return esp_partition_erase_range(s_part, off, JOURNAL_SECTOR_BYTES) == ESP_OK;
+}
+
+#else  // host: archivo con semántica NOR
+
+#include <stdio.h>
+
+static const char* s_path = JOURNAL_HOST_PATH;
+static FILE* s_file;
+
+void journal_host_path(const char* path) {
+  s_path = path ? path : JOURNAL_HOST_PATH;
+}
+
+static bool fl_fill(uint32_t off, uint32_t n) {
+  uint8_t ff[256];
+  memset(ff, 0xFF, sizeof(ff));
+  if (fseek(s_file, (long)off, SEEK_SET) != 0) return false;
+  while (n > 0U) {
+    const size_t k = n < sizeof(ff) ? n : sizeof(ff);
+    if (fwrite(ff, 1, k, s_file) != k) return false;
+    n -= (uint32_t)k;
+  }
+  return true;
+}
+
+static bool fl_open(void) {
+  s_file = fopen(s_path, "r+b");
+  if (!s_file) s_file = fopen(s_path, "w+b");
+  if (!s_file) return false;
+  fseek(s_file, 0, SEEK_END);
+  const long size = ftell(s_file);
+  // Archivo nuevo o corto: el resto es flash borrada.
+  if (size >= 0 && (uint32_t)size < JOURNAL_PART_BYTES) {
+    return fl_fill((uint32_t)size, JOURNAL_PART_BYTES - (uint32_t)size);
+  }
+  return true;
+}
+
+static void fl_close(void) {
+  if (s_file) fclose(s_file);
+  s_file = NULL;
+}
+
+static bool fl_read(uint32_t off, void* buf, size_t n) {
+  return fseek(s_file, (long)off, SEEK_SET) == 0 && fread(buf, 1, n, s_file) == n;
+}
+
+// NOR: programar sólo baja bits (AND con lo que hay).
+static bool fl_write(uint32_t off, const void* buf, size_t n) {
+  uint8_t cur[JOURNAL_REC_BYTES];   // registros y cabeceras
+  if (n > sizeof(cur) || !fl_read(off, cur, n)) return false;
+  const uint8_t* src = (const uint8_t*)buf;
+  for (size_t i = 0; i < n; ++i) cur[i] &= src[i];
+  return fseek(s_file, (long)off, SEEK_SET) == 0 && fwrite(cur, 1, n, s_file) == n;
+}
+
+static bool fl_erase(uint32_t off) {
+  return fl_fill(off, JOURNAL_SECTOR_BYTES);
+}
+
+#endif  // APP_USE_FREERTOS
+
+static bool jl_read(uint32_t off, void* buf, size_t n) {
+  s_j.stats.flash_reads++;
+  s_j.stats.flash_read_bytes += (uint32_t)n;
+  return fl_read(off, buf, n);
+}
+
+static bool jl_write(uint32_t off, const void* buf, size_t n) {
+  s_j.stats.flash_writes++;
+  s_j.stats.flash_write_bytes += (uint32_t)n;
+  return fl_write(off, buf, n);
+}
+
+static bool jl_erase(uint16_t sector) {
+  s_j.stats.flash_erases++;
+  return fl_erase((uint32_t)sector * JOURNAL_SECTOR_BYTES);
+}
+
+// --- Formato ---
+
+static uint16_t crc16(const uint8_t* d, size_t n) {
+  uint16_t crc = 0xFFFFU;   // CRC-16/CCITT-FALSE
+  for (size_t i = 0; i < n; ++i) {
+    crc ^= (uint16_t)d[i] << 8;
+    for (int b = 0; b < 8; ++b) {
+      crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+  put_u16(p, (uint16_t)v);
+  put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+  return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static bool all_erased(const uint8_t* p, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (p[i] != 0xFFU) return false;
+  }
+  return true;
+}
+
+// Cabecera: magic, secuencia de sector, borrados, reservado, CRC16.
+static void hdr_encode(uint8_t* b, uint32_t seq, uint32_t erases) {
+  put_u32(b, JOURNAL_MAGIC);
+  put_u32(b + 4, seq);
+  put_u32(b + 8, erases);
+  put_u16(b + 12, 0xFFFFU);
+  put_u16(b + 14, crc16(b, 14));
+}
+
+static bool hdr_decode(const uint8_t* b, uint32_t* seq, uint32_t* erases) {
+  if (get_u32(b) != JOURNAL_MAGIC || get_u16(b + 14) != crc16(b, 14)) return false;
+  *seq = get_u32(b + 4);
+  *erases = get_u32(b + 8);
+  return *seq != 0U;
+}
+
+// Registro: magic, nodo, tipo, seq, rec_no, ts, epoch_ms, pico, reposo, reservado, CRC16.
+static void rec_encode(uint8_t* b, const journal_rec_t* r) {
+  b[0] = JOURNAL_REC_MAGIC;
+  b[1] = r->node;
+  b[2] = r->kind;
+  b[3] = r->seq;
+  put_u32(b + 4, r->rec_no);
+  put_u32(b + 8, r->ts);
+  put_u32(b + 12, r->epoch_ms);
+  put_u16(b + 16, (uint16_t)r->ax_peak_centi_g);
+  put_u16(b + 18, r->idle_ms);
+  put_u16(b + 20, 0xFFFFU);
+  put_u16(b + 22, crc16(b, 22));
+}
+
+static bool rec_decode(const uint8_t* b, journal_rec_t* r) {
+  if (b[0] != JOURNAL_REC_MAGIC || get_u16(b + 22) != crc16(b, 22)) return false;
+  r->node = b[1];
+  r->kind = b[2];
+  r->seq = b[3];
+  r->rec_no = get_u32(b + 4);
+  r->ts = get_u32(b + 8);
+  r->epoch_ms = get_u32(b + 12);
+  r->ax_peak_centi_g = (int16_t)get_u16(b + 16);
+  r->idle_ms = get_u16(b + 18);
+  return true;
+}
+
+static uint32_t rec_offset(uint16_t loc) {
+  const uint32_t sector = loc / JOURNAL_RECS_PER_SECTOR;
+  const uint32_t slot = loc % JOURNAL_RECS_PER_SECTOR;
+  return sector * JOURNAL_SECTOR_BYTES + JOURNAL_HDR_BYTES + slot * JOURNAL_REC_BYTES;
+}
+
+// --- Índice ---
+
+static uint16_t idx_pos(uint32_t logical) {
+  return (uint16_t)((s_j.first + logical) % JOURNAL_CAPACITY);
+}
+
+static uint32_t idx_logical(uint16_t pos) {
+  return (pos + JOURNAL_CAPACITY - s_j.first) % JOURNAL_CAPACITY;
+}
+
+static const jidx_t* idx_at(uint32_t logical) {
+  return &s_j.idx[idx_pos(logical)];
+}
+
+// Primera posición de by_node con nodo > node (>= con inclusive).
+static uint32_t node_bound(uint16_t node, bool inclusive) {
+  uint32_t lo = 0, hi = s_j.count;
+  while (lo < hi) {
+    const uint32_t mid = (lo + hi) / 2U;
+    const uint16_t n = s_j.idx[s_j.by_node[mid]].node;
+    if (inclusive ? n < node : n <= node) lo = mid + 1U; else hi = mid;
+  }
+  return lo;
+}
+
+static void idx_push(const journal_rec_t* r, uint16_t loc) {
+  const uint16_t pos = idx_pos(s_j.count);
+  s_j.idx[pos] = (jidx_t){ r->ts, loc, r->node, r->kind };
+  // La entrada nueva es la más reciente: va al final del bloque de su nodo.
+  const uint32_t at = node_bound(r->node, false);
+  memmove(&s_j.by_node[at + 1U], &s_j.by_node[at], (s_j.count - at) * sizeof(s_j.by_node[0]));
+  s_j.by_node[at] = pos;
+  s_j.count++;
+  s_j.last_ts = r->ts;
+}
+
+// Saca del frente del índice las entradas del sector que se va a reciclar.
+static void idx_evict_sector(uint16_t sector) {
+  uint32_t k = 0;
+  while (k < s_j.count && idx_at(k)->loc / JOURNAL_RECS_PER_SECTOR == sector) k++;
+  if (k == 0U) return;
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < s_j.count; ++i) {
+    if (idx_logical(s_j.by_node[i]) >= k) s_j.by_node[j++] = s_j.by_node[i];
+  }
+  s_j.first = idx_pos(k);
+  s_j.count = (uint16_t)(s_j.count - k);
+  s_j.stats.evicted += k;
+}
+
+// --- Sectores ---
+
+static bool sector_open(uint16_t sector, uint32_t seq) {
+  s_j.erase_cnt[sector]++;
+  s_j.sector_seq[sector] = 0U;
+  uint8_t hdr[JOURNAL_HDR_BYTES];
+  hdr_encode(hdr, seq, s_j.erase_cnt[sector]);
+  // Corte entre el borrado y la cabecera: el sector queda libre.
+  if (!jl_erase(sector) || !jl_write((uint32_t)sector * JOURNAL_SECTOR_BYTES, hdr, sizeof(hdr))) return false;
+  s_j.sector_seq[sector] = seq;
+  s_j.head = sector;
+  s_j.slot = 0;
+  return true;
+}
+
+static bool sector_advance(void) {
+  const uint16_t next = (uint16_t)((s_j.head + 1U) % JOURNAL_SECTORS);
+  idx_evict_sector(next);
+  return sector_open(next, s_j.sector_seq[s_j.head] + 1U);
+}
+
+static void sector_scan(uint16_t sector) {
+  uint8_t buf[JOURNAL_SCAN_RECS * JOURNAL_REC_BYTES];
+  for (uint16_t slot = 0; slot < JOURNAL_RECS_PER_SECTOR; slot += JOURNAL_SCAN_RECS) {
+    const uint16_t n = (uint16_t)((JOURNAL_RECS_PER_SECTOR - slot) < JOURNAL_SCAN_RECS
+                                       ? JOURNAL_RECS_PER_SECTOR - slot : JOURNAL_SCAN_RECS);
+    const uint16_t loc0 = (uint16_t)(sector * JOURNAL_RECS_PER_SECTOR + slot);
+    if (!jl_read(rec_offset(loc0), buf, (size_t)n * JOURNAL_REC_BYTES)) return;
+    for (uint16_t i = 0; i < n; ++i) {
+      const uint8_t* b = &buf[i * JOURNAL_REC_BYTES];
+      // Se escribe en orden: el primer hueco es el fin del sector.
+      if (all_erased(b, JOURNAL_REC_BYTES)) {
+        s_j.slot = (uint16_t)(slot + i);
+        return;
+      }
+      journal_rec_t r;
+      if (!rec_decode(b, &r)) {
+        s_j.stats.torn++;
+        continue;
+      }
+      if (r.ts < s_j.last_ts) r.ts = s_j.last_ts;
+      idx_push(&r, (uint16_t)(loc0 + i));
+      s_j.next_rec_no = r.rec_no + 1U;
+    }
+  }
+  s_j.slot = JOURNAL_RECS_PER_SECTOR;
+}
+
+static bool recover(void) {
+  uint16_t head = 0;
+  bool any = false;
+  for (uint16_t s = 0; s < JOURNAL_SECTORS; ++s) {
+    uint8_t hdr[JOURNAL_HDR_BYTES];
+    uint32_t seq = 0, erases = 0;
+    if (!jl_read((uint32_t)s * JOURNAL_SECTOR_BYTES, hdr, sizeof(hdr))) return false;
+    if (hdr_decode(hdr, &seq, &erases)) {
+      s_j.sector_seq[s] = seq;
+      s_j.erase_cnt[s] = erases;
+      if (!any || seq > s_j.sector_seq[head]) head = s;
+      any = true;
+    } else if (!all_erased(hdr, sizeof(hdr))) {
+      s_j.stats.bad_sectors++;
+    }
+  }
+  s_j.next_rec_no = 1U;
+  if (!any) return sector_open(0, 1U);
+
+  // Cadena viva: sectores físicamente anteriores al activo con secuencia
+  // consecutiva. Lo demás (restos de otra vuelta, borrados cortados) es libre.
+  uint16_t oldest = head;
+  for (uint16_t k = 1; k < JOURNAL_SECTORS; ++k) {
+    const uint16_t prev = (uint16_t)((oldest + JOURNAL_SECTORS - 1U) % JOURNAL_SECTORS);
+    if (s_j.sector_seq[prev] == 0U || s_j.sector_seq[prev] + 1U != s_j.sector_seq[oldest]) break;
+    oldest = prev;
+  }
+  for (uint16_t s = 0; s < JOURNAL_SECTORS; ++s) {
+    const uint16_t dist = (uint16_t)((head + JOURNAL_SECTORS - s) % JOURNAL_SECTORS);
+    const uint16_t span = (uint16_t)((head + JOURNAL_SECTORS - oldest) % JOURNAL_SECTORS);
+    if (dist > span) s_j.sector_seq[s] = 0U;
+  }
+  for (uint16_t s = oldest;; s = (uint16_t)((s + 1U) % JOURNAL_SECTORS)) {
+    sector_scan(s);
+    if (s == head) break;
+  }
+  s_j.head = head;
+  return true;
+}
+
+// --- API ---
+
+bool journal_init(void) {
+  journal_deinit();
+  memset(&s_j, 0, sizeof(s_j));
+  mem_report_static("journal", sizeof(s_j));
+  if (!fl_open()) return false;
+  s_j.mounted = recover();
+  if (!s_j.mounted) fl_close();
+  return s_j.mounted;
+}
+
+void journal_deinit(void) {
+  if (s_j.mounted) fl_close();
+  s_j.mounted = false;
+}
+
+bool journal_append(journal_rec_t* rec) {
+  if (!s_j.mounted || !rec) return false;
+  if (s_j.slot >= JOURNAL_RECS_PER_SECTOR && !sector_advance()) {
+    s_j.stats.write_fail++;
+    return false;
+  }
+  if (rec->ts < s_j.last_ts) rec->ts = s_j.last_ts;
+  rec->rec_no = s_j.next_rec_no;
+  uint8_t b[JOURNAL_REC_BYTES];
+  rec_encode(b, rec);
+  const uint16_t loc = (uint16_t)(s_j.head * JOURNAL_RECS_PER_SECTOR + s_j.slot);
+  s_j.slot++;   // un slot fallido queda cortado: se salta
+  if (!jl_write(rec_offset(loc), b, sizeof(b))) {
+    s_j.stats.write_fail++;
+    return false;
+  }
+  s_j.next_rec_no++;
+  idx_push(rec, loc);
+  s_j.stats.appended++;
+  return true;
+}
+
+// Rango [*lo, *hi) de posiciones (en el anillo o en by_node) que cumplen.
+static bool query_range(uint16_t node, uint32_t since_ts, uint32_t* lo, uint32_t* hi) {
+  if (!s_j.mounted) return false;
+  uint32_t a = 0, b = s_j.count;
+  if (node != JOURNAL_ANY_NODE) {
+    a = node_bound(node, true);
+    b = node_bound(node, false);
+  }
+  // Dentro del bloque el orden de llegada es orden de ts.
+  uint32_t l = a, h = b;
+  while (l < h) {
+    const uint32_t mid = (l + h) / 2U;
+    const jidx_t* e = node == JOURNAL_ANY_NODE ? idx_at(mid) : &s_j.idx[s_j.by_node[mid]];
+    if (e->ts < since_ts) l = mid + 1U; else h = mid;
+  }
+  *lo = l;
+  *hi = b;
+  return true;
+}
+
+uint32_t journal_count(uint16_t node, uint32_t since_ts) {
+  uint32_t lo, hi;
+  return query_range(node, since_ts, &lo, &hi) ? hi - lo : 0U;
+}
+
+size_t journal_query(uint16_t node, uint32_t since_ts, journal_rec_t* out, size_t max) {
+  uint32_t lo, hi;
+  if (!out || !query_range(node, since_ts, &lo, &hi)) return 0;
+  size_t n = 0;
+  for (uint32_t i = hi; i > lo && n < max; --i) {
+    const uint16_t pos = node == JOURNAL_ANY_NODE ? idx_pos(i - 1U) : s_j.by_node[i - 1U];
+    uint8_t b[JOURNAL_REC_BYTES];
+    if (jl_read(rec_offset(s_j.idx[pos].loc), b, sizeof(b)) && rec_decode(b, &out[n])) {
+      out[n].ts = s_j.idx[pos].ts;   // ts corregido al indexar
+      n++;
+    }
+  }
+  return n;
+}
+
+uint32_t journal_last_ts(void) {
+  return s_j.last_ts;
+}
+
+void journal_stats(journal_stats_t* out) {
+  if (!out) return;
+  *out = s_j.stats;
+  out->records = s_j.count;
+  out->erase_min = UINT32_MAX;
+  out->erase_max = 0;
+  for (uint16_t s = 0; s < JOURNAL_SECTORS; ++s) {
+    if (s_j.erase_cnt[s] < out->erase_min) out->erase_min = s_j.erase_cnt[s];
+    if (s_j.erase_cnt[s] > out->erase_max) out->erase_max = s_j.erase_cnt[s];
+  }
+}
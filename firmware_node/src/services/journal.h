@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config/system_config.h"
+
+// Bitácora persistente de eventos del receptor (append-only, log-structured)
+// sobre una partición de flash NOR; en host, un archivo con la misma
+// semántica (escribir sólo baja bits, borrar por sector deja 0xFF).
+//
+// - La partición es un anillo de JOURNAL_SECTORS sectores. Cada sector abre
+//   con una cabecera (secuencia de sector, cantidad de borrados, CRC) y sigue
+//   con registros de JOURNAL_REC_BYTES con CRC16. Al llenarse el sector
+//   activo se borra el siguiente (el más viejo): todos los sectores se borran
+//   por turno (wear leveling por construcción) y se pierden sus registros.
+// - Recuperación en journal_init(): lee las cabeceras, ordena los sectores
+//   válidos por secuencia y reconstruye el índice leyendo sus registros. Un
+//   registro cortado (CRC inválido) se salta; un sector con el borrado
+//   interrumpido (cabecera inválida) queda libre.
+// - Índice en RAM: un anillo en orden de llegada (= orden de tiempo) y otro
+//   ordenado por (nodo, tiempo). Las consultas buscan en O(log n) y sólo leen
+//   de flash los registros que devuelven.
+// Una sola tarea escribe y consulta (tsk_ui en el receptor): sin locks.
+
+#ifndef JOURNAL_SECTOR_BYTES
+#define JOURNAL_SECTOR_BYTES 4096U
+#endif
+
+#ifndef JOURNAL_SECTORS
+#define JOURNAL_SECTORS 16U   // 64 KB
+#endif
+
+#ifndef JOURNAL_PARTITION_LABEL
+#define JOURNAL_PARTITION_LABEL "journal"   // partitions.csv, tipo data
+#endif
+
+#ifndef JOURNAL_HOST_PATH
+#define JOURNAL_HOST_PATH "journal.bin"
+#endif
+
+#define JOURNAL_HDR_BYTES       16U
+#define JOURNAL_REC_BYTES       24U
+#define JOURNAL_RECS_PER_SECTOR ((JOURNAL_SECTOR_BYTES - JOURNAL_HDR_BYTES) / JOURNAL_REC_BYTES)
+#define JOURNAL_CAPACITY        (JOURNAL_SECTORS * JOURNAL_RECS_PER_SECTOR)
+#define JOURNAL_ANY_NODE        0xFFFFU
+
+typedef struct {
+  uint32_t rec_no;      // correlativo de la bitácora (lo asigna journal_append)
+  uint32_t ts;          // tiempo del receptor en s, no decreciente
+  uint8_t node;         // origen (sobre de retransmisión) o 0
+  uint8_t kind;         // fall_evt_kind_t
+  uint8_t seq;
+  uint32_t epoch_ms;    // clave del evento en el nodo
+  int16_t ax_peak_centi_g;
+  uint16_t idle_ms;
+} journal_rec_t;
+
+typedef struct {
+  uint32_t records;       // en el índice
+  uint32_t appended;      // desde journal_init
+  uint32_t evicted;       // perdidos al reciclar sectores
+  uint32_t torn;          // registros con CRC inválido saltados al recuperar
+  uint32_t bad_sectors;   // cabeceras inválidas (borrado interrumpido o sin usar)
+  uint32_t write_fail;
+  uint32_t erase_min;     // borrados por sector (wear leveling)
+  uint32_t erase_max;
+  uint32_t flash_reads;
+  uint32_t flash_read_bytes;
+  uint32_t flash_writes;
+  uint32_t flash_write_bytes;
+  uint32_t flash_erases;
+} journal_stats_t;
+
+#if !APP_USE_FREERTOS
+// Archivo de respaldo en host (antes de journal_init); se crea en 0xFF.
+void journal_host_path(const char* path);
+#endif
+
+// Monta la partición, recupera y arma el índice. false sin partición/archivo.
+bool journal_init(void);
+void journal_deinit(void);
+
+// Agrega un registro (rec_no y ts corregidos se devuelven en *rec). Un ts
+// menor que el último se sube al último: el índice queda ordenado.
+bool journal_append(journal_rec_t* rec);
+
+// Hasta max registros de node (o JOURNAL_ANY_NODE) con ts >= since_ts, del
+// más nuevo al más viejo.
+size_t journal_query(uint16_t node, uint32_t since_ts, journal_rec_t* out, size_t max);
+// Cuántos registros cumplen lo mismo, sin leer flash.
+uint32_t journal_count(uint16_t node, uint32_t since_ts);
+
+// ts del último registro (0 si está vacía): base de tiempo tras reiniciar.
+uint32_t journal_last_ts(void);
+void journal_stats(journal_stats_t* out);
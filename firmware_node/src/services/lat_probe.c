@@ -0,0 +1,218 @@
+#include "firmware_node/src/services/lat_probe.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LAT_HIST_MAX_US ((1U << (LAT_HIST_MAX_LOG2 + 1U)) - 1U)
+
+// Una marca (clave, instante) de una etapa. seq es impar mientras el dueño la
+// reescribe; quien la lee desde otra tarea descarta la lectura si seq cambió.
+typedef struct {
+  atomic_uint seq;
+  uint32_t key;
+  uint64_t t_us;   // 0 = libre
+} lat_mark_t;
+
+// Anillo por etapa: lo escribe sólo la tarea que marca esa etapa, así reciclar
+// una entrada nunca mezcla instantes de alertas distintas.
+typedef struct {
+  lat_mark_t marks[LAT_PROBE_INFLIGHT];
+  unsigned next;   // sólo el dueño
+} lat_ring_t;
+
+static lat_ring_t s_rings[LAT_STAGE_COUNT];
+static lat_hist_t s_hist[LAT_M_COUNT];
+
+static const char* const s_metric_names[LAT_M_COUNT] = {
+  "peak->confirm",
+  "confirm->push",
+  "push->pop",
+  "pop->encode",
+  "encode->tx_start",
+  "tx_start->tx_done",
+  "tx_done->rx",
+  "confirm->tx_start",
+  "confirm->rx",
+  "peak->rx",
+  "peak->pre_rx",
+};
+
+// --- Histograma log-lineal ---
+
+static unsigned bin_index(uint32_t us) {
+  if (us < LAT_HIST_SUB) return us;
+  if (us > LAT_HIST_MAX_US) us = LAT_HIST_MAX_US;
+  const unsigned e = 31U - (unsigned)__builtin_clz(us);
+  const unsigned shift = e - LAT_HIST_SUB_BITS;
+  return (shift + 1U) * LAT_HIST_SUB + ((us >> shift) - LAT_HIST_SUB);
+}
+
+static uint32_t bin_upper(unsigned bin) {
+  if (bin < LAT_HIST_SUB) return bin;
+  const unsigned shift = bin / LAT_HIST_SUB - 1U;
+  const uint32_t lower = (uint32_t)(LAT_HIST_SUB + bin % LAT_HIST_SUB) << shift;
+  return lower + ((1U << shift) - 1U);
+}
+
+void lat_hist_reset(lat_hist_t* h) {
+  if (!h) return;
+  memset(h, 0, sizeof(*h));
+  h->min_us = UINT32_MAX;
+}
+
+void lat_hist_record(lat_hist_t* h, uint32_t us) {
+  if (!h) return;
+  h->bins[bin_index(us)]++;
+  h->count++;
+  h->sum_us += us;
+  if (us < h->min_us) h->min_us = us;
+  if (us > h->max_us) h->max_us = us;
+}
+
+uint32_t lat_hist_percentile(const lat_hist_t* h, uint32_t pct) {
+  if (!h || h->count == 0U) return 0U;
+  if (pct >= 100U) return h->max_us;
+  uint64_t rank = ((uint64_t)h->count * pct + 99U) / 100U;
+  if (rank == 0U) rank = 1U;
+  uint64_t acc = 0;
+  for (unsigned b = 0; b < LAT_HIST_BINS; ++b) {
+    acc += h->bins[b];
+    if (acc >= rank) {
+      const uint32_t up = bin_upper(b);
+      return up < h->max_us ? up : h->max_us;
+    }
+  }
+  return h->max_us;
+}
+
+// --- Sondas ---
+
+void lat_probe_init(void) {
+  mem_report_static("lat_probe", sizeof(s_rings) + sizeof(s_hist));
+  memset(s_rings, 0, sizeof(s_rings));
+  for (unsigned m = 0; m < LAT_M_COUNT; ++m) lat_hist_reset(&s_hist[m]);
+}
+
+uint64_t lat_probe_now_us(void) {
+  return os_now_us();
+}
+
+// Instante de key en la etapa; 0 si no está o cambió durante la lectura.
+static uint64_t mark_get(lat_stage_t stage, uint32_t key) {
+  const lat_ring_t* r = &s_rings[stage];
+  for (unsigned i = 0; i < LAT_PROBE_INFLIGHT; ++i) {
+    const lat_mark_t* m = &r->marks[i];
+    const unsigned seq = atomic_load_explicit(&m->seq, memory_order_acquire);
+    if (seq & 1U) continue;
+    const uint32_t k = m->key;
+    const uint64_t t = m->t_us;
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&m->seq, memory_order_relaxed) != seq) continue;
+    if (t != 0U && k == key) return t;
+  }
+  return 0U;
+}
+
+// Sólo el dueño de la etapa: reescribe la marca de key o recicla la más antigua.
+static void mark_put(lat_stage_t stage, uint32_t key, uint64_t t_us) {
+  lat_ring_t* r = &s_rings[stage];
+  lat_mark_t* m = NULL;
+  for (unsigned i = 0; i < LAT_PROBE_INFLIGHT && !m; ++i) {
+    if (r->marks[i].t_us != 0U && r->marks[i].key == key) m = &r->marks[i];
+  }
+  if (!m) {
+    m = &r->marks[r->next];
+    r->next = (r->next + 1U) % LAT_PROBE_INFLIGHT;
+  }
+  const unsigned seq = atomic_load_explicit(&m->seq, memory_order_relaxed);
+  atomic_store_explicit(&m->seq, seq + 1U, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  m->key = key;
+  m->t_us = t_us;
+  atomic_store_explicit(&m->seq, seq + 2U, memory_order_release);
+}
+
+static void record_delta(lat_metric_t m, uint64_t from_us, uint64_t to_us) {
+  if (from_us == 0U || to_us < from_us) return;
+  const uint64_t d = to_us - from_us;
+  lat_hist_record(&s_hist[m], d > UINT32_MAX ? UINT32_MAX : (uint32_t)d);
+}
+
+void lat_probe_mark_at(uint32_t key, lat_stage_t stage, uint64_t t_us) {
+  if ((unsigned)stage >= LAT_STAGE_COUNT) return;
+  const uint64_t peak = mark_get(LAT_STAGE_PEAK, key);
+  const uint64_t confirm = stage == LAT_STAGE_PEAK ? 0U : mark_get(LAT_STAGE_CONFIRM, key);
+  if (stage > LAT_STAGE_CONFIRM && peak == 0U && confirm == 0U) return;
+  if (t_us == 0U) t_us = 1U;
+  mark_put(stage, key, t_us);
+
+  // Intervalo con la etapa inmediatamente anterior (métrica stage-1).
+  if (stage > LAT_STAGE_PEAK && stage <= LAT_STAGE_RX_DECODE) {
+    record_delta((lat_metric_t)(stage - 1U), mark_get((lat_stage_t)(stage - 1U), key), t_us);
+  }
+  if (stage == LAT_STAGE_TX_START) {
+    record_delta(LAT_M_CONFIRM_TX_START, confirm, t_us);
+  } else if (stage == LAT_STAGE_RX_DECODE) {
+    record_delta(LAT_M_CONFIRM_RX, confirm, t_us);
+    record_delta(LAT_M_PEAK_RX, peak, t_us);
+  } else if (stage == LAT_STAGE_PRE_RX) {
+    record_delta(LAT_M_PEAK_PRE_RX, peak, t_us);
+  }
+}
+
+void lat_probe_mark(uint32_t key, lat_stage_t stage) {
+  lat_probe_mark_at(key, stage, os_now_us());
+}
+
+void lat_probe_summary(lat_metric_t m, lat_summary_t* out) {
+  if (!out) return;
+  memset(out, 0, sizeof(*out));
+  if ((unsigned)m >= LAT_M_COUNT) return;
+  const lat_hist_t* h = &s_hist[m];
+  out->count = h->count;
+  if (h->count == 0U) return;
+  out->p50_us = lat_hist_percentile(h, 50U);
+  out->p99_us = lat_hist_percentile(h, 99U);
+  out->max_us = h->max_us;
+  out->mean_us = (uint32_t)(h->sum_us / h->count);
+}
+
+const lat_hist_t* lat_probe_hist(lat_metric_t m) {
+  return (unsigned)m < LAT_M_COUNT ? &s_hist[m] : NULL;
+}
+
+const char* lat_probe_metric_name(lat_metric_t m) {
+  return (unsigned)m < LAT_M_COUNT ? s_metric_names[m] : "?";
+}
+
+bool lat_probe_within_budget(void) {
+  const lat_hist_t* h = &s_hist[LAT_M_CONFIRM_TX_START];
+  return h->count == 0U || lat_hist_percentile(h, 99U) <= LAT_BUDGET_CONFIRM_TX_US;
+}
+
+void lat_probe_dump(void) {
+  for (unsigned m = 0; m < LAT_M_COUNT; ++m) {
+    lat_summary_t s;
+    lat_probe_summary((lat_metric_t)m, &s);
+    if (s.count == 0U) continue;
+    printf("LAT %-18s n=%u p50=%uus p99=%uus max=%uus media=%uus\n",
+           s_metric_names[m], (unsigned)s.count, (unsigned)s.p50_us,
+           (unsigned)s.p99_us, (unsigned)s.max_us, (unsigned)s.mean_us);
+    // Bins no vacíos como "cota_superior:cuenta" para reconstruir offline.
+    printf("LATH %s", s_metric_names[m]);
+    for (unsigned b = 0; b < LAT_HIST_BINS; ++b) {
+      if (s_hist[m].bins[b]) printf(" %u:%u", (unsigned)bin_upper(b), (unsigned)s_hist[m].bins[b]);
+    }
+    printf("\n");
+  }
+  const lat_hist_t* h = &s_hist[LAT_M_CONFIRM_TX_START];
+  if (h->count) {
+    printf("LAT presupuesto confirm->tx_start p99=%uus limite=%uus %s\n",
+           (unsigned)lat_hist_percentile(h, 99U), (unsigned)LAT_BUDGET_CONFIRM_TX_US,
+           lat_probe_within_budget() ? "OK" : "EXCEDIDO");
+  }
+  fflush(stdout);
+}
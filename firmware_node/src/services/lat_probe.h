@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sondas de latencia de extremo a extremo de una alerta.
+// Cada etapa estampa os_now_us() asociada a la clave de la alerta
+// (fall_event_t.epoch_ms); la etapa que cierra un intervalo lo acumula en un
+// histograma log-lineal de memoria fija. Sin malloc ni locks: cada etapa guarda
+// sus marcas en un anillo propio que sólo escribe la tarea que la marca, y cada
+// intervalo lo escribe una sola tarea (la que marca su etapa final). Las marcas
+// de otras etapas se leen con un contador de secuencia por entrada.
+// El receptor sólo puede cerrar intervalos si comparte reloj con el nodo
+// (simulación host); en placas separadas RX_DECODE queda sin intervalo.
+
+#ifndef LAT_PROBE_ENABLE
+#define LAT_PROBE_ENABLE 1
+#endif
+
+#ifndef LAT_PROBE_INFLIGHT
+#define LAT_PROBE_INFLIGHT 8U      // alertas en vuelo rastreadas a la vez
+#endif
+
+// Presupuesto del curso: detección confirmada → inicio de TX ≤ 300 ms.
+#ifndef LAT_BUDGET_CONFIRM_TX_US
+#define LAT_BUDGET_CONFIRM_TX_US 300000U
+#endif
+
+// Histograma: 2^SUB_BITS sub-bins lineales por potencia de 2 (error ≤ 12.5 %),
+// exacto por debajo de 2^SUB_BITS us; satura en 2^(MAX_LOG2+1)-1 us (~33 s).
+#define LAT_HIST_SUB_BITS 3U
+#define LAT_HIST_SUB      (1U << LAT_HIST_SUB_BITS)
+#define LAT_HIST_MAX_LOG2 24U
+#define LAT_HIST_BINS     ((LAT_HIST_MAX_LOG2 - LAT_HIST_SUB_BITS + 2U) * LAT_HIST_SUB)
+
+typedef enum {
+  LAT_STAGE_PEAK = 0,     // muestra con el pico (fall_detector)
+  LAT_STAGE_CONFIRM,      // reposo confirmado (fall_detector_feed)
+  LAT_STAGE_PUSH,         // antes de alert_queue_push
+  LAT_STAGE_POP,          // alert_queue_pop devolvió el evento
+  LAT_STAGE_ENCODE,       // pkt_encode_alert terminado
+  LAT_STAGE_TX_START,     // antes de lora_tx
+  LAT_STAGE_TX_DONE,      // lora_tx confirmó TxDone
+  LAT_STAGE_RX_DECODE,    // receptor: pkt_decode_alert OK
+  LAT_STAGE_PRE_RX,       // receptor: prealerta decodificada (clave = primer pico)
+  LAT_STAGE_COUNT
+} lat_stage_t;
+
+typedef enum {
+  LAT_M_PEAK_CONFIRM = 0,
+  LAT_M_CONFIRM_PUSH,
+  LAT_M_PUSH_POP,
+  LAT_M_POP_ENCODE,
+  LAT_M_ENCODE_TX_START,
+  LAT_M_TX_AIR,           // TX_START → TX_DONE
+  LAT_M_TX_DONE_RX,
+  LAT_M_CONFIRM_TX_START, // métrica del presupuesto
+  LAT_M_CONFIRM_RX,
+  LAT_M_PEAK_RX,          // primer aviso sin prealerta: pico → alerta recibida
+  LAT_M_PEAK_PRE_RX,      // primer aviso con prealerta: pico → prealerta recibida
+  LAT_M_COUNT
+} lat_metric_t;
+
+typedef struct {
+  uint32_t count;
+  uint32_t min_us;
+  uint32_t max_us;
+  uint64_t sum_us;
+  uint32_t bins[LAT_HIST_BINS];
+} lat_hist_t;
+
+typedef struct {
+  uint32_t count;
+  uint32_t p50_us;
+  uint32_t p99_us;
+  uint32_t max_us;
+  uint32_t mean_us;
+} lat_summary_t;
+
+void lat_hist_reset(lat_hist_t* h);
+void lat_hist_record(lat_hist_t* h, uint32_t us);
+// Cota superior del bin que contiene el percentil pct (0..100); max_us si pct=100.
+uint32_t lat_hist_percentile(const lat_hist_t* h, uint32_t pct);
+
+void lat_probe_init(void);
+uint64_t lat_probe_now_us(void);
+// PEAK y CONFIRM abren una entrada para key; el resto sólo cierra intervalos
+// de una entrada existente (una clave desconocida se ignora).
+void lat_probe_mark_at(uint32_t key, lat_stage_t stage, uint64_t t_us);
+void lat_probe_mark(uint32_t key, lat_stage_t stage);
+
+void lat_probe_summary(lat_metric_t m, lat_summary_t* out);
+const lat_hist_t* lat_probe_hist(lat_metric_t m);
+const char* lat_probe_metric_name(lat_metric_t m);
+// p99 de CONFIRM→TX_START dentro de LAT_BUDGET_CONFIRM_TX_US (true sin muestras).
+bool lat_probe_within_budget(void);
+// Resumen por métrica + bins no vacíos ("LAT ..." / "LATH ...") por stdout/serial.
+void lat_probe_dump(void);
+
+#if LAT_PROBE_ENABLE
+#define LAT_PROBE_NOW()                  lat_probe_now_us()
+#define LAT_PROBE_MARK(key, stage)       lat_probe_mark((key), (stage))
+#define LAT_PROBE_MARK_AT(key, stage, t) lat_probe_mark_at((key), (stage), (t))
+#else
+#define LAT_PROBE_NOW()                  0U
+#define LAT_PROBE_MARK(key, stage)       ((void)0)
+#define LAT_PROBE_MARK_AT(key, stage, t) ((void)0)
+#endif
@@ -0,0 +1,64 @@
+#include "firmware_node/src/services/mem_report.h"
+#include "firmware_node/src/port/os_port.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if APP_USE_FREERTOS
+#include "esp_heap_caps.h"
+#endif
+
+typedef struct {
+  const char* name;
+  uint32_t bytes;
+} mem_static_t;
+
+static mem_static_t s_static[MEM_REPORT_MAX_STATIC];
+static unsigned s_static_count = 0;
+static const char* const s_obj_names[OS_OBJ_COUNT] = { "tareas", "colas", "semaforos", "eventos" };
+
+// Los registros ocurren en init (antes de que las tareas compitan).
+void mem_report_static(const char* name, size_t bytes) {
+  if (!name) return;
+  for (unsigned i = 0; i < s_static_count; ++i) {
+    if (strcmp(s_static[i].name, name) == 0) {
+      s_static[i].bytes = (uint32_t)bytes;
+      return;
+    }
+  }
+  if (s_static_count >= MEM_REPORT_MAX_STATIC) return;
+  s_static[s_static_count].name = name;
+  s_static[s_static_count].bytes = (uint32_t)bytes;
+  s_static_count++;
+}
+
+size_t mem_report_static_total(void) {
+  size_t total = 0;
+  for (unsigned i = 0; i < s_static_count; ++i) total += s_static[i].bytes;
+  return total;
+}
+
+void mem_report_dump(void) {
+  for (unsigned i = 0; i < s_static_count; ++i) {
+    printf("MEM static %-14s %6u B\n", s_static[i].name, (unsigned)s_static[i].bytes);
+  }
+  printf("MEM static %-14s %6u B\n", "TOTAL", (unsigned)mem_report_static_total());
+  for (unsigned k = 0; k < OS_OBJ_COUNT; ++k) {
+    os_heap_use_t h;
+    os_heap_usage((os_obj_kind_t)k, &h);
+    printf("MEM heap   %-14s objetos=%u %u B fallos=%u\n", s_obj_names[k], (unsigned)h.objects,
+           (unsigned)h.bytes, (unsigned)h.fails);
+  }
+  for (int t = 0; os_task_name(t); ++t) {
+    uint32_t size = 0, min_free = 0;
+    if (!os_task_stack_info(t, &size, &min_free)) continue;
+    const uint32_t used = size > min_free ? size - min_free : 0U;
+    printf("MEM stack  %-14s %5u/%5u B usados (%u%%)\n", os_task_name(t), (unsigned)used,
+           (unsigned)size, size ? (unsigned)(used * 100U / size) : 0U);
+  }
+#if APP_USE_FREERTOS
+  printf("MEM heap   libre=%u B minimo=%u B\n", (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+         (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+#endif
+  fflush(stdout);
+}
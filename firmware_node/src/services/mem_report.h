@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Contabilidad de memoria: RAM estática por subsistema (cada módulo registra
+// sus buffers en su init), heap tomado por os_port por tipo de objeto (los
+// drivers y servicios no usan heap en régimen) y high-water mark del stack de
+// cada tarea creada con os_port. mem_report_dump() lo emite por serial
+// (reporte periódico) o al final de una simulación host.
+
+#ifndef MEM_REPORT_MAX_STATIC
+#define MEM_REPORT_MAX_STATIC 24U
+#endif
+
+// Idempotente por nombre (nodo y receptor pueden compartir proceso en host).
+void mem_report_static(const char* name, size_t bytes);
+size_t mem_report_static_total(void);
+// "MEM ..." por stdout: estáticos, heap por tipo de objeto, stack por tarea.
+void mem_report_dump(void);
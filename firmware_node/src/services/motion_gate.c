@@ -0,0 +1,63 @@
+#include "firmware_node/src/services/motion_gate.h"
+#include "config/fall_params.h"
+
+#include <stdlib.h>
+
+typedef struct {
+  motion_gate_cfg_t cfg;
+  uint32_t still_needed;   // muestras
+  accel_raw_t ref;
+  bool have_ref;
+  motion_gate_stats_t stats;
+} motion_gate_ctx_t;
+
+static motion_gate_ctx_t s_gate;
+
+void motion_gate_init(const motion_gate_cfg_t* cfg) {
+  if (cfg) {
+    s_gate.cfg = *cfg;
+  } else {
+    s_gate.cfg.still_thr_centi_g = FALL_STILL_THR_CENTI_G;
+    s_gate.cfg.still_ms = FALL_STILL_MS;
+    s_gate.cfg.fs_hz = FALL_FS_HZ;
+  }
+  s_gate.still_needed = (uint32_t)s_gate.cfg.still_ms * s_gate.cfg.fs_hz / 1000U;
+  if (s_gate.still_needed == 0U) s_gate.still_needed = 1U;
+  s_gate.have_ref = false;
+  s_gate.stats.entries = 0U;
+  s_gate.stats.still_samples = 0U;
+}
+
+static bool near_ref(const accel_raw_t* s) {
+  const int thr = s_gate.cfg.still_thr_centi_g;
+  return abs(s->ax - s_gate.ref.ax) <= thr && abs(s->ay - s_gate.ref.ay) <= thr &&
+         abs(s->az - s_gate.ref.az) <= thr;
+}
+
+bool motion_gate_feed(const accel_raw_t* s, bool detector_busy) {
+  if (!s) return false;
+  if (!s_gate.have_ref || detector_busy || !near_ref(s)) {
+    s_gate.ref = *s;
+    s_gate.have_ref = true;
+    s_gate.stats.still_samples = 0U;
+    return false;
+  }
+  if (++s_gate.stats.still_samples < s_gate.still_needed) return false;
+  s_gate.stats.entries++;
+  s_gate.stats.still_samples = 0U;
+  s_gate.have_ref = false;
+  return true;
+}
+
+void motion_gate_wake(void) {
+  s_gate.have_ref = false;
+  s_gate.stats.still_samples = 0U;
+}
+
+void motion_gate_stats(motion_gate_stats_t* out) {
+  if (out) *out = s_gate.stats;
+}
+
+uint16_t motion_gate_wom_thr_mg(void) {
+  return (uint16_t)(s_gate.cfg.still_thr_centi_g * 10);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "firmware_node/src/drivers/imu_accel.h"
+
+// Decide cuándo el nodo puede dejar de muestrear a tasa completa y pasar el
+// IMU a wake-on-motion: todas las muestras dentro de ±still_thr (por eje)
+// respecto de una referencia durante still_ms, sin pico en seguimiento en el
+// detector. Misma regla que aplica el MPU9250 para despertar, así la
+// transición es simétrica. Lógica pura: la usan app.c y tools/wom_replay.c.
+
+typedef struct {
+  int16_t still_thr_centi_g;   // FALL_STILL_THR_CENTI_G
+  uint16_t still_ms;           // FALL_STILL_MS
+  uint8_t fs_hz;               // FALL_FS_HZ
+} motion_gate_cfg_t;
+
+typedef struct {
+  uint32_t entries;        // pasajes a wake-on-motion
+  uint32_t still_samples;  // muestras seguidas quieto (actual)
+} motion_gate_stats_t;
+
+void motion_gate_init(const motion_gate_cfg_t* cfg);   // NULL: config/fall_params.h
+// Una muestra a tasa completa. true: entrar en wake-on-motion ahora.
+bool motion_gate_feed(const accel_raw_t* s, bool detector_busy);
+// Tras despertar (o si imu_enter_wom falló): reinicia la ventana de quietud.
+void motion_gate_wake(void);
+void motion_gate_stats(motion_gate_stats_t* out);
+// Umbral WOM para imu_enter_wom(), en mg.
+uint16_t motion_gate_wom_thr_mg(void);
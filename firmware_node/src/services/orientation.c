@@ -0,0 +1,112 @@
+#include "firmware_node/src/services/orientation.h"
+#include "config/fall_params.h"
+#include "firmware_node/src/services/fixmath.h"
+#include "firmware_node/src/services/mem_report.h"
+#include "firmware_node/src/services/prof.h"
+
+#define ORIENT_PI_Q16 205887   // π · 2^16
+
+typedef struct {
+  orient_cfg_t cfg;
+  orient_vec_t g;
+  int32_t gyro_k;      // LSB → rad/muestra en Q31
+  int32_t beta_q15;    // 1 - alpha
+  uint32_t gate_lo2;   // |a|² en centi-g²
+  uint32_t gate_hi2;
+  bool valid;
+  orient_stats_t stats;
+} orient_ctx_t;
+
+static orient_ctx_t s_or;
+
+void orientation_init(const orient_cfg_t* cfg) {
+  mem_report_static("orientation", sizeof(s_or));
+  if (cfg) {
+    s_or.cfg = *cfg;
+  } else {
+    s_or.cfg.fs_hz = FALL_FS_HZ;
+    s_or.cfg.alpha_q15 = ORIENT_ALPHA_Q15;
+    s_or.cfg.gate_lo_centi_g = ORIENT_GATE_LO_CENTI_G;
+    s_or.cfg.gate_hi_centi_g = ORIENT_GATE_HI_CENTI_G;
+    s_or.cfg.gyro_lsb_per_dps_x10 = IMU_GYRO_LSB_PER_DPS_X10;
+  }
+  if (s_or.cfg.fs_hz < 10U) s_or.cfg.fs_hz = 10U;   // |raw · gyro_k| < 2^31
+  if (s_or.cfg.gyro_lsb_per_dps_x10 == 0U) s_or.cfg.gyro_lsb_per_dps_x10 = IMU_GYRO_LSB_PER_DPS_X10;
+  // 2^31 · (π/180) / (LSB/°/s) / fs
+  s_or.gyro_k = (int32_t)(((uint64_t)ORIENT_PI_Q16 << 15) * 10U /
+                          (180U * (uint64_t)s_or.cfg.gyro_lsb_per_dps_x10 * s_or.cfg.fs_hz));
+  s_or.beta_q15 = 32768 - (int32_t)s_or.cfg.alpha_q15;
+  s_or.gate_lo2 = (uint32_t)(s_or.cfg.gate_lo_centi_g * s_or.cfg.gate_lo_centi_g);
+  s_or.gate_hi2 = (uint32_t)(s_or.cfg.gate_hi_centi_g * s_or.cfg.gate_hi_centi_g);
+  s_or.stats.updates = 0U;
+  s_or.stats.accel_corrections = 0U;
+  orientation_reset();
+}
+
+void orientation_reset(void) {
+  s_or.valid = false;
+  s_or.g.x = 0;
+  s_or.g.y = 0;
+  s_or.g.z = ORIENT_ONE;
+}
+
+void orientation_update(const accel_raw_t* a, const imu_gyro_t* gy) {
+  PROF_SCOPE(PROF_ORIENT_UPDATE);
+  if (!a || !gy) return;
+  s_or.stats.updates++;
+
+  // Giroscopio: dg = -ω × g. ω en Q31 rad/muestra, g en Q30.
+  const int32_t wx = gy->gx * s_or.gyro_k;
+  const int32_t wy = gy->gy * s_or.gyro_k;
+  const int32_t wz = gy->gz * s_or.gyro_k;
+  orient_vec_t g = s_or.g;
+  if (s_or.valid) {
+    g.x -= (int32_t)(((int64_t)wy * s_or.g.z - (int64_t)wz * s_or.g.y) >> 31);
+    g.y -= (int32_t)(((int64_t)wz * s_or.g.x - (int64_t)wx * s_or.g.z) >> 31);
+    g.z -= (int32_t)(((int64_t)wx * s_or.g.y - (int64_t)wy * s_or.g.x) >> 31);
+  }
+
+  // Acelerómetro: sólo cerca de 1 g (fuera de eso no indica la vertical).
+  const uint32_t a2 = (uint32_t)(a->ax * a->ax) + (uint32_t)(a->ay * a->ay) + (uint32_t)(a->az * a->az);
+  if (a2 >= s_or.gate_lo2 && a2 <= s_or.gate_hi2) {
+    const uint32_t norm = isqrt32(a2);
+    const int32_t inv = (int32_t)((uint32_t)ORIENT_ONE / norm);   // Q30 / centi-g
+    const orient_vec_t an = { a->ax * inv, a->ay * inv, a->az * inv };
+    if (s_or.valid) {
+      g.x += (int32_t)(((int64_t)(an.x - g.x) * s_or.beta_q15) >> 15);
+      g.y += (int32_t)(((int64_t)(an.y - g.y) * s_or.beta_q15) >> 15);
+      g.z += (int32_t)(((int64_t)(an.z - g.z) * s_or.beta_q15) >> 15);
+    } else {
+      g = an;
+      s_or.valid = true;
+    }
+    s_or.stats.accel_corrections++;
+  }
+
+  // |g| → 1 con un paso de Newton: g · (3 - |g|²) / 2 (|g| ya es ≈ 1).
+  const int64_t n2 = ((int64_t)g.x * g.x + (int64_t)g.y * g.y + (int64_t)g.z * g.z) >> 30;
+  const int64_t k = (3 * (int64_t)ORIENT_ONE - n2) >> 1;
+  s_or.g.x = (int32_t)(((int64_t)g.x * k) >> 30);
+  s_or.g.y = (int32_t)(((int64_t)g.y * k) >> 30);
+  s_or.g.z = (int32_t)(((int64_t)g.z * k) >> 30);
+}
+
+bool orientation_valid(void) {
+  return s_or.valid;
+}
+
+void orientation_get(orient_vec_t* out) {
+  if (out) *out = s_or.g;
+}
+
+int16_t orientation_cos_q15(const orient_vec_t* a, const orient_vec_t* b) {
+  if (!a || !b) return 0;
+  const int64_t dot = ((int64_t)a->x * b->x + (int64_t)a->y * b->y + (int64_t)a->z * b->z) >> 45;
+  if (dot > 32767) return 32767;
+  if (dot < -32767) return -32767;
+  return (int16_t)dot;
+}
+
+void orientation_stats(orient_stats_t* out) {
+  if (out) *out = s_or.stats;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "firmware_node/src/drivers/imu_accel.h"
+
+// Orientación en punto fijo (sin float): filtro complementario sobre el
+// vector gravedad en el marco del sensor. Cada muestra lo rota con el
+// giroscopio (ángulo pequeño, g -= ω×g·dt) y lo acerca a la dirección del
+// acelerómetro con peso 1 - alpha, sólo si |a| está cerca de 1 g (en caída
+// libre o en el impacto integra únicamente el giroscopio). Renormaliza con un
+// paso de Newton. Costo fijo por muestra: ~20 multiplicaciones, un isqrt de
+// 16 pasos y una división de 32 bits. Un solo escritor (tsk_sample_detect).
+
+#define ORIENT_ONE (1L << 30)   // Q30
+
+typedef struct { int32_t x, y, z; } orient_vec_t;   // Q30, |g| ≈ ORIENT_ONE
+
+typedef struct {
+  uint16_t fs_hz;             // FALL_FS_HZ (≥ 10)
+  uint16_t alpha_q15;         // ORIENT_ALPHA_Q15
+  int16_t  gate_lo_centi_g;   // ORIENT_GATE_LO_CENTI_G
+  int16_t  gate_hi_centi_g;   // ORIENT_GATE_HI_CENTI_G
+  uint16_t gyro_lsb_per_dps_x10;   // IMU_GYRO_LSB_PER_DPS_X10
+} orient_cfg_t;
+
+typedef struct {
+  uint32_t updates;
+  uint32_t accel_corrections;   // muestras con |a| dentro de la ventana
+} orient_stats_t;
+
+void orientation_init(const orient_cfg_t* cfg);   // NULL: config/fall_params.h
+// Descarta la estimación; la próxima muestra con |a| ≈ 1 g la siembra (tras
+// wake-on-motion o al encender el giroscopio).
+void orientation_reset(void);
+void orientation_update(const accel_raw_t* a, const imu_gyro_t* g);
+bool orientation_valid(void);
+void orientation_get(orient_vec_t* out);
+// Coseno del ángulo entre dos estimaciones, Q15 (32767 = misma postura).
+int16_t orientation_cos_q15(const orient_vec_t* a, const orient_vec_t* b);
+void orientation_stats(orient_stats_t* out);
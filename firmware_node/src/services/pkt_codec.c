@@ -1,7 +1,9 @@
 #include "firmware_node/src/services/pkt_codec.h"
+#include "firmware_node/src/services/prof.h"
 #include <string.h>
 
 static uint8_t crc8(const uint8_t* data, size_t len) {
+  PROF_SCOPE(PROF_CRC8);
   uint8_t crc = 0x00; // inicialización habitual con polinomio 0x07
   for (size_t i = 0; i < len; ++i) {
     crc ^= data[i];
@@ -13,6 +15,7 @@ static uint8_t crc8(const uint8_t* data, size_t len) {
 }
 
 size_t pkt_encode_alert(const fall_event_t* e, uint8_t* out, size_t max) {
+  PROF_SCOPE(PROF_PKT_ENCODE);
   if (!e || !out) return 0;
   const size_t need = 1 + 1 + 4 + 2 + 2 + 1; // TYPE,VER,epoch,peak,idle,CRC
   if (max < need) return 0;
@@ -52,6 +55,155 @@ bool pkt_decode_alert(const uint8_t* in, size_t len, fall_event_t* e) {
   i += 2;
   // idle_ms (LE)
   e->idle_ms = (uint16_t)in[i] | ((uint16_t)in[i+1] << 8);
+  e->kind = FALL_EVT_CONFIRMED;
+  e->seq = 0U;
   return true;
 }
 
+static size_t encode_phase(const fall_event_t* e, uint8_t* out, size_t max) {
+  const bool pre = e->kind == FALL_EVT_PREALERT;
+  const size_t need = pre ? PKT_PRE_BYTES : PKT_CANCEL_BYTES;
+  if (max < need) return 0;
+  size_t i = 0;
+  out[i++] = pre ? PKT_TYPE_PRE : PKT_TYPE_CANCEL;
+  out[i++] = PKT_VER;
+  out[i++] = e->seq;
+  out[i++] = (uint8_t)(e->epoch_ms & 0xFF);
+  out[i++] = (uint8_t)((e->epoch_ms >> 8) & 0xFF);
+  out[i++] = (uint8_t)((e->epoch_ms >> 16) & 0xFF);
+  out[i++] = (uint8_t)((e->epoch_ms >> 24) & 0xFF);
+  if (pre) {
+    out[i++] = (uint8_t)(e->ax_peak_centi_g & 0xFF);
+    out[i++] = (uint8_t)((e->ax_peak_centi_g >> 8) & 0xFF);
+  }
+  out[i] = crc8(out, i);
+  return i + 1U;
+}
+
+size_t pkt_encode_event(const fall_event_t* e, uint8_t* out, size_t max) {
+  if (!e || !out) return 0;
+  if (e->kind == FALL_EVT_CONFIRMED) return pkt_encode_alert(e, out, max);
+  if (e->kind != FALL_EVT_PREALERT && e->kind != FALL_EVT_CANCEL) return 0;
+  return encode_phase(e, out, max);
+}
+
+bool pkt_decode_event(const uint8_t* in, size_t len, fall_event_t* e) {
+  if (!in || !e || len < 1U) return false;
+  if (in[0] == PKT_TYPE_ALERT) return pkt_decode_alert(in, len, e);
+  if (in[0] != PKT_TYPE_PRE && in[0] != PKT_TYPE_CANCEL) return false;
+  const bool pre = in[0] == PKT_TYPE_PRE;
+  const size_t need = pre ? PKT_PRE_BYTES : PKT_CANCEL_BYTES;
+  if (len < need || in[1] != PKT_VER) return false;
+  if (crc8(in, need - 1U) != in[need - 1U]) return false;
+  e->kind = pre ? FALL_EVT_PREALERT : FALL_EVT_CANCEL;
+  e->seq = in[2];
+  e->epoch_ms = (uint32_t)in[3] | ((uint32_t)in[4] << 8) | ((uint32_t)in[5] << 16) | ((uint32_t)in[6] << 24);
+  e->ax_peak_centi_g = pre ? (int16_t)((uint16_t)in[7] | ((uint16_t)in[8] << 8)) : 0;
+  e->idle_ms = 0U;
+  return true;
+}
+
+size_t pkt_encode_batch(const fall_event_t* e, size_t n, uint8_t* out, size_t max) {
+  if (!e || !out || n == 0U || n > PKT_BATCH_MAX || max < PKT_BATCH_BYTES(n)) return 0;
+  size_t i = 0;
+  out[i++] = PKT_TYPE_BATCH;
+  out[i++] = PKT_VER;
+  out[i++] = (uint8_t)n;
+  for (size_t k = 0; k < n; ++k) {
+    out[i++] = (uint8_t)(e[k].epoch_ms & 0xFF);
+    out[i++] = (uint8_t)((e[k].epoch_ms >> 8) & 0xFF);
+    out[i++] = (uint8_t)((e[k].epoch_ms >> 16) & 0xFF);
+    out[i++] = (uint8_t)((e[k].epoch_ms >> 24) & 0xFF);
+    out[i++] = (uint8_t)(e[k].ax_peak_centi_g & 0xFF);
+    out[i++] = (uint8_t)((e[k].ax_peak_centi_g >> 8) & 0xFF);
+    out[i++] = (uint8_t)(e[k].idle_ms & 0xFF);
+    out[i++] = (uint8_t)((e[k].idle_ms >> 8) & 0xFF);
+  }
+  out[i] = crc8(out, i);
+  return i + 1U;
+}
+
+size_t pkt_decode_batch(const uint8_t* in, size_t len, fall_event_t* out, size_t max) {
+  if (!in || !out || len < PKT_BATCH_BYTES(1U)) return 0;
+  if (in[0] != PKT_TYPE_BATCH || in[1] != PKT_VER) return 0;
+  const size_t n = in[2];
+  if (n == 0U || n > PKT_BATCH_MAX || n > max || len < PKT_BATCH_BYTES(n)) return 0;
+  if (crc8(in, PKT_BATCH_BYTES(n) - 1U) != in[PKT_BATCH_BYTES(n) - 1U]) return 0;
+  const uint8_t* p = &in[PKT_BATCH_HDR_BYTES];
+  for (size_t k = 0; k < n; ++k, p += PKT_BATCH_ITEM_BYTES) {
+    out[k].epoch_ms = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    out[k].ax_peak_centi_g = (int16_t)((uint16_t)p[4] | ((uint16_t)p[5] << 8));
+    out[k].idle_ms = (uint16_t)((uint16_t)p[6] | ((uint16_t)p[7] << 8));
+    out[k].kind = FALL_EVT_CONFIRMED;
+    out[k].seq = 0U;
+  }
+  return n;
+}
+
+size_t pkt_encode_bbox_frag(const pkt_bbox_frag_t* f, uint8_t* out, size_t max) {
+  if (!f || !out || (f->len && !f->payload)) return 0;
+  if (f->len > PKT_BBOX_MAX_PAYLOAD || f->frag_idx >= f->frag_cnt) return 0;
+  const size_t need = PKT_BBOX_HDR_BYTES + f->len + 1U;
+  if (max < need) return 0;
+  size_t i = 0;
+  out[i++] = PKT_TYPE_BBOX;
+  out[i++] = PKT_VER;
+  out[i++] = f->xfer_id;
+  out[i++] = f->frag_idx;
+  out[i++] = f->frag_cnt;
+  out[i++] = f->len;
+  memcpy(&out[i], f->payload, f->len);
+  i += f->len;
+  out[i] = crc8(out, i);
+  return i + 1U;
+}
+
+bool pkt_decode_bbox_frag(const uint8_t* in, size_t len, pkt_bbox_frag_t* f) {
+  if (!in || !f || len < PKT_BBOX_HDR_BYTES + 1U) return false;
+  if (in[0] != PKT_TYPE_BBOX || in[1] != PKT_VER) return false;
+  const uint8_t plen = in[5];
+  if (plen > PKT_BBOX_MAX_PAYLOAD) return false;
+  const size_t need = PKT_BBOX_HDR_BYTES + plen + 1U;
+  if (len < need) return false;
+  if (crc8(in, need - 1U) != in[need - 1U]) return false;
+  if (in[4] == 0U || in[3] >= in[4]) return false;
+  f->xfer_id = in[2];
+  f->frag_idx = in[3];
+  f->frag_cnt = in[4];
+  f->len = plen;
+  f->payload = &in[PKT_BBOX_HDR_BYTES];
+  return true;
+}
+
+size_t pkt_encode_relay(const pkt_relay_t* r, uint8_t* out, size_t max) {
+  if (!r || !out || !r->inner || r->len == 0U || r->len > PKT_RELAY_MAX_INNER) return 0;
+  const size_t need = PKT_RELAY_HDR_BYTES + r->len + 1U;
+  if (max < need) return 0;
+  size_t i = 0;
+  out[i++] = PKT_TYPE_RELAY;
+  out[i++] = PKT_VER;
+  out[i++] = r->origin;
+  out[i++] = r->seq;
+  out[i++] = r->hops;
+  out[i++] = r->len;
+  memcpy(&out[i], r->inner, r->len);   // inner no puede solaparse con out
+  i += r->len;
+  out[i] = crc8(out, i);
+  return i + 1U;
+}
+
+bool pkt_decode_relay(const uint8_t* in, size_t len, pkt_relay_t* r) {
+  if (!in || !r || len < PKT_RELAY_HDR_BYTES + 1U) return false;
+  if (in[0] != PKT_TYPE_RELAY || in[1] != PKT_VER) return false;
+  const uint8_t ilen = in[5];
+  if (ilen == 0U || ilen > PKT_RELAY_MAX_INNER) return false;
+  const size_t need = PKT_RELAY_HDR_BYTES + ilen + 1U;
+  if (len < need) return false;
+  if (crc8(in, need - 1U) != in[need - 1U]) return false;
+  r->origin = in[2];
+  r->seq = in[3];
+  r->hops = in[4];
+  r->len = ilen;
+  r->inner = &in[PKT_RELAY_HDR_BYTES];
+  return true;
+}
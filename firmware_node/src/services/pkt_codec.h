@@ -5,9 +5,74 @@
 #include <stddef.h>
 #include "firmware_node/src/services/fall_detector.h"
 
+#define PKT_TYPE_BATCH 0xF9
 #define PKT_TYPE_ALERT 0xFA
+#define PKT_TYPE_BBOX  0xFB
+#define PKT_TYPE_PRE   0xFC
+#define PKT_TYPE_CANCEL 0xFD
+#define PKT_TYPE_RELAY 0xFE
 #define PKT_VER        0x01
 
+// Alerta en dos fases (fall_event_t.kind). La confirmación es la trama
+// PKT_TYPE_ALERT de siempre; el receptor la asocia a la prealerta pendiente.
+//   prealerta:   TYPE, VER, seq, epoch_ms(4), peak(2), CRC8          (10 B)
+//   cancelación: TYPE, VER, seq, epoch_ms(4) de la prealerta, CRC8   (8 B)
+#define PKT_ALERT_BYTES  11U
+#define PKT_PRE_BYTES    10U
+#define PKT_CANCEL_BYTES 8U
+
+// Fragmento de transferencia "caja negra":
+// TYPE, VER, xfer_id, frag_idx, frag_cnt, plen, payload[plen], CRC8
+#define PKT_BBOX_HDR_BYTES   6U
+#define PKT_BBOX_MAX_PAYLOAD 48U
+#define PKT_BBOX_MAX_FRAME   (PKT_BBOX_HDR_BYTES + PKT_BBOX_MAX_PAYLOAD + 1U)
+
+// Lote de alertas confirmadas diferidas (store-and-forward del nodo):
+// TYPE, VER, n, n × (epoch_ms(4), peak(2), idle(2)), CRC8
+#define PKT_BATCH_HDR_BYTES 3U
+#define PKT_BATCH_ITEM_BYTES 8U
+#define PKT_BATCH_MAX ((PKT_BBOX_MAX_FRAME - PKT_BATCH_HDR_BYTES - 1U) / PKT_BATCH_ITEM_BYTES)
+#define PKT_BATCH_BYTES(n) (PKT_BATCH_HDR_BYTES + (n) * PKT_BATCH_ITEM_BYTES + 1U)
+
+// Sobre de retransmisión (services/relay): cualquier trama anterior viaja
+// adentro, identificada por nodo de origen y secuencia de ese nodo.
+// TYPE, VER, origin, seq, hops, ilen, inner[ilen], CRC8
+#define PKT_RELAY_HDR_BYTES 6U
+#define PKT_RELAY_MAX_INNER PKT_BBOX_MAX_FRAME
+#define PKT_RELAY_MAX_FRAME (PKT_RELAY_HDR_BYTES + PKT_RELAY_MAX_INNER + 1U)
+
+typedef struct {
+  uint8_t origin;
+  uint8_t seq;
+  uint8_t hops;             // saltos recorridos (0 = lo emitió el origen)
+  uint8_t len;
+  const uint8_t* inner;     // apunta dentro del buffer de entrada al decodificar
+} pkt_relay_t;
+
+typedef struct {
+  uint8_t xfer_id;
+  uint8_t frag_idx;
+  uint8_t frag_cnt;
+  uint8_t len;
+  const uint8_t* payload;   // apunta dentro del buffer de entrada al decodificar
+} pkt_bbox_frag_t;
+
 size_t pkt_encode_alert(const fall_event_t* e, uint8_t* out, size_t max);
 bool   pkt_decode_alert(const uint8_t* in, size_t len, fall_event_t* e);
 
+// Según e->kind: PKT_TYPE_ALERT, PKT_TYPE_PRE o PKT_TYPE_CANCEL.
+size_t pkt_encode_event(const fall_event_t* e, uint8_t* out, size_t max);
+// Acepta los tres tipos; e->kind indica cuál llegó.
+bool   pkt_decode_event(const uint8_t* in, size_t len, fall_event_t* e);
+
+// n entre 1 y PKT_BATCH_MAX confirmaciones.
+size_t pkt_encode_batch(const fall_event_t* e, size_t n, uint8_t* out, size_t max);
+// Cantidad de alertas decodificadas en out (0 si la trama es inválida).
+size_t pkt_decode_batch(const uint8_t* in, size_t len, fall_event_t* out, size_t max);
+
+size_t pkt_encode_relay(const pkt_relay_t* r, uint8_t* out, size_t max);
+bool   pkt_decode_relay(const uint8_t* in, size_t len, pkt_relay_t* r);
+
+size_t pkt_encode_bbox_frag(const pkt_bbox_frag_t* f, uint8_t* out, size_t max);
+bool   pkt_decode_bbox_frag(const uint8_t* in, size_t len, pkt_bbox_frag_t* f);
+
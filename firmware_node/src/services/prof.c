@@ -0,0 +1,60 @@
+#include "firmware_node/src/services/prof.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static prof_entry_t s_table[PROF_COUNT];
+
+static const char* const s_names[PROF_COUNT] = {
+  "fall_detector_feed",
+  "vector_peak_centi_g",
+  "raw_to_centi_g",
+  "spi_read_reg",
+  "wait_for_irq",
+  "pkt_encode_alert",
+  "crc8",
+  "orientation_update",
+  "feat_window_push",
+};
+
+void prof_reset(void) {
+  mem_report_static("prof", sizeof(s_table));
+  memset(s_table, 0, sizeof(s_table));
+  for (unsigned i = 0; i < PROF_COUNT; ++i) s_table[i].min = UINT32_MAX;
+}
+
+void prof_record(prof_id_t id, uint32_t cycles) {
+  if ((unsigned)id >= PROF_COUNT) return;
+  prof_entry_t* e = &s_table[id];
+  if (e->calls == 0U) e->min = UINT32_MAX;
+  e->calls++;
+  e->total += cycles;
+  if (cycles < e->min) e->min = cycles;
+  if (cycles > e->max) e->max = cycles;
+}
+
+void prof_get(prof_id_t id, prof_entry_t* out) {
+  if (!out) return;
+  if ((unsigned)id >= PROF_COUNT) {
+    memset(out, 0, sizeof(*out));
+    return;
+  }
+  *out = s_table[id];
+}
+
+const char* prof_name(prof_id_t id) {
+  return (unsigned)id < PROF_COUNT ? s_names[id] : "?";
+}
+
+void prof_dump(void) {
+  printf("PROF %-20s %10s %14s %8s %8s %8s\n", "funcion", "llamadas", "total", "min", "max", "media");
+  for (unsigned i = 0; i < PROF_COUNT; ++i) {
+    const prof_entry_t* e = &s_table[i];
+    if (e->calls == 0U) continue;
+    printf("PROF %-20s %10u %14llu %8u %8u %8llu\n", s_names[i], (unsigned)e->calls,
+           (unsigned long long)e->total, (unsigned)e->min, (unsigned)e->max,
+           (unsigned long long)(e->total / e->calls));
+  }
+  fflush(stdout);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config/system_config.h"
+
+// Profiler por ámbito con contador de ciclos. PROF_SCOPE(id) al inicio de una
+// función (o bloque) acumula llamadas, total, mínimo y máximo de ciclos hasta
+// el cierre del ámbito (__attribute__((cleanup)), cubre todos los return).
+// ESP32: esp_cpu_get_cycle_count(); host x86: rdtsc; otro host: clock_gettime (ns).
+// Con PROF_ENABLE=0 (por defecto) las macros no generan código.
+// Sin locks: si dos tareas perfilan el mismo id a la vez puede perderse una
+// muestra; suficiente para ubicar el presupuesto de CPU.
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE 0
+#endif
+
+typedef enum {
+  PROF_FALL_FEED = 0,      // fall_detector_feed
+  PROF_VECTOR_PEAK,        // vector_peak_centi_g
+  PROF_RAW_TO_CENTI_G,     // raw_to_centi_g (MPU9250)
+  PROF_SPI_READ_REG,       // spi_read_reg (SX1276)
+  PROF_WAIT_FOR_IRQ,       // wait_for_irq (SX1276)
+  PROF_PKT_ENCODE,         // pkt_encode_alert
+  PROF_CRC8,               // crc8 (pkt_codec)
+  PROF_ORIENT_UPDATE,      // orientation_update
+  PROF_FEAT_PUSH,          // feat_window_push
+  PROF_COUNT
+} prof_id_t;
+
+typedef struct {
+  uint32_t calls;
+  uint64_t total;
+  uint32_t min;
+  uint32_t max;
+} prof_entry_t;
+
+#if APP_USE_FREERTOS
+#include "esp_cpu.h"
+static inline uint32_t prof_cycles(void) {
+  return (uint32_t)esp_cpu_get_cycle_count();
+}
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint32_t prof_cycles(void) {
+  return (uint32_t)__rdtsc();
+}
+#else
+#include <time.h>
+static inline uint32_t prof_cycles(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+#endif
+
+void prof_reset(void);
+void prof_record(prof_id_t id, uint32_t cycles);
+void prof_get(prof_id_t id, prof_entry_t* out);
+const char* prof_name(prof_id_t id);
+// Tabla "PROF <función> llamadas total min max media" por stdout/serial.
+void prof_dump(void);
+
+#if PROF_ENABLE
+typedef struct {
+  prof_id_t id;
+  uint32_t t0;
+} prof_scope_t;
+
+static inline void prof_scope_end(prof_scope_t* s) {
+  prof_record(s->id, prof_cycles() - s->t0);
+}
+
+#define PROF_CAT_(a, b) a##b
+#define PROF_CAT(a, b)  PROF_CAT_(a, b)
+#define PROF_SCOPE(id) \
+  prof_scope_t PROF_CAT(prof_scope_, __LINE__) __attribute__((cleanup(prof_scope_end))) = { (id), prof_cycles() }
+#else
+#define PROF_SCOPE(id) ((void)0)
+#endif
@@ -0,0 +1,158 @@
+#include "firmware_node/src/services/relay.h"
+
+#include <string.h>
+
+#if RELAY_CACHE_LEN > 255U
+#error "RELAY_CACHE_LEN debe ser <= 255"
+#endif
+
+static uint16_t make_key(uint8_t origin, uint8_t seq) {
+  return (uint16_t)(((uint16_t)origin << 8) | seq);
+}
+
+static uint32_t rng_next(relay_t* r) {
+  uint32_t x = r->rng;   // xorshift32
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  r->rng = x;
+  return x;
+}
+
+void relay_init(relay_t* r, const relay_cfg_t* cfg) {
+  if (!r) return;
+  memset(r, 0, sizeof(*r));
+  if (cfg) {
+    r->cfg = *cfg;
+  } else {
+    r->cfg.rebroadcast = true;
+    r->cfg.max_hops = RELAY_MAX_HOPS;
+    r->cfg.delay_min_ms = RELAY_DELAY_MIN_MS;
+    r->cfg.delay_max_ms = RELAY_DELAY_MAX_MS;
+    r->cfg.suppress_copies = RELAY_SUPPRESS_COPIES;
+    r->cfg.seed = 1U;
+  }
+  if (r->cfg.delay_max_ms < r->cfg.delay_min_ms) r->cfg.delay_max_ms = r->cfg.delay_min_ms;
+  r->rng = r->cfg.seed ? r->cfg.seed : 0x9E3779B9U;
+}
+
+static bool cache_seen(const relay_t* r, uint16_t key) {
+  for (unsigned i = 0; i < r->cache_fill; ++i) {
+    if (r->cache[i] == key) return true;
+  }
+  return false;
+}
+
+// Reemplazo FIFO: la clave más vieja se olvida primero.
+static void cache_add(relay_t* r, uint16_t key) {
+  r->cache[r->cache_head] = key;
+  r->cache_head = (uint8_t)((r->cache_head + 1U) % RELAY_CACHE_LEN);
+  if (r->cache_fill < RELAY_CACHE_LEN) r->cache_fill++;
+}
+
+static relay_pending_t* pending_find(relay_t* r, uint16_t key) {
+  for (unsigned i = 0; i < RELAY_PENDING; ++i) {
+    if (r->pending[i].used && r->pending[i].key == key) return &r->pending[i];
+  }
+  return NULL;
+}
+
+static void schedule(relay_t* r, const pkt_relay_t* env, uint16_t key, uint32_t now_ms) {
+  if (env->hops >= r->cfg.max_hops) {
+    r->stats.hop_limit++;
+    return;
+  }
+  relay_pending_t* p = NULL;
+  for (unsigned i = 0; i < RELAY_PENDING; ++i) {
+    if (!r->pending[i].used) {
+      p = &r->pending[i];
+      break;
+    }
+  }
+  if (!p) {
+    r->stats.pending_full++;
+    return;
+  }
+  pkt_relay_t out = *env;
+  out.hops = (uint8_t)(env->hops + 1U);
+  const size_t len = pkt_encode_relay(&out, p->frame, sizeof(p->frame));
+  if (len == 0U) return;
+  const uint32_t span = (uint32_t)r->cfg.delay_max_ms - r->cfg.delay_min_ms;
+  p->used = true;
+  p->key = key;
+  p->copies = 0U;
+  p->len = (uint8_t)len;
+  p->due_ms = now_ms + r->cfg.delay_min_ms + (span ? rng_next(r) % (span + 1U) : 0U);
+  r->stats.scheduled++;
+}
+
+relay_verdict_t relay_on_rx(relay_t* r, const uint8_t* frame, size_t len, uint32_t now_ms, pkt_relay_t* env) {
+  if (!r || !frame || len == 0U || !env) return RELAY_BAD;
+  if (frame[0] != PKT_TYPE_RELAY) return RELAY_PLAIN;
+  if (!pkt_decode_relay(frame, len, env)) return RELAY_BAD;
+  r->stats.heard++;
+  const uint16_t key = make_key(env->origin, env->seq);
+  if (cache_seen(r, key)) {
+    r->stats.duplicates++;
+    relay_pending_t* p = pending_find(r, key);
+    if (p && r->cfg.suppress_copies && ++p->copies >= r->cfg.suppress_copies) {
+      p->used = false;   // los vecinos ya la cubrieron
+      r->stats.suppressed++;
+    }
+    return RELAY_DUP;
+  }
+  cache_add(r, key);
+  r->stats.delivered++;
+  if (r->cfg.rebroadcast) schedule(r, env, key, now_ms);
+  return RELAY_NEW;
+}
+
+size_t relay_poll(relay_t* r, uint32_t now_ms, uint8_t* out, size_t max) {
+  if (!r || !out) return 0;
+  relay_pending_t* due = NULL;
+  for (unsigned i = 0; i < RELAY_PENDING; ++i) {
+    relay_pending_t* p = &r->pending[i];
+    if (!p->used || (int32_t)(now_ms - p->due_ms) < 0) continue;
+    if (!due || (int32_t)(p->due_ms - due->due_ms) < 0) due = p;
+  }
+  if (!due || due->len > max) return 0;
+  memcpy(out, due->frame, due->len);
+  due->used = false;
+  r->stats.relayed++;
+  return due->len;
+}
+
+uint32_t relay_next_due_ms(const relay_t* r, uint32_t now_ms) {
+  uint32_t best = UINT32_MAX;
+  if (!r) return best;
+  for (unsigned i = 0; i < RELAY_PENDING; ++i) {
+    const relay_pending_t* p = &r->pending[i];
+    if (!p->used) continue;
+    const int32_t left = (int32_t)(p->due_ms - now_ms);
+    const uint32_t wait = left > 0 ? (uint32_t)left : 0U;
+    if (wait < best) best = wait;
+  }
+  return best;
+}
+
+size_t relay_wrap(relay_t* r, uint8_t origin, const uint8_t* inner, size_t len, uint8_t* out, size_t max) {
+  if (!r || !inner || len == 0U || len > PKT_RELAY_MAX_INNER) return 0;
+  const pkt_relay_t env = { origin, r->next_seq, 0U, (uint8_t)len, inner };
+  const size_t n = pkt_encode_relay(&env, out, max);
+  if (n == 0U) return 0;
+  cache_add(r, make_key(origin, r->next_seq));
+  r->next_seq++;
+  return n;
+}
+
+void relay_set_next_seq(relay_t* r, uint8_t seq) {
+  if (r) r->next_seq = seq;
+}
+
+uint8_t relay_next_seq(const relay_t* r) {
+  return r ? r->next_seq : 0U;
+}
+
+void relay_stats(const relay_t* r, relay_stats_t* out) {
+  if (r && out) *out = r->stats;
+}
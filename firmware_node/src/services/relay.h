@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "firmware_node/src/services/pkt_codec.h"
+
+// Retransmisión por inundación (multi-salto) de tramas con sobre
+// PKT_TYPE_RELAY. Cada instancia (propiedad del llamador, sin malloc) guarda
+// las últimas RELAY_CACHE_LEN claves (origen, seq) vistas: una trama ya vista
+// no se entrega ni se retransmite otra vez (lazos, copias por varios
+// caminos). Las retransmisiones salen tras un retardo aleatorio para que
+// los vecinos que oyeron la misma trama no transmitan a la vez; si mientras
+// tanto se oyen suppress_copies copias, se cancela (supresión por contador).
+// Lógica pura: el llamador pone el reloj y la radio.
+
+#ifndef RELAY_CACHE_LEN
+#define RELAY_CACHE_LEN 32U      // claves (origen, seq) recordadas
+#endif
+
+#ifndef RELAY_PENDING
+#define RELAY_PENDING 4U         // retransmisiones programadas a la vez
+#endif
+
+#ifndef RELAY_MAX_HOPS
+#define RELAY_MAX_HOPS 6U
+#endif
+
+#ifndef RELAY_DELAY_MIN_MS
+#define RELAY_DELAY_MIN_MS 0U
+#endif
+
+#ifndef RELAY_DELAY_MAX_MS
+#define RELAY_DELAY_MAX_MS 800U  // ~15 tramas de alerta con sobre a SF7: ≥ vecinos × aire
+#endif
+
+#ifndef RELAY_SUPPRESS_COPIES
+#define RELAY_SUPPRESS_COPIES 2U // 0 = sin supresión
+#endif
+
+typedef enum {
+  RELAY_NEW = 0,     // primera copia: procesar env->inner
+  RELAY_DUP,         // ya vista: descartar
+  RELAY_PLAIN,       // trama sin sobre: procesar tal cual, no se retransmite
+  RELAY_BAD          // sobre inválido (CRC, largo)
+} relay_verdict_t;
+
+typedef struct {
+  bool rebroadcast;          // false: sólo filtra duplicados (receptor final)
+  uint8_t max_hops;
+  uint16_t delay_min_ms;
+  uint16_t delay_max_ms;
+  uint8_t suppress_copies;
+  uint32_t seed;             // distinto por equipo (desincroniza los retardos)
+} relay_cfg_t;
+
+typedef struct {
+  uint32_t heard;            // sobres válidos
+  uint32_t delivered;        // RELAY_NEW
+  uint32_t duplicates;
+  uint32_t scheduled;
+  uint32_t relayed;          // entregados por relay_poll
+  uint32_t suppressed;       // cancelados por copias oídas
+  uint32_t hop_limit;        // no se retransmiten: max_hops alcanzado
+  uint32_t pending_full;
+} relay_stats_t;
+
+typedef struct {
+  bool used;
+  uint16_t key;
+  uint8_t copies;
+  uint8_t len;
+  uint32_t due_ms;
+  uint8_t frame[PKT_RELAY_MAX_FRAME];
+} relay_pending_t;
+
+typedef struct {
+  relay_cfg_t cfg;
+  uint16_t cache[RELAY_CACHE_LEN];
+  uint8_t cache_head;
+  uint8_t cache_fill;
+  uint8_t next_seq;          // relay_wrap
+  uint32_t rng;
+  relay_pending_t pending[RELAY_PENDING];
+  relay_stats_t stats;
+} relay_t;
+
+// cfg NULL: valores RELAY_* y rebroadcast = true.
+void relay_init(relay_t* r, const relay_cfg_t* cfg);
+
+// Clasifica una trama recibida en now_ms. Con RELAY_NEW env recibe el sobre
+// (env->inner apunta dentro de frame) y, si corresponde, queda programada la
+// retransmisión con hops + 1.
+relay_verdict_t relay_on_rx(relay_t* r, const uint8_t* frame, size_t len, uint32_t now_ms, pkt_relay_t* env);
+
+// Copia en out la próxima retransmisión vencida (la radio debe estar libre);
+// 0 si no hay ninguna.
+size_t relay_poll(relay_t* r, uint32_t now_ms, uint8_t* out, size_t max);
+
+// ms hasta la próxima retransmisión; UINT32_MAX si no hay pendientes.
+uint32_t relay_next_due_ms(const relay_t* r, uint32_t now_ms);
+
+// Envuelve una trama propia (origen, siguiente seq) y la marca como vista
+// para no retransmitir su eco.
+size_t relay_wrap(relay_t* r, uint8_t origin, const uint8_t* inner, size_t len, uint8_t* out, size_t max);
+
+// Seq del próximo relay_wrap. relay_init lo deja en 0: el llamador lo fija al
+// arrancar para no repetir claves (origen, seq) que los receptores todavía
+// recuerdan de antes de un reinicio (ver app.c: RTC_NOINIT o aleatorio).
+void relay_set_next_seq(relay_t* r, uint8_t seq);
+uint8_t relay_next_seq(const relay_t* r);
+
+void relay_stats(const relay_t* r, relay_stats_t* out);
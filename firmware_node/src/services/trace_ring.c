@@ -0,0 +1,92 @@
+#include "firmware_node/src/services/trace_ring.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#if (TRACE_RING_LEN & (TRACE_RING_LEN - 1U)) != 0U
+#error "TRACE_RING_LEN debe ser potencia de 2"
+#endif
+
+_Static_assert(sizeof(trace_rec_t) == 8, "trace_rec_t debe ocupar 8 bytes");
+
+static trace_rec_t s_ring[TRACE_RING_LEN];
+static atomic_uint s_head;   // próximo índice a escribir (monótono)
+static unsigned s_tail = 0;  // próximo índice a drenar (sólo el lector)
+
+static const char* const s_event_names[TRACE_EV_COUNT] = {
+  "sample",
+  "detect",
+  "alert_tx",
+  "bbox_frag",
+  "led",
+  "i2c",
+  "spi",
+  "lora_tx",
+  "lora_rx",
+  "dio_irq",
+  "alert_push",
+};
+
+void trace_ring_init(void) {
+  mem_report_static("trace_ring", sizeof(s_ring));
+  memset(s_ring, 0, sizeof(s_ring));
+  atomic_store_explicit(&s_head, 0U, memory_order_relaxed);
+  s_tail = 0U;
+}
+
+void trace_ring_emit(trace_kind_t kind, trace_event_t ev, uint8_t arg) {
+  const unsigned idx = atomic_fetch_add_explicit(&s_head, 1U, memory_order_relaxed);
+  const int task = os_task_index();
+  trace_rec_t* r = &s_ring[idx & (TRACE_RING_LEN - 1U)];
+  r->ts_us = (uint32_t)os_now_us();
+  r->kind = (uint8_t)kind;
+  r->task = task < 0 || task >= (int)TRACE_TASK_NONE ? TRACE_TASK_NONE : (uint8_t)task;
+  r->ev = (uint8_t)ev;
+  r->arg = arg;
+}
+
+size_t trace_ring_drain(trace_rec_t* out, size_t max, uint32_t* lost) {
+  const unsigned head = atomic_load_explicit(&s_head, memory_order_acquire);
+  uint32_t skipped = 0U;
+  if (head - s_tail > TRACE_RING_LEN) {
+    skipped = head - s_tail - TRACE_RING_LEN;
+    s_tail = head - TRACE_RING_LEN;
+  }
+  size_t n = 0;
+  while (n < max && s_tail != head) {
+    out[n++] = s_ring[s_tail & (TRACE_RING_LEN - 1U)];
+    s_tail++;
+  }
+  if (lost) *lost = skipped;
+  return n;
+}
+
+const char* trace_event_name(trace_event_t ev) {
+  return (unsigned)ev < TRACE_EV_COUNT ? s_event_names[ev] : "?";
+}
+
+void trace_ring_dump(void) {
+  for (int t = 0; os_task_name(t); ++t) {
+    printf("TRT %d %s\n", t, os_task_name(t));
+  }
+  for (unsigned e = 0; e < TRACE_EV_COUNT; ++e) {
+    printf("TRE %u %s\n", e, s_event_names[e]);
+  }
+  trace_rec_t chunk[32];
+  uint32_t lost_total = 0U;
+  for (;;) {
+    uint32_t lost = 0U;
+    const size_t n = trace_ring_drain(chunk, sizeof(chunk) / sizeof(chunk[0]), &lost);
+    lost_total += lost;
+    for (size_t i = 0; i < n; ++i) {
+      const trace_rec_t* r = &chunk[i];
+      printf("TRC %08x%02x%02x%02x%02x\n", (unsigned)r->ts_us, r->kind, r->task, r->ev, r->arg);
+    }
+    if (n < sizeof(chunk) / sizeof(chunk[0])) break;
+  }
+  printf("TRL %u\n", (unsigned)lost_total);
+  fflush(stdout);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Tracer binario de eventos: ring fijo de registros de 8 bytes (begin/end/
+// instant + tarea + evento), pensado para quedar activo en producción.
+// Escritura lock-free (fetch_add del índice, apto para ISR); si el lector no
+// drena a tiempo se pisan los registros más viejos (flight recorder).
+// Drenaje: trace_ring_dump() emite líneas de texto "TRC..." por serial o
+// stdout; tools/trace2json.c las convierte a Chrome trace-event JSON
+// (abrible en chrome://tracing o ui.perfetto.dev).
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+#ifndef TRACE_RING_LEN
+#define TRACE_RING_LEN 1024U   // potencia de 2 (8 KiB)
+#endif
+
+#define TRACE_TASK_NONE 0xFFU  // ISR o tarea ajena a os_port
+
+typedef enum {
+  TRACE_BEGIN = 'B',
+  TRACE_END = 'E',
+  TRACE_INSTANT = 'i'
+} trace_kind_t;
+
+typedef enum {
+  TRACE_EV_SAMPLE = 0,   // vuelta de tsk_sample_detect
+  TRACE_EV_DETECT,       // fall_detector_feed
+  TRACE_EV_ALERT_TX,     // alerta: encode + lora_tx
+  TRACE_EV_BBOX_FRAG,    // fragmento de caja negra
+  TRACE_EV_LED,          // cambio de modo del LED (arg = modo)
+  TRACE_EV_I2C,          // transacción I2C (imu_accel)
+  TRACE_EV_SPI,          // transacción SPI (lora_radio)
+  TRACE_EV_LORA_TX,      // lora_tx completo
+  TRACE_EV_LORA_RX,      // trama recibida (arg = primer byte)
+  TRACE_EV_DIO_IRQ,      // flanco DIO0/DIO1
+  TRACE_EV_ALERT_PUSH,   // evento encolado
+  TRACE_EV_COUNT
+} trace_event_t;
+
+typedef struct {
+  uint32_t ts_us;   // reloj os_now_us truncado (envuelve cada ~71 min)
+  uint8_t kind;     // trace_kind_t
+  uint8_t task;     // os_task_index() o TRACE_TASK_NONE
+  uint8_t ev;       // trace_event_t
+  uint8_t arg;
+} trace_rec_t;
+
+void trace_ring_init(void);
+void trace_ring_emit(trace_kind_t kind, trace_event_t ev, uint8_t arg);
+// Copia y consume hasta max registros en orden; *lost (opcional) recibe los
+// pisados desde el último drenaje. Un solo lector.
+size_t trace_ring_drain(trace_rec_t* out, size_t max, uint32_t* lost);
+const char* trace_event_name(trace_event_t ev);
+// Emite "TRT <idx> <tarea>", "TRE <id> <evento>", "TRC <16 hex>" por registro
+// y "TRL <perdidos>" por stdout (UART0 en el ESP32).
+void trace_ring_dump(void);
+
+#if TRACE_ENABLE
+#define TRACE_BEGIN_EV(ev)        trace_ring_emit(TRACE_BEGIN, (ev), 0U)
+#define TRACE_END_EV(ev)          trace_ring_emit(TRACE_END, (ev), 0U)
+#define TRACE_INSTANT_EV(ev, arg) trace_ring_emit(TRACE_INSTANT, (ev), (uint8_t)(arg))
+#else
+#define TRACE_BEGIN_EV(ev)        ((void)0)
+#define TRACE_END_EV(ev)          ((void)0)
+#define TRACE_INSTANT_EV(ev, arg) ((void)0)
+#endif
@@ -2,135 +2,437 @@
 
 #include "config/radio_params.h"
 #include "firmware_node/src/drivers/lora_radio.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/bbox_xfer.h"
+#include "firmware_node/src/services/dlog.h"
 #include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/journal.h"
+#include "firmware_node/src/services/lat_probe.h"
+#include "firmware_node/src/services/mem_report.h"
 #include "firmware_node/src/services/pkt_codec.h"
+#include "firmware_node/src/services/relay.h"
+#include "firmware_rx/src/rx_display.h"
+#include "firmware_rx/src/rx_stream.h"
 
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <string.h>
 
 #if APP_USE_FREERTOS
-#include "FreeRTOS.h"
-#include "queue.h"
-#include "task.h"
 #include "esp_log.h"
-#else
-#if defined(__unix__) || defined(__APPLE__)
-#include <time.h>
 #endif
+
+// Sin confirmación ni cancelación en este tiempo la prealerta vence (trama
+// perdida): cubre Tidle + la ventana del detector + cola y aire.
+#ifndef APP_RX_PREALERT_TIMEOUT_MS
+#define APP_RX_PREALERT_TIMEOUT_MS 3000U
 #endif
 
-#if !APP_USE_FREERTOS
-#define APP_RX_POLL_ITER 200U
+// 1: además de entregar, retransmite los sobres PKT_TYPE_RELAY que oye
+// (repetidor). Con 0 el sobre sólo sirve para descartar copias.
+#ifndef APP_RX_RELAY
+#define APP_RX_RELAY 0
+#endif
+
+#ifndef APP_RX_RELAY_SEED
+#define APP_RX_RELAY_SEED 0x5EEDU   // distinto por equipo en una instalación real
+#endif
+
+// 1: cada evento recibido queda en la bitácora de flash (services/journal).
+#ifndef APP_RX_JOURNAL
+#define APP_RX_JOURNAL 1
+#endif
+
+// 1: UI de estado en el OLED del TTGO (rx_display), refrescada por evento y
+// una vez por segundo; sin OLED el receptor sigue sólo con el log.
+#ifndef APP_RX_OLED
+#define APP_RX_OLED 1
+#endif
+
+// 1: cada trama recibida sale en binario por la UART (rx_stream, COBS) para
+// tools/rx_capture; en host va a RX_STREAM_HOST_PATH.
+#ifndef APP_RX_STREAM
+#define APP_RX_STREAM 1
+#endif
+
+// Prealertas pendientes a la vez, cada una de un (nodo, seq). Llena: la más
+// próxima a vencer se da por vencida.
+#ifndef APP_RX_PRE_SLOTS
+#define APP_RX_PRE_SLOTS 4U
+#endif
+
+#ifndef APP_RX_EVT_QUEUE_CAP
+#define APP_RX_EVT_QUEUE_CAP 4U
+#endif
+
+// Stacks en bytes; ver "MEM stack" en mem_report_dump().
+#ifndef APP_RX_STACK_LORA
+#define APP_RX_STACK_LORA 4096U
 #endif
 
+#ifndef APP_RX_STACK_UI
+#define APP_RX_STACK_UI 3072U   // esp_partition_write en journal_append
+#endif
+
+typedef enum {
+  RX_PRE_CANCELLED = 0,
+  RX_PRE_CONFIRMED,
+  RX_PRE_EXPIRED
+} rx_pre_end_t;
+
+// Elemento de evt_queue: el evento, su origen (sobre de retransmisión o 0)
+// y la calidad de la trama que lo trajo.
+typedef struct {
+  fall_event_t evt;
+  uint8_t node;
+  int8_t snr_db;
+  int16_t rssi_dbm;
+} rx_evt_t;
+
+// Prealerta pendiente: el epoch_ms es del reloj del nodo, así que sólo se
+// compara con eventos del mismo nodo.
+typedef struct {
+  bool used;
+  uint8_t node;
+  fall_event_t evt;
+  uint64_t deadline_us;
+} rx_pre_t;
+
 typedef struct {
   bool ready;
-#if APP_USE_FREERTOS
-  QueueHandle_t evt_queue;
-#else
-  bool event_pending;
-  fall_event_t last_event;
-#endif
+  bool journal_ok;
+  bool display_ok;
+  bool stream_ok;
+  uint32_t ts_base;         // s: último ts de la bitácora al arrancar (sin RTC)
+  rx_pre_t pre[APP_RX_PRE_SLOTS];   // tsk_ui: prealarmas mostradas
+  relay_t relay;
+  os_queue_t evt_queue;
+  app_rx_stats_t stats;
 } app_rx_ctx_t;
 
 static app_rx_ctx_t s_rx_ctx;
+#if APP_USE_FREERTOS
 static const char* TAG_RX = "app_rx";
+#endif
+static accel_raw_t s_bbox_samples[BBOX_MAX_SAMPLES];
 
-#if APP_USE_FREERTOS
-static void rx_log(const fall_event_t* evt) {
-  ESP_LOGI(TAG_RX, "ALERTA RX epoch=%u peak=%d idle=%u",
-           (unsigned)evt->epoch_ms,
-           (int)evt->ax_peak_centi_g,
-           (unsigned)evt->idle_ms);
+static rx_stream_status_t rx_handle_bbox(const uint8_t* frame, size_t len) {
+  pkt_bbox_frag_t frag;
+  if (!pkt_decode_bbox_frag(frame, len, &frag)) {
+    s_rx_ctx.stats.frames_bad++;
+    return RX_ST_BAD;
+  }
+  s_rx_ctx.stats.bbox_frags++;
+  if (bbox_xfer_rx_feed(&frag) != BBOX_RX_COMPLETE) return RX_ST_BBOX;
+  const size_t n = bbox_xfer_rx_samples(s_bbox_samples, BBOX_MAX_SAMPLES);
+  s_rx_ctx.stats.bbox_done++;
+  DLOG(DLOG_RX_BBOX_DONE, frag.xfer_id, frag.frag_cnt, (int32_t)n);
+  (void)n;
+  return RX_ST_BBOX;
+}
+
+static void pre_end(rx_pre_t* p, rx_pre_end_t how) {
+  p->used = false;
+  if (how == RX_PRE_EXPIRED) s_rx_ctx.stats.pre_expired++;
+  if (how == RX_PRE_CONFIRMED) s_rx_ctx.stats.escalated++;
+  DLOG(DLOG_RX_PRE_END, p->evt.seq, how, p->node);
 }
-#else
-static void rx_delay_ms(uint32_t ms) {
-#if defined(__unix__) || defined(__APPLE__)
-  struct timespec ts;
-  ts.tv_sec = (time_t)(ms / 1000U);
-  ts.tv_nsec = (long)((ms % 1000U) * 1000000L);
-  nanosleep(&ts, NULL);
-#else
-  volatile uint32_t spin = ms * 4000U;
-  while (spin-- > 0U) {
-    (void)spin;
+
+// Pendiente de node con seq (seq < 0: cualquiera), o NULL.
+static rx_pre_t* pre_find(uint8_t node, int seq) {
+  for (unsigned i = 0; i < APP_RX_PRE_SLOTS; ++i) {
+    rx_pre_t* p = &s_rx_ctx.pre[i];
+    if (p->used && p->node == node && (seq < 0 || p->evt.seq == (uint8_t)seq)) return p;
+  }
+  return NULL;
+}
+
+// Vence las pendientes cuyo plazo pasó; devuelve el próximo plazo
+// (UINT64_MAX si no queda ninguna).
+static uint64_t pre_expire(uint64_t now_us) {
+  uint64_t next = UINT64_MAX;
+  for (unsigned i = 0; i < APP_RX_PRE_SLOTS; ++i) {
+    rx_pre_t* p = &s_rx_ctx.pre[i];
+    if (!p->used) continue;
+    if (now_us >= p->deadline_us) {
+      pre_end(p, RX_PRE_EXPIRED);
+    } else if (p->deadline_us < next) {
+      next = p->deadline_us;
+    }
+  }
+  return next;
+}
+
+static rx_pre_t* pre_slot(uint8_t node, uint8_t seq) {
+  rx_pre_t* p = pre_find(node, seq);   // la misma prealerta otra vez
+  if (p) return p;
+  rx_pre_t* soonest = &s_rx_ctx.pre[0];
+  for (unsigned i = 0; i < APP_RX_PRE_SLOTS; ++i) {
+    if (!s_rx_ctx.pre[i].used) return &s_rx_ctx.pre[i];
+    if (s_rx_ctx.pre[i].deadline_us < soonest->deadline_us) soonest = &s_rx_ctx.pre[i];
+  }
+  pre_end(soonest, RX_PRE_EXPIRED);
+  return soonest;
+}
+
+// Tiempo de la bitácora: segundos monótonos entre reinicios.
+static uint32_t journal_ts(void) {
+  return s_rx_ctx.ts_base + (uint32_t)(os_now_us() / 1000000U);
+}
+
+static void journal_log(const rx_evt_t* e) {
+  if (!s_rx_ctx.journal_ok) return;
+  journal_rec_t rec = { 0U, journal_ts(), e->node, e->evt.kind, e->evt.seq, e->evt.epoch_ms,
+                        e->evt.ax_peak_centi_g, e->evt.idle_ms };
+  if (journal_append(&rec)) {
+    s_rx_ctx.stats.journaled++;
+  } else {
+    s_rx_ctx.stats.journal_fail++;
+  }
+}
+
+// Prealarma → alarma (confirmación) o vuelta al reposo (cancelación), por
+// (nodo, seq). Una confirmación sin prealerta pendiente (prealerta perdida)
+// alarma igual. Las tramas sin sobre llegan todas con nodo 0: con ellas el
+// emparejamiento sólo vale para un nodo (README_app_rx.md).
+static void ui_handle(const fall_event_t* evt, uint8_t node) {
+  rx_pre_t* p;
+  switch (evt->kind) {
+    case FALL_EVT_PREALERT:
+      p = pre_slot(node, evt->seq);
+      p->used = true;
+      p->node = node;
+      p->evt = *evt;
+      p->deadline_us = os_now_us() + (uint64_t)APP_RX_PREALERT_TIMEOUT_MS * 1000U;
+      DLOG(DLOG_RX_PREALERT, evt->seq, (int32_t)evt->epoch_ms, evt->ax_peak_centi_g);
+      break;
+    case FALL_EVT_CANCEL:
+      p = pre_find(node, evt->seq);
+      if (p && evt->epoch_ms == p->evt.epoch_ms) pre_end(p, RX_PRE_CANCELLED);
+      break;
+    default:
+      // La alerta no lleva seq: la pendiente del mismo nodo cuyo pico abrió la
+      // prealerta; el pico final puede ser posterior, nunca anterior.
+      for (unsigned i = 0; i < APP_RX_PRE_SLOTS; ++i) {
+        p = &s_rx_ctx.pre[i];
+        if (p->used && p->node == node && evt->epoch_ms >= p->evt.epoch_ms &&
+            evt->epoch_ms - p->evt.epoch_ms <= APP_RX_PREALERT_TIMEOUT_MS) {
+          pre_end(p, RX_PRE_CONFIRMED);
+          break;
+        }
+      }
+      DLOG(DLOG_RX_ALERT, (int32_t)evt->epoch_ms, evt->ax_peak_centi_g, evt->idle_ms);
+      break;
   }
-#endif
 }
-#endif
 
 void app_rx_init(void) {
   memset(&s_rx_ctx, 0, sizeof(s_rx_ctx));
+  dlog_init();
   s_rx_ctx.ready = lora_init(LORA_FREQ_HZ, LORA_SF, LORA_BW_KHZ, LORA_POUT_DBM, LORA_CRC_ON);
+  bbox_xfer_init();
+  const relay_cfg_t relay_cfg = { APP_RX_RELAY, RELAY_MAX_HOPS, RELAY_DELAY_MIN_MS, RELAY_DELAY_MAX_MS,
+                                  RELAY_SUPPRESS_COPIES, APP_RX_RELAY_SEED };
+  relay_init(&s_rx_ctx.relay, &relay_cfg);
+  s_rx_ctx.journal_ok = APP_RX_JOURNAL && journal_init();
+  s_rx_ctx.ts_base = s_rx_ctx.journal_ok ? journal_last_ts() + 1U : 0U;
 #if APP_USE_FREERTOS
-  if (s_rx_ctx.ready) {
-    s_rx_ctx.evt_queue = xQueueCreate(4, sizeof(fall_event_t));
-    xTaskCreatePinnedToCore(tsk_lora_rx, "rx_lora", 4096, NULL, configMAX_PRIORITIES - 2, NULL, 1);
-    xTaskCreatePinnedToCore(tsk_ui, "rx_ui", 2048, NULL, tskIDLE_PRIORITY + 1, NULL, 1);
-  } else {
-    ESP_LOGE(TAG_RX, "LoRa init failed");
+  if (APP_RX_JOURNAL && !s_rx_ctx.journal_ok) {
+    ESP_LOGW(TAG_RX, "bitacora: sin particion '%s'", JOURNAL_PARTITION_LABEL);
+  }
+#endif
+  s_rx_ctx.display_ok = APP_RX_OLED && rx_display_init();
+#if APP_USE_FREERTOS
+  if (APP_RX_OLED && !s_rx_ctx.display_ok) {
+    ESP_LOGW(TAG_RX, "OLED no responde: sin pantalla");
   }
 #endif
+  mem_report_static("rx_ctx", sizeof(s_rx_ctx) + sizeof(s_bbox_samples));
+  if (!s_rx_ctx.ready) {
+#if APP_USE_FREERTOS
+    ESP_LOGE(TAG_RX, "LoRa init failed");
+#endif
+    return;
+  }
+  s_rx_ctx.evt_queue = os_queue_create(APP_RX_EVT_QUEUE_CAP, sizeof(rx_evt_t));
+  s_rx_ctx.stream_ok = APP_RX_STREAM && rx_stream_init(1);
+  os_task_create(tsk_lora_rx, "rx_lora", APP_RX_STACK_LORA, OS_PRIO_HIGH, 1, NULL, NULL);
+  os_task_create(tsk_ui, "rx_ui", APP_RX_STACK_UI, OS_PRIO_LOW, 1, NULL, NULL);
+  dlog_start(1);
+}
+
+// Trama sin sobre (o el contenido de un sobre nuevo de node) con la calidad
+// de la trama que la trajo.
+static rx_stream_status_t rx_handle_frame(const uint8_t* frame, size_t len, uint8_t node, int16_t rssi_dbm,
+                                          int8_t snr_db) {
+  if (frame[0] == PKT_TYPE_BBOX) return rx_handle_bbox(frame, len);
+  if (frame[0] == PKT_TYPE_BATCH) {
+    // Alertas confirmadas que el nodo guardó durante un corte del enlace.
+    fall_event_t batch[PKT_BATCH_MAX];
+    const size_t n = pkt_decode_batch(frame, len, batch, PKT_BATCH_MAX);
+    if (n == 0U) {
+      s_rx_ctx.stats.frames_bad++;
+      return RX_ST_BAD;
+    }
+    DLOG(DLOG_RX_BATCH, (int32_t)n);
+    for (size_t i = 0; i < n; ++i) {
+      const rx_evt_t item = { .evt = batch[i], .node = node, .snr_db = snr_db, .rssi_dbm = rssi_dbm };
+      s_rx_ctx.stats.alerts++;
+      s_rx_ctx.stats.batched++;
+      if (!os_queue_send(s_rx_ctx.evt_queue, &item, 0U)) {
+        s_rx_ctx.stats.ui_dropped++;
+      }
+    }
+    return RX_ST_BATCH;
+  }
+  rx_evt_t item = { .node = node, .snr_db = snr_db, .rssi_dbm = rssi_dbm };
+  fall_event_t* evt = &item.evt;
+  if (!pkt_decode_event(frame, len, evt)) {
+    s_rx_ctx.stats.frames_bad++;
+    return RX_ST_BAD;
+  }
+  if (evt->kind == FALL_EVT_PREALERT) {
+    LAT_PROBE_MARK(evt->epoch_ms, LAT_STAGE_PRE_RX);
+    s_rx_ctx.stats.prealerts++;
+  } else if (evt->kind == FALL_EVT_CANCEL) {
+    s_rx_ctx.stats.cancels++;
+  } else {
+    LAT_PROBE_MARK(evt->epoch_ms, LAT_STAGE_RX_DECODE);
+    s_rx_ctx.stats.alerts++;
+  }
+  if (!os_queue_send(s_rx_ctx.evt_queue, &item, 0U)) {
+    s_rx_ctx.stats.ui_dropped++;
+  }
+  return RX_ST_EVENT;
+}
+
+static uint32_t now_ms(void) {
+  return (uint32_t)(os_now_us() / 1000U);
+}
+
+static uint32_t now_s(void) {
+  return (uint32_t)(os_now_us() / 1000000U);
+}
+
+// Trama tal como llegó del aire: sobre (el primero de cada origen se procesa)
+// o trama simple. *origin: origen del sobre decodificado (nuevo o repetido);
+// 0 para una trama simple o un sobre inválido.
+static rx_stream_status_t rx_dispatch(const uint8_t* buf, size_t len, int16_t rssi_dbm, int8_t snr_db,
+                                      uint8_t* origin) {
+  pkt_relay_t env;
+  *origin = 0U;
+  switch (relay_on_rx(&s_rx_ctx.relay, buf, len, now_ms(), &env)) {
+    case RELAY_NEW:
+      *origin = env.origin;
+      return rx_handle_frame(env.inner, env.len, env.origin, rssi_dbm, snr_db);
+    case RELAY_PLAIN:
+      return rx_handle_frame(buf, len, 0U, rssi_dbm, snr_db);
+    case RELAY_DUP:
+      *origin = env.origin;
+      return RX_ST_DUP;
+    default:
+      s_rx_ctx.stats.frames_bad++;
+      return RX_ST_BAD;
+  }
 }
 
 void tsk_lora_rx(void* arg) {
   (void)arg;
   if (!s_rx_ctx.ready) return;
 
-  const size_t expected_len = 1U + 1U + 4U + 2U + 2U + 1U;
-  uint8_t rx_buf[32];
+  uint8_t rx_buf[PKT_RELAY_MAX_FRAME];
+  uint8_t tx_buf[PKT_RELAY_MAX_FRAME];
 
-#if APP_USE_FREERTOS
-  for (;;) {
-#else
-  for (uint32_t i = 0; i < APP_RX_POLL_ITER; ++i) {
-#endif
-    if (lora_rx(rx_buf, sizeof(rx_buf), LORA_RX_TIMEOUT_MS)) {
-      fall_event_t evt;
-      if (pkt_decode_alert(rx_buf, expected_len, &evt)) {
-#if APP_USE_FREERTOS
-        if (s_rx_ctx.evt_queue) {
-          xQueueSend(s_rx_ctx.evt_queue, &evt, 0);
-        }
-#else
-        s_rx_ctx.last_event = evt;
-        s_rx_ctx.event_pending = true;
-#endif
-      }
+  while (os_running()) {
+    // Radio half-duplex: las retransmisiones vencidas salen antes de volver a escuchar.
+    size_t n;
+    while ((n = relay_poll(&s_rx_ctx.relay, now_ms(), tx_buf, sizeof(tx_buf))) > 0U) {
+      lora_tx(tx_buf, n, LORA_TX_TIMEOUT_MS);
     }
-#if !APP_USE_FREERTOS
-    else {
-      rx_delay_ms(20U);
+    // Sin sondeo: la tarea duerme hasta RxDone (DIO0), la próxima
+    // retransmisión o el fin de la simulación.
+    uint32_t wait_ms = relay_next_due_ms(&s_rx_ctx.relay, now_ms());
+    if (wait_ms == UINT32_MAX) wait_ms = OS_WAIT_FOREVER;
+    else if (wait_ms == 0U) wait_ms = 1U;
+    const bool got = lora_rx(rx_buf, sizeof(rx_buf), wait_ms);
+    if (!os_running()) break;
+    s_rx_ctx.stats.wakeups_rx++;
+    if (!got) continue;
+    int16_t rssi_dbm;
+    int8_t snr_db;
+    lora_rx_quality(&rssi_dbm, &snr_db);
+    const size_t len = lora_rx_len();
+    uint8_t origin;
+    const rx_stream_status_t st = rx_dispatch(rx_buf, len, rssi_dbm, snr_db, &origin);
+    if (s_rx_ctx.stream_ok && !rx_stream_put(st, origin, rssi_dbm, snr_db, rx_buf, len)) {
+      s_rx_ctx.stats.stream_dropped++;
     }
-#endif
   }
 }
 
+// Evento ya decodificado: prealarma/alarma, pantalla y bitácora.
+static void ui_item(const rx_evt_t* item) {
+  ui_handle(&item->evt, item->node);
+  if (s_rx_ctx.display_ok) {
+    rx_display_event(&item->evt, item->node, item->rssi_dbm, item->snr_db, now_s());
+    rx_display_render(now_s());
+  }
+  journal_log(item);   // después de mostrar: el borrado de un sector tarda ~45 ms
+}
+
 void tsk_ui(void* arg) {
   (void)arg;
   if (!s_rx_ctx.ready) return;
 
-#if APP_USE_FREERTOS
-  fall_event_t evt;
-  for (;;) {
-    if (s_rx_ctx.evt_queue && xQueueReceive(s_rx_ctx.evt_queue, &evt, portMAX_DELAY) == pdTRUE) {
-      rx_log(&evt);
+  rx_evt_t item;
+  while (os_running()) {
+    uint32_t wait_ms = OS_WAIT_FOREVER;
+    const uint64_t now = os_now_us();
+    const uint64_t pre_due = pre_expire(now);
+    if (pre_due != UINT64_MAX) wait_ms = (uint32_t)((pre_due - now + 999U) / 1000U);
+    if (s_rx_ctx.display_ok) {
+      // Relojes del OLED: despertar en el próximo cambio de segundo.
+      const uint32_t tick_ms = (uint32_t)((1000000U - now % 1000000U + 999U) / 1000U);
+      if (tick_ms < wait_ms) wait_ms = tick_ms;
     }
-  }
-#else
-  for (uint32_t i = 0; i < APP_RX_POLL_ITER; ++i) {
-    if (s_rx_ctx.event_pending) {
-      s_rx_ctx.event_pending = false;
-      printf("[RX] ALERTA HOMBRE CAIDO - epoch=%ums peak=%d idle=%ums\n",
-             (unsigned)s_rx_ctx.last_event.epoch_ms,
-             (int)s_rx_ctx.last_event.ax_peak_centi_g,
-             (unsigned)s_rx_ctx.last_event.idle_ms);
-      fflush(stdout);
+    const bool got = os_queue_recv(s_rx_ctx.evt_queue, &item, wait_ms);
+    if (!os_running()) break;
+    s_rx_ctx.stats.wakeups_ui++;
+    if (!got) {   // vencidas: al principio de la próxima vuelta
+      if (s_rx_ctx.display_ok) rx_display_render(now_s());
+      continue;
     }
-    rx_delay_ms(100U);
+    ui_item(&item);
   }
+}
+
+#if !APP_USE_FREERTOS
+void app_rx_offline_init(void) {
+  memset(&s_rx_ctx, 0, sizeof(s_rx_ctx));
+  dlog_init();
+  bbox_xfer_init();
+  const relay_cfg_t relay_cfg = { 0, RELAY_MAX_HOPS, RELAY_DELAY_MIN_MS, RELAY_DELAY_MAX_MS,
+                                  RELAY_SUPPRESS_COPIES, APP_RX_RELAY_SEED };
+  relay_init(&s_rx_ctx.relay, &relay_cfg);
+  s_rx_ctx.evt_queue = os_queue_create(APP_RX_EVT_QUEUE_CAP, sizeof(rx_evt_t));
+  s_rx_ctx.ready = s_rx_ctx.evt_queue != NULL;
+}
+
+uint8_t app_rx_offline_frame(const uint8_t* frame, size_t len, int16_t rssi_dbm, int8_t snr_db) {
+  if (!s_rx_ctx.ready || !frame || len == 0U) return RX_ST_BAD;
+  uint8_t origin;
+  const rx_stream_status_t st = rx_dispatch(frame, len, rssi_dbm, snr_db, &origin);
+  (void)origin;
+  rx_evt_t item;
+  while (os_queue_recv(s_rx_ctx.evt_queue, &item, 0U)) ui_item(&item);
+  return (uint8_t)st;
+}
 #endif
+
+void app_rx_get_stats(app_rx_stats_t* out) {
+  if (out) *out = s_rx_ctx.stats;
 }
 
+void app_rx_relay_stats(relay_stats_t* out) {
+  relay_stats(&s_rx_ctx.relay, out);
+}
@@ -1,7 +1,42 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "config/system_config.h"
+#include "firmware_node/src/services/relay.h"
+
+typedef struct {
+  uint32_t alerts;        // alertas (confirmaciones) con CRC OK
+  uint32_t prealerts;     // prealertas con CRC OK
+  uint32_t cancels;       // cancelaciones con CRC OK
+  uint32_t escalated;     // confirmación de la prealerta pendiente
+  uint32_t pre_expired;   // prealerta sin confirmación ni cancelación a tiempo
+  uint32_t frames_bad;    // tipo desconocido o CRC inválido
+  uint32_t ui_dropped;    // cola de UI llena
+  uint32_t bbox_frags;
+  uint32_t bbox_done;
+  uint32_t batched;       // alertas llegadas en lotes de reenvío (store-and-forward)
+  uint32_t journaled;     // eventos guardados en la bitácora
+  uint32_t journal_fail;
+  uint32_t wakeups_rx;    // vueltas de tsk_lora_rx
+  uint32_t wakeups_ui;    // vueltas de tsk_ui
+  uint32_t stream_dropped;   // registros del flujo binario perdidos (ring lleno)
+} app_rx_stats_t;
 
 void app_rx_init(void);
 void tsk_lora_rx(void* arg);
 void tsk_ui(void* arg);
+void app_rx_get_stats(app_rx_stats_t* out);
+// Sobres oídos, duplicados descartados y retransmisiones (APP_RX_RELAY).
+void app_rx_relay_stats(relay_stats_t* out);
+
+#if !APP_USE_FREERTOS
+// Reproducción (tools/rx_capture): la lógica del receptor sin radio ni
+// tareas, sin bitácora ni OLED. Cada trama pasa por el mismo camino que en
+// tsk_lora_rx y sus eventos por el de tsk_ui, en el contexto del llamador.
+// Las prealertas no vencen (dependen del reloj, no de las tramas).
+void app_rx_offline_init(void);
+// Resultado como rx_stream_status_t.
+uint8_t app_rx_offline_frame(const uint8_t* frame, size_t len, int16_t rssi_dbm, int8_t snr_db);
+#endif
@@ -2,11 +2,21 @@
 
 #if !APP_USE_FREERTOS
 #include <stddef.h>
+#include <stdio.h>
+
+#include "firmware_node/src/port/os_port.h"
+
+#ifndef APP_HOST_RUN_MS
+#define APP_HOST_RUN_MS 5000U
+#endif
 
 int main(void) {
   app_rx_init();
-  tsk_lora_rx(NULL);
-  tsk_ui(NULL);
+  os_run_for_ms(APP_HOST_RUN_MS);
+
+  app_rx_stats_t st;
+  app_rx_get_stats(&st);
+  printf("[HOST] rx alertas=%u invalidas=%u\n", (unsigned)st.alerts, (unsigned)st.frames_bad);
   return 0;
 }
 #endif
@@ -0,0 +1,225 @@
+#include "firmware_rx/src/rx_display.h"
+
+#include "firmware_node/src/drivers/oled_ssd1306.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <string.h>
+
+#define BAR_X   (17U * OLED_CHAR_W)
+#define BAR_W   (OLED_WIDTH - BAR_X - 2U)
+#define RSSI_MIN_DBM (-120)   // barra vacía
+#define RSSI_MAX_DBM (-60)    // barra llena
+
+typedef enum {
+  NODE_IDLE = 0,
+  NODE_PRE,
+  NODE_ALERT
+} node_state_t;
+
+typedef struct {
+  bool used;
+  uint8_t node;
+  uint8_t state;        // node_state_t
+  int8_t snr_db;
+  int16_t rssi_dbm;
+  uint32_t last_s;      // última trama
+  uint32_t state_s;     // inicio de la prealerta / última alerta
+} node_row_t;
+
+typedef struct {
+  node_row_t rows[RX_DISPLAY_NODES];
+  uint32_t events;
+  bool ok;
+} rx_display_ctx_t;
+
+static rx_display_ctx_t s_disp;
+
+// Texto de ancho fijo: sin snprintf (stack de tsk_ui acotado).
+static char* put_str(char* p, const char* s) {
+  while (*s) *p++ = *s++;
+  return p;
+}
+
+// v alineado a la derecha en w caracteres (se recorta a los dígitos menos significativos).
+static char* put_u(char* p, uint32_t v, unsigned w) {
+  for (unsigned i = w; i > 0U; --i) {
+    p[i - 1U] = (v || i == w) ? (char)('0' + v % 10U) : ' ';
+    v /= 10U;
+  }
+  return p + w;
+}
+
+// Con signo, alineado a la derecha en w caracteres.
+static char* put_i(char* p, int32_t v, unsigned w) {
+  const uint32_t m = (uint32_t)(v < 0 ? -v : v);
+  put_u(p, m, w);
+  if (v < 0) {
+    unsigned i = 0;
+    while (i + 1U < w && p[i + 1U] == ' ') ++i;
+    p[i] = '-';
+  }
+  return p + w;
+}
+
+// v alineado a la izquierda en w caracteres (ids de nodo).
+static char* put_ul(char* p, uint32_t v, unsigned w) {
+  char tmp[10];
+  char* end = put_u(tmp, v, w);
+  char* q = tmp;
+  while (q < end && *q == ' ') ++q;
+  char* out = p;
+  while (q < end) *out++ = *q++;
+  while (out < p + w) *out++ = ' ';
+  return p + w;
+}
+
+// Edad compacta en 4 caracteres: "12s", "5m", "3h"; cambia menos seguido.
+static char* put_age(char* p, uint32_t s) {
+  if (s < 60U) {
+    p = put_u(p, s, 3);
+    *p++ = 's';
+  } else if (s < 3600U) {
+    p = put_u(p, s / 60U, 3);
+    *p++ = 'm';
+  } else {
+    p = put_u(p, s / 3600U > 999U ? 999U : s / 3600U, 3);
+    *p++ = 'h';
+  }
+  return p;
+}
+
+// cols caracteres desde la izquierda: lo que sobra se borra con espacios.
+// Nunca pisa lo dibujado a la derecha (la barra), que se ensuciaría en cada vuelta.
+static void line_w(uint8_t page, char* buf, char* end, bool inv, unsigned cols) {
+  while (end < buf + cols) *end++ = ' ';
+  *end = '\0';
+  oled_text(0, page, buf, inv);
+}
+
+static void line(uint8_t page, char* buf, char* end, bool inv) {
+  line_w(page, buf, end, inv, OLED_COLS);
+}
+
+static uint8_t state_at(const node_row_t* r, uint32_t now_s) {
+  if (r->state == NODE_ALERT && now_s - r->state_s < RX_DISPLAY_ALERT_HOLD_S) return NODE_ALERT;
+  if (r->state == NODE_PRE && now_s - r->state_s < RX_DISPLAY_PRE_HOLD_S) return NODE_PRE;
+  return NODE_IDLE;
+}
+
+static node_row_t* row_for(uint8_t node) {
+  node_row_t* free_row = NULL;
+  node_row_t* oldest = &s_disp.rows[0];
+  for (uint32_t i = 0; i < RX_DISPLAY_NODES; ++i) {
+    node_row_t* r = &s_disp.rows[i];
+    if (r->used && r->node == node) return r;
+    if (!r->used && !free_row) free_row = r;
+    if (r->used && r->last_s < oldest->last_s) oldest = r;
+  }
+  node_row_t* r = free_row ? free_row : oldest;
+  memset(r, 0, sizeof(*r));
+  r->used = true;
+  r->node = node;
+  return r;
+}
+
+bool rx_display_init(void) {
+  memset(&s_disp, 0, sizeof(s_disp));
+  mem_report_static("rx_display", sizeof(s_disp));
+  s_disp.ok = oled_init();
+  return s_disp.ok;
+}
+
+void rx_display_event(const fall_event_t* evt, uint8_t node, int16_t rssi_dbm, int8_t snr_db, uint32_t now_s) {
+  if (!evt) return;
+  node_row_t* r = row_for(node);
+  r->rssi_dbm = rssi_dbm;
+  r->snr_db = snr_db;
+  r->last_s = now_s;
+  s_disp.events++;
+  switch (evt->kind) {
+    case FALL_EVT_PREALERT:
+      if (state_at(r, now_s) != NODE_ALERT) {
+        r->state = NODE_PRE;
+        r->state_s = now_s;
+      }
+      break;
+    case FALL_EVT_CANCEL:
+      if (r->state == NODE_PRE) r->state = NODE_IDLE;
+      break;
+    default:
+      r->state = NODE_ALERT;
+      r->state_s = now_s;
+      break;
+  }
+}
+
+size_t rx_display_render(uint32_t now_s) {
+  if (!s_disp.ok) return 0;
+  char buf[OLED_COLS + 1U];
+  char* p;
+
+  // Estado: la alerta más reciente manda; si no, la prealerta abierta.
+  const node_row_t* alert = NULL;
+  const node_row_t* pre = NULL;
+  uint32_t active = 0;
+  for (uint32_t i = 0; i < RX_DISPLAY_NODES; ++i) {
+    const node_row_t* r = &s_disp.rows[i];
+    if (!r->used) continue;
+    const uint8_t st = state_at(r, now_s);
+    if (st == NODE_ALERT) {
+      active++;
+      if (!alert || r->state_s > alert->state_s) alert = r;
+    } else if (st == NODE_PRE) {
+      pre = r;
+    }
+  }
+  if (alert) {
+    p = put_str(buf, " CAIDA N");
+    p = put_ul(p, alert->node, 3);
+    p = put_str(p, "  hace");
+    p = put_age(p, now_s - alert->state_s);
+    line(0, buf, p, true);
+  } else if (pre) {
+    p = put_str(buf, " POSIBLE N");
+    p = put_ul(p, pre->node, 3);
+    line(0, buf, p, true);
+  } else {
+    line(0, buf, put_str(buf, " Receptor OK"), false);
+  }
+
+  p = put_str(buf, "alertas activas");
+  p = put_u(p, active, 3);
+  line(1, buf, p, false);
+
+  // Nodos: "N3   -67dB 12s! [barra]".
+  uint8_t page = 2;
+  for (uint32_t i = 0; i < RX_DISPLAY_NODES; ++i, ++page) {
+    const node_row_t* r = &s_disp.rows[i];
+    if (!r->used) {
+      line(page, buf, buf, false);
+      continue;
+    }
+    const uint8_t st = state_at(r, now_s);
+    p = put_str(buf, "N");
+    p = put_ul(p, r->node, 3);
+    p = put_i(p, r->rssi_dbm, 4);
+    p = put_str(p, "dB");
+    p = put_age(p, now_s - r->last_s);
+    *p++ = st == NODE_ALERT ? '!' : (st == NODE_PRE ? '?' : ' ');
+    line_w(page, buf, p, false, BAR_X / OLED_CHAR_W);
+    // Calidad: RSSI lineal entre RSSI_MIN_DBM y RSSI_MAX_DBM; SNR negativa resta.
+    int32_t q = r->rssi_dbm + (r->snr_db < 0 ? r->snr_db : 0) - RSSI_MIN_DBM;
+    if (q < 0) q = 0;
+    if (q > RSSI_MAX_DBM - RSSI_MIN_DBM) q = RSSI_MAX_DBM - RSSI_MIN_DBM;
+    oled_bar((uint8_t)BAR_X, page, (uint8_t)BAR_W, (uint8_t)(q * (int32_t)BAR_W / (RSSI_MAX_DBM - RSSI_MIN_DBM)));
+  }
+  for (; page < OLED_PAGES - 1U; ++page) line(page, buf, buf, false);
+
+  p = put_str(buf, "ev ");
+  p = put_ul(p, s_disp.events, 6);
+  p = put_u(p, now_s, 11);
+  *p++ = 's';
+  line(OLED_PAGES - 1U, buf, p, false);
+
+  return oled_flush();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "firmware_node/src/services/fall_detector.h"
+
+// UI de estado del receptor en el OLED (drivers/oled_ssd1306):
+//   página 0     estado: "CAIDA N<id>" en negativo mientras haya una alerta
+//                activa, "POSIBLE N<id>" con una prealerta abierta, si no
+//                "Receptor OK"
+//   página 1     cantidad de alertas activas
+//   páginas 2-6  un nodo por fila: id, RSSI, tiempo desde la última trama,
+//                estado ('!' alerta, '?' prealerta) y barra de calidad de enlace
+//   página 7     eventos recibidos y segundos desde el arranque
+// Cada rx_display_render() redibuja todo en el framebuffer y el driver envía
+// sólo los bytes que cambiaron (típicamente las edades de los nodos y el reloj).
+// Los tiempos van en segundos monótonos del receptor. Una sola tarea (tsk_ui).
+
+#ifndef RX_DISPLAY_NODES
+#define RX_DISPLAY_NODES 5U   // filas de nodos; lleno, se reemplaza el más viejo
+#endif
+
+#ifndef RX_DISPLAY_ALERT_HOLD_S
+#define RX_DISPLAY_ALERT_HOLD_S 300U   // una alerta sigue activa 5 min
+#endif
+
+#ifndef RX_DISPLAY_PRE_HOLD_S
+#define RX_DISPLAY_PRE_HOLD_S 3U   // como APP_RX_PREALERT_TIMEOUT_MS
+#endif
+
+// false si no responde el OLED (el receptor sigue sin pantalla).
+bool rx_display_init(void);
+
+// Evento recibido de node con la calidad de su trama.
+void rx_display_event(const fall_event_t* evt, uint8_t node, int16_t rssi_dbm, int8_t snr_db, uint32_t now_s);
+
+// Redibuja y envía lo que cambió; bytes de bus usados (0 si nada cambió).
+size_t rx_display_render(uint32_t now_s);
@@ -0,0 +1,189 @@
+#include "firmware_rx/src/rx_stream.h"
+
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/mem_report.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#if (RX_STREAM_RING_BYTES & (RX_STREAM_RING_BYTES - 1U)) != 0U
+#error "RX_STREAM_RING_BYTES debe ser potencia de 2"
+#endif
+
+static uint8_t s_ring[RX_STREAM_RING_BYTES];
+static atomic_uint s_head;   // bytes escritos (monótono, sólo el productor)
+static atomic_uint s_tail;   // bytes drenados (monótono, sólo tsk_rx_stream)
+static os_sem_t s_wake = NULL;
+static uint16_t s_seq = 0;
+static rx_stream_stats_t s_stats;
+static bool s_ready = false;
+
+static const char* const k_status_names[RX_ST_COUNT] = { "evento", "lote", "caja", "dup", "invalida" };
+
+const char* rx_stream_status_name(uint8_t status) {
+  return status < RX_ST_COUNT ? k_status_names[status] : "?";
+}
+
+static uint16_t crc16_ccitt(const uint8_t* p, size_t n) {
+  uint16_t crc = 0xFFFFU;
+  while (n--) {
+    crc ^= (uint16_t)(*p++ << 8);
+    for (int b = 0; b < 8; ++b) crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+static void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+size_t rx_stream_pack(const rx_stream_rec_t* r, uint8_t* out, size_t max) {
+  if (!r || !out || r->len > RX_STREAM_MAX_RAW || max < 2U) return 0;
+  uint8_t rec[RX_STREAM_MAX_REC];
+  rec[0] = RX_STREAM_VER;
+  rec[1] = r->status;
+  put16(&rec[2], r->seq);
+  for (int i = 0; i < 8; ++i) rec[4 + i] = (uint8_t)(r->t_us >> (8 * i));
+  rec[12] = r->node;
+  put16(&rec[13], (uint16_t)r->rssi_dbm);
+  rec[15] = (uint8_t)r->snr_db;
+  rec[16] = r->len;
+  memcpy(&rec[RX_STREAM_HDR_BYTES], r->raw, r->len);
+  const size_t n = RX_STREAM_HDR_BYTES + r->len;
+  put16(&rec[n], crc16_ccitt(rec, n));
+  out[0] = 0U;
+  const size_t enc = cobs_encode(rec, n + 2U, &out[1], max - 2U);
+  if (enc == 0U) return 0;
+  out[1U + enc] = 0U;
+  return enc + 2U;
+}
+
+bool rx_stream_unpack(const uint8_t* in, size_t len, rx_stream_rec_t* r) {
+  uint8_t rec[RX_STREAM_MAX_REC];
+  if (!in || !r) return false;
+  const size_t n = cobs_decode(in, len, rec, sizeof(rec));
+  if (n < RX_STREAM_HDR_BYTES + 2U || rec[0] != RX_STREAM_VER) return false;
+  if (rec[16] != n - RX_STREAM_HDR_BYTES - 2U || get16(&rec[n - 2U]) != crc16_ccitt(rec, n - 2U)) return false;
+  r->status = rec[1];
+  r->seq = get16(&rec[2]);
+  r->t_us = 0;
+  for (int i = 7; i >= 0; --i) r->t_us = (r->t_us << 8) | rec[4 + i];
+  r->node = rec[12];
+  r->rssi_dbm = (int16_t)get16(&rec[13]);
+  r->snr_db = (int8_t)rec[15];
+  r->len = rec[16];
+  memcpy(r->raw, &rec[RX_STREAM_HDR_BYTES], r->len);
+  return true;
+}
+
+#if APP_USE_FREERTOS
+
+#include "driver/uart.h"
+
+static bool sink_open(void) {
+  if (uart_driver_install(RX_STREAM_UART, 256, RX_STREAM_UART_TX_BUF, 0, NULL, 0) != ESP_OK) return false;
+  return uart_set_baudrate(RX_STREAM_UART, RX_STREAM_BAUD) == ESP_OK;
+}
+
+// Copia al buffer de TX del driver; sólo espera si ese buffer está lleno.
+static void sink_write(const uint8_t* p, size_t n) {
+  uart_write_bytes(RX_STREAM_UART, (const char*)p, n);
+}
+
+static void sink_flush(void) {
+}
+
+#else  // host: archivo de captura
+
+#include <stdio.h>
+
+static FILE* s_file = NULL;
+
+static bool sink_open(void) {
+  if (!s_file) s_file = fopen(RX_STREAM_HOST_PATH, "wb");
+  return s_file != NULL;
+}
+
+static void sink_write(const uint8_t* p, size_t n) {
+  fwrite(p, 1, n, s_file);
+}
+
+static void sink_flush(void) {
+  fflush(s_file);
+}
+
+#endif  // APP_USE_FREERTOS
+
+static void drain(void) {
+  unsigned tail = atomic_load_explicit(&s_tail, memory_order_relaxed);
+  const unsigned head = atomic_load_explicit(&s_head, memory_order_acquire);
+  while (tail != head) {
+    const unsigned at = tail & (RX_STREAM_RING_BYTES - 1U);
+    unsigned n = head - tail;
+    if (n > RX_STREAM_RING_BYTES - at) n = RX_STREAM_RING_BYTES - at;   // hasta el final del ring
+    sink_write(&s_ring[at], n);
+    s_stats.bytes += n;
+    tail += n;
+    atomic_store_explicit(&s_tail, tail, memory_order_release);
+  }
+  sink_flush();
+}
+
+static void tsk_rx_stream(void* arg) {
+  (void)arg;
+  while (os_running()) {
+    os_sem_take(s_wake, OS_WAIT_FOREVER);
+    drain();
+  }
+  drain();   // host: lo pendiente al detener la simulación
+}
+
+bool rx_stream_init(int core) {
+  if (s_ready) return true;
+  mem_report_static("rx_stream", sizeof(s_ring));
+  atomic_store(&s_head, 0U);
+  atomic_store(&s_tail, 0U);
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_wake = os_sem_create();
+  if (!s_wake || !sink_open()) return false;
+  s_ready = true;
+  return os_task_create(tsk_rx_stream, "rx_stream", RX_STREAM_STACK, OS_PRIO_LOW, core, NULL, NULL);
+}
+
+bool rx_stream_put(rx_stream_status_t status, uint8_t node, int16_t rssi_dbm, int8_t snr_db, const uint8_t* raw,
+                   size_t len) {
+  if (!s_ready) return false;
+  rx_stream_rec_t r;
+  r.status = (uint8_t)status;
+  r.node = node;
+  r.seq = s_seq++;
+  r.t_us = os_now_us();
+  r.rssi_dbm = rssi_dbm;
+  r.snr_db = snr_db;
+  r.len = raw ? (uint8_t)(len > RX_STREAM_MAX_RAW ? RX_STREAM_MAX_RAW : len) : 0U;   // sin raw: sólo cabecera
+  if (r.len) memcpy(r.raw, raw, r.len);
+  uint8_t wire[RX_STREAM_MAX_WIRE];
+  const size_t n = rx_stream_pack(&r, wire, sizeof(wire));
+
+  const unsigned head = atomic_load_explicit(&s_head, memory_order_relaxed);
+  const unsigned used = head - atomic_load_explicit(&s_tail, memory_order_acquire);
+  if (n == 0U || used + n > RX_STREAM_RING_BYTES) {
+    s_stats.dropped++;   // el seq saltado lo delata en el lector
+    return false;
+  }
+  for (size_t i = 0; i < n; ++i) s_ring[(head + i) & (RX_STREAM_RING_BYTES - 1U)] = wire[i];
+  atomic_store_explicit(&s_head, head + (unsigned)n, memory_order_release);
+  if (used + n > s_stats.high_water) s_stats.high_water = (uint32_t)(used + n);
+  s_stats.records++;
+  os_sem_give(s_wake);
+  return true;
+}
+
+void rx_stream_stats(rx_stream_stats_t* out) {
+  if (out) *out = s_stats;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config/system_config.h"
+#include "firmware_node/src/services/cobs.h"
+#include "firmware_node/src/services/pkt_codec.h"
+
+// Flujo binario del receptor: un registro por trama recibida (bytes crudos,
+// RSSI/SNR, tiempo y resultado de la decodificación), en vez de texto.
+// Cada registro sale como 0x00 + COBS(registro) + 0x00: el cero inicial
+// aísla cualquier texto de consola intercalado (ESP_LOG/DLOG en la misma
+// UART), que el lector descarta por CRC, y un byte perdido cuesta un solo
+// registro. tools/rx_capture graba el flujo y lo reproduce.
+//
+// Registro (little endian), RX_STREAM_HDR_BYTES + len + 2:
+//   ver u8 | status u8 | seq u16 | t_us u64 | node u8 | rssi i16 | snr i8 |
+//   len u8 | raw[len] | crc16 (CCITT-FALSE sobre todo lo anterior)
+// seq es del flujo: un salto en el lector es un registro descartado con el
+// ring lleno o perdido en la línea.
+//
+// tsk_lora_rx llama a rx_stream_put() (copia a un ring de bytes SPSC, nunca
+// bloquea: lleno se descarta y se cuenta) y tsk_rx_stream (prioridad baja)
+// drena el ring a la UART con el driver de ESP-IDF (buffer de TX servido por
+// ISR, la tarea no espera el envío byte a byte). En host el flujo va a
+// RX_STREAM_HOST_PATH en el directorio actual.
+
+#ifndef RX_STREAM_RING_BYTES
+#define RX_STREAM_RING_BYTES 4096U   // potencia de 2; ~48 registros de alerta
+#endif
+
+#ifndef RX_STREAM_UART
+#define RX_STREAM_UART 0   // la del USB del TTGO (consola)
+#endif
+
+#ifndef RX_STREAM_BAUD
+#define RX_STREAM_BAUD 921600U
+#endif
+
+#ifndef RX_STREAM_UART_TX_BUF
+#define RX_STREAM_UART_TX_BUF 2048U   // buffer de TX del driver (ISR)
+#endif
+
+#ifndef RX_STREAM_STACK
+#define RX_STREAM_STACK 2048U
+#endif
+
+#ifndef RX_STREAM_HOST_PATH
+#define RX_STREAM_HOST_PATH "rx_stream.cap"
+#endif
+
+#define RX_STREAM_VER       1U
+#define RX_STREAM_HDR_BYTES 17U
+#define RX_STREAM_MAX_RAW   PKT_RELAY_MAX_FRAME
+#define RX_STREAM_MAX_REC   (RX_STREAM_HDR_BYTES + RX_STREAM_MAX_RAW + 2U)
+// En el cable: delimitadores + COBS del registro más largo.
+#define RX_STREAM_MAX_WIRE  (2U + COBS_MAX_ENCODED(RX_STREAM_MAX_REC))
+
+// Resultado de la trama en el receptor.
+typedef enum {
+  RX_ST_EVENT = 0,   // alerta, prealerta o cancelación válida
+  RX_ST_BATCH,       // lote de store-and-forward válido
+  RX_ST_BBOX,        // fragmento de caja negra válido
+  RX_ST_DUP,         // copia de un sobre ya procesado
+  RX_ST_BAD,         // tipo desconocido, campos o CRC inválidos
+  RX_ST_COUNT
+} rx_stream_status_t;
+
+typedef struct {
+  uint8_t status;   // rx_stream_status_t
+  uint8_t node;     // origen del sobre, 0 sin sobre
+  uint16_t seq;
+  uint64_t t_us;    // os_now_us() del receptor al decodificar
+  int16_t rssi_dbm;
+  int8_t snr_db;
+  uint8_t len;
+  uint8_t raw[RX_STREAM_MAX_RAW];
+} rx_stream_rec_t;
+
+typedef struct {
+  uint32_t records;      // aceptados en el ring
+  uint32_t dropped;      // ring lleno
+  uint32_t bytes;        // escritos a la UART / archivo
+  uint32_t high_water;   // máximo ocupado del ring (bytes)
+} rx_stream_stats_t;
+
+// Registro → bytes de cable (con los dos delimitadores); 0 si no entra.
+size_t rx_stream_pack(const rx_stream_rec_t* r, uint8_t* out, size_t max);
+// Bytes entre dos delimitadores → registro; false si COBS, CRC o versión fallan.
+bool rx_stream_unpack(const uint8_t* in, size_t len, rx_stream_rec_t* r);
+
+// Configura la UART (o abre el archivo en host) y crea tsk_rx_stream.
+bool rx_stream_init(int core);
+// Productor único (tsk_lora_rx). false si el ring está lleno. raw NULL: registro
+// sin bytes (len se ignora).
+bool rx_stream_put(rx_stream_status_t status, uint8_t node, int16_t rssi_dbm, int8_t snr_db, const uint8_t* raw,
+                   size_t len);
+void rx_stream_stats(rx_stream_stats_t* out);
+const char* rx_stream_status_name(uint8_t status);
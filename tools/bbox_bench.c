@@ -0,0 +1,106 @@
+// Benchmark host del codec "caja negra": ratio de compresión y ciclos/muestra.
+//
+// Uso: bbox_bench [traza.csv]
+//   traza.csv: una muestra por línea "ax,ay,az" en centi-g (p. ej. captura
+//   serial del nodo). Sin argumento usa el stub IMU del host.
+
+#include "firmware_node/src/drivers/imu_accel.h"
+#include "firmware_node/src/services/bbox_codec.h"
+#include "firmware_node/src/services/bbox_xfer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define BENCH_MAX_SAMPLES 200000U
+#define BENCH_REPEAT      50U
+
+static accel_raw_t s_trace[BENCH_MAX_SAMPLES];
+static uint8_t s_enc[BBOX_MAX_ENCODED(BBOX_MAX_SAMPLES)];
+static accel_raw_t s_dec[BBOX_MAX_SAMPLES];
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static size_t load_csv(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return 0;
+  }
+  size_t n = 0;
+  char line[128];
+  while (n < BENCH_MAX_SAMPLES && fgets(line, sizeof(line), f)) {
+    int ax, ay, az;
+    if (sscanf(line, "%d,%d,%d", &ax, &ay, &az) == 3) {
+      s_trace[n].ax = (int16_t)ax;
+      s_trace[n].ay = (int16_t)ay;
+      s_trace[n].az = (int16_t)az;
+      ++n;
+    }
+  }
+  fclose(f);
+  return n;
+}
+
+static size_t load_stub(void) {
+  imu_init();
+  const size_t n = 20000U;
+  for (size_t i = 0; i < n; ++i) imu_read(&s_trace[i]);
+  return n;
+}
+
+int main(int argc, char** argv) {
+  const size_t n = argc > 1 ? load_csv(argv[1]) : load_stub();
+  if (n < BBOX_MAX_SAMPLES) {
+    fprintf(stderr, "traza muy corta (%zu muestras, mínimo %u)\n", n, BBOX_MAX_SAMPLES);
+    return 1;
+  }
+
+  const size_t win = BBOX_MAX_SAMPLES;
+  uint64_t raw_bytes = 0, enc_bytes = 0, cycles = 0, samples = 0;
+  size_t worst = 0;
+
+  for (size_t off = 0; off + win <= n; off += win) {
+    size_t len = 0;
+    const uint64_t t0 = now_cycles();
+    for (unsigned r = 0; r < BENCH_REPEAT; ++r) {
+      len = bbox_encode(&s_trace[off], win, NULL, 0, s_enc, sizeof(s_enc));
+    }
+    cycles += now_cycles() - t0;
+    samples += (uint64_t)win * BENCH_REPEAT;
+
+    if (len == 0U || bbox_decode(s_enc, len, s_dec, win) != win ||
+        memcmp(s_dec, &s_trace[off], win * sizeof(accel_raw_t)) != 0) {
+      fprintf(stderr, "round-trip falló en offset %zu\n", off);
+      return 1;
+    }
+    raw_bytes += win * sizeof(accel_raw_t);
+    enc_bytes += len;
+    if (len > worst) worst = len;
+  }
+
+  printf("ventanas=%llu muestras/ventana=%zu\n",
+         (unsigned long long)(raw_bytes / (win * sizeof(accel_raw_t))), win);
+  printf("bytes crudos=%llu comprimidos=%llu ratio=%.2fx peor_ventana=%zuB (%zu frags)\n",
+         (unsigned long long)raw_bytes, (unsigned long long)enc_bytes,
+         (double)raw_bytes / (double)enc_bytes, worst,
+         (worst + PKT_BBOX_MAX_PAYLOAD - 1U) / PKT_BBOX_MAX_PAYLOAD);
+#if defined(__x86_64__) || defined(__i386__)
+  printf("encode: %.1f ciclos/muestra (TSC)\n", (double)cycles / (double)samples);
+#else
+  printf("encode: %.1f ns/muestra\n", (double)cycles / (double)samples);
+#endif
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Benchmark host de contención de alert_queue: N productores (pthreads) con
+// prioridades mezcladas contra un consumidor bloqueante.
+//
+// Antes, sin consumidor: llena el nivel NORMAL como una ráfaga de
+// prealertas/cancelaciones con el enlace caído y verifica que una
+// confirmación (CRITICAL) igual entra. Sale con 1 si se rechaza.
+//
+// Uso: bench_alert_queue [productores] [eventos_por_productor]
+
+#include "firmware_node/src/services/alert_queue.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct {
+  unsigned id;
+  unsigned events;
+  uint64_t push_ns_max;
+  uint64_t push_ns_sum;
+} producer_t;
+
+static atomic_uint s_producers_left;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void* producer(void* arg) {
+  producer_t* p = (producer_t*)arg;
+  for (unsigned i = 0; i < p->events; ++i) {
+    fall_event_t e = { .epoch_ms = i, .ax_peak_centi_g = (int16_t)p->id, .idle_ms = 0 };
+    // 1 de cada 16 es caída confirmada, el resto telemetría normal/baja.
+    const alert_prio_t prio = (i % 16U) == 0U ? ALERT_PRIO_CRITICAL
+                              : ((i & 1U) ? ALERT_PRIO_NORMAL : ALERT_PRIO_LOW);
+    const uint64_t t0 = now_ns();
+    alert_queue_push_prio(&e, prio);
+    const uint64_t dt = now_ns() - t0;
+    p->push_ns_sum += dt;
+    if (dt > p->push_ns_max) p->push_ns_max = dt;
+    if ((i & 63U) == 0U) sched_yield();
+  }
+  atomic_fetch_sub(&s_producers_left, 1U);
+  return NULL;
+}
+
+static void* consumer(void* arg) {
+  (void)arg;
+  fall_event_t e;
+  for (;;) {
+    if (alert_queue_pop(&e, 10U)) continue;
+    if (atomic_load(&s_producers_left) == 0U) break;
+  }
+  return NULL;
+}
+
+// Cola del nodo (APP_SAMPLE_QUEUE_CAP = 4 por nivel) sin consumir.
+static bool check_full_lane(void) {
+  const size_t cap = alert_queue_init(4U);
+  fall_event_t phase = { .epoch_ms = 1, .kind = FALL_EVT_PREALERT };
+  unsigned rejected = 0;
+  for (size_t i = 0; i < cap * 4U; ++i) {
+    phase.seq = (uint8_t)i;
+    if (!alert_queue_push_prio(&phase, ALERT_PRIO_NORMAL)) rejected++;
+  }
+  fall_event_t confirm = { .epoch_ms = 2, .kind = FALL_EVT_CONFIRMED };
+  const bool ok = alert_queue_push(&confirm);
+  fall_event_t e;
+  alert_prio_t prio;
+  const bool first = alert_queue_pop_prio(&e, &prio, 0U) && prio == ALERT_PRIO_CRITICAL && e.epoch_ms == 2U;
+  printf("nivel lleno: %zu fases en cola, %u rechazadas, confirmacion %s\n", cap, rejected,
+         ok && first ? "aceptada y primera" : "RECHAZADA");
+  return ok && first;
+}
+
+int main(int argc, char** argv) {
+  const unsigned n_prod = argc > 1 ? (unsigned)atoi(argv[1]) : 4U;
+  const unsigned n_evt = argc > 2 ? (unsigned)atoi(argv[2]) : 200000U;
+  if (n_prod == 0U || n_prod > 64U) return 1;
+
+  const bool lane_ok = check_full_lane();
+
+  alert_queue_init(ALERT_QUEUE_LANE_CAP);
+  atomic_store(&s_producers_left, n_prod);
+
+  producer_t prods[64] = { 0 };
+  pthread_t th[64], cons;
+  const uint64_t t0 = now_ns();
+  pthread_create(&cons, NULL, consumer, NULL);
+  for (unsigned i = 0; i < n_prod; ++i) {
+    prods[i].id = i;
+    prods[i].events = n_evt;
+    pthread_create(&th[i], NULL, producer, &prods[i]);
+  }
+  for (unsigned i = 0; i < n_prod; ++i) pthread_join(th[i], NULL);
+  pthread_join(cons, NULL);
+  const uint64_t elapsed = now_ns() - t0;
+
+  uint64_t sum = 0, max = 0;
+  for (unsigned i = 0; i < n_prod; ++i) {
+    sum += prods[i].push_ns_sum;
+    if (prods[i].push_ns_max > max) max = prods[i].push_ns_max;
+  }
+
+  alert_queue_stats_t st;
+  alert_queue_stats(&st);
+  const char* names[ALERT_PRIO_COUNT] = { "critical", "normal", "low" };
+  printf("productores=%u eventos=%u tiempo=%.1f ms\n", n_prod, n_prod * n_evt, (double)elapsed / 1e6);
+  printf("push: media=%.0f ns max=%llu ns\n", (double)sum / (double)(n_prod * n_evt),
+         (unsigned long long)max);
+  for (unsigned p = 0; p < ALERT_PRIO_COUNT; ++p) {
+    printf("%-8s pushed=%u popped=%u dropped=%u high_water=%u\n", names[p],
+           (unsigned)st.pushed[p], (unsigned)st.popped[p], (unsigned)st.dropped[p],
+           (unsigned)st.high_water[p]);
+  }
+  return lane_ok ? 0 : 1;
+}
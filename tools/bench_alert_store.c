@@ -0,0 +1,240 @@
+// Store-and-forward del nodo (services/alert_store) sobre el respaldo de
+// archivo: orden de reenvío (críticas más viejas primero), desborde RTC → NVS,
+// reinicio con la RTC conservada, falla de escritura del desborde (nada se
+// pierde), descarte con el desborde lleno (por prioridad, sin perder la
+// desalojada si la escritura falla) y lotes PKT_TYPE_BATCH que decodifica
+// el receptor. Mide alert_store_put (sólo RTC) contra alert_store_service
+// (escritura del desborde). Sale con 1 si alguna verificación falla.
+//
+// Uso: bench_alert_store [archivo] [iteraciones]
+
+#include "firmware_node/src/services/alert_store.h"
+#include "firmware_node/src/services/pkt_codec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static int s_fail;
+
+static double now_us(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static void check(bool ok, const char* what) {
+  printf("STORE check %-44s %s\n", what, ok ? "OK" : "FALLA");
+  if (!ok) s_fail = 1;
+}
+
+static fall_event_t evt(uint32_t epoch_ms) {
+  return (fall_event_t){ epoch_ms, (int16_t)(300 + epoch_ms % 400U), 700U, FALL_EVT_CONFIRMED, 0U };
+}
+
+// Vacía el almacén en lotes; devuelve cuántas salieron y verifica el orden
+// (todas de la misma prioridad: ids crecientes entre lotes).
+static uint32_t drain(bool* ordered) {
+  uint32_t total = 0, last_id = 0;
+  uint8_t frame[PKT_BATCH_BYTES(PKT_BATCH_MAX)];
+  while (alert_store_count() > 0U) {
+    fall_event_t batch[PKT_BATCH_MAX], rx[PKT_BATCH_MAX];
+    uint32_t ids[PKT_BATCH_MAX];
+    const size_t n = alert_store_peek(batch, ids, PKT_BATCH_MAX);
+    const size_t len = pkt_encode_batch(batch, n, frame, sizeof(frame));
+    if (n == 0U || pkt_decode_batch(frame, len, rx, PKT_BATCH_MAX) != n) {
+      *ordered = false;
+      return total;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (rx[i].epoch_ms != batch[i].epoch_ms || rx[i].ax_peak_centi_g != batch[i].ax_peak_centi_g ||
+          rx[i].idle_ms != batch[i].idle_ms || ids[i] <= last_id) {
+        *ordered = false;
+      }
+      last_id = ids[i];
+    }
+    alert_store_drop(ids, n);
+    total += (uint32_t)n;
+  }
+  return total;
+}
+
+// Desborda hasta llenar la NVS con alertas de prio (epoch desde base) y
+// saca de la RTC las que no llegaron a desbordarse.
+static void fill_nvs(alert_prio_t prio, uint32_t base) {
+  alert_store_stats_t st;
+  alert_store_stats(&st);
+  uint32_t n = 0;
+  while (st.nvs_len < ALERT_STORE_NVS_LEN) {
+    const fall_event_t e = evt(base + n++);
+    alert_store_put(&e, prio);
+    alert_store_service();
+    alert_store_stats(&st);
+  }
+  fall_event_t out[ALERT_STORE_NVS_LEN + ALERT_STORE_RTC_LEN];
+  uint32_t ids[ALERT_STORE_NVS_LEN + ALERT_STORE_RTC_LEN];
+  const size_t k = alert_store_peek(out, ids, ALERT_STORE_NVS_LEN + ALERT_STORE_RTC_LEN);
+  for (size_t i = 0; i < k; ++i) {
+    if (out[i].epoch_ms >= base + n - st.rtc_len && out[i].epoch_ms < base + n) alert_store_drop(&ids[i], 1);
+  }
+}
+
+// Completa la RTC con alertas de prio (epoch desde base), sin rechazos.
+static void fill_rtc(alert_prio_t prio, uint32_t base) {
+  alert_store_stats_t st;
+  alert_store_stats(&st);
+  for (uint32_t n = 0; st.rtc_len < ALERT_STORE_RTC_LEN; ++n) {
+    const fall_event_t e = evt(base + n);
+    alert_store_put(&e, prio);
+    alert_store_stats(&st);
+  }
+}
+
+// Guardadas con epoch en [lo, hi).
+static uint32_t count_range(uint32_t lo, uint32_t hi) {
+  fall_event_t out[ALERT_STORE_NVS_LEN + ALERT_STORE_RTC_LEN];
+  uint32_t ids[ALERT_STORE_NVS_LEN + ALERT_STORE_RTC_LEN];
+  const size_t n = alert_store_peek(out, ids, ALERT_STORE_NVS_LEN + ALERT_STORE_RTC_LEN);
+  uint32_t c = 0;
+  for (size_t i = 0; i < n; ++i) c += out[i].epoch_ms >= lo && out[i].epoch_ms < hi;
+  return c;
+}
+
+int main(int argc, char** argv) {
+  const char* path = argc > 1 ? argv[1] : "alert_store_bench.bin";
+  const unsigned iters = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 200000U;
+  remove(path);
+  alert_store_host_path(path);
+  alert_store_init();
+  printf("STORE rtc=%u (desborde sobre %u) nvs=%u lote=%u alertas/trama (%u B)\n",
+         (unsigned)ALERT_STORE_RTC_LEN, (unsigned)ALERT_STORE_RTC_SPILL, (unsigned)ALERT_STORE_NVS_LEN,
+         (unsigned)PKT_BATCH_MAX, (unsigned)PKT_BATCH_BYTES(PKT_BATCH_MAX));
+
+  // 1) Orden: prioridad primero, después antigüedad.
+  const fall_event_t a = evt(10), b = evt(20), c = evt(30);
+  alert_store_put(&a, ALERT_PRIO_NORMAL);
+  alert_store_put(&b, ALERT_PRIO_CRITICAL);
+  alert_store_put(&c, ALERT_PRIO_CRITICAL);
+  fall_event_t out[3];
+  uint32_t ids[3];
+  const size_t n = alert_store_peek(out, ids, 3);
+  check(n == 3U && out[0].epoch_ms == 20U && out[1].epoch_ms == 30U && out[2].epoch_ms == 10U,
+        "criticas mas viejas primero");
+  alert_store_drop(ids, n);
+  check(alert_store_count() == 0U, "drop vacia el almacen");
+
+  // 2) Desborde a NVS y reinicio: la RTC se conserva, la RAM se recarga.
+  for (uint32_t i = 0; i < ALERT_STORE_RTC_LEN; ++i) {
+    const fall_event_t e = evt(1000U + i);
+    alert_store_put(&e, ALERT_PRIO_CRITICAL);
+  }
+  const fall_event_t extra = evt(9999U);
+  check(!alert_store_put(&extra, ALERT_PRIO_CRITICAL), "RTC llena rechaza");
+  alert_store_service();
+  alert_store_stats_t st;
+  alert_store_stats(&st);
+  check(st.rtc_len == ALERT_STORE_RTC_SPILL && st.nvs_len == ALERT_STORE_RTC_LEN - ALERT_STORE_RTC_SPILL,
+        "service pasa las mas viejas a NVS");
+  alert_store_host_reset();
+  alert_store_stats(&st);
+  check(st.recovered == ALERT_STORE_RTC_LEN && alert_store_count() == ALERT_STORE_RTC_LEN,
+        "reinicio recupera RTC + NVS");
+  bool ordered = true;
+  const uint32_t got = drain(&ordered);
+  check(got == ALERT_STORE_RTC_LEN && ordered, "lotes en orden y decodificables");
+
+  // 3) Falla al escribir el desborde: las alertas siguen en la RTC y salen
+  //    en el próximo service.
+  for (uint32_t i = 0; i < ALERT_STORE_RTC_LEN; ++i) {
+    const fall_event_t e = evt(2000U + i);
+    alert_store_put(&e, ALERT_PRIO_CRITICAL);
+  }
+  alert_store_host_path("/sin/directorio/alert_store.bin");
+  alert_store_service();
+  alert_store_stats(&st);
+  check(st.rtc_len == ALERT_STORE_RTC_LEN && st.nvs_len == 0U,
+        "escritura fallida: quedan en la RTC");
+  alert_store_host_path(path);
+  alert_store_service();
+  alert_store_stats(&st);
+  check(st.rtc_len == ALERT_STORE_RTC_SPILL && alert_store_count() == ALERT_STORE_RTC_LEN, "reintento desborda");
+  check(drain(&ordered) == ALERT_STORE_RTC_LEN && ordered, "reenvio completo");
+
+  // 4) Desborde lleno: se descarta y se cuenta, nunca crece.
+  alert_store_stats_t s0;
+  alert_store_stats(&s0);
+  const uint32_t total = ALERT_STORE_NVS_LEN + ALERT_STORE_RTC_LEN + 10U;
+  uint32_t rejected = 0;   // put rechazados (también cuentan en dropped) y reintentados
+  for (uint32_t i = 0; i < total; ++i) {
+    const fall_event_t e = evt(3000U + i);
+    if (!alert_store_put(&e, ALERT_PRIO_CRITICAL)) {
+      rejected++;
+      alert_store_service();
+      alert_store_put(&e, ALERT_PRIO_CRITICAL);
+    }
+  }
+  alert_store_service();
+  alert_store_stats(&st);
+  check(st.nvs_len == ALERT_STORE_NVS_LEN && alert_store_count() + (st.dropped - s0.dropped - rejected) == total,
+        "desborde lleno: acotado y contado");
+  drain(&ordered);
+
+  // 5) Desborde lleno por prioridad: una baja que entra no desaloja a una
+  //    crítica guardada; se descarta la que entra.
+  fill_nvs(ALERT_PRIO_CRITICAL, 4000U);
+  const uint32_t crit = count_range(4000U, 5000U);
+  alert_store_stats(&s0);
+  fill_rtc(ALERT_PRIO_LOW, 5000U);
+  alert_store_service();
+  alert_store_stats(&st);
+  check(count_range(4000U, 5000U) == crit && st.dropped - s0.dropped == ALERT_STORE_RTC_LEN - ALERT_STORE_RTC_SPILL,
+        "lleno: baja entrante no desaloja critica");
+  drain(&ordered);
+
+  // 6) Desborde lleno y escritura fallida: la desalojada vuelve al espejo y
+  //    nada cuenta como descartado hasta que la escritura sale bien.
+  fill_nvs(ALERT_PRIO_NORMAL, 6000U);
+  const uint32_t normal = count_range(6000U, 7000U);
+  fill_rtc(ALERT_PRIO_CRITICAL, 7000U);
+  alert_store_stats(&s0);
+  const size_t before_fail = alert_store_count();
+  alert_store_host_path("/sin/directorio/alert_store.bin");
+  alert_store_service();
+  alert_store_stats(&st);
+  check(alert_store_count() == before_fail && count_range(6000U, 7000U) == normal && st.dropped == s0.dropped,
+        "lleno + escritura fallida: nada se pierde");
+  alert_store_host_path(path);
+  alert_store_service();
+  alert_store_stats(&st);
+  const uint32_t moved = ALERT_STORE_RTC_LEN - ALERT_STORE_RTC_SPILL;
+  check(count_range(6000U, 7000U) == normal - moved && count_range(7000U, 8000U) == ALERT_STORE_RTC_LEN &&
+            st.dropped - s0.dropped == moved,
+        "reintento: criticas desalojan normales");
+  drain(&ordered);
+
+  // 7) Costo: put (memcpy + CRC en RTC) contra service (escritura del desborde).
+  double t_put = 0.0, t_srv = 0.0;
+  unsigned n_put = 0, n_srv = 0;
+  for (unsigned k = 0; k < iters; ++k) {
+    const fall_event_t e = evt(k);
+    double t0 = now_us();
+    const bool ok = alert_store_put(&e, ALERT_PRIO_CRITICAL);
+    t_put += now_us() - t0;
+    n_put += ok;
+    if (alert_store_count() > ALERT_STORE_RTC_SPILL) {
+      t0 = now_us();
+      alert_store_service();
+      t_srv += now_us() - t0;
+      n_srv++;
+      fall_event_t tmp[PKT_BATCH_MAX];
+      uint32_t tid[PKT_BATCH_MAX];
+      const size_t m = alert_store_peek(tmp, tid, PKT_BATCH_MAX);
+      alert_store_drop(tid, m);
+    }
+  }
+  printf("STORE put n=%u %.3fus (solo RTC) service n=%u %.1fus (desborde a archivo; NVS en el ESP32: ms)\n", n_put,
+         n_put ? t_put / n_put : 0.0, n_srv, n_srv ? t_srv / n_srv : 0.0);
+
+  remove(path);
+  return s_fail;
+}
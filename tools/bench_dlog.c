@@ -0,0 +1,62 @@
+// Ciclos por mensaje en el camino caliente: printf formateado + fflush (como
+// hacían log_alert()/rx_log()) contra DLOG() (sólo copia al ring).
+// stdout va a /dev/null; el formateo diferido se mide aparte (lo paga tsk_dlog).
+//
+// Uso: bench_dlog [iteraciones]
+
+#include "firmware_node/src/services/dlog.h"
+#include "firmware_node/src/services/prof.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+  uint64_t total;
+  uint32_t max;
+} acc_t;
+
+static void acc_add(acc_t* a, uint32_t c) {
+  a->total += c;
+  if (c > a->max) a->max = c;
+}
+
+int main(int argc, char** argv) {
+  const unsigned iters = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 100000U;
+  if (!freopen("/dev/null", "w", stdout)) return 1;
+  dlog_init();
+
+  acc_t sync = { 0 }, push = { 0 }, deferred = { 0 };
+  for (unsigned i = 0; i < iters; ++i) {
+    const uint32_t epoch = i * 1000U;
+    const int16_t peak = (int16_t)(400 + (i & 63));
+    const uint16_t idle = 700;
+
+    uint32_t t0 = prof_cycles();
+    printf("[RX] ALERTA HOMBRE CAIDO - epoch=%ums peak=%d idle=%ums\n",
+           (unsigned)epoch, (int)peak, (unsigned)idle);
+    fflush(stdout);
+    acc_add(&sync, prof_cycles() - t0);
+
+    t0 = prof_cycles();
+    DLOG(DLOG_RX_ALERT, (int32_t)epoch, peak, idle);
+    acc_add(&push, prof_cycles() - t0);
+
+    if ((i & 31U) == 31U) {
+      t0 = prof_cycles();
+      dlog_flush();
+      acc_add(&deferred, prof_cycles() - t0);
+    }
+  }
+  dlog_flush();
+
+  dlog_stats_t st;
+  dlog_stats(&st);
+  fprintf(stderr, "iteraciones=%u descartes=%u\n", iters, (unsigned)st.dropped);
+  fprintf(stderr, "printf+fflush : media=%llu max=%u ciclos/msg\n",
+          (unsigned long long)(sync.total / iters), (unsigned)sync.max);
+  fprintf(stderr, "DLOG (push)   : media=%llu max=%u ciclos/msg\n",
+          (unsigned long long)(push.total / iters), (unsigned)push.max);
+  fprintf(stderr, "formateo dif. : media=%llu ciclos/msg (tsk_dlog, fuera del camino TX/RX)\n",
+          (unsigned long long)(deferred.total / iters));
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Costo por muestra de services/feat_window (incremental, O(1)) contra
+// recalcular la ventana completa en cada muestra (O(N)), para varias
+// longitudes de ventana. Verifica en cada muestra que ambos den exactamente
+// los mismos features; sale con 1 si difieren.
+//
+// Compilar con -DFEAT_WIN_MAX=1024 para barrer hasta 1024 muestras (el
+// firmware usa 64). Uso: bench_features [muestras]
+
+#include "firmware_node/src/services/feat_window.h"
+#include "firmware_node/src/services/prof.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIG_LEN 8192U
+
+static accel_raw_t s_sig[SIG_LEN];
+static int16_t s_mag[SIG_LEN];
+static int16_t s_svm[SIG_LEN];
+
+static uint16_t isqrt_ref(uint32_t v) {
+  uint32_t r = 0;
+  while ((r + 1U) * (r + 1U) <= v) r++;
+  return (uint16_t)r;
+}
+
+// Reposo con ruido, marcha y cada ~2 s una caída (caída libre + impacto).
+static void gen_signal(void) {
+  uint32_t rng = 1U;
+  for (unsigned i = 0; i < SIG_LEN; ++i) {
+    rng = rng * 1103515245U + 12345U;
+    const int n = (int)((rng >> 16) % 9U) - 4;
+    accel_raw_t s = { (int16_t)n, (int16_t)(-n / 2), (int16_t)(100 + n) };
+    const unsigned ph = i % 200U;
+    if (ph >= 100U && ph < 130U) s.az = (int16_t)(100 + (int)(ph % 27U) * 3 - 40);
+    if (ph >= 150U && ph < 170U) s.az = (int16_t)(10 + n);
+    if (ph >= 170U && ph < 175U) s.az = (int16_t)(250 + 40 * (int)(ph - 170U));
+    s_sig[i] = s;
+    s_mag[i] = (int16_t)isqrt_ref((uint32_t)(s.ax * s.ax + s.ay * s.ay + s.az * s.az));
+    s_svm[i] = (int16_t)(abs(s.ax) + abs(s.ay) + abs(s.az));
+  }
+}
+
+// Recalcula desde cero sobre las muestras [i - n + 1, i] (mismas fórmulas).
+static void naive(unsigned i, unsigned len, uint16_t fs, feat_values_t* out) {
+  const unsigned n = i + 1U < len ? i + 1U : len;
+  const unsigned first = i + 1U - n;
+  int32_t sum = 0, svm = 0, dj = 0;
+  int64_t sq = 0;
+  int16_t mn = INT16_MAX, mx = INT16_MIN;
+  for (unsigned k = first; k <= i; ++k) {
+    const int16_t m = s_mag[k % SIG_LEN];
+    sum += m;
+    sq += (int32_t)m * m;
+    svm += s_svm[k % SIG_LEN];
+    if (k > 0U) dj += abs(m - s_mag[(k - 1U) % SIG_LEN]);
+    if (m < mn) mn = m;
+    if (m > mx) mx = m;
+  }
+  memset(out, 0, sizeof(*out));
+  out->n = (uint16_t)n;
+  out->mean_centi_g = (int16_t)(sum / (int64_t)n);
+  const int64_t v = (int64_t)n * sq - (int64_t)sum * sum;
+  out->var_centi_g2 = v > 0 ? (uint32_t)(v / ((int64_t)n * n)) : 0U;
+  out->min_centi_g = mn;
+  out->max_centi_g = mx;
+  out->sma_centi_g = (uint16_t)(svm / (int32_t)n);
+  out->jerk_centi_g_s = (uint32_t)((int64_t)dj * fs / n);
+}
+
+static feat_window_t s_win;
+static volatile uint64_t s_sink;   // evita que el compilador descarte los cálculos
+
+int main(int argc, char** argv) {
+  const unsigned samples = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 200000U;
+  const uint16_t fs = 100U;
+  gen_signal();
+
+  printf("FEAT %6s %12s %12s %8s %10s\n", "len", "incr_ciclos", "naive_ciclos", "x", "difieren");
+  unsigned bad_total = 0;
+  for (unsigned len = 8U; len <= FEAT_WIN_MAX; len *= 2U) {
+    feat_values_t a, b;
+    unsigned bad = 0;
+
+    // Exactitud (sin cronometrar).
+    feat_window_init(&s_win, (uint16_t)len, fs);
+    for (unsigned i = 0; i < 3U * SIG_LEN; ++i) {
+      feat_window_push(&s_win, &s_sig[i % SIG_LEN]);
+      feat_window_get(&s_win, &a);
+      naive(i, len, fs, &b);
+      if (memcmp(&a, &b, sizeof(a)) != 0) bad++;
+    }
+
+    // Costo: push + get por muestra.
+    feat_window_init(&s_win, (uint16_t)len, fs);
+    uint64_t acc = 0;
+    uint32_t t0 = prof_cycles();
+    for (unsigned i = 0; i < samples; ++i) {
+      feat_window_push(&s_win, &s_sig[i % SIG_LEN]);
+      feat_window_get(&s_win, &a);
+      acc += a.var_centi_g2;
+    }
+    const double incr = (double)(uint32_t)(prof_cycles() - t0) / samples;
+
+    const unsigned naive_samples = samples / (len / 8U);   // mismo tiempo total aprox.
+    t0 = prof_cycles();
+    for (unsigned i = 0; i < naive_samples; ++i) {
+      naive(i + len, len, fs, &b);
+      acc += b.var_centi_g2;
+    }
+    const double slow = (double)(uint32_t)(prof_cycles() - t0) / naive_samples;
+
+    s_sink = acc;
+    printf("FEAT %6u %12.0f %12.0f %7.1fx %10u\n", len, incr, slow, slow / incr, bad);
+    bad_total += bad;
+  }
+  printf("FEAT memoria por instancia: %u B (FEAT_WIN_MAX=%u)\n", (unsigned)sizeof(feat_window_t),
+         (unsigned)FEAT_WIN_MAX);
+  return bad_total ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+// Arbitraje del bus I2C compartido (drivers/i2c_bus) con el tiempo de cable
+// simulado de host: una tarea os_port "IMU" (OS_PRIO_HIGH, como tsk_sample)
+// lee ráfagas de 14 B a FALL_FS_HZ mientras una "OLED" (OS_PRIO_LOW) escribe
+// cuadros enteros de 1 KB con 1 ms entre cuadros (carga de pantalla mucho
+// peor que la real, que envía sólo franjas sucias). Para cada tamaño de trozo
+// (0 = sin trocear) mide la espera del IMU pedido → bus concedido y la latencia
+// de la lectura completa (p50/p99/máx), lecturas vencidas contra el timeout del
+// driver del IMU y cuadros/s del OLED. La primera fila es el IMU solo.
+// Sale con 1 si con el trozo por defecto el p99 de latencia del IMU supera
+// LAT_BOUND_US o alguna lectura vence (el máximo aislado es jitter del host).
+//
+// Uso: bench_i2c_bus [segundos_por_config]
+
+#include "config/fall_params.h"
+#include "firmware_node/src/drivers/i2c_bus.h"
+#include "firmware_node/src/port/os_port.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define IMU_ADDR       0x68U
+#define OLED_ADDR      0x3CU
+#define IMU_BURST      14U
+#define IMU_TIMEOUT_MS 20U     // IMU_I2C_TIMEOUT_MS de imu_accel.c
+#define OLED_TIMEOUT_MS 50U
+#define MAX_SAMPLES    8192U
+#define LAT_BOUND_US   2000U   // un trozo por defecto ≈ 0.4 ms + jitter del host
+
+static atomic_bool s_stop;
+static atomic_uint s_alive;
+static atomic_bool s_oled_on;
+static uint32_t s_lat_us[MAX_SAMPLES];
+static uint32_t s_n_lat, s_imu_fail, s_frames;
+
+static void add_ns(struct timespec* t, long ns) {
+  t->tv_nsec += ns;
+  while (t->tv_nsec >= 1000000000L) {
+    t->tv_nsec -= 1000000000L;
+    t->tv_sec++;
+  }
+}
+
+static void imu_task(void* arg) {
+  (void)arg;
+  const uint8_t reg = 0x3B;   // ACCEL_XOUT_H
+  uint8_t buf[IMU_BURST];
+  struct timespec next;
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  while (!atomic_load(&s_stop)) {
+    add_ns(&next, 1000000000L / FALL_FS_HZ);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    const uint64_t t0 = os_now_us();
+    const bool ok = i2c_bus_write_read(I2C_CLIENT_IMU, IMU_ADDR, &reg, 1U, buf, sizeof(buf), IMU_TIMEOUT_MS);
+    const uint64_t dt = os_now_us() - t0;
+    if (!ok || dt > IMU_TIMEOUT_MS * 1000U) s_imu_fail++;
+    if (s_n_lat < MAX_SAMPLES) s_lat_us[s_n_lat++] = (uint32_t)dt;
+  }
+  atomic_fetch_sub(&s_alive, 1U);
+}
+
+static void oled_task(void* arg) {
+  (void)arg;
+  static uint8_t frame[1024];
+  const uint8_t cmd[] = { 0x00, 0x21, 0x00, 0x7F, 0x22, 0x00, 0x07 };
+  while (!atomic_load(&s_stop)) {
+    os_delay_ms(1);   // deja correr a main en host de un núcleo con SCHED_FIFO
+    if (!atomic_load(&s_oled_on)) continue;
+    frame[0]++;
+    if (i2c_bus_write(I2C_CLIENT_OLED, OLED_ADDR, cmd, sizeof(cmd), OLED_TIMEOUT_MS) &&
+        i2c_bus_write_bulk(I2C_CLIENT_OLED, OLED_ADDR, 0x40U, frame, sizeof(frame), OLED_TIMEOUT_MS)) {
+      s_frames++;
+    }
+  }
+  atomic_fetch_sub(&s_alive, 1U);
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  const uint32_t x = *(const uint32_t*)a;
+  const uint32_t y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+// Una configuración; devuelve el p99 de latencia del IMU (us).
+static uint32_t run(const char* label, bool oled, size_t chunk, uint32_t secs) {
+  i2c_bus_set_chunk(chunk);
+  s_n_lat = 0;
+  s_imu_fail = 0;
+  s_frames = 0;
+  i2c_bus_reset_stats();
+  atomic_store(&s_oled_on, oled);
+  os_delay_ms(secs * 1000U);
+  atomic_store(&s_oled_on, false);
+  os_delay_ms(30);   // el cuadro en vuelo termina
+
+  i2c_bus_stats_t imu, disp;
+  i2c_bus_stats(I2C_CLIENT_IMU, &imu);
+  i2c_bus_stats(I2C_CLIENT_OLED, &disp);
+  const uint32_t n = s_n_lat;
+  qsort(s_lat_us, n, sizeof(s_lat_us[0]), cmp_u32);
+  const uint32_t p50 = n ? s_lat_us[n / 2U] : 0U;
+  const uint32_t p99 = n ? s_lat_us[(n * 99U) / 100U] : 0U;
+  const uint32_t mx = n ? s_lat_us[n - 1U] : 0U;
+  printf("%-10s lecturas=%4u vencidas=%3u espera media=%5.0fus max=%5uus | lat p50=%5uus p99=%5uus max=%5uus | "
+         "OLED %5.1f cuadros/s trozos=%5u cedidos=%4u\n",
+         label, (unsigned)n, (unsigned)s_imu_fail, imu.xfers ? (double)imu.wait_us_sum / imu.xfers : 0.0,
+         (unsigned)imu.wait_us_max, (unsigned)p50, (unsigned)p99, (unsigned)mx, (double)s_frames / secs,
+         (unsigned)disp.xfers, (unsigned)disp.yields);
+  return p99;
+}
+
+int main(int argc, char** argv) {
+  const uint32_t secs = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 2U;
+  if (secs == 0U || secs * FALL_FS_HZ > MAX_SAMPLES || !i2c_bus_init()) return 1;
+  printf("I2C %u kHz simulado, IMU %u B a %u Hz (timeout %u ms), OLED cuadro 1024 B cada 1 ms, %us por config\n",
+         (unsigned)(I2C_BUS_HOST_HZ / 1000U), (unsigned)IMU_BURST, (unsigned)FALL_FS_HZ, (unsigned)IMU_TIMEOUT_MS,
+         (unsigned)secs);
+
+  atomic_store(&s_alive, 2U);
+  if (!os_task_create(imu_task, "imu", 4096, OS_PRIO_HIGH, OS_CORE_ANY, NULL, NULL) ||
+      !os_task_create(oled_task, "oled", 4096, OS_PRIO_LOW, OS_CORE_ANY, NULL, NULL)) {
+    return 1;
+  }
+
+  run("solo IMU", false, I2C_BUS_CHUNK_BYTES, secs);
+  static const size_t k_chunks[] = { 0U, 128U, 64U, 32U, 16U, 8U };
+  uint32_t lat_default = 0;
+  uint32_t fail_default = 0;
+  for (size_t i = 0; i < sizeof(k_chunks) / sizeof(k_chunks[0]); ++i) {
+    char label[16];
+    if (k_chunks[i] == 0U) {
+      snprintf(label, sizeof(label), "entero");
+    } else {
+      snprintf(label, sizeof(label), "trozo %3u", (unsigned)k_chunks[i]);
+    }
+    const uint32_t p99 = run(label, true, k_chunks[i], secs);
+    if (k_chunks[i] == I2C_BUS_CHUNK_BYTES) {
+      lat_default = p99;
+      fail_default = s_imu_fail;
+    }
+  }
+  atomic_store(&s_stop, true);
+  while (atomic_load(&s_alive) > 0U) os_delay_ms(5);
+
+  const bool ok = lat_default <= LAT_BOUND_US && fail_default == 0U;
+  printf("trozo por defecto %u B: latencia IMU p99 %uus (cota %uus), vencidas %u: %s\n",
+         (unsigned)I2C_BUS_CHUNK_BYTES, (unsigned)lat_default, (unsigned)LAT_BOUND_US, (unsigned)fail_default,
+         ok ? "OK" : "FALLA");
+  return ok ? 0 : 1;
+}
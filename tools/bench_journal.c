@@ -0,0 +1,244 @@
+// Bitácora del receptor (services/journal) sobre el respaldo de archivo:
+// llena la partición dos vueltas (throughput de append con reciclado de
+// sectores), mide la recuperación de una partición llena, compara
+// journal_count/journal_query contra una copia en memoria y simula cortes de
+// energía (registro a medio escribir, borrado de sector interrumpido).
+// Además del tiempo en host estima el del ESP32 con tiempos típicos de flash.
+// Sale con 1 si alguna verificación falla.
+//
+// Uso: bench_journal [archivo] [consultas]
+
+#include "firmware_node/src/services/journal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define NODES 8U
+
+// Flash SPI típica (W25Q32, 40 MHz DIO): programación de página 0.4 ms,
+// borrado de sector 45 ms, lectura ~10 MB/s + ~10 us por llamada.
+#define DEV_WRITE_US      400.0
+#define DEV_ERASE_US      45000.0
+#define DEV_READ_CALL_US  10.0
+#define DEV_READ_MBPS     10.0
+
+typedef struct {
+  uint32_t rec_no;
+  uint32_t ts;
+  uint8_t node;
+} shadow_t;
+
+static shadow_t s_shadow[3U * JOURNAL_CAPACITY];
+static uint32_t s_nshadow;
+static uint32_t s_rng = 7U;
+static int s_fail;
+
+static uint32_t rnd(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static double now_us(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static void check(bool ok, const char* what) {
+  printf("JNL check %-40s %s\n", what, ok ? "OK" : "FALLA");
+  if (!ok) s_fail = 1;
+}
+
+static double dev_us(const journal_stats_t* a, const journal_stats_t* b) {
+  return (b->flash_writes - a->flash_writes) * DEV_WRITE_US + (b->flash_erases - a->flash_erases) * DEV_ERASE_US +
+         (b->flash_reads - a->flash_reads) * DEV_READ_CALL_US +
+         (b->flash_read_bytes - a->flash_read_bytes) / DEV_READ_MBPS;
+}
+
+static bool append_n(uint32_t n) {
+  for (uint32_t i = 0; i < n; ++i) {
+    journal_rec_t r = { 0 };
+    r.node = (uint8_t)(1U + rnd() % NODES);
+    r.kind = (uint8_t)(rnd() % 3U);
+    r.seq = (uint8_t)s_nshadow;
+    r.ts = s_nshadow / 3U;   // ~3 eventos por segundo
+    r.epoch_ms = rnd();
+    r.ax_peak_centi_g = (int16_t)(300 + rnd() % 400);
+    r.idle_ms = 700U;
+    if (!journal_append(&r)) return false;
+    s_shadow[s_nshadow++] = (shadow_t){ r.rec_no, r.ts, r.node };
+  }
+  return true;
+}
+
+// Cuenta de referencia sobre los últimos `records` agregados.
+static uint32_t shadow_count(uint32_t records, uint16_t node, uint32_t since) {
+  uint32_t c = 0;
+  for (uint32_t i = s_nshadow - records; i < s_nshadow; ++i) {
+    if (s_shadow[i].ts >= since && (node == JOURNAL_ANY_NODE || s_shadow[i].node == node)) c++;
+  }
+  return c;
+}
+
+static bool verify_queries(unsigned n) {
+  journal_stats_t st;
+  journal_stats(&st);
+  for (unsigned q = 0; q < n; ++q) {
+    const uint16_t node = (q % 4U == 0U) ? JOURNAL_ANY_NODE : (uint16_t)(1U + rnd() % NODES);
+    const uint32_t since = s_shadow[s_nshadow - 1U].ts - rnd() % 1200U;
+    if (journal_count(node, since) != shadow_count(st.records, node, since)) return false;
+    journal_rec_t out[4];
+    const size_t k = journal_query(node, since, out, 4);
+    for (size_t i = 0; i < k; ++i) {
+      if (out[i].ts < since || (node != JOURNAL_ANY_NODE && out[i].node != node)) return false;
+      if (i > 0U && out[i].rec_no >= out[i - 1U].rec_no) return false;
+    }
+  }
+  return true;
+}
+
+// Sector activo del archivo (mayor secuencia) y su primer slot libre.
+static long file_head_slot(FILE* f, unsigned* head) {
+  uint32_t best = 0;
+  for (unsigned s = 0; s < JOURNAL_SECTORS; ++s) {
+    uint8_t h[8];
+    fseek(f, (long)(s * JOURNAL_SECTOR_BYTES), SEEK_SET);
+    if (fread(h, 1, sizeof(h), f) != sizeof(h)) return -1;
+    const uint32_t seq = h[4] | (h[5] << 8) | ((uint32_t)h[6] << 16) | ((uint32_t)h[7] << 24);
+    if (seq != 0xFFFFFFFFU && seq > best) {
+      best = seq;
+      *head = s;
+    }
+  }
+  for (unsigned i = 0; i < JOURNAL_RECS_PER_SECTOR; ++i) {
+    const long off = (long)(*head * JOURNAL_SECTOR_BYTES + JOURNAL_HDR_BYTES + i * JOURNAL_REC_BYTES);
+    uint8_t b[JOURNAL_REC_BYTES];
+    fseek(f, off, SEEK_SET);
+    if (fread(b, 1, sizeof(b), f) != sizeof(b)) return -1;
+    bool blank = true;
+    for (unsigned k = 0; k < sizeof(b); ++k) blank = blank && b[k] == 0xFFU;
+    if (blank) return off;
+  }
+  return -1;
+}
+
+int main(int argc, char** argv) {
+  const char* path = argc > 1 ? argv[1] : "journal_bench.bin";
+  const unsigned queries = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 20000U;
+  remove(path);
+  journal_host_path(path);
+  printf("JNL particion=%u sectores x %u B registros=%u x %u B capacidad=%u indice RAM=%u B\n",
+         (unsigned)JOURNAL_SECTORS, (unsigned)JOURNAL_SECTOR_BYTES, (unsigned)JOURNAL_RECS_PER_SECTOR,
+         (unsigned)JOURNAL_REC_BYTES, (unsigned)JOURNAL_CAPACITY, (unsigned)(JOURNAL_CAPACITY * 10U));
+  if (!journal_init()) {
+    printf("JNL no se pudo abrir %s\n", path);
+    return 1;
+  }
+
+  // 1) Append: dos vueltas y media sector (cada sector se recicla dos veces;
+  //    el activo queda a medias para el corte del paso 4).
+  journal_stats_t a, b;
+  journal_stats(&a);
+  double t0 = now_us();
+  const bool ok_fill = append_n(2U * JOURNAL_CAPACITY + JOURNAL_RECS_PER_SECTOR / 2U);
+  double t1 = now_us();
+  journal_stats(&b);
+  check(ok_fill, "append 2 vueltas");
+  const uint32_t n_app = b.appended - a.appended;
+  printf("JNL append n=%u host=%.2fus/reg (%.0f reg/s) dispositivo~%.0fus/reg (%.0f reg/s) borrados=%u "
+         "desgaste min/max=%u/%u\n",
+         (unsigned)n_app, (t1 - t0) / n_app, n_app / ((t1 - t0) / 1e6), dev_us(&a, &b) / n_app,
+         n_app / (dev_us(&a, &b) / 1e6), (unsigned)(b.flash_erases - a.flash_erases), (unsigned)b.erase_min,
+         (unsigned)b.erase_max);
+  check(b.erase_max - b.erase_min <= 1U, "desgaste parejo (max - min <= 1)");
+  check(b.records == JOURNAL_CAPACITY - JOURNAL_RECS_PER_SECTOR + (n_app % JOURNAL_RECS_PER_SECTOR == 0U
+                                                                      ? JOURNAL_RECS_PER_SECTOR : n_app % JOURNAL_RECS_PER_SECTOR),
+        "registros tras reciclar");
+
+  // 2) Recuperación de la partición llena.
+  const uint32_t records = b.records;
+  journal_deinit();
+  memset(&a, 0, sizeof(a));   // journal_init reinicia los contadores
+  t0 = now_us();
+  const bool ok_mount = journal_init();
+  t1 = now_us();
+  journal_stats(&b);
+  printf("JNL recuperar registros=%u host=%.0fus dispositivo~%.1fms lecturas=%u (%u B)\n", (unsigned)b.records,
+         t1 - t0, dev_us(&a, &b) / 1000.0, (unsigned)b.flash_reads, (unsigned)b.flash_read_bytes);
+  check(ok_mount && b.records == records && b.torn == 0U, "recupera todos los registros");
+  journal_rec_t last;
+  check(journal_query(JOURNAL_ANY_NODE, 0, &last, 1) == 1U && last.rec_no == s_shadow[s_nshadow - 1U].rec_no,
+        "ultimo rec_no tras recuperar");
+
+  // 3) Consultas contra la copia en memoria.
+  check(verify_queries(2000U), "count/query == referencia");
+  uint32_t sink = 0;
+  t0 = now_us();
+  for (unsigned q = 0; q < queries; ++q) {
+    sink += journal_count((uint16_t)(1U + q % NODES), s_shadow[s_nshadow - 1U].ts - q % 600U);
+  }
+  t1 = now_us();
+  journal_stats(&a);
+  journal_rec_t out[8];
+  const double t2 = now_us();
+  for (unsigned q = 0; q < queries; ++q) {
+    sink += (uint32_t)journal_query((uint16_t)(1U + q % NODES), s_shadow[s_nshadow - 1U].ts - 300U, out, 8);
+  }
+  const double t3 = now_us();
+  journal_stats(&b);
+  printf("JNL consulta (nodo, desde) n=%u count=%.0fns query(8 regs)=%.2fus dispositivo~%.0fus (sink=%u)\n",
+         queries, (t1 - t0) * 1000.0 / queries, (t3 - t2) / queries, dev_us(&a, &b) / queries, (unsigned)sink);
+
+  // 4) Corte durante la escritura de un registro: 10 de 24 bytes programados.
+  journal_deinit();
+  FILE* f = fopen(path, "r+b");
+  unsigned head = 0;
+  const long off = f ? file_head_slot(f, &head) : -1;
+  if (off >= 0) {
+    const uint8_t partial[10] = { 0xA5, 1, 0, 0, 0x12, 0x34, 0x56, 0x78, 0x00, 0x01 };
+    fseek(f, off, SEEK_SET);
+    fwrite(partial, 1, sizeof(partial), f);
+  }
+  if (f) fclose(f);
+  journal_init();
+  journal_stats(&b);
+  check(off >= 0 && b.torn == 1U && b.records == records, "registro cortado: se salta");
+  check(append_n(1U), "append tras el corte");
+  journal_deinit();
+  journal_init();
+  journal_stats(&b);
+  check(b.torn == 1U && b.records == records + 1U && verify_queries(500U), "el siguiente slot queda indexado");
+
+  // 5) Corte durante el borrado del sector a reciclar: media página en 0xFF
+  //    y la cabecera dañada.
+  const uint32_t before = b.records;
+  journal_deinit();
+  f = fopen(path, "r+b");
+  const unsigned victim = (head + 1U) % JOURNAL_SECTORS;
+  if (f) {
+    uint8_t ff[JOURNAL_SECTOR_BYTES / 2U];
+    memset(ff, 0xFF, sizeof(ff));
+    ff[5] = 0x00;
+    fseek(f, (long)(victim * JOURNAL_SECTOR_BYTES), SEEK_SET);
+    fwrite(ff, 1, sizeof(ff), f);
+    fclose(f);
+  }
+  journal_init();
+  journal_stats(&b);
+  check(b.bad_sectors == 1U && b.records == before - JOURNAL_RECS_PER_SECTOR, "borrado cortado: sector libre");
+  check(append_n(2U * JOURNAL_RECS_PER_SECTOR), "append recicla el sector dañado");
+  journal_stats(&b);
+  const uint32_t records_now = b.records;
+  journal_deinit();
+  journal_init();
+  journal_stats(&b);
+  check(b.bad_sectors == 0U && b.records == records_now && verify_queries(500U), "recupera tras reciclar");
+
+  journal_deinit();
+  remove(path);
+  return s_fail;
+}
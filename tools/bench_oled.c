@@ -0,0 +1,107 @@
+// UI del OLED del receptor (firmware_rx/src/rx_display + drivers/oled_ssd1306)
+// sobre el panel emulado de host: recorre un escenario de 10 minutos con 5
+// nodos (tramas periódicas, prealertas, cancelaciones, dos caídas) renderizando
+// una vez por segundo y en cada evento. Verifica después de cada flush que el
+// panel emulado sea idéntico al framebuffer (las franjas sucias alcanzan) y
+// compara los bytes de bus por actualización contra enviar el cuadro entero.
+// Estima el tiempo de bus en el ESP32 (I2C a BOARD_I2C_FREQ_HZ, 9 bits por
+// byte) y vuelca el panel en PGM en el momento de la primera caída.
+// Sale con 1 si el panel diverge o si el promedio supera 1/4 del cuadro entero.
+//
+// Uso: bench_oled [archivo.pgm] [segundos]
+
+#include "firmware_node/src/drivers/oled_ssd1306.h"
+#include "firmware_rx/src/rx_display.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define I2C_HZ      400000.0   // BOARD_I2C_FREQ_HZ (config/board_pins.h es sólo del ESP32)
+#define NODES       5U
+
+static double now_us(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static double bus_ms(double bytes) {
+  return bytes * 9.0 / I2C_HZ * 1000.0;
+}
+
+static uint32_t s_updates, s_empty, s_max, s_sum, s_mismatch;
+static double s_render_us;
+
+static void render(uint32_t t) {
+  const double t0 = now_us();
+  const size_t n = rx_display_render(t);
+  s_render_us += now_us() - t0;
+  s_updates++;
+  if (n == 0U) s_empty++;
+  s_sum += (uint32_t)n;
+  if (n > s_max) s_max = (uint32_t)n;
+  if (memcmp(oled_host_panel(), oled_framebuffer(), OLED_FB_BYTES) != 0) s_mismatch++;
+}
+
+int main(int argc, char** argv) {
+  const char* pgm = argc > 1 ? argv[1] : "rx_oled.pgm";
+  const uint32_t secs = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 600U;
+  if (!rx_display_init()) {
+    printf("OLED init fallo\n");
+    return 1;
+  }
+  oled_stats_t init;
+  oled_stats(&init);
+  printf("OLED %ux%u framebuffer=%u B cuadro entero=%u B de bus (%.1f ms a %.0f kHz) primer cuadro=%u B\n",
+         (unsigned)OLED_WIDTH, (unsigned)OLED_HEIGHT, (unsigned)OLED_FB_BYTES, (unsigned)OLED_FULL_FRAME_BUS_BYTES,
+         bus_ms(OLED_FULL_FRAME_BUS_BYTES), I2C_HZ / 1000.0, (unsigned)init.bus_bytes);
+
+  bool snap = false;
+  uint32_t events = 0;
+  for (uint32_t t = 0; t < secs; ++t) {
+    for (uint8_t k = 0; k < NODES; ++k) {
+      const uint8_t node = (uint8_t)(k + 1U);
+      // Latido de cada nodo cada 15..35 s (una trama de evento cualquiera).
+      fall_event_t e = { t * 1000U, 120, 0U, FALL_EVT_CANCEL, 0U };
+      bool fire = (t + 7U * k) % (15U + 5U * k) == 0U;
+      if (node == 2U && (t == 100U || t == 400U)) {
+        e.kind = FALL_EVT_PREALERT;
+        fire = true;
+      }
+      if (node == 2U && t == 102U) {
+        e.kind = FALL_EVT_CONFIRMED;   // caída confirmada
+        fire = true;
+      }
+      if (node == 2U && t == 401U) fire = true;   // cancelación
+      if (node == 4U && t == 250U) {
+        e.kind = FALL_EVT_CONFIRMED;
+        fire = true;
+      }
+      if (!fire) continue;
+      const int16_t rssi = (int16_t)(-62 - 9 * (int16_t)k - (int16_t)((t / 30U + k) % 5U));
+      rx_display_event(&e, node, rssi, (int8_t)(k < 3U ? 8 : -4 - (int8_t)k), t);
+      events++;
+      render(t);
+    }
+    render(t);
+    if (!snap && t == 110U) snap = oled_host_pgm(pgm, 4);
+  }
+
+  oled_stats_t st;
+  oled_stats(&st);
+  const double avg = s_updates ? (double)s_sum / s_updates : 0.0;
+  printf("OLED escenario=%us eventos=%u actualizaciones=%u sin cambios=%u franjas=%u\n", (unsigned)secs,
+         (unsigned)events, (unsigned)s_updates, (unsigned)s_empty, (unsigned)(st.pages - init.pages));
+  printf("OLED bus por actualizacion: media=%.1f B max=%u B (cuadro entero %u B: x%.1f menos) ~%.2f ms media en el "
+         "ESP32\n",
+         avg, (unsigned)s_max, (unsigned)OLED_FULL_FRAME_BUS_BYTES, avg > 0.0 ? OLED_FULL_FRAME_BUS_BYTES / avg : 0.0,
+         bus_ms(avg));
+  printf("OLED bus total=%u B (%.1f B/s) vs cuadro entero por actualizacion=%u B; render host=%.2fus\n",
+         (unsigned)s_sum, (double)s_sum / secs, (unsigned)(s_updates * OLED_FULL_FRAME_BUS_BYTES),
+         s_updates ? s_render_us / s_updates : 0.0);
+  printf("OLED panel==framebuffer tras cada flush: %s; PGM %s: %s\n", s_mismatch ? "FALLA" : "OK", pgm,
+         snap ? "escrito" : "no escrito");
+  return (s_mismatch == 0U && avg * 4.0 <= OLED_FULL_FRAME_BUS_BYTES) ? 0 : 1;
+}
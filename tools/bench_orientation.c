@@ -0,0 +1,211 @@
+// Costo y comportamiento del filtro de orientación Q15/Q30 (services/orientation)
+// y del chequeo de postura de fall_detector_feed_imu().
+//
+// Por frecuencia de muestreo (100 y 1000 Hz):
+//   - ciclos por muestra de orientation_update() y de fall_detector_feed()
+//     contra fall_detector_feed_imu() (el costo extra por muestra);
+//   - CPU por segundo (ciclos · fs) y tiempo de bus I2C: ráfaga de 14 bytes
+//     contra 6 (a 400 kHz);
+//   - error angular tras girar 90° lento (accel dentro de la ventana) y
+//     rápido (sólo giroscopio);
+//   - caída (giro de 90° + impacto + inmovilidad) contra sentarse de golpe
+//     (mismo pico e inmovilidad, sin giro): la primera debe confirmarse y la
+//     segunda descartarse.
+// Sale con 1 si alguna clasificación falla o el error supera 5°.
+//
+// Uso: bench_orientation [muestras_cronometradas]
+
+#include "config/fall_params.h"
+#include "firmware_node/src/drivers/imu_accel.h"
+#include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/orientation.h"
+#include "firmware_node/src/services/prof.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_I2C_HZ   400000U   // BOARD_I2C_FREQ_HZ
+#define MAX_ERR_DEG    5.0
+
+static const double kPi = 3.14159265358979323846;
+
+// Transacción write(reg) + read(n): START, addr+W, reg, RSTART, addr+R, n
+// bytes; 9 bits por byte + ~2 bits de START/STOP.
+static double i2c_us(unsigned n) {
+  return (double)((3U + n) * 9U + 2U) * 1e6 / BENCH_I2C_HZ;
+}
+
+static double cycles_per_ns(void) {
+  struct timespec a, b;
+  clock_gettime(CLOCK_MONOTONIC, &a);
+  const uint32_t c0 = prof_cycles();
+  do {
+    clock_gettime(CLOCK_MONOTONIC, &b);
+  } while ((b.tv_sec - a.tv_sec) * 1000000000L + (b.tv_nsec - a.tv_nsec) < 20000000L);
+  const uint32_t c1 = prof_cycles();
+  const double ns = (double)(b.tv_sec - a.tv_sec) * 1e9 + (double)(b.tv_nsec - a.tv_nsec);
+  return (double)(uint32_t)(c1 - c0) / ns;
+}
+
+// Muestra física: gravedad girada theta alrededor de x, velocidad omega (°/s).
+static void physical(double theta_deg, double omega_dps, accel_raw_t* a, imu_gyro_t* g) {
+  const double t = theta_deg * kPi / 180.0;
+  a->ax = 0;
+  a->ay = (int16_t)lround(100.0 * sin(t));
+  a->az = (int16_t)lround(100.0 * cos(t));
+  g->gx = (int16_t)lround(omega_dps * IMU_GYRO_LSB_PER_DPS_X10 / 10.0);
+  g->gy = 0;
+  g->gz = 0;
+  g->temp_centi_c = 2500;
+}
+
+static double angle_deg(const orient_vec_t* v, double theta_deg) {
+  const double t = theta_deg * kPi / 180.0;
+  const double n = sqrt((double)v->x * v->x + (double)v->y * v->y + (double)v->z * v->z);
+  const double c = ((double)v->y * sin(t) + (double)v->z * cos(t)) / n;
+  return acos(c > 1.0 ? 1.0 : (c < -1.0 ? -1.0 : c)) * 180.0 / kPi;
+}
+
+static orient_cfg_t cfg_for(uint16_t fs) {
+  orient_cfg_t c = { fs, ORIENT_ALPHA_Q15, ORIENT_GATE_LO_CENTI_G, ORIENT_GATE_HI_CENTI_G,
+                     IMU_GYRO_LSB_PER_DPS_X10 };
+  // alpha escala con fs: misma constante de tiempo (~0.5 s) que a 100 Hz.
+  c.alpha_q15 = (uint16_t)(32768U - (32768U - ORIENT_ALPHA_Q15) * 100U / fs);
+  return c;
+}
+
+// Gira 90° en rot_s segundos y mide el error al final (quieto 0.2 s).
+static double rotation_error(uint16_t fs, double rot_s, bool in_gate) {
+  const orient_cfg_t c = cfg_for(fs);
+  orientation_init(&c);
+  accel_raw_t a;
+  imu_gyro_t g;
+  physical(0.0, 0.0, &a, &g);
+  for (unsigned i = 0; i < fs; ++i) orientation_update(&a, &g);
+  const unsigned n = (unsigned)(rot_s * fs);
+  const double omega = 90.0 / rot_s;
+  for (unsigned i = 1; i <= n; ++i) {
+    physical(90.0 * i / n, omega, &a, &g);
+    if (!in_gate) a.ay = a.az = 10;   // caída libre: el accel no aporta vertical
+    orientation_update(&a, &g);
+  }
+  physical(90.0, 0.0, &a, &g);
+  if (!in_gate) a.ay = a.az = 10;
+  for (unsigned i = 0; i < fs / 5U; ++i) orientation_update(&a, &g);
+  orient_vec_t v;
+  orientation_get(&v);
+  return angle_deg(&v, 90.0);
+}
+
+// Reposo 2 s, giro de rot_deg en 0.4 s con caída libre, impacto 4 g de 50 ms,
+// inmovilidad 1.5 s (convención del detector: |a| < FALL_I_THR_CENTI_G).
+static bool run_event(uint16_t fs, double rot_deg, fall_posture_stats_t* st) {
+  const orient_cfg_t c = cfg_for(fs);
+  const fall_cfg_t fc = { FALL_A_THR_CENTI_G, FALL_I_THR_CENTI_G, FALL_IDLE_MS, fs, false };
+  orientation_init(&c);
+  fall_detector_init(&fc);
+  bool fell = false;
+  fall_event_t e;
+  accel_raw_t a;
+  imu_gyro_t g;
+  physical(0.0, 0.0, &a, &g);
+  for (unsigned i = 0; i < 2U * fs; ++i) fell |= fall_detector_feed_imu(&a, &g, &e);
+  const unsigned nrot = fs * 4U / 10U;
+  for (unsigned i = 1; i <= nrot; ++i) {
+    physical(rot_deg * i / nrot, rot_deg / 0.4, &a, &g);
+    a.ax = 0;
+    a.ay = a.az = 15;
+    fell |= fall_detector_feed_imu(&a, &g, &e);
+  }
+  for (unsigned i = 0; i < fs / 20U; ++i) {
+    physical(rot_deg, 0.0, &a, &g);
+    a.az = 400;
+    fell |= fall_detector_feed_imu(&a, &g, &e);
+  }
+  for (unsigned i = 0; i < fs * 3U / 2U; ++i) {
+    physical(rot_deg, 0.0, &a, &g);
+    a.ay = 5;
+    a.az = 10;
+    fell |= fall_detector_feed_imu(&a, &g, &e);
+  }
+  fall_detector_posture_stats(st);
+  return fell;
+}
+
+#define BATCH 4096U
+
+static accel_raw_t s_acc[BATCH];
+static imu_gyro_t s_gyr[BATCH];
+
+// Giro lento continuo; in_gate=false: |a| fuera de la ventana (sólo giroscopio).
+static void fill_batch(bool in_gate) {
+  for (unsigned i = 0; i < BATCH; ++i) {
+    physical((double)i / 10.0, 10.0, &s_acc[i], &s_gyr[i]);
+    if (!in_gate) s_acc[i].az = (int16_t)(s_acc[i].az / 4);
+  }
+}
+
+typedef enum { RUN_ORIENT, RUN_FEED, RUN_FEED_IMU } run_kind_t;
+
+// Ciclos medios por muestra de un lote (evita el costo de leer el contador
+// en cada llamada).
+static double time_batch(run_kind_t kind, unsigned rounds) {
+  fall_event_t e;
+  const uint32_t t0 = prof_cycles();
+  for (unsigned r = 0; r < rounds; ++r) {
+    for (unsigned i = 0; i < BATCH; ++i) {
+      switch (kind) {
+        case RUN_ORIENT: orientation_update(&s_acc[i], &s_gyr[i]); break;
+        case RUN_FEED: (void)fall_detector_feed(&s_acc[i], &e); break;
+        case RUN_FEED_IMU: (void)fall_detector_feed_imu(&s_acc[i], &s_gyr[i], &e); break;
+      }
+    }
+  }
+  return (double)(uint32_t)(prof_cycles() - t0) / ((double)rounds * BATCH);
+}
+
+int main(int argc, char** argv) {
+  const unsigned iters = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 200000U;
+  const double cpn = cycles_per_ns();
+  static const uint16_t rates[] = { 100U, 1000U };
+  int fails = 0;
+
+  printf("ORI i2c 6 B=%.0fus 14 B=%.0fus (+%.0fus/muestra a %u kHz)\n", i2c_us(6U), i2c_us(14U),
+         i2c_us(14U) - i2c_us(6U), BENCH_I2C_HZ / 1000U);
+  for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); ++r) {
+    const uint16_t fs = rates[r];
+    const orient_cfg_t c = cfg_for(fs);
+    const fall_cfg_t fc = { FALL_A_THR_CENTI_G, FALL_I_THR_CENTI_G, FALL_IDLE_MS, fs, false };
+    const unsigned rounds = iters / BATCH ? iters / BATCH : 1U;
+
+    orientation_init(&c);
+    fall_detector_init(&fc);
+    fill_batch(false);
+    const double upd_out = time_batch(RUN_ORIENT, rounds);
+    fill_batch(true);
+    const double upd_in = time_batch(RUN_ORIENT, rounds);
+    const double base = time_batch(RUN_FEED, rounds);
+    const double full = time_batch(RUN_FEED_IMU, rounds);
+    const double extra = full - base;
+    printf("ORI fs=%u orientation_update=%.0f ciclos (accel en ventana) / %.0f (sólo gyro) | "
+           "feed=%.0f feed_imu=%.0f: +%.0f ciclos, +%.0f ns/muestra | +%.3f Mciclos/s, %.3f%% de un núcleo host\n",
+           (unsigned)fs, upd_in, upd_out, base, full, extra, extra / cpn, extra * fs / 1e6,
+           extra * fs / (cpn * 1e7));
+    printf("ORI fs=%u bus I2C ocupado %.1f%% (6 B) → %.1f%% (14 B)\n", (unsigned)fs,
+           i2c_us(6U) * fs / 1e4, i2c_us(14U) * fs / 1e4);
+
+    const double err_slow = rotation_error(fs, 2.0, true);
+    const double err_fast = rotation_error(fs, 0.4, false);
+    fall_posture_stats_t st_fall, st_sit;
+    const bool fall_ok = run_event(fs, 90.0, &st_fall);
+    const bool sit_ok = !run_event(fs, 5.0, &st_sit);
+    printf("ORI fs=%u error 90° lento=%.2f° rápido(sólo gyro)=%.2f° | caída=%s (cos=%d) "
+           "sentarse=%s (cos=%d)\n",
+           (unsigned)fs, err_slow, err_fast, fall_ok ? "confirmada" : "PERDIDA",
+           (int)st_fall.last_cos_q15, sit_ok ? "descartada" : "ALERTA", (int)st_sit.last_cos_q15);
+    if (!fall_ok || !sit_ok || err_slow > MAX_ERR_DEG || err_fast > MAX_ERR_DEG) fails++;
+  }
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+// Compara particiones de núcleos del nodo: jitter del muestreo a 100 Hz y
+// latencia confirmación → inicio de TX. Cada partición corre en un proceso
+// hijo (os_run_for_ms detiene el planificador para siempre).
+// La carga de radio se emula con LORA_STUB_TX_BUSY_US (CPU ocupada por trama).
+//
+// Uso: bench_partition [duracion_ms]
+
+#include "firmware_node/src/app/app.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/lat_probe.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef LORA_STUB_TX_BUSY_US
+#define LORA_STUB_TX_BUSY_US 0U   // sólo informativo; se pasa con -D al compilar
+#endif
+
+typedef struct {
+  const char* name;
+  app_cores_t cores;
+} partition_t;
+
+static const partition_t k_partitions[] = {
+  { "todo-en-1", { 1, 1, 1 } },
+  { "sense1-radio0", { 1, 0, 0 } },
+  { "sense0-radio1", { 0, 1, 1 } },
+  { "sin-afinidad", { OS_CORE_ANY, OS_CORE_ANY, OS_CORE_ANY } },
+};
+
+static void run_child(const partition_t* p, uint32_t run_ms) {
+  app_set_cores(&p->cores);
+  app_init();
+  os_run_for_ms(run_ms);
+
+  lat_hist_t jitter;
+  app_get_sample_jitter(&jitter);
+  lat_summary_t tx;
+  lat_probe_summary(LAT_M_CONFIRM_TX_START, &tx);
+  printf("%-14s %7u %8u %8u %8u | %5u %8u %8u %8u\n", p->name,
+         (unsigned)jitter.count, (unsigned)lat_hist_percentile(&jitter, 50U),
+         (unsigned)lat_hist_percentile(&jitter, 99U), (unsigned)jitter.max_us,
+         (unsigned)tx.count, (unsigned)tx.p50_us, (unsigned)tx.p99_us, (unsigned)tx.max_us);
+  fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  const uint32_t run_ms = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 5000U;
+  printf("CPUs en línea: %ld, LORA_STUB_TX_BUSY_US=%u\n", sysconf(_SC_NPROCESSORS_ONLN),
+         (unsigned)LORA_STUB_TX_BUSY_US);
+  printf("%-14s %7s %8s %8s %8s | %5s %8s %8s %8s\n", "particion", "mues.", "jit p50", "jit p99",
+         "jit max", "alert", "tx p50", "tx p99", "tx max");
+  fflush(stdout);
+  for (size_t i = 0; i < sizeof(k_partitions) / sizeof(k_partitions[0]); ++i) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      run_child(&k_partitions[i], run_ms);
+      _exit(0);
+    }
+    if (pid < 0) {
+      perror("fork");
+      return 1;
+    }
+    waitpid(pid, NULL, 0);
+  }
+  return 0;
+}
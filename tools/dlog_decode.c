@@ -0,0 +1,39 @@
+// Formatea en la PC las líneas "DLG <id> <ms> <a0> <a1> <a2> <a3>" que emite
+// tsk_dlog compilado con DLOG_RAW=1 (la tabla de formatos sale de dlog.h).
+// Las demás líneas pasan sin cambios.
+//
+// Uso: dlog_decode [log.txt]     (sin argumento lee stdin)
+
+#include "firmware_node/src/services/dlog.h"
+
+#include <stdio.h>
+
+#define DLOG_MSG_(id, lvl, tag, fmt) { lvl, tag, fmt },
+static const dlog_msg_t k_msgs[DLOG_MSG_COUNT] = {
+  DLOG_MESSAGES(DLOG_MSG_)
+};
+#undef DLOG_MSG_
+
+int main(int argc, char** argv) {
+  FILE* in = stdin;
+  if (argc > 1 && !(in = fopen(argv[1], "r"))) {
+    perror(argv[1]);
+    return 1;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), in)) {
+    unsigned id, ms;
+    int a[4];
+    if (sscanf(line, "DLG %u %u %d %d %d %d", &id, &ms, &a[0], &a[1], &a[2], &a[3]) == 6 &&
+        id < DLOG_MSG_COUNT) {
+      const dlog_msg_t* m = &k_msgs[id];
+      printf("%c (%u) %s: ", m->level, ms, m->tag);
+      printf(m->fmt, a[0], a[1], a[2], a[3]);
+      printf("\n");
+    } else {
+      fputs(line, stdout);
+    }
+  }
+  if (in != stdin) fclose(in);
+  return 0;
+}
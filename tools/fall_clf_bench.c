@@ -0,0 +1,286 @@
+// Arnés del clasificador de segunda etapa (services/fall_clf).
+//
+// Genera eventos sintéticos etiquetados con la convención de señal del
+// detector (reposo ≈ 1 g en z, inmovilidad posterior < 0.2 g): caídas
+// (hacia adelante, desmayo, hacia atrás) y actividades que también pasan las
+// reglas de umbral (dispositivo que se cae sobre la mesa, tirarse en la cama,
+// sentarse de golpe). Cada evento corre por fall_detector sólo con umbrales y
+// con la segunda etapa; reporta matriz de confusión, exactitud y ciclos por
+// inferencia.
+//
+// Uso: fall_clf_bench [--seed N] [--events N] [--dump train.csv]
+//   --dump escribe "f0,..,f7,etiqueta" de los eventos que confirman las
+//   reglas (entrada de tools/train_fall_clf.py) y no evalúa.
+// Sale con 1 si la segunda etapa pierde caídas que las reglas detectan
+// (recall −2 pp) o no reduce las falsas alarmas.
+
+#include "config/fall_params.h"
+#include "firmware_node/src/services/fall_clf.h"
+#include "firmware_node/src/services/fall_clf_model.h"
+#include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/prof.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_EVENT_SAMPLES 1024U
+#define TIMING_REPEATS    200U
+
+typedef enum {
+  EV_FALL_FORWARD = 0,
+  EV_FALL_SLUMP,
+  EV_FALL_BACKWARD,
+  EV_ADL_DROP,
+  EV_ADL_FLOP_BED,
+  EV_ADL_SIT_HARD,
+  EV_COUNT
+} ev_kind_t;
+
+static const char* const k_ev_names[EV_COUNT] = {
+  "caida_adelante", "caida_desmayo", "caida_atras", "disp_cae_mesa", "tirarse_cama", "sentarse_golpe",
+};
+
+static accel_raw_t s_buf[MAX_EVENT_SAMPLES];
+static size_t s_n;
+static uint32_t s_rng;
+
+static uint32_t rnd(void) {
+  s_rng = s_rng * 1103515245U + 12345U;
+  return s_rng >> 8;
+}
+
+static int urand(int lo, int hi) {
+  return lo + (int)(rnd() % (uint32_t)(hi - lo + 1));
+}
+
+static void push(int ax, int ay, int az) {
+  if (s_n >= MAX_EVENT_SAMPLES) return;
+  const int lim = 400;   // ±4 g del MPU9250
+  ax = ax > lim ? lim : (ax < -lim ? -lim : ax);
+  ay = ay > lim ? lim : (ay < -lim ? -lim : ay);
+  az = az > lim ? lim : (az < -lim ? -lim : az);
+  s_buf[s_n++] = (accel_raw_t){ (int16_t)ax, (int16_t)ay, (int16_t)az };
+}
+
+static int noise(int amp) {
+  return urand(-amp, amp);
+}
+
+static void pre_activity(void) {
+  const bool walk = (rnd() & 1U) != 0U;
+  const int amp = urand(15, 35);
+  for (unsigned i = 0; i < 150U; ++i) {
+    const int w = walk ? (int)((i % 28U) < 14U ? (int)(i % 14U) - 7 : 7 - (int)(i % 14U)) * amp / 7 : 0;
+    push(w / 3 + noise(3), noise(3), 100 + w + noise(3));
+  }
+}
+
+static void ramp_to(int from, int to, unsigned n) {
+  for (unsigned i = 1; i <= n; ++i) push(noise(4), noise(4), from + (to - from) * (int)i / (int)n + noise(3));
+}
+
+static void hold(int level, unsigned n, int amp) {
+  for (unsigned i = 0; i < n; ++i) push(noise(amp), noise(amp), level + noise(amp));
+}
+
+// Impacto triangular de `width` muestras; parte del pico en x.
+static void impact(int peak, unsigned width) {
+  const int side = urand(0, 30);
+  for (unsigned i = 0; i < width; ++i) {
+    const int half = (int)width / 2;
+    const int d = (int)i - half;
+    const int v = peak - (half ? peak * 6 / 10 * abs(d) / half : 0);
+    push(v * side / 100 + noise(8), noise(8), v + noise(6));
+  }
+}
+
+static void idle(unsigned n) {
+  const int level = urand(4, 12);
+  for (unsigned i = 0; i < n; ++i) push(noise(3), noise(3), level + noise(3));
+}
+
+static int gen_event(ev_kind_t k) {
+  s_n = 0;
+  pre_activity();
+  switch (k) {
+    case EV_FALL_FORWARD: {
+      const int ff = urand(15, 50);
+      ramp_to(100, ff, 10U);
+      hold(ff, (unsigned)urand(20, 40), 4);
+      impact(urand(280, 400), (unsigned)urand(3, 6));
+      hold(urand(120, 180), (unsigned)urand(1, 3), 8);
+      break;
+    }
+    case EV_FALL_SLUMP: {
+      const int ff = urand(40, 70);
+      ramp_to(100, ff, 30U);
+      hold(ff, (unsigned)urand(10, 20), 4);
+      impact(urand(230, 320), (unsigned)urand(3, 5));
+      break;
+    }
+    case EV_FALL_BACKWARD: {
+      const int ff = urand(5, 35);
+      ramp_to(100, ff, 8U);
+      hold(ff, (unsigned)urand(25, 45), 3);
+      impact(urand(360, 450), (unsigned)urand(2, 4));
+      break;
+    }
+    case EV_ADL_DROP:
+      ramp_to(100, 3, 3U);
+      hold(urand(0, 6), (unsigned)urand(30, 50), 2);
+      impact(450, (unsigned)urand(1, 2));
+      idle((unsigned)urand(3, 6));
+      impact(urand(200, 350), 1U);
+      idle(5U);
+      impact(urand(120, 220), 1U);
+      break;
+    case EV_ADL_FLOP_BED: {
+      const int ff = urand(65, 85);
+      ramp_to(100, ff, 30U);
+      impact(urand(225, 290), (unsigned)urand(10, 20));
+      break;
+    }
+    case EV_ADL_SIT_HARD: {
+      const int ff = urand(55, 80);
+      ramp_to(100, ff, 25U);
+      impact(urand(230, 330), (unsigned)urand(4, 8));
+      break;
+    }
+    default:
+      break;
+  }
+  idle(150U);
+  return k <= EV_FALL_BACKWARD ? 1 : 0;
+}
+
+typedef struct {
+  bool confirmed;
+  int32_t feat[FALL_CLF_N_IN];
+} run_out_t;
+
+static bool run_detector(bool use_clf, run_out_t* out) {
+  fall_cfg_t cfg = { FALL_A_THR_CENTI_G, FALL_I_THR_CENTI_G, FALL_IDLE_MS, FALL_FS_HZ, use_clf };
+  fall_detector_init(&cfg);
+  for (size_t i = 0; i < s_n; ++i) {
+    fall_event_t e;
+    if (fall_detector_feed(&s_buf[i], &e)) {
+      if (out) {
+        feat_values_t now, at_peak;
+        fall_detector_features(&now, &at_peak);
+        fall_clf_features(&at_peak, &now, e.ax_peak_centi_g, out->feat);
+        out->confirmed = true;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+typedef struct {
+  unsigned tp, fp, tn, fn;
+} confusion_t;
+
+static void tally(confusion_t* c, int label, bool alarm) {
+  if (label && alarm) c->tp++;
+  else if (label) c->fn++;
+  else if (alarm) c->fp++;
+  else c->tn++;
+}
+
+static void print_confusion(const char* name, const confusion_t* c) {
+  const unsigned total = c->tp + c->fp + c->tn + c->fn;
+  printf("CLF %-16s TP=%4u FN=%4u FP=%4u TN=%4u exactitud=%.1f%% recall=%.1f%% falsas_alarmas=%.1f%%\n", name,
+         c->tp, c->fn, c->fp, c->tn, 100.0 * (c->tp + c->tn) / total, 100.0 * c->tp / (c->tp + c->fn),
+         100.0 * c->fp / (c->fp + c->tn));
+}
+
+int main(int argc, char** argv) {
+  uint32_t seed = 2U;
+  unsigned events = 1200U;
+  const char* dump = NULL;
+  for (int a = 1; a < argc; ++a) {
+    if (strcmp(argv[a], "--seed") == 0 && a + 1 < argc) seed = (uint32_t)strtoul(argv[++a], NULL, 10);
+    else if (strcmp(argv[a], "--events") == 0 && a + 1 < argc) events = (unsigned)strtoul(argv[++a], NULL, 10);
+    else if (strcmp(argv[a], "--dump") == 0 && a + 1 < argc) dump = argv[++a];
+  }
+  s_rng = seed;
+
+  FILE* f = NULL;
+  if (dump) {
+    f = fopen(dump, "w");
+    if (!f) {
+      perror(dump);
+      return 1;
+    }
+  }
+
+  static int32_t feats[4096][FALL_CLF_N_IN];
+  size_t n_feats = 0;
+  confusion_t rules = { 0 }, clf = { 0 };
+  unsigned per_kind[EV_COUNT][2] = { { 0 } };   // [alarmas reglas, alarmas clf]
+  unsigned per_kind_n[EV_COUNT] = { 0 };
+
+  for (unsigned k = 0; k < events; ++k) {
+    const ev_kind_t kind = (ev_kind_t)(k % EV_COUNT);
+    const int label = gen_event(kind);
+    run_out_t r = { 0 };
+    const bool alarm_rules = run_detector(false, &r);
+    if (f) {
+      if (r.confirmed) {
+        for (unsigned i = 0; i < FALL_CLF_N_IN; ++i) fprintf(f, "%d,", (int)r.feat[i]);
+        fprintf(f, "%d\n", label);
+      }
+      continue;
+    }
+    const bool alarm_clf = run_detector(true, NULL);
+    tally(&rules, label, alarm_rules);
+    tally(&clf, label, alarm_clf);
+    per_kind_n[kind]++;
+    per_kind[kind][0] += alarm_rules;
+    per_kind[kind][1] += alarm_clf;
+    if (r.confirmed && n_feats < sizeof(feats) / sizeof(feats[0])) memcpy(feats[n_feats++], r.feat, sizeof(r.feat));
+  }
+  if (f) {
+    fclose(f);
+    fprintf(stderr, "CLF %u eventos (semilla %u) → %s\n", events, (unsigned)seed, dump);
+    return 0;
+  }
+
+  printf("CLF eventos=%u semilla=%u\n", events, (unsigned)seed);
+  for (unsigned k = 0; k < EV_COUNT; ++k) {
+    printf("CLF %-16s n=%4u alarmas reglas=%4u reglas+clf=%4u\n", k_ev_names[k], per_kind_n[k], per_kind[k][0],
+           per_kind[k][1]);
+  }
+  print_confusion("reglas", &rules);
+  print_confusion("reglas+clf", &clf);
+
+  // Ciclos por inferencia sobre los vectores reales (incluye cuantización).
+  // Por vector se toma el mínimo de las repeticiones (descarta interrupciones
+  // del host); "media" y "max" son sobre vectores.
+  uint64_t total = 0;
+  uint32_t worst = 0;
+  volatile int32_t sink = 0;
+  for (size_t i = 0; i < n_feats; ++i) {
+    uint32_t best = UINT32_MAX;
+    for (unsigned r = 0; r < TIMING_REPEATS; ++r) {
+      const uint32_t t0 = prof_cycles();
+      sink += fall_clf_score(feats[i]);
+      const uint32_t dt = prof_cycles() - t0;
+      if (dt < best) best = dt;
+    }
+    total += best;
+    if (best > worst) worst = best;
+  }
+  fall_clf_stats_t st;
+  fall_clf_stats(&st);
+  printf("CLF inferencia: %u MACs, media=%.0f ciclos, max=%u ciclos (host, incluye rdtsc); "
+         "accept max=%u ciclos; tablas=%u B\n",
+         (unsigned)FALL_CLF_MACS, n_feats ? (double)total / (double)n_feats : 0.0,
+         (unsigned)worst, (unsigned)st.cycles_max, (unsigned)FALL_CLF_TABLE_BYTES);
+  (void)sink;
+
+  const double recall_rules = (double)rules.tp / (rules.tp + rules.fn);
+  const double recall_clf = (double)clf.tp / (clf.tp + clf.fn);
+  return (recall_clf + 0.02 >= recall_rules && clf.fp < rules.fp) ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+// Nodo + receptor concurrentes en un solo proceso (os_port sobre pthreads),
+// unidos por el stub de radio. Reporta latencia real de la cola de alertas y
+// despertares por tarea (/s) para verificar que nada sondea en reposo.
+// Vuelca los histogramas de lat_probe, el reporte de memoria (estáticos,
+// heap de os_port, high-water mark de cada stack pintado) y el modelo de
+// energía del nodo (residencia por estado, mAh, autonomía); sale con 1 si se pierden alertas o si
+// el p99 confirmación → inicio de TX excede el presupuesto. Con prealertas
+// compara el primer aviso (pico → prealerta recibida) contra la confirmación.
+// Deja el panel del OLED del receptor en rx_oled.pgm y el flujo binario de
+// tramas en rx_stream.cap (directorio actual; ver tools/rx_capture.c).
+//
+// Uso: host_pipeline [duracion_ms] [trace|corte]
+//   "trace": vuelca también el ring de trace_ring (ver tools/trace2json.c).
+//   "corte": el enlace cae entre 1/5 y 1/2 de la corrida; las alertas
+//   confirmadas que no salen quedan en alert_store y se reenvían en lotes al
+//   volver. Sale con 0 si todas llegan (almacén vacío, reenviadas ==
+//   guardadas == recibidas en lotes) y ninguna se descarta.
+
+#include "firmware_node/src/app/app.h"
+#include "firmware_node/src/drivers/lora_radio.h"
+#include "firmware_node/src/drivers/oled_ssd1306.h"
+#include "firmware_node/src/port/os_port.h"
+#include "firmware_node/src/services/alert_queue.h"
+#include "firmware_node/src/services/alert_store.h"
+#include "firmware_node/src/services/energy.h"
+#include "firmware_node/src/services/fall_clf.h"
+#include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/journal.h"
+#include "firmware_node/src/services/lat_probe.h"
+#include "firmware_node/src/services/mem_report.h"
+#include "firmware_node/src/services/prof.h"
+#include "firmware_node/src/services/trace_ring.h"
+#include "firmware_rx/src/app_rx.h"
+#include "firmware_rx/src/rx_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t s_run_ms;
+
+static void tsk_link_cut(void* arg) {
+  (void)arg;
+  os_delay_ms(s_run_ms / 5U);
+  lora_stub_set_link(false);
+  os_delay_ms(s_run_ms / 2U - s_run_ms / 5U);
+  lora_stub_set_link(true);
+}
+
+int main(int argc, char** argv) {
+  const uint32_t run_ms = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 5000U;
+  const bool cut = argc > 2 && strcmp(argv[2], "corte") == 0;
+  s_run_ms = run_ms;
+  remove(ALERT_STORE_HOST_PATH);   // sin desborde de una corrida anterior
+
+  // El receptor primero: su tarea ya escucha cuando el nodo transmite.
+  app_rx_init();
+  app_init();
+  if (cut) os_task_create(tsk_link_cut, "link_cut", 2048U, OS_PRIO_LOW, OS_CORE_ANY, NULL, NULL);
+  os_run_for_ms(run_ms);
+
+  alert_queue_stats_t q;
+  alert_queue_stats(&q);
+  app_rx_stats_t rx;
+  app_rx_get_stats(&rx);
+
+  // Nivel crítico: confirmaciones; nivel normal: prealertas y cancelaciones.
+  const uint32_t n = q.popped[ALERT_PRIO_CRITICAL] + q.popped[ALERT_PRIO_NORMAL];
+  const uint32_t rx_frames = rx.alerts + rx.prealerts + rx.cancels;
+  printf("[PIPE] duracion=%ums tx_tramas=%u rx_tramas=%u rx_alertas=%u rx_invalidas=%u caja_negra=%u/%u frags\n",
+         (unsigned)run_ms, (unsigned)n, (unsigned)rx_frames, (unsigned)rx.alerts, (unsigned)rx.frames_bad,
+         (unsigned)rx.bbox_done, (unsigned)rx.bbox_frags);
+  lat_summary_t first, confirm;
+  lat_probe_summary(LAT_M_PEAK_PRE_RX, &first);
+  lat_probe_summary(LAT_M_PEAK_RX, &confirm);
+  printf("[PIPE] prealertas=%u canceladas=%u escaladas=%u vencidas=%u primer aviso p50=%uus (confirmada p50=%uus)\n",
+         (unsigned)rx.prealerts, (unsigned)rx.cancels, (unsigned)rx.escalated, (unsigned)rx.pre_expired,
+         (unsigned)first.p50_us, (unsigned)confirm.p50_us);
+  relay_stats_t rs;
+  app_rx_relay_stats(&rs);
+  printf("[PIPE] sobres oidos=%u nuevos=%u duplicados=%u retransmitidos=%u\n", (unsigned)rs.heard,
+         (unsigned)rs.delivered, (unsigned)rs.duplicates, (unsigned)rs.relayed);
+  alert_store_stats_t ss;
+  alert_store_stats(&ss);
+  printf("[PIPE] almacen guardadas=%u reenviadas=%u rx_en_lotes=%u a_nvs=%u descartadas=%u pendientes=%u\n",
+         (unsigned)ss.stored, (unsigned)ss.flushed, (unsigned)rx.batched, (unsigned)ss.spilled,
+         (unsigned)ss.dropped, (unsigned)(ss.rtc_len + ss.nvs_len));
+  journal_stats_t js;
+  journal_stats(&js);
+  printf("[PIPE] bitacora guardados=%u fallos=%u registros=%u (persisten en %s)\n", (unsigned)rx.journaled,
+         (unsigned)rx.journal_fail, (unsigned)js.records, JOURNAL_HOST_PATH);
+  const uint32_t n_crit = q.popped[ALERT_PRIO_CRITICAL];
+  printf("[PIPE] cola alertas: descartes=%u+%u espera media=%lluus max=%uus (confirmaciones)\n",
+         (unsigned)q.dropped[ALERT_PRIO_CRITICAL], (unsigned)q.dropped[ALERT_PRIO_NORMAL],
+         (unsigned long long)(n_crit ? q.wait_us_sum[ALERT_PRIO_CRITICAL] / n_crit : 0U),
+         (unsigned)q.wait_us_max[ALERT_PRIO_CRITICAL]);
+  oled_stats_t os;
+  oled_stats(&os);
+  printf("[PIPE] oled actualizaciones=%u bus=%u B (media %u B, cuadro entero %u B) panel en rx_oled.pgm: %s\n",
+         (unsigned)os.flushes, (unsigned)os.bus_bytes, (unsigned)(os.flushes ? os.bus_bytes / os.flushes : 0U),
+         (unsigned)OLED_FULL_FRAME_BUS_BYTES, oled_host_pgm("rx_oled.pgm", 4) ? "ok" : "no escrito");
+  rx_stream_stats_t xs;
+  rx_stream_stats(&xs);
+  printf("[PIPE] flujo registros=%u descartados=%u bytes=%u ring max=%u/%u B en %s\n", (unsigned)xs.records,
+         (unsigned)xs.dropped, (unsigned)xs.bytes, (unsigned)xs.high_water, (unsigned)RX_STREAM_RING_BYTES,
+         RX_STREAM_HOST_PATH);
+  app_wakeups_t w;
+  app_get_wakeups(&w);
+  const double secs = run_ms / 1000.0;
+  printf("[PIPE] despertares/s: sample=%.1f alert_tx=%.1f blink=%.1f lora_rx=%.1f ui=%.1f\n",
+         w.wakeups[APP_TASK_SAMPLE] / secs, w.wakeups[APP_TASK_ALERT_TX] / secs,
+         w.wakeups[APP_TASK_BLINK] / secs, rx.wakeups_rx / secs, rx.wakeups_ui / secs);
+  fall_posture_stats_t ps;
+  fall_detector_posture_stats(&ps);
+  fall_clf_stats_t cs;
+  fall_clf_stats(&cs);
+  printf("[PIPE] imu: i2c/s=%.1f wom entradas=%u tiempo=%llums postura confirmadas=%u descartadas=%u "
+         "clf evaluadas=%u descartadas=%u\n",
+         w.imu_i2c / secs, (unsigned)w.wom_entries, (unsigned long long)(w.wom_us / 1000U),
+         (unsigned)ps.confirmed, (unsigned)ps.rejected, (unsigned)cs.runs, (unsigned)cs.rejected);
+  lat_probe_dump();
+  if (PROF_ENABLE) prof_dump();
+  mem_report_dump();
+  energy_dump();
+  if (argc > 2 && strcmp(argv[2], "trace") == 0) trace_ring_dump();
+  if (cut) {
+    return (ss.rtc_len + ss.nvs_len == 0U && ss.dropped == 0U && ss.flushed == ss.stored &&
+            rx.batched == ss.flushed) ? 0 : 1;
+  }
+  return (rx_frames == n && lat_probe_within_budget()) ? 0 : 1;
+}
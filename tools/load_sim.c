@@ -0,0 +1,665 @@
+// Prueba de carga: N nodos virtuales sobre un canal LoRa compartido y uno o
+// más receptores con la lógica real de firmware_rx. Barre N de 1 a N_max
+// (1-2-5) y reporta entrega de alertas, latencia y ocupación del canal.
+//
+// Fase 1, nodos: cada nodo pasa su propia traza sintética (semilla = id:
+// reposo, marcha, golpes que no son caída y caídas a tasa de Poisson) por los
+// cuerpos de tsk_sample_detect / tsk_alert_tx de app.c
+// (app_node_step_sample / app_node_step_tx, con la cola de alertas real) en
+// tiempo simulado: la tarea de TX despierta cuando termina la trama en curso
+// (lora_time_on_air_us()) y, con la cola vacía, APP_BBOX_FRAG_GAP_MS después
+// para el próximo fragmento de caja negra. El nodo sólo transmite (sin ACK), así que
+// su agenda no depende del canal: se calcula una vez para N_max nodos y cada
+// punto del barrido usa los primeros N.
+// Fase 2, canal de eventos: pérdida log-distancia con sombra fija por
+// enlace; una trama llega a un receptor si su SNR supera el mínimo del SF y
+// si supera por SIM_CAPTURE_DB la suma de las tramas solapadas (efecto
+// captura; sin él toda superposición audible es colisión).
+// Fase 3, receptores: las tramas que decodifica cada receptor, en orden,
+// pasan por app_rx_offline_frame() (mismo camino que tsk_lora_rx / tsk_ui);
+// se verifica que las clasifique como el canal las emitió.
+//
+// Detector, ring, caja negra y receptor son singletons: los nodos corren en
+// serie dentro de cada proceso hijo (fork) y los puntos del barrido en
+// paralelo, un hijo por núcleo. Una alerta cuenta como entregada si algún
+// receptor la decodifica; la caja negra, si un mismo receptor junta todos
+// sus fragmentos.
+//
+// Uso: load_sim [N_max] [segundos] [caidas_h] [golpes_h] [receptores] [procesos]
+// Sale con 1 si el receptor clasifica distinto alguna trama o si con un nodo
+// hay colisiones.
+
+#include "config/fall_params.h"
+#include "config/radio_params.h"
+#include "firmware_node/src/app/app.h"
+#include "firmware_node/src/drivers/lora_radio.h"
+#include "firmware_node/src/services/bbox_xfer.h"
+#include "firmware_node/src/services/imu_ring.h"
+#include "firmware_node/src/services/pkt_codec.h"
+#include "firmware_rx/src/app_rx.h"
+#include "firmware_rx/src/rx_stream.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Mismo valor por defecto que app.c (espera de tsk_alert_tx entre fragmentos).
+#ifndef APP_BBOX_FRAG_GAP_MS
+#define APP_BBOX_FRAG_GAP_MS 50U
+#endif
+
+// Canal (915 MHz, nodos en el cuerpo, interiores/suburbano).
+#ifndef SIM_AREA_M
+#define SIM_AREA_M 1000.0   // radio del disco donde se reparten los nodos
+#endif
+#define SIM_PL0_DB      40.0    // pérdida a 1 m, incluye el cuerpo
+#define SIM_PL_EXP      2.9
+#define SIM_SHADOW_DB   6.0     // desvío de la sombra (fija por enlace)
+#define SIM_NF_DB       6.0
+#define SIM_CAPTURE_DB  6.0
+#define SIM_SNR_MIN_DB  (-7.5 - 2.5 * (LORA_SF - 7))
+
+#define SIM_PERIOD_MS    (1000U / FALL_FS_HZ)
+#define SIM_MAX_NODES    10000U
+#define SIM_MAX_TX_NODE  256U
+#define SIM_MAX_XFER     16U     // cajas negras por nodo
+#define SIM_MAX_RX       8U
+#define SIM_MAX_SEG      3600U
+#define SIM_MAX_SAMPLES  (FALL_FS_HZ * SIM_MAX_SEG)
+#define SIM_MAX_POINTS   16U
+
+typedef enum {
+  TX_ALERT = 0,
+  TX_PRE,
+  TX_CANCEL,
+  TX_BBOX,
+  TX_KINDS
+} tx_kind_t;
+
+typedef struct {
+  uint64_t start_us;
+  uint64_t ref_us;     // alerta / prealerta: pico del evento (epoch)
+  uint32_t toa_us;
+  uint16_t node_tx;    // índice dentro del nodo
+  uint8_t kind;        // tx_kind_t
+  uint8_t cand;        // fall_event_t.seq: une prealerta y confirmación
+  uint8_t xfer;        // caja negra del nodo (TX_BBOX)
+  uint8_t len;
+  uint8_t frame[PKT_BBOX_MAX_FRAME];
+} sim_tx_t;
+
+typedef struct {
+  uint32_t n_tx;
+  uint32_t overflow;   // tramas que no entraron en SIM_MAX_TX_NODE
+  uint32_t falls;      // caídas de la traza
+  uint32_t bumps;
+  uint32_t confirmed;  // confirmaciones del detector
+  uint32_t samples;
+} node_out_t;
+
+typedef struct {
+  uint32_t nodes;
+  uint32_t frames;
+  double offered;      // Σ aire / duración (G)
+  double busy;         // fracción de tiempo con alguna trama en el aire
+  uint32_t sent[TX_KINDS];
+  uint32_t got[TX_KINDS];   // decodificadas por algún receptor
+  uint32_t xfers;
+  uint32_t xfers_done;
+  uint32_t collided;   // trama perdida en todos los receptores con alguno en alcance
+  uint32_t weak;       // fuera de alcance de todos
+  uint32_t lat_p50_ms, lat_p99_ms;     // pico → fin de RX de la confirmación
+  uint32_t first_p50_ms, first_p99_ms; // pico → primer aviso (prealerta o confirmación)
+  uint32_t noticed;    // confirmaciones con prealerta o confirmación entregada
+  uint32_t rx_alerts;  // app_rx: confirmaciones (suma de receptores)
+  uint32_t rx_escalated;
+  uint32_t rx_bbox_done;
+  uint32_t rx_mismatch;
+  double ms;
+  int ok;
+} point_out_t;
+
+static unsigned s_nmax = 2000U;
+static unsigned s_seg = 300U;
+static double s_falls_h = 6.0;
+static double s_bumps_h = 30.0;
+static unsigned s_nrx = 1U;
+static unsigned s_workers = 1U;
+
+static sim_tx_t* s_tx;          // [SIM_MAX_NODES][SIM_MAX_TX_NODE], compartido
+static node_out_t* s_node;      // [SIM_MAX_NODES], compartido
+static point_out_t* s_point;    // [SIM_MAX_POINTS], compartido
+
+static double s_link_dbm[SIM_MAX_NODES][SIM_MAX_RX];
+static double s_link_mw[SIM_MAX_NODES][SIM_MAX_RX];
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void* shared_alloc(size_t bytes) {
+  void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  return p == MAP_FAILED ? NULL : p;
+}
+
+// ---------------------------------------------------------------------------
+// Trazas. Mismo modelo de señal que wom_replay / stub IMU: reposo ≈ 1 g en z,
+// marcha bajo el umbral, caída = caída libre + impacto + inmovilidad, golpe =
+// pico sin inmovilidad (prealerta y cancelación).
+// ---------------------------------------------------------------------------
+
+static accel_raw_t s_trace[SIM_MAX_SAMPLES];
+static size_t s_trace_n;
+static uint32_t s_rng;
+
+static uint32_t rng_next(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static double rng_unit(void) {
+  return (rng_next() >> 8) / 16777216.0;
+}
+
+static void rng_seed(uint32_t seed) {
+  s_rng = seed * 2654435761U + 0x9E3779B9U;
+  if (s_rng == 0U) s_rng = 1U;
+  for (int i = 0; i < 4; ++i) rng_next();
+}
+
+static int noise(int amp) {
+  return (int)(rng_next() % (unsigned)(2 * amp + 1)) - amp;
+}
+
+static void push(int ax, int ay, int az) {
+  if (s_trace_n >= SIM_MAX_SAMPLES) return;
+  s_trace[s_trace_n++] = (accel_raw_t){ (int16_t)ax, (int16_t)ay, (int16_t)az };
+}
+
+static void gen_rest(uint32_t ms) {
+  for (uint32_t i = 0; i < ms / SIM_PERIOD_MS; ++i) push(noise(2), noise(2), 100 + noise(2));
+}
+
+static void gen_walk(uint32_t ms) {
+  static const int8_t wave[] = { 0, 12, 22, 30, 34, 34, 30, 22, 12, 0, -12, -22, -30, -34, -34, -30, -22, -12, 0, 6, 0, -6, 0, 0, 0, 0, 0 };
+  const size_t len = sizeof(wave) / sizeof(wave[0]);
+  for (uint32_t i = 0; i < ms / SIM_PERIOD_MS; ++i) {
+    const int w = wave[i % len];
+    push(w / 2 + noise(4), noise(4), 100 + w + noise(4));
+  }
+}
+
+static void gen_fall(void) {
+  const uint32_t n = 300U / SIM_PERIOD_MS;
+  for (uint32_t i = 0; i < n; ++i) push(noise(3), noise(3), 100 - (int)(90U * i / (n - 1U)) + noise(2));
+  const int peak = 300 + (int)(rng_next() % 120U);
+  const int shape[] = { peak * 35 / 100, peak * 70 / 100, peak, peak * 70 / 100, peak * 35 / 100 };
+  for (size_t i = 0; i < 5U; ++i) push(noise(10), noise(10), shape[i]);
+  const uint32_t lying = 3000U + rng_next() % 7000U;
+  for (uint32_t i = 0; i < lying / SIM_PERIOD_MS; ++i) push(5 + noise(3), noise(3), 10 + noise(3));
+}
+
+static void gen_bump(void) {
+  const int peak = 250 + (int)(rng_next() % 100U);
+  const int shape[] = { peak * 50 / 100, peak, peak * 50 / 100 };
+  for (size_t i = 0; i < 3U; ++i) push(noise(10), noise(10), shape[i]);
+  gen_walk(3000U);
+}
+
+static double exp_gap_ms(double per_h) {
+  if (per_h <= 0.0) return 1e18;
+  return -log(1.0 - rng_unit()) * 3600e3 / per_h;
+}
+
+static void gen_trace(uint32_t node, node_out_t* out) {
+  rng_seed(node + 1U);
+  s_trace_n = 0;
+  const double end_ms = (double)s_seg * 1000.0;
+  double next_fall = exp_gap_ms(s_falls_h);
+  double next_bump = exp_gap_ms(s_bumps_h);
+  while (s_trace_n * SIM_PERIOD_MS < end_ms && s_trace_n < SIM_MAX_SAMPLES) {
+    const double t = (double)s_trace_n * SIM_PERIOD_MS;
+    if (t >= next_fall) {
+      gen_fall();
+      out->falls++;
+      next_fall = t + exp_gap_ms(s_falls_h);
+    } else if (t >= next_bump) {
+      gen_bump();
+      out->bumps++;
+      next_bump = t + exp_gap_ms(s_bumps_h);
+    } else {
+      const uint32_t ms = 2000U + rng_next() % 8000U;
+      if (rng_next() & 1U) {
+        gen_rest(ms);
+      } else {
+        gen_walk(ms);
+      }
+    }
+  }
+  if (s_trace_n * SIM_PERIOD_MS > end_ms) s_trace_n = (size_t)(end_ms / SIM_PERIOD_MS);
+}
+
+// ---------------------------------------------------------------------------
+// Fase 1: agenda de TX de un nodo.
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  sim_tx_t* tx;
+  node_out_t* out;
+  uint64_t phase_us;    // desfase del reloj de muestreo del nodo
+  uint64_t free_us;     // fin de la trama en curso (tsk_alert_tx bloqueada en lora_tx)
+  int xfer_id;          // xfer_id de la caja negra en curso (-1: ninguna)
+  uint8_t xfer;
+} node_sim_t;
+
+static void emit(node_sim_t* n, uint64_t start_us, tx_kind_t kind, const uint8_t* frame, size_t len,
+                 const fall_event_t* evt) {
+  if (len == 0U) return;
+  if (n->out->n_tx >= SIM_MAX_TX_NODE) {
+    n->out->overflow++;
+    n->free_us = start_us + lora_time_on_air_us(len);
+    return;
+  }
+  sim_tx_t* t = &n->tx[n->out->n_tx];
+  t->start_us = start_us;
+  t->ref_us = evt ? n->phase_us + (uint64_t)evt->epoch_ms * 1000U : 0U;
+  t->cand = evt ? evt->seq : 0U;
+  t->toa_us = lora_time_on_air_us(len);
+  t->node_tx = (uint16_t)n->out->n_tx;
+  t->kind = (uint8_t)kind;
+  t->xfer = n->xfer;
+  t->len = (uint8_t)len;
+  memcpy(t->frame, frame, len);
+  n->out->n_tx++;
+  n->free_us = start_us + t->toa_us;
+}
+
+// tsk_alert_tx hasta el instante now_us: cada despertar es app_node_step_tx()
+// con lo que entrega la cola; vacía, un fragmento de caja negra
+// APP_BBOX_FRAG_GAP_MS después de la última trama.
+static void node_service(node_sim_t* n, uint64_t now_us) {
+  uint8_t buf[PKT_BBOX_MAX_FRAME];
+  while (n->free_us <= now_us) {
+    fall_event_t evt;
+    alert_prio_t prio = ALERT_PRIO_CRITICAL;
+    const bool got = alert_queue_pop_prio(&evt, &prio, 0U);
+    uint64_t start = n->free_us > now_us ? n->free_us : now_us;
+    if (!got) {
+      if (!bbox_xfer_tx_pending()) return;
+      start = n->free_us + APP_BBOX_FRAG_GAP_MS * 1000U;
+      if (start > now_us) return;
+    }
+    const size_t len = app_node_step_tx(got ? &evt : NULL, prio, buf, sizeof(buf));
+    if (!got) {
+      pkt_bbox_frag_t f;
+      if (len > 0U && pkt_decode_bbox_frag(buf, len, &f) && f.xfer_id != n->xfer_id) {
+        if (n->xfer_id >= 0 && n->xfer + 1U < SIM_MAX_XFER) n->xfer++;
+        n->xfer_id = f.xfer_id;
+      }
+      emit(n, start, TX_BBOX, buf, len, NULL);
+    } else if (evt.kind == FALL_EVT_CONFIRMED) {
+      emit(n, start, TX_ALERT, buf, len, &evt);
+    } else {
+      emit(n, start, evt.kind == FALL_EVT_PREALERT ? TX_PRE : TX_CANCEL, buf, len, &evt);
+    }
+  }
+}
+
+static void run_node(uint32_t node) {
+  node_out_t* out = &s_node[node];
+  memset(out, 0, sizeof(*out));
+  gen_trace(node, out);
+
+  node_sim_t n;
+  memset(&n, 0, sizeof(n));
+  n.tx = &s_tx[(size_t)node * SIM_MAX_TX_NODE];
+  n.out = out;
+  n.phase_us = rng_next() % (SIM_PERIOD_MS * 1000U);
+  n.xfer_id = -1;
+  app_node_reset();
+
+  for (size_t i = 0; i < s_trace_n; ++i) {
+    const uint64_t now_us = n.phase_us + (uint64_t)i * SIM_PERIOD_MS * 1000U;
+    *imu_ring_slot() = s_trace[i];
+    if (app_node_step_sample(NULL)) out->confirmed++;
+    node_service(&n, now_us);
+  }
+  out->samples = (uint32_t)s_trace_n;
+}
+
+// ---------------------------------------------------------------------------
+// Fase 2: canal.
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  const sim_tx_t* t;
+  uint32_t node;
+} tx_ref_t;
+
+static int cmp_start(const void* a, const void* b) {
+  const uint64_t x = ((const tx_ref_t*)a)->t->start_us;
+  const uint64_t y = ((const tx_ref_t*)b)->t->start_us;
+  return (x > y) - (x < y);
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  const uint32_t x = *(const uint32_t*)a;
+  const uint32_t y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+static double gauss(void) {
+  const double u1 = rng_unit() + 1e-12;
+  const double u2 = rng_unit();
+  return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+// Posición y sombra dependen sólo del id: el nodo i es el mismo en todo el barrido.
+static void build_links(unsigned nodes) {
+  double rx_x[SIM_MAX_RX], rx_y[SIM_MAX_RX];
+  for (unsigned r = 0; r < s_nrx; ++r) {
+    const double a = 6.283185307179586 * r / s_nrx;
+    const double d = s_nrx > 1U ? SIM_AREA_M / 2.0 : 0.0;
+    rx_x[r] = d * cos(a);
+    rx_y[r] = d * sin(a);
+  }
+  for (unsigned i = 0; i < nodes; ++i) {
+    rng_seed(0x10000U + i);
+    const double rad = SIM_AREA_M * sqrt(rng_unit());
+    const double ang = 6.283185307179586 * rng_unit();
+    const double x = rad * cos(ang), y = rad * sin(ang);
+    for (unsigned r = 0; r < s_nrx; ++r) {
+      double d = hypot(x - rx_x[r], y - rx_y[r]);
+      if (d < 1.0) d = 1.0;
+      const double pl = SIM_PL0_DB + 10.0 * SIM_PL_EXP * log10(d) + SIM_SHADOW_DB * gauss();
+      s_link_dbm[i][r] = LORA_POUT_DBM - pl;
+      s_link_mw[i][r] = pow(10.0, s_link_dbm[i][r] / 10.0);
+    }
+  }
+}
+
+static bool receiver_rx(const tx_ref_t* v, size_t n, size_t i, unsigned r, uint32_t max_toa_us, double noise_dbm) {
+  const tx_ref_t* me = &v[i];
+  if (s_link_dbm[me->node][r] - noise_dbm < SIM_SNR_MIN_DB) return false;
+  const uint64_t s0 = me->t->start_us;
+  const uint64_t e0 = s0 + me->t->toa_us;
+  double interf_mw = 0.0;
+  for (size_t k = i; k-- > 0U;) {
+    if (v[k].t->start_us + max_toa_us <= s0) break;
+    if (v[k].t->start_us + v[k].t->toa_us > s0) interf_mw += s_link_mw[v[k].node][r];
+  }
+  for (size_t k = i + 1U; k < n && v[k].t->start_us < e0; ++k) interf_mw += s_link_mw[v[k].node][r];
+  if (interf_mw <= 0.0) return true;
+  return s_link_dbm[me->node][r] - 10.0 * log10(interf_mw) >= SIM_CAPTURE_DB;
+}
+
+static uint8_t expected_status(uint8_t kind) {
+  return kind == TX_BBOX ? (uint8_t)RX_ST_BBOX : (uint8_t)RX_ST_EVENT;
+}
+
+static void run_point(unsigned nodes, point_out_t* out) {
+  const double t0 = now_ms();
+  memset(out, 0, sizeof(*out));
+  out->nodes = nodes;
+  build_links(nodes);
+
+  size_t n = 0;
+  for (unsigned i = 0; i < nodes; ++i) n += s_node[i].n_tx;
+  tx_ref_t* v = malloc((n ? n : 1U) * sizeof(*v));
+  uint8_t* ok = calloc((n ? n : 1U) * s_nrx, 1);
+  uint8_t (*xfer_got)[SIM_MAX_XFER][SIM_MAX_RX] = calloc(nodes, sizeof(*xfer_got));
+  uint8_t (*xfer_frags)[SIM_MAX_XFER] = calloc(nodes, sizeof(*xfer_frags));
+  uint32_t* lat = malloc((n ? n : 1U) * sizeof(*lat));
+  uint32_t* first = malloc((n ? n : 1U) * sizeof(*first));
+  int16_t* pre_cand = malloc(nodes * sizeof(*pre_cand));   // última prealerta entregada
+  uint64_t* pre_end = malloc(nodes * sizeof(*pre_end));
+  if (!v || !ok || !xfer_got || !xfer_frags || !lat || !first || !pre_cand || !pre_end) {
+    fprintf(stderr, "load_sim: sin memoria (%zu tramas)\n", n);
+    exit(2);
+  }
+  size_t k = 0;
+  uint32_t max_toa = 0;
+  uint64_t air_us = 0;
+  for (unsigned i = 0; i < nodes; ++i) {
+    for (uint32_t j = 0; j < s_node[i].n_tx; ++j) {
+      v[k].t = &s_tx[(size_t)i * SIM_MAX_TX_NODE + j];
+      v[k].node = i;
+      if (v[k].t->toa_us > max_toa) max_toa = v[k].t->toa_us;
+      air_us += v[k].t->toa_us;
+      ++k;
+    }
+  }
+  qsort(v, n, sizeof(*v), cmp_start);
+  for (unsigned i = 0; i < nodes; ++i) pre_cand[i] = -1;
+
+  const double dur_us = (double)s_seg * 1e6;
+  const double noise_dbm = -174.0 + 10.0 * log10(LORA_BW_KHZ * 1000.0) + SIM_NF_DB;
+  uint64_t busy_us = 0, busy_end = 0;
+  size_t n_lat = 0, n_first = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const sim_tx_t* t = v[i].t;
+    const uint64_t end = t->start_us + t->toa_us;
+    if (end > busy_end) {
+      busy_us += end - (t->start_us > busy_end ? t->start_us : busy_end);
+      busy_end = end;
+    }
+    bool any = false, audible = false;
+    for (unsigned r = 0; r < s_nrx; ++r) {
+      audible |= s_link_dbm[v[i].node][r] - noise_dbm >= SIM_SNR_MIN_DB;
+      ok[i * s_nrx + r] = receiver_rx(v, n, i, r, max_toa, noise_dbm);
+      any |= ok[i * s_nrx + r] != 0U;
+      if (t->kind == TX_BBOX && ok[i * s_nrx + r]) xfer_got[v[i].node][t->xfer][r]++;
+    }
+    out->sent[t->kind]++;
+    if (any) out->got[t->kind]++;
+    if (!audible) {
+      out->weak++;
+    } else if (!any) {
+      out->collided++;
+    }
+    if (t->kind == TX_BBOX) xfer_frags[v[i].node][t->xfer]++;
+    if (t->kind == TX_PRE && any) {
+      pre_cand[v[i].node] = t->cand;
+      pre_end[v[i].node] = end;
+    } else if (t->kind == TX_ALERT) {
+      const bool pre_ok = pre_cand[v[i].node] == t->cand;
+      if (any) lat[n_lat++] = (uint32_t)((end - t->ref_us) / 1000U);
+      if (pre_ok || any) first[n_first++] = (uint32_t)(((pre_ok ? pre_end[v[i].node] : end) - t->ref_us) / 1000U);
+      pre_cand[v[i].node] = -1;
+    }
+  }
+  out->frames = (uint32_t)n;
+  out->offered = (double)air_us / dur_us;
+  out->busy = (double)busy_us / dur_us;
+  for (unsigned i = 0; i < nodes; ++i) {
+    for (unsigned x = 0; x < SIM_MAX_XFER; ++x) {
+      if (xfer_frags[i][x] == 0U) continue;
+      out->xfers++;
+      for (unsigned r = 0; r < s_nrx; ++r) {
+        if (xfer_got[i][x][r] == xfer_frags[i][x]) {
+          out->xfers_done++;
+          break;
+        }
+      }
+    }
+  }
+  if (n_lat > 0U) {
+    qsort(lat, n_lat, sizeof(*lat), cmp_u32);
+    out->lat_p50_ms = lat[n_lat * 50U / 100U];
+    out->lat_p99_ms = lat[n_lat * 99U / 100U];
+  }
+  if (n_first > 0U) {
+    qsort(first, n_first, sizeof(*first), cmp_u32);
+    out->first_p50_ms = first[n_first * 50U / 100U];
+    out->first_p99_ms = first[n_first * 99U / 100U];
+    out->noticed = (uint32_t)n_first;
+  }
+
+  // Fase 3: lógica real del receptor, una instancia por receptor en serie.
+  for (unsigned r = 0; r < s_nrx; ++r) {
+    app_rx_offline_init();
+    for (size_t i = 0; i < n; ++i) {
+      if (!ok[i * s_nrx + r]) continue;
+      const double snr = s_link_dbm[v[i].node][r] - noise_dbm;
+      const uint8_t st = app_rx_offline_frame(v[i].t->frame, v[i].t->len, (int16_t)lrint(s_link_dbm[v[i].node][r]),
+                                              (int8_t)(snr > 127.0 ? 127 : lrint(snr)));
+      if (st != expected_status(v[i].t->kind)) out->rx_mismatch++;
+    }
+    app_rx_stats_t st;
+    app_rx_get_stats(&st);
+    out->rx_alerts += st.alerts;
+    out->rx_escalated += st.escalated;
+    out->rx_bbox_done += st.bbox_done;
+  }
+
+  free(v);
+  free(ok);
+  free(xfer_got);
+  free(xfer_frags);
+  free(lat);
+  free(first);
+  free(pre_cand);
+  free(pre_end);
+  out->ms = now_ms() - t0;
+  out->ok = 1;
+}
+
+// ---------------------------------------------------------------------------
+
+static double pct(uint32_t a, uint32_t b) {
+  return b ? 100.0 * a / b : 100.0;
+}
+
+static void wait_children(unsigned n) {
+  for (unsigned i = 0; i < n; ++i) {
+    int status;
+    if (wait(&status) < 0) break;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc > 1) s_nmax = (unsigned)atoi(argv[1]);
+  if (argc > 2) s_seg = (unsigned)atoi(argv[2]);
+  if (argc > 3) s_falls_h = atof(argv[3]);
+  if (argc > 4) s_bumps_h = atof(argv[4]);
+  if (argc > 5) s_nrx = (unsigned)atoi(argv[5]);
+  const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  s_workers = argc > 6 ? (unsigned)atoi(argv[6]) : (cpus > 0 ? (unsigned)cpus : 1U);
+  if (s_nmax < 1U || s_nmax > SIM_MAX_NODES || s_seg < 10U || s_seg > SIM_MAX_SEG || s_nrx < 1U ||
+      s_nrx > SIM_MAX_RX || s_workers < 1U) {
+    fprintf(stderr, "uso: %s [N_max<=%u] [segundos 10..%u] [caidas_h] [golpes_h] [receptores<=%u] [procesos]\n",
+            argv[0], SIM_MAX_NODES, SIM_MAX_SEG, SIM_MAX_RX);
+    return 2;
+  }
+
+  s_tx = shared_alloc((size_t)s_nmax * SIM_MAX_TX_NODE * sizeof(*s_tx));
+  s_node = shared_alloc((size_t)s_nmax * sizeof(*s_node));
+  s_point = shared_alloc(SIM_MAX_POINTS * sizeof(*s_point));
+  if (!s_tx || !s_node || !s_point) {
+    fprintf(stderr, "load_sim: mmap\n");
+    return 2;
+  }
+  lora_init(LORA_FREQ_HZ, LORA_SF, LORA_BW_KHZ, LORA_POUT_DBM, LORA_CRC_ON);
+
+  printf("[LOAD] %u nodos max, %u s, %.1f caidas/h, %.1f golpes/h por nodo, %u receptor(es), %u procesos\n", s_nmax,
+         s_seg, s_falls_h, s_bumps_h, s_nrx, s_workers);
+  printf("[LOAD] SF%u/%u kHz %d dBm, area r=%.0f m, PL %.0f+%.0f*%.1f*log10(d) sombra %.0f dB, SNR min %.1f dB, "
+         "captura %.0f dB\n",
+         (unsigned)LORA_SF, (unsigned)LORA_BW_KHZ, LORA_POUT_DBM, SIM_AREA_M, SIM_PL0_DB, 10.0, SIM_PL_EXP,
+         SIM_SHADOW_DB, SIM_SNR_MIN_DB, SIM_CAPTURE_DB);
+
+  // Fase 1: nodos intercalados entre los procesos.
+  double t0 = now_ms();
+  for (unsigned w = 0; w < s_workers; ++w) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      for (unsigned i = w; i < s_nmax; i += s_workers) run_node(i);
+      _exit(0);
+    }
+    if (pid < 0) {
+      perror("fork");
+      return 2;
+    }
+  }
+  wait_children(s_workers);
+  const double t_nodes = now_ms() - t0;
+  uint64_t samples = 0;
+  uint32_t falls = 0, bumps = 0, confirmed = 0, overflow = 0;
+  for (unsigned i = 0; i < s_nmax; ++i) {
+    samples += s_node[i].samples;
+    falls += s_node[i].falls;
+    bumps += s_node[i].bumps;
+    confirmed += s_node[i].confirmed;
+    overflow += s_node[i].overflow;
+  }
+  printf("[LOAD] nodos: %llu muestras en %.0f ms (%.0f ns/muestra), caidas %u golpes %u "
+         "confirmadas %u, tramas fuera de agenda %u\n",
+         (unsigned long long)samples, t_nodes, samples ? t_nodes * 1e6 / (double)samples : 0.0, falls,
+         bumps, confirmed, overflow);
+
+  // Fase 2 + 3: puntos del barrido 1-2-5, a lo sumo s_workers a la vez.
+  unsigned points[SIM_MAX_POINTS];
+  unsigned n_points = 0;
+  for (unsigned dec = 1U; n_points < SIM_MAX_POINTS; dec *= 10U) {
+    static const unsigned k_mult[] = { 1U, 2U, 5U };
+    for (unsigned m = 0; m < 3U && n_points < SIM_MAX_POINTS; ++m) {
+      if (dec * k_mult[m] < s_nmax) points[n_points++] = dec * k_mult[m];
+    }
+    if (dec * 10U >= s_nmax) break;
+  }
+  if (n_points < SIM_MAX_POINTS) points[n_points++] = s_nmax;
+
+  t0 = now_ms();
+  unsigned running = 0;
+  for (unsigned p = 0; p < n_points; ++p) {
+    if (running == s_workers) {
+      wait_children(1U);
+      running--;
+    }
+    const pid_t pid = fork();
+    if (pid == 0) {
+      run_point(points[p], &s_point[p]);
+      _exit(0);
+    }
+    if (pid < 0) {
+      perror("fork");
+      return 2;
+    }
+    running++;
+  }
+  wait_children(running);
+
+  printf("[LOAD] %6s %7s %6s %6s %7s %8s %8s %8s %8s %6s %6s %6s %6s %7s %6s\n", "nodos", "tramas", "G", "ocup",
+         "alertas", "entrega", "aviso", "prealer", "caja", "conf50", "conf99", "avi50", "avi99", "colis", "debil");
+  int rc = overflow ? 1 : 0;
+  for (unsigned p = 0; p < n_points; ++p) {
+    const point_out_t* o = &s_point[p];
+    if (!o->ok) {
+      printf("[LOAD] %6u  (proceso fallido)\n", points[p]);
+      rc = 1;
+      continue;
+    }
+    printf("[LOAD] %6u %7u %6.3f %5.1f%% %7u %7.1f%% %7.1f%% %7.1f%% %7.1f%% %6u %6u %6u %6u %7u %6u\n", o->nodes,
+           o->frames, o->offered, 100.0 * o->busy, o->sent[TX_ALERT], pct(o->got[TX_ALERT], o->sent[TX_ALERT]),
+           pct(o->noticed, o->sent[TX_ALERT]), pct(o->got[TX_PRE], o->sent[TX_PRE]), pct(o->xfers_done, o->xfers),
+           o->lat_p50_ms, o->lat_p99_ms, o->first_p50_ms, o->first_p99_ms, o->collided, o->weak);
+    if (o->rx_mismatch != 0U) rc = 1;
+    if (o->nodes == 1U && o->collided != 0U) rc = 1;
+  }
+  for (unsigned p = 0; p < n_points; ++p) {
+    const point_out_t* o = &s_point[p];
+    printf("[LOAD] rx %6u nodos: app_rx alertas %u escaladas %u cajas %u, clasificacion distinta %u (%.0f ms)\n",
+           o->nodes, o->rx_alerts, o->rx_escalated, o->rx_bbox_done, o->rx_mismatch, o->ms);
+  }
+  printf("[LOAD] barrido en %.0f ms; %s\n", now_ms() - t0, rc == 0 ? "OK" : "FALLA");
+  return rc;
+}
@@ -0,0 +1,234 @@
+// Simulación de inundación multi-salto con services/relay sobre una grilla de
+// repetidores. Cada equipo corre su propia instancia de relay; el canal es de
+// eventos a paso de 1 ms: una trama dura lora_time_on_air_us(len), llega a
+// todos los equipos a distancia <= alcance y se pierde en un receptor si éste
+// transmite o si otra trama audible se solapa (sin efecto captura).
+//
+// El origen es el equipo (0,0) y el destino el de la esquina opuesta. Por
+// configuración de retardo/supresión reporta entrega (equipos que recibieron
+// cada alerta), entrega al destino, saltos y latencia origen → destino y
+// amplificación de tiempo en aire (aire total / aire de la trama original).
+// Aparte, reinicio del origen frente a un receptor que no se reinicia: con
+// seq de vuelta en 0 vs. la numeración continuada (RTC_NOINIT en app.c).
+// Sale con 1 si la configuración por defecto (RELAY_*) entrega menos del 98 %
+// o si con la numeración continuada se pierde alguna trama tras el reinicio.
+//
+// Uso: relay_sim [lado_grilla] [alertas] [alcance_x10]
+
+#include "firmware_node/src/drivers/lora_radio.h"
+#include "firmware_node/src/services/pkt_codec.h"
+#include "firmware_node/src/services/relay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SIDE   10U
+#define MAX_NODES  (MAX_SIDE * MAX_SIDE)
+#define MAX_TX     1024U
+#define ALERT_GAP_MS 5000U   // sin interferencia entre alertas
+#define RUN_LIMIT_MS 10000U
+
+typedef struct {
+  uint16_t sender;
+  uint32_t start_ms;
+  uint32_t end_ms;
+  uint8_t len;
+  uint8_t frame[PKT_RELAY_MAX_FRAME];
+} tx_t;
+
+typedef struct {
+  const char* name;
+  uint16_t delay_min_ms;
+  uint16_t delay_max_ms;
+  uint8_t suppress;
+} scenario_t;
+
+static relay_t s_nodes[MAX_NODES];
+static tx_t s_tx[MAX_TX];
+static unsigned s_ntx;
+static unsigned s_side;
+static unsigned s_range_x10;
+static uint32_t s_lat_ms[4096];
+
+static bool in_range(unsigned a, unsigned b) {
+  const int dx = (int)(a % s_side) - (int)(b % s_side);
+  const int dy = (int)(a / s_side) - (int)(b / s_side);
+  return (unsigned)(100 * (dx * dx + dy * dy)) <= s_range_x10 * s_range_x10;
+}
+
+static uint32_t air_ms(size_t len) {
+  return (lora_time_on_air_us(len) + 999U) / 1000U;
+}
+
+static bool transmitting(unsigned node, uint32_t now_ms) {
+  for (unsigned i = 0; i < s_ntx; ++i) {
+    if (s_tx[i].sender == node && s_tx[i].start_ms <= now_ms && now_ms < s_tx[i].end_ms) return true;
+  }
+  return false;
+}
+
+// La trama i llega intacta a rx si rx no transmitió ni oyó otra trama
+// mientras duraba.
+static bool received(unsigned i, unsigned rx) {
+  const tx_t* t = &s_tx[i];
+  for (unsigned k = 0; k < s_ntx; ++k) {
+    if (k == i) continue;
+    const tx_t* o = &s_tx[k];
+    if (o->start_ms >= t->end_ms || o->end_ms <= t->start_ms) continue;
+    if (o->sender == rx || in_range(o->sender, rx)) return false;
+  }
+  return true;
+}
+
+static void start_tx(unsigned node, uint32_t now_ms, const uint8_t* frame, size_t len) {
+  if (s_ntx >= MAX_TX) return;
+  tx_t* t = &s_tx[s_ntx++];
+  t->sender = (uint16_t)node;
+  t->start_ms = now_ms;
+  t->end_ms = now_ms + air_ms(len);
+  t->len = (uint8_t)len;
+  memcpy(t->frame, frame, len);
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  const uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static double run(const scenario_t* sc, unsigned alerts, bool print) {
+  const unsigned n = s_side * s_side;
+  const unsigned sink = n - 1U;
+  for (unsigned i = 0; i < n; ++i) {
+    relay_cfg_t cfg = { true, RELAY_MAX_HOPS, sc->delay_min_ms, sc->delay_max_ms, sc->suppress, 0x1234567U * (i + 1U) };
+    relay_init(&s_nodes[i], &cfg);
+  }
+  unsigned delivered = 0, covered = 0, lost_collision = 0, hops_sum = 0;
+  uint64_t air_total = 0, air_orig = 0;
+
+  for (unsigned a = 0; a < alerts; ++a) {
+    const uint32_t t0 = a * ALERT_GAP_MS;
+    fall_event_t e = { t0, (int16_t)(300 + a % 100), 700U, FALL_EVT_CONFIRMED, 0U };
+    uint8_t inner[PKT_ALERT_BYTES], frame[PKT_RELAY_MAX_FRAME];
+    const size_t ilen = pkt_encode_alert(&e, inner, sizeof(inner));
+    const size_t flen = relay_wrap(&s_nodes[0], 0U, inner, ilen, frame, sizeof(frame));
+    s_ntx = 0;
+    start_tx(0U, t0, frame, flen);
+    air_orig += air_ms(flen);
+    bool got[MAX_NODES] = { false };
+    got[0] = true;
+
+    for (uint32_t t = t0; t < t0 + RUN_LIMIT_MS; ++t) {
+      bool busy = false;
+      for (unsigned i = 0; i < s_ntx; ++i) {
+        if (s_tx[i].end_ms > t) busy = true;
+        if (s_tx[i].end_ms != t) continue;
+        for (unsigned r = 0; r < n; ++r) {
+          if (r == s_tx[i].sender || !in_range(s_tx[i].sender, r)) continue;
+          if (!received(i, r)) {
+            lost_collision++;
+            continue;
+          }
+          pkt_relay_t env;
+          if (relay_on_rx(&s_nodes[r], s_tx[i].frame, s_tx[i].len, t, &env) == RELAY_NEW && !got[r]) {
+            got[r] = true;
+            if (r == sink) {
+              if (delivered < sizeof(s_lat_ms) / sizeof(s_lat_ms[0])) s_lat_ms[delivered] = t - t0;
+              delivered++;
+              hops_sum += env.hops + 1U;
+            }
+          }
+        }
+      }
+      for (unsigned r = 0; r < n; ++r) {
+        if (transmitting(r, t)) continue;
+        uint8_t buf[PKT_RELAY_MAX_FRAME];
+        const size_t len = relay_poll(&s_nodes[r], t, buf, sizeof(buf));
+        if (len) {
+          start_tx(r, t, buf, len);
+          busy = true;
+        }
+      }
+      bool pending = false;
+      for (unsigned r = 0; r < n && !pending; ++r) pending = relay_next_due_ms(&s_nodes[r], t) != UINT32_MAX;
+      if (!busy && !pending) break;
+    }
+    for (unsigned i = 0; i < s_ntx; ++i) air_total += s_tx[i].end_ms - s_tx[i].start_ms;
+    for (unsigned r = 1; r < n; ++r) covered += got[r];
+  }
+
+  const double coverage = (double)covered / ((double)alerts * (n - 1U));
+  if (print) {
+    const unsigned nl = delivered < 4096U ? delivered : 4096U;
+    qsort(s_lat_ms, nl, sizeof(s_lat_ms[0]), cmp_u32);
+    const double hops = delivered ? (double)hops_sum / delivered : 0.0;
+    const unsigned p50 = nl ? (unsigned)s_lat_ms[nl / 2U] : 0U;
+    printf("RELAY %-18s entrega=%5.1f%% destino=%5.1f%% saltos=%.2f lat p50=%4ums max=%4ums (%.0fms/salto) "
+           "aire=x%.1f colisiones/alerta=%.1f\n",
+           sc->name, 100.0 * coverage, 100.0 * delivered / alerts, hops, p50, nl ? (unsigned)s_lat_ms[nl - 1U] : 0U,
+           hops > 0.0 ? p50 / hops : 0.0, air_orig ? (double)air_total / air_orig : 0.0,
+           (double)lost_collision / alerts);
+  }
+  return coverage;
+}
+
+// Tramas del origen que el receptor descarta como copias a lo largo de
+// REBOOTS reinicios de REBOOT_FRAMES tramas cada uno.
+#define REBOOTS 3U
+#define REBOOT_FRAMES 10U
+
+static unsigned reboot_lost(bool keep_seq) {
+  relay_t node, sink;
+  const relay_cfg_t sink_cfg = { false, RELAY_MAX_HOPS, 0U, 0U, 0U, 1U };
+  relay_init(&node, NULL);
+  relay_init(&sink, &sink_cfg);
+  unsigned lost = 0;
+  for (unsigned boot = 0; boot < REBOOTS; ++boot) {
+    const uint8_t next = relay_next_seq(&node);
+    relay_init(&node, NULL);
+    if (keep_seq) relay_set_next_seq(&node, next);
+    for (unsigned i = 0; i < REBOOT_FRAMES; ++i) {
+      fall_event_t e = { boot * 1000U + i, 300, 700U, FALL_EVT_CONFIRMED, 0U };
+      uint8_t inner[PKT_ALERT_BYTES], frame[PKT_RELAY_MAX_FRAME];
+      const size_t ilen = pkt_encode_alert(&e, inner, sizeof(inner));
+      const size_t flen = relay_wrap(&node, 0U, inner, ilen, frame, sizeof(frame));
+      pkt_relay_t env;
+      if (relay_on_rx(&sink, frame, flen, i, &env) != RELAY_NEW) lost++;
+    }
+  }
+  return lost;
+}
+
+int main(int argc, char** argv) {
+  s_side = argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 5U;
+  const unsigned alerts = argc > 2 ? (unsigned)strtoul(argv[2], NULL, 10) : 200U;
+  s_range_x10 = argc > 3 ? (unsigned)strtoul(argv[3], NULL, 10) : 15U;
+  if (s_side < 2U || s_side > MAX_SIDE) s_side = 5U;
+
+  uint8_t probe[PKT_RELAY_MAX_FRAME];
+  const uint8_t inner[PKT_ALERT_BYTES] = { PKT_TYPE_ALERT };
+  relay_t tmp;
+  relay_init(&tmp, NULL);
+  const size_t flen = relay_wrap(&tmp, 0U, inner, sizeof(inner), probe, sizeof(probe));
+  printf("RELAY grilla=%ux%u alcance=%u.%u alertas=%u trama=%uB aire=%ums max_saltos=%u cache=%u sizeof(relay_t)=%uB\n",
+         s_side, s_side, s_range_x10 / 10U, s_range_x10 % 10U, alerts, (unsigned)flen, (unsigned)air_ms(flen),
+         (unsigned)RELAY_MAX_HOPS, (unsigned)RELAY_CACHE_LEN, (unsigned)sizeof(relay_t));
+
+  const scenario_t scenarios[] = {
+    { "sin_retardo", 0U, 0U, 0U },
+    { "retardo_0-100ms", 0U, 100U, 0U },
+    { "retardo_0-400ms", 0U, 400U, 0U },
+    { "retardo_0-800ms", 0U, 800U, 0U },
+    { "defecto(RELAY_*)", RELAY_DELAY_MIN_MS, RELAY_DELAY_MAX_MS, RELAY_SUPPRESS_COPIES },
+  };
+  double def_ratio = 0.0;
+  for (unsigned i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); ++i) {
+    const double r = run(&scenarios[i], alerts, true);
+    if (i == sizeof(scenarios) / sizeof(scenarios[0]) - 1U) def_ratio = r;
+  }
+  const unsigned lost_reset = reboot_lost(false);
+  const unsigned lost_kept = reboot_lost(true);
+  printf("RELAY reinicio del origen (%u x %u tramas): descartadas como copia seq=0 %u, seq continuada %u\n",
+         REBOOTS, REBOOT_FRAMES, lost_reset, lost_kept);
+  return def_ratio >= 0.98 && lost_kept == 0U ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+// Captura y reproducción del flujo binario del receptor (firmware_rx/src/rx_stream).
+//
+//   record <puerto|-> <salida.cap> [baudios]
+//       Copia el flujo tal cual a la captura (puerto serie en crudo a
+//       RX_STREAM_BAUD, o stdin con "-") hasta EOF o Ctrl-C. Valida al vuelo:
+//       registros, saltos de seq (descartados en el receptor o en la línea) y
+//       texto de consola intercalado, que se reenvía a stderr.
+//   dump <captura.cap>
+//       Un registro por línea.
+//   replay <captura.cap> [vueltas]
+//       Carga la captura y la pasa a máxima velocidad por pkt_decode_alert()
+//       (sólo alertas) y por la lógica del receptor (app_rx_offline_frame(),
+//       mismo camino que tsk_lora_rx/tsk_ui sin radio, bitácora ni OLED).
+//       Compara el resultado de cada trama con el que grabó el receptor; sale
+//       con 1 si alguno difiere (regresión del decodificador o de app_rx).
+//
+// La captura es el flujo del cable sin procesar: 0x00 + COBS(registro) + 0x00.
+
+#include "firmware_node/src/services/pkt_codec.h"
+#include "firmware_rx/src/app_rx.h"
+#include "firmware_rx/src/rx_stream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+// Bytes entre delimitadores; más largo que un registro es texto o basura.
+typedef struct {
+  uint8_t buf[RX_STREAM_MAX_WIRE];
+  size_t n;
+  bool overflow;
+  bool have_seq;
+  uint16_t next_seq;
+  uint32_t records;
+  uint32_t gaps;        // registros faltantes según seq
+  uint32_t junk;        // tramas que no son registros (texto, bytes perdidos)
+  uint32_t junk_bytes;
+} scan_t;
+
+typedef void (*scan_cb_t)(const rx_stream_rec_t* r, void* arg);
+
+static double now_s(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (double)t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void scan_junk(scan_t* s, bool echo) {
+  s->junk++;
+  s->junk_bytes += (uint32_t)s->n;
+  if (!echo) return;
+  for (size_t i = 0; i < s->n; ++i) {
+    const uint8_t c = s->buf[i];
+    if (c == '\n' || c == '\r' || c == '\t' || (c >= 0x20U && c < 0x7FU)) fputc(c, stderr);
+  }
+}
+
+static void scan_byte(scan_t* s, uint8_t b, bool echo, scan_cb_t cb, void* arg) {
+  if (b != 0U) {
+    if (s->n < sizeof(s->buf)) {
+      s->buf[s->n++] = b;
+    } else {
+      s->overflow = true;
+      if (echo) fputc(b >= 0x20U && b < 0x7FU ? b : '.', stderr);
+    }
+    return;
+  }
+  if (s->n == 0U) return;   // delimitadores seguidos
+  rx_stream_rec_t r;
+  if (!s->overflow && rx_stream_unpack(s->buf, s->n, &r)) {
+    if (s->have_seq && r.seq != s->next_seq) s->gaps += (uint16_t)(r.seq - s->next_seq);
+    s->have_seq = true;
+    s->next_seq = (uint16_t)(r.seq + 1U);
+    s->records++;
+    if (cb) cb(&r, arg);
+  } else {
+    scan_junk(s, echo);
+  }
+  s->n = 0;
+  s->overflow = false;
+}
+
+static void scan_summary(const scan_t* s, const char* what) {
+  printf("%s: registros=%u faltantes(seq)=%u no-registros=%u (%u B)\n", what, (unsigned)s->records,
+         (unsigned)s->gaps, (unsigned)s->junk, (unsigned)s->junk_bytes);
+}
+
+// --- record ---
+
+static volatile sig_atomic_t s_stop = 0;
+
+static void on_sigint(int sig) {
+  (void)sig;
+  s_stop = 1;
+}
+
+static speed_t baud_const(unsigned long baud) {
+  switch (baud) {
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default: return B0;
+  }
+}
+
+static int open_input(const char* path, unsigned long baud) {
+  if (strcmp(path, "-") == 0) return STDIN_FILENO;
+  const int fd = open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0 || !isatty(fd)) return fd;
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0) return fd;
+  cfmakeraw(&tio);
+  const speed_t sp = baud_const(baud);
+  if (sp != B0) {
+    cfsetispeed(&tio, sp);
+    cfsetospeed(&tio, sp);
+  } else {
+    fprintf(stderr, "baudios %lu no soportados, se deja el puerto como está\n", baud);
+  }
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+  return fd;
+}
+
+static int cmd_record(const char* in, const char* out, unsigned long baud) {
+  const int fd = open_input(in, baud);
+  if (fd < 0) {
+    fprintf(stderr, "%s: %s\n", in, strerror(errno));
+    return 1;
+  }
+  FILE* f = fopen(out, "wb");
+  if (!f) {
+    fprintf(stderr, "%s: %s\n", out, strerror(errno));
+    return 1;
+  }
+  signal(SIGINT, on_sigint);
+  static scan_t s;
+  uint8_t buf[4096];
+  uint64_t total = 0;
+  const double t0 = now_s();
+  while (!s_stop) {
+    const ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR) continue;
+      break;
+    }
+    fwrite(buf, 1, (size_t)n, f);
+    total += (uint64_t)n;
+    for (ssize_t i = 0; i < n; ++i) scan_byte(&s, buf[i], true, NULL, NULL);
+  }
+  fclose(f);
+  const double dt = now_s() - t0;
+  printf("grabados %llu B en %.1f s (%.0f B/s) en %s\n", (unsigned long long)total, dt, dt > 0.0 ? total / dt : 0.0,
+         out);
+  scan_summary(&s, "captura");
+  return 0;
+}
+
+// --- dump / replay: la captura entera en memoria ---
+
+typedef struct {
+  rx_stream_rec_t* recs;
+  size_t n;
+  size_t cap;
+} rec_list_t;
+
+static void collect(const rx_stream_rec_t* r, void* arg) {
+  rec_list_t* l = (rec_list_t*)arg;
+  if (l->n == l->cap) {
+    l->cap = l->cap ? l->cap * 2U : 256U;
+    l->recs = realloc(l->recs, l->cap * sizeof(*l->recs));
+    if (!l->recs) exit(1);
+  }
+  l->recs[l->n++] = *r;
+}
+
+static bool load(const char* path, rec_list_t* l, scan_t* s) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0U) {
+    for (size_t i = 0; i < n; ++i) scan_byte(s, buf[i], false, collect, l);
+  }
+  fclose(f);
+  return true;
+}
+
+static int cmd_dump(const char* path) {
+  static scan_t s;
+  rec_list_t l = { 0 };
+  if (!load(path, &l, &s)) return 1;
+  for (size_t i = 0; i < l.n; ++i) {
+    const rx_stream_rec_t* r = &l.recs[i];
+    printf("%5u %10.6fs %-8s nodo=%3u rssi=%4d snr=%3d len=%2u tipo=0x%02X", (unsigned)r->seq, r->t_us / 1e6,
+           rx_stream_status_name(r->status), (unsigned)r->node, (int)r->rssi_dbm, (int)r->snr_db, (unsigned)r->len,
+           r->len ? r->raw[0] : 0U);
+    fall_event_t e;
+    if (pkt_decode_event(r->raw, r->len, &e)) {
+      printf(" seq=%u epoch=%ums pico=%d idle=%ums", (unsigned)e.seq, (unsigned)e.epoch_ms, (int)e.ax_peak_centi_g,
+             (unsigned)e.idle_ms);
+    }
+    printf("\n");
+  }
+  scan_summary(&s, path);
+  free(l.recs);
+  return 0;
+}
+
+static int cmd_replay(const char* path, unsigned loops) {
+  static scan_t s;
+  rec_list_t l = { 0 };
+  if (!load(path, &l, &s)) return 1;
+  scan_summary(&s, path);
+  if (l.n == 0U) {
+    free(l.recs);
+    return 1;
+  }
+
+  // 1) Decodificador de alertas solo (tramas 0xFA, directas o dentro de un sobre).
+  uint32_t alerts = 0;
+  uint32_t decoded = 0;
+  double t0 = now_s();
+  for (unsigned k = 0; k < loops; ++k) {
+    for (size_t i = 0; i < l.n; ++i) {
+      const rx_stream_rec_t* r = &l.recs[i];
+      const uint8_t* p = r->raw;
+      size_t len = r->len;
+      if (len > PKT_RELAY_HDR_BYTES && p[0] == PKT_TYPE_RELAY && p[5] < len - PKT_RELAY_HDR_BYTES) {
+        len = p[5];
+        p += PKT_RELAY_HDR_BYTES;
+      }
+      if (len == 0U || p[0] != PKT_TYPE_ALERT) continue;
+      fall_event_t e;
+      alerts++;
+      decoded += pkt_decode_alert(p, len, &e) ? 1U : 0U;
+    }
+  }
+  const double t_dec = now_s() - t0;
+
+  // 2) Lógica del receptor. La primera vuelta se compara con lo grabado; en
+  // las siguientes los sobres ya vistos son duplicados (caché de relay).
+  uint32_t per_status[RX_ST_COUNT + 1U] = { 0 };
+  uint32_t mismatch = 0;
+  app_rx_offline_init();
+  t0 = now_s();
+  for (unsigned k = 0; k < loops; ++k) {
+    for (size_t i = 0; i < l.n; ++i) {
+      const rx_stream_rec_t* r = &l.recs[i];
+      const uint8_t st = app_rx_offline_frame(r->raw, r->len, r->rssi_dbm, r->snr_db);
+      if (k > 0U) continue;
+      per_status[st < RX_ST_COUNT ? st : RX_ST_COUNT]++;
+      if (st != r->status) {
+        mismatch++;
+        if (mismatch <= 10U) {
+          printf("  difiere seq=%u: grabado=%s reproducido=%s\n", (unsigned)r->seq, rx_stream_status_name(r->status),
+                 rx_stream_status_name(st));
+        }
+      }
+    }
+  }
+  const double t_rx = now_s() - t0;
+  const double frames = (double)l.n * loops;
+
+  app_rx_stats_t st;
+  app_rx_get_stats(&st);
+  printf("pkt_decode_alert: %u alertas (%u validas) x%u vueltas, %.0f ns/trama (%.2f M tramas/s)\n",
+         (unsigned)(alerts / loops), (unsigned)(decoded / loops), loops, alerts ? t_dec * 1e9 / alerts : 0.0,
+         t_dec > 0.0 ? alerts / t_dec / 1e6 : 0.0);
+  printf("app_rx: %zu tramas x%u vueltas, %.0f ns/trama (%.2f M tramas/s)\n", l.n, loops, t_rx * 1e9 / frames,
+         t_rx > 0.0 ? frames / t_rx / 1e6 : 0.0);
+  printf("app_rx por vuelta: evento=%u lote=%u caja=%u dup=%u invalida=%u | alertas=%u prealertas=%u canceladas=%u "
+         "escaladas=%u cajas=%u\n",
+         (unsigned)per_status[RX_ST_EVENT], (unsigned)per_status[RX_ST_BATCH], (unsigned)per_status[RX_ST_BBOX],
+         (unsigned)per_status[RX_ST_DUP], (unsigned)per_status[RX_ST_BAD], (unsigned)(st.alerts / loops),
+         (unsigned)(st.prealerts / loops), (unsigned)(st.cancels / loops), (unsigned)(st.escalated / loops),
+         (unsigned)(st.bbox_done / loops));
+  printf("resultado vs grabado: %s (%u distintos)\n", mismatch ? "FALLA" : "OK", (unsigned)mismatch);
+  free(l.recs);
+  return mismatch ? 1 : 0;
+}
+
+static void usage(void) {
+  fprintf(stderr,
+          "uso: rx_capture record <puerto|-> <salida.cap> [baudios]\n"
+          "     rx_capture dump <captura.cap>\n"
+          "     rx_capture replay <captura.cap> [vueltas]\n");
+}
+
+int main(int argc, char** argv) {
+  if (argc >= 4 && strcmp(argv[1], "record") == 0) {
+    return cmd_record(argv[2], argv[3], argc > 4 ? strtoul(argv[4], NULL, 10) : RX_STREAM_BAUD);
+  }
+  if (argc >= 3 && strcmp(argv[1], "dump") == 0) return cmd_dump(argv[2]);
+  if (argc >= 3 && strcmp(argv[1], "replay") == 0) {
+    const unsigned loops = argc > 3 ? (unsigned)strtoul(argv[3], NULL, 10) : 1000U;
+    return cmd_replay(argv[2], loops ? loops : 1U);
+  }
+  usage();
+  return 2;
+}
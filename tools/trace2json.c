@@ -0,0 +1,97 @@
+// Convierte el volcado de trace_ring ("TRT/TRE/TRC/TRL", por serial o desde
+// host_pipeline) a Chrome trace-event JSON. Abrir en chrome://tracing o
+// ui.perfetto.dev. Ignora cualquier otra línea del log.
+//
+// Uso: trace2json [log.txt] > trace.json     (sin argumento lee stdin)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NAMES 256
+#define NAME_LEN  32
+
+static char s_task_names[MAX_NAMES][NAME_LEN];
+static char s_event_names[MAX_NAMES][NAME_LEN];
+
+static void set_name(char table[][NAME_LEN], unsigned idx, const char* name) {
+  if (idx >= MAX_NAMES) return;
+  snprintf(table[idx], NAME_LEN, "%s", name);
+}
+
+int main(int argc, char** argv) {
+  FILE* in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "r");
+    if (!in) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  char line[256];
+  uint64_t base = 0, last = 0, wrap = 0;
+  int have_base = 0;
+  unsigned long events = 0, lost = 0;
+  unsigned used_tasks[MAX_NAMES] = { 0 };
+  unsigned depth[MAX_NAMES] = { 0 };   // B abiertos por tarea
+
+  printf("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  while (fgets(line, sizeof(line), in)) {
+    unsigned idx;
+    char name[NAME_LEN];
+    char hex[17];
+    unsigned long l;
+    if (sscanf(line, "TRT %u %31s", &idx, name) == 2) {
+      set_name(s_task_names, idx, name);
+    } else if (sscanf(line, "TRE %u %31s", &idx, name) == 2) {
+      set_name(s_event_names, idx, name);
+    } else if (sscanf(line, "TRL %lu", &l) == 1) {
+      lost += l;
+    } else if (sscanf(line, "TRC %16[0-9a-fA-F]", hex) == 1 && strlen(hex) == 16) {
+      const uint64_t v = strtoull(hex, NULL, 16);
+      const uint32_t ts = (uint32_t)(v >> 32);
+      const char kind = (char)((v >> 24) & 0xFF);
+      const unsigned task = (unsigned)((v >> 16) & 0xFF);
+      const unsigned ev = (unsigned)((v >> 8) & 0xFF);
+      const unsigned arg = (unsigned)(v & 0xFF);
+      // Desenvuelve el reloj de 32 bits (registros en orden).
+      uint64_t t = wrap + ts;
+      if (have_base && t + 0x80000000ULL < last) {
+        wrap += 0x100000000ULL;
+        t += 0x100000000ULL;
+      }
+      if (!have_base) {
+        base = t;
+        have_base = 1;
+      }
+      last = t;
+      const char* ev_name = ev < MAX_NAMES && s_event_names[ev][0] ? s_event_names[ev] : "ev";
+      if (kind != 'B' && kind != 'E' && kind != 'i') continue;
+      // El ring pudo empezar a mitad de un bloque: descarta E sin su B.
+      if (kind == 'B') depth[task]++;
+      if (kind == 'E') {
+        if (depth[task] == 0U) continue;
+        depth[task]--;
+      }
+      used_tasks[task] = 1;
+      printf("%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%u",
+             events ? ",\n" : "", ev_name, kind, (unsigned long long)(t - base), task);
+      if (kind == 'i') printf(",\"s\":\"t\",\"args\":{\"arg\":%u}", arg);
+      printf("}");
+      events++;
+    }
+  }
+  for (unsigned t = 0; t < MAX_NAMES; ++t) {
+    if (!used_tasks[t]) continue;
+    const char* tn = s_task_names[t][0] ? s_task_names[t] : (t == 0xFFU ? "isr" : "task");
+    printf("%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+           events ? ",\n" : "", t, tn);
+    events++;
+  }
+  printf("\n]}\n");
+  fprintf(stderr, "trace2json: %lu eventos, %lu registros perdidos en el ring\n", events, lost);
+  if (in != stdin) fclose(in);
+  return 0;
+}
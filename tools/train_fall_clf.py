@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Entrena el MLP de services/fall_clf y genera fall_clf_model.h.
+
+Entrada: CSV "f0,..,f7,etiqueta" (tools/fall_clf_bench --dump). Estandariza
+las entradas, entrena 8 → 8 ReLU → 1 (logística, SGD, semilla fija), cuantiza
+a int8 con la misma aritmética que fall_clf_score() y verifica la inferencia
+entera sobre el propio CSV antes de escribir el header.
+
+Uso: train_fall_clf.py train.csv firmware_node/src/services/fall_clf_model.h
+Sólo biblioteca estándar.
+"""
+
+import csv
+import math
+import random
+import sys
+
+N_IN = 8
+N_HID = 8
+IN_SCALE = 32          # entrada cuantizada ≈ 32 · z (±127 ≈ ±4 desvíos)
+POS_WEIGHT = 3.0       # perder una caída cuesta más que una falsa alarma
+EPOCHS = 400
+LR = 0.05
+
+
+def load(path):
+    xs, ys = [], []
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            if len(row) != N_IN + 1:
+                continue
+            xs.append([int(v) for v in row[:N_IN]])
+            ys.append(int(row[N_IN]))
+    return xs, ys
+
+
+def quant_inputs(x, off, mul):
+    out = []
+    for i in range(N_IN):
+        v = ((x[i] - off[i]) * mul[i]) >> 8
+        out.append(max(-127, min(127, v)))
+    return out
+
+
+def train(zs, ys, rnd):
+    w1 = [[rnd.gauss(0.0, 0.5) for _ in range(N_IN)] for _ in range(N_HID)]
+    b1 = [0.1] * N_HID
+    w2 = [rnd.gauss(0.0, 0.5) for _ in range(N_HID)]
+    b2 = 0.0
+    idx = list(range(len(zs)))
+    for _ in range(EPOCHS):
+        rnd.shuffle(idx)
+        for k in idx:
+            z, y = zs[k], ys[k]
+            pre = [b1[j] + sum(w1[j][i] * z[i] for i in range(N_IN)) for j in range(N_HID)]
+            h = [p if p > 0 else 0.0 for p in pre]
+            o = b2 + sum(w2[j] * h[j] for j in range(N_HID))
+            p = 1.0 / (1.0 + math.exp(-max(-30.0, min(30.0, o))))
+            g = (p - y) * (POS_WEIGHT if y else 1.0)
+            for j in range(N_HID):
+                gh = g * w2[j] if pre[j] > 0 else 0.0
+                w2[j] -= LR * g * h[j]
+                b1[j] -= LR * gh
+                for i in range(N_IN):
+                    w1[j][i] -= LR * gh * z[i]
+            b2 -= LR * g
+    return w1, b1, w2, b2
+
+
+def quantize(w1, b1, w2, b2, xq_all):
+    s_w1 = 127.0 / max(abs(v) for row in w1 for v in row)
+    w1q = [[int(round(v * s_w1)) for v in row] for row in w1]
+    b1q = [int(round(v * s_w1 * IN_SCALE)) for v in b1]
+    acc_max = 1
+    for xq in xq_all:
+        for j in range(N_HID):
+            acc_max = max(acc_max, b1q[j] + sum(w1q[j][i] * xq[i] for i in range(N_IN)))
+    shift = max(0, math.ceil(math.log2(acc_max / 127.0)))
+    s_h = s_w1 * IN_SCALE / (1 << shift)
+    s_w2 = 127.0 / max(abs(v) for v in w2)
+    w2q = [int(round(v * s_w2)) for v in w2]
+    b2q = int(round(b2 * s_w2 * s_h))
+    return w1q, b1q, w2q, b2q, shift
+
+
+def score_int(xq, w1q, b1q, w2q, b2q, shift):
+    out = b2q
+    for j in range(N_HID):
+        acc = b1q[j] + sum(w1q[j][i] * xq[i] for i in range(N_IN))
+        out += w2q[j] * max(0, min(127, acc >> shift))
+    return out
+
+
+def fmt_list(vals):
+    return ", ".join(str(v) for v in vals)
+
+
+def emit(path, off, mul, w1q, b1q, w2q, b2q, shift, stats):
+    table_bytes = 4 * N_IN + 2 * N_IN + N_HID * N_IN + 4 * N_HID + N_HID + 4
+    lines = [
+        "#pragma once",
+        "",
+        "// GENERADO por tools/train_fall_clf.py — no editar a mano.",
+        "// %s" % stats,
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define FALL_CLF_MODEL_N_IN %d" % N_IN,
+        "#define FALL_CLF_N_HID %d" % N_HID,
+        "#define FALL_CLF_SHIFT1 %d" % shift,
+        "#define FALL_CLF_MACS (FALL_CLF_MODEL_N_IN * FALL_CLF_N_HID + FALL_CLF_N_HID)",
+        "#define FALL_CLF_TABLE_BYTES %d" % table_bytes,
+        "",
+        "static const int32_t k_fall_clf_in_off[FALL_CLF_MODEL_N_IN] = { %s };" % fmt_list(off),
+        "static const int16_t k_fall_clf_in_mul[FALL_CLF_MODEL_N_IN] = { %s };" % fmt_list(mul),
+        "static const int8_t k_fall_clf_w1[FALL_CLF_N_HID][FALL_CLF_MODEL_N_IN] = {",
+    ]
+    lines += ["  { %s }," % fmt_list(row) for row in w1q]
+    lines += [
+        "};",
+        "static const int32_t k_fall_clf_b1[FALL_CLF_N_HID] = { %s };" % fmt_list(b1q),
+        "static const int8_t k_fall_clf_w2[FALL_CLF_N_HID] = { %s };" % fmt_list(w2q),
+        "static const int32_t k_fall_clf_b2 = %d;" % b2q,
+        "",
+    ]
+    with open(path, "w") as f:
+        f.write("\n".join(lines))
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__, file=sys.stderr)
+        return 2
+    xs, ys = load(sys.argv[1])
+    if not xs or len(set(ys)) < 2:
+        print("CSV vacío o con una sola clase", file=sys.stderr)
+        return 1
+
+    off, mul = [], []
+    for i in range(N_IN):
+        col = [x[i] for x in xs]
+        mean = sum(col) / len(col)
+        std = math.sqrt(sum((v - mean) ** 2 for v in col) / len(col)) or 1.0
+        off.append(int(round(mean)))
+        mul.append(max(1, min(32767, int(round(256.0 * IN_SCALE / std)))))
+
+    xq_all = [quant_inputs(x, off, mul) for x in xs]
+    zs = [[v / IN_SCALE for v in xq] for xq in xq_all]   # entrena sobre la entrada ya cuantizada
+    w1, b1, w2, b2 = train(zs, ys, random.Random(1))
+    w1q, b1q, w2q, b2q, shift = quantize(w1, b1, w2, b2, xq_all)
+
+    tp = fp = tn = fn = 0
+    for xq, y in zip(xq_all, ys):
+        fall = score_int(xq, w1q, b1q, w2q, b2q, shift) > 0
+        tp += fall and y
+        fn += (not fall) and y
+        fp += fall and not y
+        tn += (not fall) and not y
+    stats = "entrenado con %d eventos: TP=%d FN=%d FP=%d TN=%d (inferencia entera)" % (len(xs), tp, fn, fp, tn)
+    print(stats)
+    emit(sys.argv[2], off, mul, w1q, b1q, w2q, b2q, shift, stats)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
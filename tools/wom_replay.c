@@ -0,0 +1,351 @@
+// Reproduce trazas etiquetadas contra el detector real con y sin adquisición
+// adaptativa (wake-on-motion) y verifica que no se pierden caídas.
+//
+// Modelo del modo adaptativo (misma lógica que tsk_sample_detect):
+//   - tasa completa: una lectura I2C y un despertar por muestra;
+//     motion_gate decide cuándo entrar en WOM (IMU_XFERS_WOM_ENTER).
+//   - WOM: el MPU9250 compara cada muestra low-power (cada 32 ms con
+//     FALL_WOM_LP_ODR_SEL = 7) con la referencia; al superar el umbral el INT
+//     despierta la tarea, que sale de WOM (IMU_XFERS_WOM_WAKE + _EXIT) y
+//     retoma en la muestra siguiente (≤ 1 periodo). El reloj del detector
+//     avanza por las muestras no leídas (fall_detector_skip_samples).
+// Cada escenario se corre con todas las fases posibles del reloj low-power.
+//
+// Uso: wom_replay                  dataset sintético etiquetado (abajo)
+//      wom_replay traza.csv ...    líneas "ax,ay,az[,caida]" en centi-g a
+//                                  FALL_FS_HZ; caida=1 en la muestra del impacto
+// Sale con 1 si el modo adaptativo pierde una caída etiquetada o difiere del
+// muestreo continuo.
+
+#include "config/fall_params.h"
+#include "firmware_node/src/drivers/imu_accel.h"
+#include "firmware_node/src/services/fall_detector.h"
+#include "firmware_node/src/services/motion_gate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SAMPLES   (FALL_FS_HZ * 600U)   // 10 min por escenario
+#define MAX_EVENTS    64U
+#define MATCH_TOL_MS  100U                  // tolerancia de epoch entre modos / etiqueta
+
+typedef struct {
+  const char* name;
+  size_t n;
+  accel_raw_t s[MAX_SAMPLES];
+  uint8_t label[MAX_SAMPLES];
+} trace_t;
+
+typedef struct {
+  fall_event_t ev[MAX_EVENTS];
+  size_t n_ev;
+  uint32_t i2c;
+  uint32_t wakeups;
+  uint32_t wom_samples;   // muestras cubiertas en WOM
+  uint32_t wom_entries;
+} run_t;
+
+static trace_t s_trace;
+static uint32_t s_rng = 12345U;
+
+// ---------------------------------------------------------------------------
+// Dataset sintético. Mismo modelo de señal que el stub IMU del host: reposo
+// ≈ 1 g en z; tras el impacto la "inmovilidad" del detector es |a| < 0.2 g
+// por eje (ver fall_detector.c).
+// ---------------------------------------------------------------------------
+
+static int16_t noise(int amp) {
+  s_rng = s_rng * 1103515245U + 12345U;
+  return (int16_t)((int)((s_rng >> 16) % (unsigned)(2 * amp + 1)) - amp);
+}
+
+static void push(int ax, int ay, int az, uint8_t label) {
+  if (s_trace.n >= MAX_SAMPLES) return;
+  s_trace.s[s_trace.n] = (accel_raw_t){ (int16_t)ax, (int16_t)ay, (int16_t)az };
+  s_trace.label[s_trace.n] = label;
+  s_trace.n++;
+}
+
+static void gen_rest(uint32_t ms, int ax, int az) {
+  for (uint32_t i = 0; i < ms / 10U; ++i) push(ax + noise(2), noise(2), az + noise(2), 0);
+}
+
+// Marcha a ~1.8 Hz: picos ≈ 1.4 g, por debajo de FALL_A_THR_CENTI_G.
+static void gen_walk(uint32_t ms) {
+  static const int8_t wave[] = { 0, 12, 22, 30, 34, 34, 30, 22, 12, 0, -12, -22, -30, -34, -34, -30, -22, -12, 0, 6, 0, -6, 0, 0, 0, 0, 0 };
+  const size_t len = sizeof(wave) / sizeof(wave[0]);
+  for (uint32_t i = 0; i < ms / 10U; ++i) {
+    const int w = wave[i % len];
+    push(w / 2 + noise(4), noise(4), 100 + w + noise(4), 0);
+  }
+}
+
+static void gen_freefall(uint32_t ms) {
+  const uint32_t n = ms / 10U;
+  for (uint32_t i = 0; i < n; ++i) {
+    const int g = 100 - (int)(90U * i / (n > 1U ? n - 1U : 1U));   // 1 g → ~0.1 g
+    push(noise(3), noise(3), g + noise(2), 0);
+  }
+}
+
+// Impacto de ~50 ms; label en la primera muestra.
+static void gen_impact(int peak) {
+  const int shape[] = { peak * 35 / 100, peak * 70 / 100, peak, peak * 70 / 100, peak * 35 / 100 };
+  for (size_t i = 0; i < 5U; ++i) push(noise(10), noise(10), shape[i], i == 0U ? 1U : 0U);
+}
+
+static void gen_lying(uint32_t ms) {
+  for (uint32_t i = 0; i < ms / 10U; ++i) push(5 + noise(3), noise(3), 10 + noise(3), 0);
+}
+
+// Movimiento brusco que no es caída (pico sin inmovilidad posterior).
+static void gen_bump(int peak) {
+  const int shape[] = { peak * 50 / 100, peak, peak * 50 / 100 };
+  for (size_t i = 0; i < 3U; ++i) push(noise(10), noise(10), shape[i], 0);
+}
+
+typedef void (*gen_fn_t)(void);
+
+static void sc_rest(void) { gen_rest(120000U, 0, 100); }
+static void sc_charger(void) { gen_rest(120000U, 70, 71); }
+static void sc_walk(void) { gen_walk(60000U); }
+static void sc_fall_from_rest(void) {
+  for (int k = 0; k < 5; ++k) {
+    gen_rest(5000U + (uint32_t)k * 730U, 0, 100);
+    gen_freefall(300U);
+    gen_impact(320 + k * 30);
+    gen_lying(3000U);
+  }
+  gen_rest(5000U, 0, 100);
+}
+static void sc_fall_walking(void) {
+  for (int k = 0; k < 3; ++k) {
+    gen_walk(5000U + (uint32_t)k * 470U);
+    gen_freefall(250U);
+    gen_impact(300 + k * 40);
+    gen_lying(2500U);
+  }
+  gen_rest(5000U, 0, 100);
+}
+// Peor caso para WOM: impacto directo desde reposo, sin caída libre previa.
+static void sc_direct_impact(void) {
+  for (int k = 0; k < 6; ++k) {
+    gen_rest(4000U + (uint32_t)k * 130U, 0, 100);
+    gen_impact(320 + k * 20);
+    gen_lying(2000U);
+  }
+  gen_rest(3000U, 0, 100);
+}
+static void sc_bumps(void) {
+  for (int k = 0; k < 4; ++k) {
+    gen_rest(4000U, 0, 100);
+    gen_bump(260 + k * 20);
+    gen_walk(3000U);
+  }
+}
+static void sc_mixed_day(void) {
+  gen_rest(60000U, 70, 71);
+  gen_walk(30000U);
+  gen_rest(45000U, 0, 100);
+  gen_freefall(300U);
+  gen_impact(380);
+  gen_lying(4000U);
+  gen_rest(60000U, 0, 100);
+  gen_walk(20000U);
+  gen_bump(280);
+  gen_walk(10000U);
+  gen_rest(90000U, 0, 100);
+}
+
+static const struct {
+  const char* name;
+  gen_fn_t fn;
+} s_scenarios[] = {
+  { "reposo_mesa", sc_rest },
+  { "cargador", sc_charger },
+  { "caminar", sc_walk },
+  { "caida_reposo", sc_fall_from_rest },
+  { "caida_caminando", sc_fall_walking },
+  { "impacto_directo", sc_direct_impact },
+  { "golpes_sin_caida", sc_bumps },
+  { "dia_mixto", sc_mixed_day },
+};
+
+static size_t load_csv(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return 0;
+  }
+  char line[128];
+  s_trace.n = 0;
+  while (s_trace.n < MAX_SAMPLES && fgets(line, sizeof(line), f)) {
+    int ax, ay, az, lab = 0;
+    if (sscanf(line, "%d,%d,%d,%d", &ax, &ay, &az, &lab) >= 3) push(ax, ay, az, (uint8_t)(lab != 0));
+  }
+  fclose(f);
+  return s_trace.n;
+}
+
+// ---------------------------------------------------------------------------
+
+static void record(run_t* r, const fall_event_t* e) {
+  if (r->n_ev < MAX_EVENTS) r->ev[r->n_ev++] = *e;
+}
+
+static void run_continuous(run_t* r) {
+  memset(r, 0, sizeof(*r));
+  fall_detector_init(NULL);
+  for (size_t i = 0; i < s_trace.n; ++i) {
+    fall_event_t e;
+    r->i2c += IMU_XFERS_READ;
+    r->wakeups++;
+    if (fall_detector_feed(&s_trace.s[i], &e)) record(r, &e);
+  }
+}
+
+static bool moved(const accel_raw_t* a, const accel_raw_t* ref, int thr) {
+  return abs(a->ax - ref->ax) > thr || abs(a->ay - ref->ay) > thr || abs(a->az - ref->az) > thr;
+}
+
+static void run_adaptive(run_t* r, uint32_t stride, uint32_t phase) {
+  memset(r, 0, sizeof(*r));
+  fall_detector_init(NULL);
+  motion_gate_init(NULL);
+  const int thr = motion_gate_wom_thr_mg() / 10;
+  size_t i = 0;
+  while (i < s_trace.n) {
+    fall_event_t e;
+    r->i2c += IMU_XFERS_READ;
+    r->wakeups++;
+    if (fall_detector_feed(&s_trace.s[i], &e)) record(r, &e);
+    if (!motion_gate_feed(&s_trace.s[i], fall_detector_busy())) {
+      i++;
+      continue;
+    }
+    // Entra en WOM tras la muestra i; referencia = última muestra leída.
+    r->i2c += IMU_XFERS_WOM_ENTER;
+    r->wom_entries++;
+    const accel_raw_t ref = s_trace.s[i];
+    size_t k = i + 1U + phase;
+    while (k < s_trace.n && !moved(&s_trace.s[k], &ref, thr)) k += stride;
+    if (k >= s_trace.n) {
+      r->wom_samples += (uint32_t)(s_trace.n - i - 1U);
+      break;
+    }
+    // INT en la muestra low-power k; la primera lectura completa es k + 1.
+    r->i2c += IMU_XFERS_WOM_WAKE + IMU_XFERS_WOM_EXIT;
+    r->wom_samples += (uint32_t)(k - i);
+    fall_detector_skip_samples((uint32_t)(k - i));
+    motion_gate_wake();
+    i = k + 1U;
+  }
+}
+
+static uint32_t epoch_of_index(size_t i) {
+  return (uint32_t)((i + 1U) * 1000U / FALL_FS_HZ);
+}
+
+static bool find_event(const run_t* r, uint32_t epoch_ms, int16_t* peak_out) {
+  for (size_t j = 0; j < r->n_ev; ++j) {
+    const uint32_t d = r->ev[j].epoch_ms > epoch_ms ? r->ev[j].epoch_ms - epoch_ms : epoch_ms - r->ev[j].epoch_ms;
+    if (d <= MATCH_TOL_MS) {
+      if (peak_out) *peak_out = r->ev[j].ax_peak_centi_g;
+      return true;
+    }
+  }
+  return false;
+}
+
+typedef struct {
+  uint64_t samples, i2c_base, i2c_adapt, wake_base, wake_adapt, wom_samples;
+  unsigned labels, missed, mismatched;
+} totals_t;
+
+static void evaluate(const char* name, totals_t* tot) {
+  run_t base, adapt;
+  run_continuous(&base);
+
+  const uint32_t stride = (4096U >> FALL_WOM_LP_ODR_SEL) * FALL_FS_HZ / 1000U;
+  const uint32_t stride_n = stride ? stride : 1U;
+  unsigned labels = 0, missed = 0, mismatched = 0;
+  int peak_err_max = 0;
+  uint64_t i2c_sum = 0, wake_sum = 0, wom_sum = 0;
+  for (size_t i = 0; i < s_trace.n; ++i) labels += s_trace.label[i];
+
+  for (uint32_t phase = 0; phase < stride_n; ++phase) {
+    run_adaptive(&adapt, stride_n, phase);
+    i2c_sum += adapt.i2c;
+    wake_sum += adapt.wakeups;
+    wom_sum += adapt.wom_samples;
+    // Etiquetas: la caída debe detectarse cerca del impacto (pico ≤ 50 ms después).
+    for (size_t i = 0; i < s_trace.n; ++i) {
+      if (!s_trace.label[i]) continue;
+      const uint32_t ep = epoch_of_index(i) + 20U;
+      if (!find_event(&adapt, ep, NULL)) missed++;
+    }
+    // Equivalencia con el muestreo continuo (mismas detecciones, ± tolerancia).
+    if (adapt.n_ev != base.n_ev) mismatched++;
+    for (size_t j = 0; j < base.n_ev; ++j) {
+      int16_t peak = 0;
+      if (!find_event(&adapt, base.ev[j].epoch_ms, &peak)) {
+        mismatched++;
+        continue;
+      }
+      const int err = abs(base.ev[j].ax_peak_centi_g - peak);
+      if (err > peak_err_max) peak_err_max = err;
+    }
+  }
+  const uint64_t i2c_adapt = i2c_sum / stride_n;
+  const uint64_t wake_adapt = wake_sum / stride_n;
+  const uint64_t wom = wom_sum / stride_n;
+  printf("WOM %-17s %7zu %3u %4zu %4zu %9u %9llu %7.1f%% %9u %9llu %7.1f%% %5.1f%% %5d%s\n", name,
+         s_trace.n, labels, base.n_ev, adapt.n_ev, (unsigned)base.i2c, (unsigned long long)i2c_adapt,
+         100.0 * (1.0 - (double)i2c_adapt / (double)base.i2c), (unsigned)base.wakeups,
+         (unsigned long long)wake_adapt, 100.0 * (1.0 - (double)wake_adapt / (double)base.wakeups),
+         100.0 * (double)wom / (double)s_trace.n, peak_err_max,
+         (missed || mismatched) ? "  << FALLA" : "");
+
+  tot->samples += s_trace.n;
+  tot->i2c_base += base.i2c;
+  tot->i2c_adapt += i2c_adapt;
+  tot->wake_base += base.wakeups;
+  tot->wake_adapt += wake_adapt;
+  tot->wom_samples += wom;
+  tot->labels += labels;
+  tot->missed += missed;
+  tot->mismatched += mismatched;
+}
+
+int main(int argc, char** argv) {
+  totals_t tot;
+  memset(&tot, 0, sizeof(tot));
+  printf("WOM umbral=%u mg quieto=%u ms lp_odr_sel=%u (fases probadas por escenario: todas)\n",
+         (unsigned)(FALL_STILL_THR_CENTI_G * 10), (unsigned)FALL_STILL_MS, (unsigned)FALL_WOM_LP_ODR_SEL);
+  printf("WOM %-17s %7s %3s %4s %4s %9s %9s %8s %9s %9s %8s %6s %5s\n", "escenario", "muestras",
+         "lab", "base", "adap", "i2c_base", "i2c_adap", "ahorro", "desp_base", "desp_adap", "ahorro",
+         "wom", "dpico");
+  if (argc > 1) {
+    for (int a = 1; a < argc; ++a) {
+      if (load_csv(argv[a]) == 0U) continue;
+      evaluate(argv[a], &tot);
+    }
+  } else {
+    for (size_t k = 0; k < sizeof(s_scenarios) / sizeof(s_scenarios[0]); ++k) {
+      s_trace.n = 0;
+      s_rng = 12345U + (uint32_t)k;
+      s_scenarios[k].fn();
+      evaluate(s_scenarios[k].name, &tot);
+    }
+  }
+  if (tot.samples == 0U) return 1;
+  printf("WOM TOTAL muestras=%llu caidas=%u perdidas=%u discrepancias=%u i2c %llu→%llu (-%.1f%%) "
+         "despertares %llu→%llu (-%.1f%%) wom=%.1f%%\n",
+         (unsigned long long)tot.samples, tot.labels, tot.missed, tot.mismatched,
+         (unsigned long long)tot.i2c_base, (unsigned long long)tot.i2c_adapt,
+         100.0 * (1.0 - (double)tot.i2c_adapt / (double)tot.i2c_base), (unsigned long long)tot.wake_base,
+         (unsigned long long)tot.wake_adapt, 100.0 * (1.0 - (double)tot.wake_adapt / (double)tot.wake_base),
+         100.0 * (double)tot.wom_samples / (double)tot.samples);
+  return (tot.missed == 0U && tot.mismatched == 0U) ? 0 : 1;
+}